@@ -4,13 +4,16 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
 #include <AK/ByteString.h>
 #include <AK/DeprecatedFlyString.h>
 #include <AK/HashTable.h>
+#include <AK/Noncopyable.h>
 #include <AK/Optional.h>
 #include <AK/Singleton.h>
 #include <AK/StringUtils.h>
 #include <AK/StringView.h>
+#include <pthread.h>
 
 namespace AK {
 
@@ -24,14 +27,52 @@ struct DeprecatedFlyStringImplTraits : public Traits<StringImpl const*> {
 
 static Singleton<HashTable<StringImpl const*, DeprecatedFlyStringImplTraits>> s_table;
 
+// The table is shared by all threads, so it may only be touched while holding this lock.
+static pthread_mutex_t s_table_lock = PTHREAD_MUTEX_INITIALIZER;
+
+class TableLocker {
+    AK_MAKE_NONCOPYABLE(TableLocker);
+    AK_MAKE_NONMOVABLE(TableLocker);
+
+public:
+    TableLocker() { pthread_mutex_lock(&s_table_lock); }
+    ~TableLocker() { pthread_mutex_unlock(&s_table_lock); }
+};
+
 static HashTable<StringImpl const*, DeprecatedFlyStringImplTraits>& fly_impls()
 {
     return *s_table;
 }
 
+void DeprecatedFlyString::enable_sharing_between_threads()
+{
+    // NOTE: The empty StringImpl is shared by every empty string, fly or not, and lazily created. It's created here at
+    //       the latest, so the new thread doesn't race us to it. As it's a fly impl, its reference count becomes atomic
+    //       along with all the others, and as it holds an extra reference of its own, it never drops to zero.
+    (void)StringImpl::the_empty_stringimpl();
+
+    // The new thread hasn't been started yet, so no reference count can be in flight while we flip the switch.
+    AK::atomic_store(&StringImpl::s_fly_impls_are_shared_between_threads, true, AK::memory_order_relaxed);
+}
+
 void DeprecatedFlyString::did_destroy_impl(Badge<StringImpl>, StringImpl& impl)
 {
+    TableLocker locker;
+    fly_impls().remove(&impl);
+}
+
+bool DeprecatedFlyString::did_drop_last_reference(Badge<StringImpl>, StringImpl const& impl)
+{
+    // Interning only takes a new reference to an impl while holding the lock, so once we hold it as well, nobody can
+    // resurrect the impl after its reference count has reached zero.
+    TableLocker locker;
+    if (AK::atomic_fetch_sub(&impl.m_ref_count, 1u, AK::memory_order_acq_rel) != 1)
+        return false;
     fly_impls().remove(&impl);
+    // Another thread may intern an equal string as soon as we let go of the lock, so the destructor must not go
+    // looking for this impl in the table again.
+    impl.set_fly({}, false);
+    return true;
 }
 
 DeprecatedFlyString::DeprecatedFlyString(ByteString const& string)
@@ -40,6 +81,7 @@ DeprecatedFlyString::DeprecatedFlyString(ByteString const& string)
     if (string.impl()->is_fly())
         return;
 
+    TableLocker locker;
     auto it = fly_impls().find(string.impl());
     if (it == fly_impls().end()) {
         fly_impls().set(string.impl());
@@ -56,6 +98,8 @@ DeprecatedFlyString::DeprecatedFlyString(StringView string)
 {
     if (string.is_null())
         return;
+
+    TableLocker locker;
     auto it = fly_impls().find(string.hash(), [&](auto& candidate) {
         return string == *candidate;
     });
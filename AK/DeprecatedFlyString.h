@@ -81,7 +81,13 @@ public:
     bool starts_with(StringView, CaseSensitivity = CaseSensitivity::CaseSensitive) const;
     bool ends_with(StringView, CaseSensitivity = CaseSensitivity::CaseSensitive) const;
 
+    // Fly strings may only be used by one thread unless this has been called first. It can't be undone, and makes
+    // every fly string reference count update atomic from then on, so only call it when actually spawning such a thread.
+    static void enable_sharing_between_threads();
+
     static void did_destroy_impl(Badge<StringImpl>, StringImpl&);
+    // Returns whether the impl is to be destroyed, which it isn't if another thread interned the same string again in the meantime.
+    static bool did_drop_last_reference(Badge<StringImpl>, StringImpl const&);
 
     template<typename... Ts>
     [[nodiscard]] ALWAYS_INLINE constexpr bool is_one_of(Ts&&... strings) const
@@ -0,0 +1,590 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/BitCast.h>
+#include <AK/BuiltinWrappers.h>
+#include <AK/Concepts.h>
+#include <AK/Error.h>
+#include <AK/HashTable.h>
+#include <AK/Platform.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Traits.h>
+#include <AK/Types.h>
+#include <AK/kmalloc.h>
+
+#if ARCH(X86_64)
+#    include <AK/SIMD.h>
+#    include <AK/SIMDExtras.h>
+#endif
+
+namespace AK {
+
+namespace Detail {
+
+// Every slot of a FlatHashTable has a control byte, kept apart from the slots themselves. A used slot's control byte is
+// the top 7 bits of its value's hash (so its high bit is clear), and an unused slot's is one of these:
+static constexpr u8 flat_hash_table_empty = 0x80;
+static constexpr u8 flat_hash_table_deleted = 0xfe;
+
+// The slots in a group that matched something, with every slot being one bit (or for SWAR, one byte) of the mask.
+template<typename MaskType, size_t Shift>
+class FlatHashTableBitMask {
+public:
+    explicit FlatHashTableBitMask(MaskType bits)
+        : m_bits(bits)
+    {
+    }
+
+    explicit operator bool() const { return m_bits != 0; }
+
+    class Iterator {
+    public:
+        explicit Iterator(MaskType bits)
+            : m_bits(bits)
+        {
+        }
+
+        bool operator!=(Iterator const& other) const { return m_bits != other.m_bits; }
+        size_t operator*() const { return count_trailing_zeroes(m_bits) >> Shift; }
+        void operator++() { m_bits &= m_bits - 1; }
+
+    private:
+        MaskType m_bits { 0 };
+    };
+
+    Iterator begin() const { return Iterator { m_bits }; }
+    Iterator end() const { return Iterator { 0 }; }
+
+private:
+    MaskType m_bits { 0 };
+};
+
+#if ARCH(X86_64)
+// Looks at the control bytes of 16 slots at once.
+class FlatHashTableGroup {
+public:
+    static constexpr size_t width = 16;
+    using Mask = FlatHashTableBitMask<u32, 0>;
+
+    explicit FlatHashTableGroup(u8 const* control)
+        : m_control(SIMD::load_unaligned<SIMD::c8x16>(control))
+    {
+    }
+
+    Mask match(u8 hash_bits) const { return Mask { to_bitmask(m_control == SIMD::expand_to<SIMD::c8x16>(static_cast<char>(hash_bits))) }; }
+    Mask match_empty() const { return match(flat_hash_table_empty); }
+    Mask match_empty_or_deleted() const { return Mask { to_bitmask(m_control) }; }
+    Mask match_used() const { return Mask { to_bitmask(m_control) ^ 0xffff }; }
+
+private:
+    // Gathers the high bit of every byte.
+    template<typename VectorType>
+    static u32 to_bitmask(VectorType bytes)
+    {
+        return static_cast<u32>(__builtin_ia32_pmovmskb128(bit_cast<SIMD::c8x16>(bytes)));
+    }
+
+    SIMD::c8x16 m_control;
+};
+#else
+// Looks at the control bytes of 8 slots at once, using ordinary 64-bit arithmetic ("SIMD within a register").
+class FlatHashTableGroup {
+public:
+    static constexpr size_t width = 8;
+    using Mask = FlatHashTableBitMask<u64, 3>;
+
+    explicit FlatHashTableGroup(u8 const* control)
+    {
+        for (size_t i = 0; i < width; ++i)
+            m_control |= static_cast<u64>(control[i]) << (i * 8);
+    }
+
+    // NOTE: This may also match a used slot right after one that really matched, if its hash bits only differ in the
+    //       lowest bit. That's fine, as every match is followed by comparing the values anyway.
+    Mask match(u8 hash_bits) const
+    {
+        auto bytes = m_control ^ (lsbs * hash_bits);
+        return Mask { (bytes - lsbs) & ~bytes & msbs };
+    }
+    Mask match_empty() const { return Mask { m_control & ~(m_control << 6) & msbs }; }
+    Mask match_empty_or_deleted() const { return Mask { m_control & msbs }; }
+    Mask match_used() const { return Mask { ~m_control & msbs }; }
+
+private:
+    static constexpr u64 lsbs = 0x0101010101010101;
+    static constexpr u64 msbs = 0x8080808080808080;
+
+    u64 m_control { 0 };
+};
+#endif
+
+}
+
+template<typename TableType, typename T>
+class FlatHashTableIterator {
+    friend TableType;
+
+public:
+    bool operator==(FlatHashTableIterator const& other) const { return m_index == other.m_index; }
+    bool operator!=(FlatHashTableIterator const& other) const { return m_index != other.m_index; }
+    T& operator*() { return m_slots[m_index]; }
+    T* operator->() { return &m_slots[m_index]; }
+    void operator++()
+    {
+        ++m_index;
+        skip_unused_slots();
+    }
+
+private:
+    FlatHashTableIterator(u8 const* control, T* slots, size_t capacity, size_t index)
+        : m_control(control)
+        , m_slots(slots)
+        , m_capacity(capacity)
+        , m_index(index)
+    {
+        skip_unused_slots();
+    }
+
+    void skip_unused_slots()
+    {
+        while (m_index < m_capacity && (m_control[m_index] & 0x80) != 0)
+            ++m_index;
+    }
+
+    u8 const* m_control { nullptr };
+    T* m_slots { nullptr };
+    size_t m_capacity { 0 };
+    size_t m_index { 0 };
+};
+
+// A set datastructure based on a hash table with open addressing, where the slots are split into groups, and every
+// group has its own control bytes next to each other: one per slot, holding 7 bits of the hash of the value in it.
+// A lookup compares the control bytes of a whole group against the hash at once (with SIMD where available), and only
+// compares values where that matched, so it rarely touches a slot that doesn't hold the value it's looking for.
+//
+// FlatHashTable has the same interface as HashTable, but it never keeps the order of its values, and removing a value
+// doesn't move any of the others. Values are stored in a flat array, so unlike with HashTable, neither pointers to them
+// nor iterators stay valid when a value is added.
+template<typename T, typename TraitsForT>
+class FlatHashTable {
+    using Group = Detail::FlatHashTableGroup;
+
+    static constexpr size_t minimum_capacity = 16;
+    static_assert(minimum_capacity % Group::width == 0);
+
+    // Up to 7/8 of the slots are used (or deleted) before growing.
+    static constexpr size_t max_load(size_t capacity) { return capacity - capacity / 8; }
+
+public:
+    FlatHashTable() = default;
+    explicit FlatHashTable(size_t capacity) { ensure_capacity(capacity); }
+
+    ~FlatHashTable()
+    {
+        if (!m_control)
+            return;
+        destroy_values();
+        kfree_sized(m_control, size_in_bytes(m_capacity));
+    }
+
+    FlatHashTable(FlatHashTable const& other)
+    {
+        ensure_capacity(other.size());
+        for (auto& it : other)
+            set(it);
+    }
+
+    FlatHashTable& operator=(FlatHashTable const& other)
+    {
+        FlatHashTable temporary(other);
+        swap(*this, temporary);
+        return *this;
+    }
+
+    FlatHashTable(FlatHashTable&& other) noexcept
+        : m_control(other.m_control)
+        , m_slots(other.m_slots)
+        , m_size(other.m_size)
+        , m_capacity(other.m_capacity)
+        , m_growth_left(other.m_growth_left)
+    {
+        other.m_control = nullptr;
+        other.m_slots = nullptr;
+        other.m_size = 0;
+        other.m_capacity = 0;
+        other.m_growth_left = 0;
+    }
+
+    FlatHashTable& operator=(FlatHashTable&& other) noexcept
+    {
+        FlatHashTable temporary { move(other) };
+        swap(*this, temporary);
+        return *this;
+    }
+
+    friend void swap(FlatHashTable& a, FlatHashTable& b) noexcept
+    {
+        swap(a.m_control, b.m_control);
+        swap(a.m_slots, b.m_slots);
+        swap(a.m_size, b.m_size);
+        swap(a.m_capacity, b.m_capacity);
+        swap(a.m_growth_left, b.m_growth_left);
+    }
+
+    [[nodiscard]] bool is_empty() const { return m_size == 0; }
+    [[nodiscard]] size_t size() const { return m_size; }
+    [[nodiscard]] size_t capacity() const { return m_capacity; }
+
+    template<typename U, size_t N>
+    ErrorOr<void> try_set_from(U (&from_array)[N])
+    {
+        for (size_t i = 0; i < N; ++i)
+            TRY(try_set(from_array[i]));
+        return {};
+    }
+    template<typename U, size_t N>
+    void set_from(U (&from_array)[N])
+    {
+        MUST(try_set_from(from_array));
+    }
+
+    ErrorOr<void> try_ensure_capacity(size_t capacity)
+    {
+        // As with HashTable, "capacity" here is the number of values that can be stored without reallocating.
+        size_t required_capacity = minimum_capacity;
+        while (max_load(required_capacity) < capacity)
+            required_capacity *= 2;
+        if (required_capacity <= m_capacity)
+            return {};
+        return try_rehash(required_capacity);
+    }
+    void ensure_capacity(size_t capacity)
+    {
+        MUST(try_ensure_capacity(capacity));
+    }
+
+    [[nodiscard]] bool contains(T const& value) const
+    {
+        return find(value) != end();
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] bool contains(K const& value) const
+    {
+        return find(value) != end();
+    }
+
+    using Iterator = FlatHashTableIterator<FlatHashTable, T>;
+    using ConstIterator = FlatHashTableIterator<FlatHashTable const, T const>;
+
+    [[nodiscard]] Iterator begin() { return Iterator(m_control, m_slots, m_capacity, 0); }
+    [[nodiscard]] Iterator end() { return Iterator(m_control, m_slots, m_capacity, m_capacity); }
+    [[nodiscard]] ConstIterator begin() const { return ConstIterator(m_control, m_slots, m_capacity, 0); }
+    [[nodiscard]] ConstIterator end() const { return ConstIterator(m_control, m_slots, m_capacity, m_capacity); }
+
+    void clear()
+    {
+        *this = FlatHashTable();
+    }
+
+    void clear_with_capacity()
+    {
+        if (m_capacity == 0)
+            return;
+        destroy_values();
+        __builtin_memset(m_control, Detail::flat_hash_table_empty, m_capacity);
+        m_size = 0;
+        m_growth_left = max_load(m_capacity);
+    }
+
+    template<typename U = T>
+    ErrorOr<HashSetResult> try_set(U&& value, HashSetExistingEntryBehavior existing_entry_behavior = HashSetExistingEntryBehavior::Replace)
+    {
+        auto hash = TraitsForT::hash(value);
+        if (auto index = lookup_with_hash(hash, [&](auto& entry) { return TraitsForT::equals(entry, static_cast<T const&>(value)); }); index != m_capacity) {
+            if (existing_entry_behavior == HashSetExistingEntryBehavior::Keep)
+                return HashSetResult::KeptExistingEntry;
+            m_slots[index] = forward<U>(value);
+            return HashSetResult::ReplacedExistingEntry;
+        }
+
+        if (m_growth_left == 0)
+            TRY(try_rehash(capacity_to_grow_to()));
+
+        auto index = find_slot_for_insertion(hash);
+        if (m_control[index] == Detail::flat_hash_table_empty)
+            --m_growth_left;
+        m_control[index] = hash_bits(hash);
+        new (&m_slots[index]) T(forward<U>(value));
+        ++m_size;
+        return HashSetResult::InsertedNewEntry;
+    }
+    template<typename U = T>
+    HashSetResult set(U&& value, HashSetExistingEntryBehavior existing_entry_behavior = HashSetExistingEntryBehavior::Replace)
+    {
+        return MUST(try_set(forward<U>(value), existing_entry_behavior));
+    }
+
+    template<typename TUnaryPredicate>
+    [[nodiscard]] Iterator find(unsigned hash, TUnaryPredicate predicate)
+    {
+        return Iterator(m_control, m_slots, m_capacity, lookup_with_hash(hash, move(predicate)));
+    }
+
+    [[nodiscard]] Iterator find(T const& value)
+    {
+        if (is_empty())
+            return end();
+        return find(TraitsForT::hash(value), [&](auto& entry) { return TraitsForT::equals(entry, value); });
+    }
+
+    template<typename TUnaryPredicate>
+    [[nodiscard]] ConstIterator find(unsigned hash, TUnaryPredicate predicate) const
+    {
+        return ConstIterator(m_control, m_slots, m_capacity, lookup_with_hash(hash, move(predicate)));
+    }
+
+    [[nodiscard]] ConstIterator find(T const& value) const
+    {
+        if (is_empty())
+            return end();
+        return find(TraitsForT::hash(value), [&](auto& entry) { return TraitsForT::equals(entry, value); });
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] Iterator find(K const& value)
+    {
+        if (is_empty())
+            return end();
+        return find(Traits<K>::hash(value), [&](auto& entry) { return Traits<T>::equals(entry, value); });
+    }
+
+    template<Concepts::HashCompatible<T> K, typename TUnaryPredicate>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] Iterator find(K const& value, TUnaryPredicate predicate)
+    {
+        if (is_empty())
+            return end();
+        return find(Traits<K>::hash(value), move(predicate));
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] ConstIterator find(K const& value) const
+    {
+        if (is_empty())
+            return end();
+        return find(Traits<K>::hash(value), [&](auto& entry) { return Traits<T>::equals(entry, value); });
+    }
+
+    template<Concepts::HashCompatible<T> K, typename TUnaryPredicate>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] ConstIterator find(K const& value, TUnaryPredicate predicate) const
+    {
+        if (is_empty())
+            return end();
+        return find(Traits<K>::hash(value), move(predicate));
+    }
+
+    bool remove(T const& value)
+    {
+        auto it = find(value);
+        if (it != end()) {
+            remove(it);
+            return true;
+        }
+        return false;
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) bool remove(K const& value)
+    {
+        auto it = find(value);
+        if (it != end()) {
+            remove(it);
+            return true;
+        }
+        return false;
+    }
+
+    // This invalidates the iterator
+    void remove(Iterator& iterator)
+    {
+        VERIFY(iterator.m_index < m_capacity);
+        delete_slot(iterator.m_index);
+        iterator.m_index = m_capacity;
+    }
+
+    template<typename TUnaryPredicate>
+    bool remove_all_matching(TUnaryPredicate const& predicate)
+    {
+        bool has_removed_anything = false;
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (!is_used(m_control[i]) || !predicate(m_slots[i]))
+                continue;
+            delete_slot(i);
+            has_removed_anything = true;
+        }
+        return has_removed_anything;
+    }
+
+    [[nodiscard]] Vector<T> values() const
+    {
+        Vector<T> list;
+        list.ensure_capacity(size());
+        for (auto& value : *this)
+            list.unchecked_append(value);
+        return list;
+    }
+
+private:
+    static constexpr bool is_used(u8 control) { return (control & 0x80) == 0; }
+
+    // The hash is spread out over all bits first, as not every Traits::hash() changes the lower bits much. The top 7
+    // bits go into the control byte, and the ones below pick the group where probing starts.
+    static constexpr u64 mix(unsigned hash) { return static_cast<u64>(hash) * 0x9e3779b97f4a7c15ull; }
+    static constexpr u8 hash_bits(unsigned hash) { return static_cast<u8>(mix(hash) >> 57); }
+    static constexpr size_t first_group(unsigned hash) { return static_cast<size_t>(mix(hash) >> 25); }
+
+    static constexpr size_t slots_offset(size_t capacity) { return align_up_to(capacity, alignof(T)); }
+    static constexpr size_t size_in_bytes(size_t capacity) { return slots_offset(capacity) + sizeof(T) * capacity; }
+
+    // Calls the callback with the index of the first slot of every group on the probe sequence for this hash, until it
+    // returns true. The sequence visits every group once, as the step between them grows by one each time.
+    template<typename Callback>
+    void for_each_group_to_probe(unsigned hash, Callback callback) const
+    {
+        auto group_mask = m_capacity / Group::width - 1;
+        auto group = first_group(hash) & group_mask;
+        for (size_t step = 1;; ++step) {
+            if (callback(group * Group::width))
+                return;
+            group = (group + step) & group_mask;
+        }
+    }
+
+    // Returns the index of the matching slot, or the capacity if there is none.
+    template<typename TUnaryPredicate>
+    size_t lookup_with_hash(unsigned hash, TUnaryPredicate predicate) const
+    {
+        if (is_empty())
+            return m_capacity;
+
+        auto bits = hash_bits(hash);
+        size_t result = m_capacity;
+        for_each_group_to_probe(hash, [&](size_t group_start) {
+            Group group { m_control + group_start };
+            for (auto index_in_group : group.match(bits)) {
+                if (predicate(m_slots[group_start + index_in_group])) {
+                    result = group_start + index_in_group;
+                    return true;
+                }
+            }
+            // A value is never put past a group with an empty slot, so this is as far as it could have gone.
+            return static_cast<bool>(group.match_empty());
+        });
+        return result;
+    }
+
+    size_t find_slot_for_insertion(unsigned hash) const
+    {
+        size_t result = 0;
+        for_each_group_to_probe(hash, [&](size_t group_start) {
+            auto free_slots = Group { m_control + group_start }.match_empty_or_deleted();
+            if (!free_slots)
+                return false;
+            result = group_start + *free_slots.begin();
+            return true;
+        });
+        return result;
+    }
+
+    void delete_slot(size_t index)
+    {
+        m_slots[index].~T();
+        --m_size;
+
+        // If its group has an empty slot, it has never been full, and so no lookup ever went past it. This slot can then
+        // be empty again, rather than being marked as deleted, which lookups would have to keep looking past.
+        auto group_start = index - index % Group::width;
+        if (Group { m_control + group_start }.match_empty()) {
+            m_control[index] = Detail::flat_hash_table_empty;
+            ++m_growth_left;
+        } else {
+            m_control[index] = Detail::flat_hash_table_deleted;
+        }
+    }
+
+    void destroy_values()
+    {
+        if constexpr (!IsTriviallyDestructible<T>) {
+            for (size_t i = 0; i < m_capacity; ++i) {
+                if (is_used(m_control[i]))
+                    m_slots[i].~T();
+            }
+        }
+    }
+
+    size_t capacity_to_grow_to() const
+    {
+        if (m_capacity == 0)
+            return minimum_capacity;
+        // If most of the slots that are taken up only hold deleted values, getting rid of those makes enough room.
+        if (m_size < max_load(m_capacity) / 2)
+            return m_capacity;
+        return m_capacity * 2;
+    }
+
+    ErrorOr<void> try_rehash(size_t new_capacity)
+    {
+        VERIFY(new_capacity >= minimum_capacity && is_power_of_two(new_capacity));
+        VERIFY(max_load(new_capacity) >= m_size);
+
+        auto* new_control = static_cast<u8*>(kmalloc(size_in_bytes(new_capacity)));
+        if (!new_control)
+            return Error::from_errno(ENOMEM);
+        __builtin_memset(new_control, Detail::flat_hash_table_empty, new_capacity);
+
+        auto* old_control = m_control;
+        auto* old_slots = m_slots;
+        auto old_capacity = m_capacity;
+
+        m_control = new_control;
+        m_slots = reinterpret_cast<T*>(new_control + slots_offset(new_capacity));
+        m_capacity = new_capacity;
+        m_growth_left = max_load(new_capacity) - m_size;
+
+        if (!old_control)
+            return {};
+
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (!is_used(old_control[i]))
+                continue;
+            auto& old_value = old_slots[i];
+            auto hash = TraitsForT::hash(old_value);
+            auto index = find_slot_for_insertion(hash);
+            m_control[index] = hash_bits(hash);
+            new (&m_slots[index]) T(move(old_value));
+            old_value.~T();
+        }
+
+        kfree_sized(old_control, size_in_bytes(old_capacity));
+        return {};
+    }
+
+    u8* m_control { nullptr };
+    T* m_slots { nullptr };
+    size_t m_size { 0 };
+    size_t m_capacity { 0 };
+    // How many more values can be added before having to grow. Deleted slots count as used here, as lookups have to
+    // probe past them too.
+    size_t m_growth_left { 0 };
+};
+
+}
+
+#if USING_AK_GLOBALLY
+using AK::FlatHashTable;
+#endif
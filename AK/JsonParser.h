@@ -20,6 +20,9 @@ public:
 
     ErrorOr<JsonValue> parse();
 
+    // Keep recursive parsing depth bounded so untrusted JSON cannot overflow the call stack.
+    static constexpr size_t max_nesting_depth { 512 };
+
 private:
     ErrorOr<JsonValue> parse_helper();
 
@@ -32,8 +35,6 @@ private:
     ErrorOr<JsonValue> parse_true();
     ErrorOr<JsonValue> parse_null();
 
-    // Keep recursive parsing depth bounded so untrusted JSON cannot overflow the call stack.
-    static constexpr size_t max_nesting_depth { 512 };
     size_t m_current_nesting_depth { 0 };
 };
 
@@ -28,12 +28,29 @@ StringImpl::StringImpl(ConstructWithInlineBufferTag, size_t length)
 {
 }
 
+bool StringImpl::s_fly_impls_are_shared_between_threads = false;
+
 StringImpl::~StringImpl()
 {
     if (m_fly)
         DeprecatedFlyString::did_destroy_impl({}, *this);
 }
 
+bool StringImpl::unref_shared_fly() const
+{
+    // Dropping anything but the last reference doesn't have to involve the fly string table.
+    auto ref_count = AK::atomic_load(&m_ref_count, AK::memory_order_relaxed);
+    while (ref_count > 1) {
+        if (AK::atomic_compare_exchange_strong(&m_ref_count, ref_count, ref_count - 1, AK::memory_order_acq_rel))
+            return false;
+    }
+
+    if (!DeprecatedFlyString::did_drop_last_reference({}, *this))
+        return false;
+    delete this;
+    return true;
+}
+
 NonnullRefPtr<StringImpl const> StringImpl::create_uninitialized(size_t length, char*& buffer)
 {
     VERIFY(length);
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Badge.h>
 #include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
@@ -23,6 +24,8 @@ enum ShouldChomp {
 size_t allocation_size_for_stringimpl(size_t length);
 
 class StringImpl : public RefCounted<StringImpl> {
+    friend class DeprecatedFlyString;
+
 public:
     static NonnullRefPtr<StringImpl const> create_uninitialized(size_t length, char*& buffer);
     static RefPtr<StringImpl const> create(char const* cstring, ShouldChomp = NoChomp);
@@ -43,6 +46,25 @@ public:
 
     ~StringImpl();
 
+    // Once fly strings are shared between threads, every thread that interns the same string holds a reference to the
+    // same impl, so their reference counts have to be updated atomically. Until then, and for any other string, the
+    // plain counter is enough.
+    ALWAYS_INLINE void ref() const
+    {
+        if (m_fly && fly_impls_are_shared_between_threads()) [[unlikely]] {
+            AK::atomic_fetch_add(&m_ref_count, 1u, AK::memory_order_relaxed);
+            return;
+        }
+        RefCountedBase::ref();
+    }
+
+    ALWAYS_INLINE bool unref() const
+    {
+        if (m_fly && fly_impls_are_shared_between_threads()) [[unlikely]]
+            return unref_shared_fly();
+        return RefCounted::unref();
+    }
+
     size_t length() const { return m_length; }
     // Includes NUL-terminator.
     char const* characters() const { return &m_inline_buffer[0]; }
@@ -96,6 +118,10 @@ private:
     StringImpl(ConstructWithInlineBufferTag, size_t length);
 
     void compute_hash() const;
+    bool unref_shared_fly() const;
+
+    static bool fly_impls_are_shared_between_threads() { return AK::atomic_load(&s_fly_impls_are_shared_between_threads, AK::memory_order_relaxed); }
+    static bool s_fly_impls_are_shared_between_threads;
 
     size_t m_length { 0 };
     mutable unsigned m_hash { 0 };
@@ -21,31 +21,51 @@ static constexpr u16 low_surrogate_max = 0xdfff;
 static constexpr u32 replacement_code_point = 0xfffd;
 static constexpr u32 first_supplementary_plane_code_point = 0x10000;
 
-template<OneOf<Utf8View, Utf32View> UtfViewType>
-static ErrorOr<Utf16Data> to_utf16_impl(UtfViewType const& view)
-{
-    Utf16Data utf16_data;
-    TRY(utf16_data.try_ensure_capacity(view.length()));
-
-    for (auto code_point : view)
-        TRY(code_point_to_utf16(utf16_data, code_point));
-
-    return utf16_data;
-}
-
 ErrorOr<Utf16Data> utf8_to_utf16(StringView utf8_view)
 {
-    return to_utf16_impl(Utf8View { utf8_view });
+    return utf8_to_utf16(Utf8View { utf8_view });
 }
 
 ErrorOr<Utf16Data> utf8_to_utf16(Utf8View const& utf8_view)
 {
-    return to_utf16_impl(utf8_view);
+    Utf16Data utf16_data;
+    TRY(utf16_data.try_ensure_capacity(utf8_view.length()));
+
+    auto const* bytes = utf8_view.bytes();
+    auto byte_length = utf8_view.byte_length();
+
+    for (size_t offset = 0; offset < byte_length;) {
+        // OPTIMIZATION: Every ASCII byte becomes one code unit with the same value, so a run of them is widened at once.
+        if (bytes[offset] < 0x80) {
+            auto ascii_length = Detail::ascii_prefix_length(bytes + offset, byte_length - offset);
+            auto utf16_offset = utf16_data.size();
+            TRY(utf16_data.try_resize(utf16_offset + ascii_length));
+
+            auto* code_units = utf16_data.data() + utf16_offset;
+            for (size_t i = 0; i < ascii_length; ++i)
+                code_units[i] = bytes[offset + i];
+
+            offset += ascii_length;
+            continue;
+        }
+
+        auto iterator = utf8_view.iterator_at_byte_offset_without_validation(offset);
+        TRY(code_point_to_utf16(utf16_data, *iterator));
+        offset += iterator.underlying_code_point_length_in_bytes();
+    }
+
+    return utf16_data;
 }
 
 ErrorOr<Utf16Data> utf32_to_utf16(Utf32View const& utf32_view)
 {
-    return to_utf16_impl(utf32_view);
+    Utf16Data utf16_data;
+    TRY(utf16_data.try_ensure_capacity(utf32_view.length()));
+
+    for (auto code_point : utf32_view)
+        TRY(code_point_to_utf16(utf16_data, code_point));
+
+    return utf16_data;
 }
 
 ErrorOr<void> code_point_to_utf16(Utf16Data& string, u32 code_point)
@@ -65,9 +85,25 @@ ErrorOr<void> code_point_to_utf16(Utf16Data& string, u32 code_point)
 
 size_t utf16_code_unit_length_from_utf8(StringView string)
 {
-    // FIXME: This is inefficient!
-    auto utf16_data = MUST(AK::utf8_to_utf16(string));
-    return Utf16View { utf16_data }.length_in_code_units();
+    // Walk the code points the same way the conversion would, but only count the code units instead of storing them.
+    Utf8View utf8_view { string };
+    auto const* bytes = utf8_view.bytes();
+    auto byte_length = utf8_view.byte_length();
+
+    size_t length = 0;
+    for (size_t offset = 0; offset < byte_length;) {
+        if (bytes[offset] < 0x80) {
+            auto ascii_length = Detail::ascii_prefix_length(bytes + offset, byte_length - offset);
+            length += ascii_length;
+            offset += ascii_length;
+            continue;
+        }
+
+        auto iterator = utf8_view.iterator_at_byte_offset_without_validation(offset);
+        length += *iterator < first_supplementary_plane_code_point ? 1 : 2;
+        offset += iterator.underlying_code_point_length_in_bytes();
+    }
+    return length;
 }
 
 bool Utf16View::is_high_surrogate(u16 code_unit)
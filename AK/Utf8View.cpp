@@ -6,12 +6,45 @@
  */
 
 #include <AK/Assertions.h>
+#include <AK/BitCast.h>
 #include <AK/Debug.h>
 #include <AK/Format.h>
 #include <AK/Utf8View.h>
 
+#ifndef KERNEL
+#    include <AK/SIMD.h>
+#    include <AK/SIMDExtras.h>
+#endif
+
 namespace AK {
 
+size_t Detail::ascii_prefix_length(u8 const* bytes, size_t length)
+{
+    size_t offset = 0;
+
+    // Non-ASCII bytes are the ones with their high bit set, so blocks of bytes can be ORed together and checked at once.
+#ifndef KERNEL
+    using SIMD::u8x16;
+    for (; offset + 2 * sizeof(u8x16) <= length; offset += 2 * sizeof(u8x16)) {
+        auto block = SIMD::load_unaligned<u8x16>(bytes + offset) | SIMD::load_unaligned<u8x16>(bytes + offset + sizeof(u8x16));
+        auto halves = bit_cast<SIMD::u64x2>(block);
+        if (((halves[0] | halves[1]) & 0x8080808080808080ull) != 0)
+            break;
+    }
+#endif
+
+    for (; offset + sizeof(FlatPtr) <= length; offset += sizeof(FlatPtr)) {
+        FlatPtr word;
+        __builtin_memcpy(&word, bytes + offset, sizeof(word));
+        if ((word & explode_byte(0x80)) != 0)
+            break;
+    }
+
+    while (offset < length && bytes[offset] < 0x80)
+        ++offset;
+    return offset;
+}
+
 Utf8CodePointIterator Utf8View::iterator_at_byte_offset(size_t byte_offset) const
 {
     size_t current_offset = 0;
@@ -75,6 +108,14 @@ size_t Utf8View::calculate_length() const
     size_t length = 0;
 
     for (size_t i = 0; i < m_string.length(); ++length) {
+        if (static_cast<u8>(m_string[i]) < 0x80) {
+            // OPTIMIZATION: A run of ASCII has one code point per byte, so it can be counted all at once.
+            auto ascii_length = Detail::ascii_prefix_length(begin_ptr() + i, m_string.length() - i);
+            i += ascii_length;
+            length += ascii_length - 1;
+            continue;
+        }
+
         auto [byte_length, code_point, is_valid] = decode_leading_byte(static_cast<u8>(m_string[i]));
 
         // Similar to Utf8CodePointIterator::operator++, if the byte is invalid, try the next byte.
@@ -18,6 +18,13 @@
 
 namespace AK {
 
+namespace Detail {
+
+// Returns how many of the given bytes there are before the first one that isn't ASCII, looking at many at a time.
+size_t ascii_prefix_length(u8 const* bytes, size_t length);
+
+}
+
 class Utf8View;
 
 class Utf8CodePointIterator {
@@ -138,6 +145,14 @@ public:
         valid_bytes = 0;
 
         for (auto it = m_string.begin(); it != m_string.end(); ++it) {
+            if (!is_constant_evaluated() && static_cast<u8>(*it) < 0x80) {
+                // OPTIMIZATION: ASCII is always valid, so a run of it can be skipped all at once.
+                auto ascii_length = Detail::ascii_prefix_length(begin_ptr() + it.index(), m_string.length() - it.index());
+                valid_bytes += ascii_length;
+                it = it + (ascii_length - 1);
+                continue;
+            }
+
             auto [byte_length, code_point, is_valid] = decode_leading_byte(static_cast<u8>(*it));
             if (!is_valid)
                 return false;
@@ -129,6 +129,14 @@ ErrorOr<NonnullRefPtr<WebView::WebContentClient>> launch_web_content_process(
         arguments.append("--enable-http-cache"sv);
     if (web_content_options.expose_internals_object == Ladybird::ExposeInternalsObject::Yes)
         arguments.append("--expose-internals-object"sv);
+    if (web_content_options.js_profile_path.has_value()) {
+        arguments.append("--js-profile"sv);
+        arguments.append(web_content_options.js_profile_path->to_byte_string());
+        arguments.append("--js-profile-interval"sv);
+        arguments.append(ByteString::number(web_content_options.js_profile_interval_in_microseconds));
+    }
+    if (web_content_options.count_js_instructions == Ladybird::CountJSInstructions::Yes)
+        arguments.append("--js-count-instructions"sv);
     if (auto server = mach_server_name(); server.has_value()) {
         arguments.append("--mach-server-name"sv);
         arguments.append(server.value());
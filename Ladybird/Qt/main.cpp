@@ -100,6 +100,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool log_all_js_exceptions = false;
     bool enable_idl_tracing = false;
     bool enable_http_cache = false;
+    StringView js_profile_path;
+    u32 js_profile_interval_in_microseconds = 1000;
+    bool count_js_instructions = false;
     bool new_window = false;
     bool force_new_process = false;
     bool allow_popups = false;
@@ -118,6 +121,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(enable_idl_tracing, "Enable IDL tracing", "enable-idl-tracing");
     args_parser.add_option(enable_http_cache, "Enable HTTP cache", "enable-http-cache");
     args_parser.add_option(expose_internals_object, "Expose internals object", "expose-internals-object");
+    args_parser.add_option(js_profile_path, "Sample JavaScript call stacks and write them to <path>.<pid> for each WebContent process", "js-profile", 0, "path");
+    args_parser.add_option(js_profile_interval_in_microseconds, "Interval between JavaScript profiler samples", "js-profile-interval", 0, "microseconds");
+    args_parser.add_option(count_js_instructions, "Count the bytecode instructions executed by each WebContent process", "js-count-instructions");
     args_parser.add_option(new_window, "Force opening in a new window", "new-window", 'n');
     args_parser.add_option(force_new_process, "Force creation of new browser/chrome process", "force-new-process");
     args_parser.add_option(allow_popups, "Disable popup blocking by default", "allow-popups");
@@ -184,6 +190,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         .enable_idl_tracing = enable_idl_tracing ? Ladybird::EnableIDLTracing::Yes : Ladybird::EnableIDLTracing::No,
         .enable_http_cache = enable_http_cache ? Ladybird::EnableHTTPCache::Yes : Ladybird::EnableHTTPCache::No,
         .expose_internals_object = expose_internals_object ? Ladybird::ExposeInternalsObject::Yes : Ladybird::ExposeInternalsObject::No,
+        .js_profile_path = js_profile_path.is_empty() ? Optional<String> {} : MUST(String::from_utf8(js_profile_path)),
+        .js_profile_interval_in_microseconds = js_profile_interval_in_microseconds,
+        .count_js_instructions = count_js_instructions ? Ladybird::CountJSInstructions::Yes : Ladybird::CountJSInstructions::No,
     };
 
     chrome_process.on_new_window = [&](auto const& urls) {
@@ -55,6 +55,11 @@ enum class ExposeInternalsObject {
     Yes
 };
 
+enum class CountJSInstructions {
+    No,
+    Yes
+};
+
 struct WebContentOptions {
     String command_line;
     String executable_path;
@@ -67,6 +72,9 @@ struct WebContentOptions {
     EnableIDLTracing enable_idl_tracing { EnableIDLTracing::No };
     EnableHTTPCache enable_http_cache { EnableHTTPCache::No };
     ExposeInternalsObject expose_internals_object { ExposeInternalsObject::No };
+    Optional<String> js_profile_path;
+    u32 js_profile_interval_in_microseconds { 1000 };
+    CountJSInstructions count_js_instructions { CountJSInstructions::No };
 };
 
 }
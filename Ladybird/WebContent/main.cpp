@@ -11,6 +11,7 @@
 #include <LibAudio/Loader.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/EventLoop.h>
+#include <LibCore/File.h>
 #include <LibCore/LocalServer.h>
 #include <LibCore/Process.h>
 #include <LibCore/Resource.h>
@@ -88,6 +89,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool log_all_js_exceptions = false;
     bool enable_idl_tracing = false;
     bool enable_http_cache = false;
+    StringView js_profile_path {};
+    u32 js_profile_interval_in_microseconds = 1000;
+    bool count_js_instructions = false;
 
     Core::ArgsParser args_parser;
     args_parser.add_option(command_line, "Chrome process command line", "command-line", 0, "command_line");
@@ -102,6 +106,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(log_all_js_exceptions, "Log all JavaScript exceptions", "log-all-js-exceptions");
     args_parser.add_option(enable_idl_tracing, "Enable IDL tracing", "enable-idl-tracing");
     args_parser.add_option(enable_http_cache, "Enable HTTP cache", "enable-http-cache");
+    args_parser.add_option(js_profile_path, "Sample JavaScript call stacks and write them to <path>.<pid>", "js-profile", 0, "path");
+    args_parser.add_option(js_profile_interval_in_microseconds, "Interval between JavaScript profiler samples", "js-profile-interval", 0, "microseconds");
+    args_parser.add_option(count_js_instructions, "Count the bytecode instructions executed", "js-count-instructions");
 
     args_parser.parse(arguments);
 
@@ -149,6 +156,18 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         Web::WebIDL::g_enable_idl_tracing = true;
     }
 
+    auto& vm = Web::Bindings::main_thread_vm();
+    if (!js_profile_path.is_empty() || count_js_instructions) {
+        if (js_profile_interval_in_microseconds == 0)
+            return Error::from_string_literal("The JS profiler interval must not be zero");
+
+        JS::Bytecode::Profiler::Options profiler_options {
+            .sampling_interval = Duration::from_microseconds(js_profile_interval_in_microseconds),
+            .count_instructions = count_js_instructions,
+        };
+        vm.bytecode_interpreter().set_profiler(make<JS::Bytecode::Profiler>(vm, profiler_options));
+    }
+
     auto maybe_content_filter_error = load_content_filters();
     if (maybe_content_filter_error.is_error())
         dbgln("Failed to load content filters: {}", maybe_content_filter_error.error());
@@ -160,7 +179,21 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     auto webcontent_socket = TRY(Core::take_over_socket_from_system_server("WebContent"sv));
     auto webcontent_client = TRY(WebContent::ConnectionFromClient::try_create(move(webcontent_socket)));
 
-    return event_loop.exec();
+    auto exit_code = event_loop.exec();
+
+    if (auto* profiler = vm.bytecode_interpreter().profiler()) {
+        // Every tab gets a WebContent process of its own, so each of them writes its own profile.
+        if (!js_profile_path.is_empty()) {
+            auto profile_file = TRY(Core::File::open(ByteString::formatted("{}.{}", js_profile_path, getpid()), Core::File::OpenMode::Write));
+            TRY(profiler->write_folded_stacks(*profile_file));
+        }
+        if (count_js_instructions) {
+            auto standard_error = TRY(Core::File::standard_error());
+            TRY(profiler->write_instruction_counts(*standard_error));
+        }
+    }
+
+    return exit_code;
 }
 
 static ErrorOr<void> load_content_filters()
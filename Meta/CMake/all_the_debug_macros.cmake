@@ -225,6 +225,7 @@ set(WAITQUEUE_DEBUG ON)
 set(WASI_DEBUG ON)
 set(WASI_FINE_GRAINED_DEBUG ON)
 set(WASM_BINPARSER_DEBUG ON)
+set(WASM_JIT_DEBUG ON)
 set(WASM_TRACE_DEBUG ON)
 set(WASM_VALIDATOR_DEBUG ON)
 set(WEBDRIVER_DEBUG ON)
@@ -312,3 +312,59 @@ TEST_CASE(roman_numerals)
     auto four_thousand = ByteString::roman_number_from(4000);
     EXPECT_EQ(four_thousand, "4000");
 }
+
+static constexpr int fly_string_benchmark_key_count = 100'000;
+static constexpr int fly_string_benchmark_rounds = 10;
+
+static Vector<ByteString> fly_string_benchmark_keys()
+{
+    Vector<ByteString> keys;
+    keys.ensure_capacity(fly_string_benchmark_key_count);
+    for (int i = 0; i < fly_string_benchmark_key_count; ++i)
+        keys.unchecked_append(ByteString::formatted("identifier_{}", i));
+    return keys;
+}
+
+BENCHMARK_CASE(fly_string_intern_new_strings)
+{
+    auto keys = fly_string_benchmark_keys();
+    for (int round = 0; round < fly_string_benchmark_rounds; ++round) {
+        Vector<DeprecatedFlyString> interned;
+        interned.ensure_capacity(keys.size());
+        for (auto& key : keys)
+            interned.unchecked_append(key.view());
+        EXPECT_EQ(interned.size(), keys.size());
+    }
+}
+
+BENCHMARK_CASE(fly_string_intern_existing_strings)
+{
+    auto keys = fly_string_benchmark_keys();
+    Vector<DeprecatedFlyString> interned;
+    for (auto& key : keys)
+        interned.append(key.view());
+
+    size_t found = 0;
+    for (int round = 0; round < fly_string_benchmark_rounds; ++round) {
+        for (size_t i = 0; i < keys.size(); ++i)
+            found += DeprecatedFlyString(keys[i].view()).impl() == interned[i].impl();
+    }
+    EXPECT_EQ(found, keys.size() * fly_string_benchmark_rounds);
+}
+
+BENCHMARK_CASE(fly_string_copy)
+{
+    auto keys = fly_string_benchmark_keys();
+    Vector<DeprecatedFlyString> interned;
+    for (auto& key : keys)
+        interned.append(key.view());
+
+    size_t length = 0;
+    for (int round = 0; round < fly_string_benchmark_rounds * 10; ++round) {
+        for (auto& fly_string : interned) {
+            DeprecatedFlyString copy = fly_string;
+            length += copy.length();
+        }
+    }
+    EXPECT(length > 0);
+}
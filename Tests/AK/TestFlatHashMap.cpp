@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/ByteString.h>
+#include <AK/FlatHashMap.h>
+#include <AK/FlatHashTable.h>
+#include <AK/HashMap.h>
+#include <AK/OwnPtr.h>
+#include <AK/String.h>
+
+TEST_CASE(construct)
+{
+    using IntIntMap = FlatHashMap<int, int>;
+    EXPECT(IntIntMap().is_empty());
+    EXPECT_EQ(IntIntMap().size(), 0u);
+    EXPECT_EQ(IntIntMap().capacity(), 0u);
+    EXPECT(IntIntMap().begin() == IntIntMap().end());
+}
+
+TEST_CASE(construct_from_initializer_list)
+{
+    FlatHashMap<int, ByteString> number_to_string {
+        { 1, "One" },
+        { 2, "Two" },
+        { 3, "Three" },
+    };
+    EXPECT_EQ(number_to_string.is_empty(), false);
+    EXPECT_EQ(number_to_string.size(), 3u);
+    EXPECT_EQ(number_to_string.get(2).value(), "Two");
+}
+
+TEST_CASE(set_get_and_replace)
+{
+    FlatHashMap<int, ByteString> number_to_string;
+    EXPECT_EQ(number_to_string.set(1, "One"), HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(number_to_string.set(2, "Two"), HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(number_to_string.set(2, "Deux"), HashSetResult::ReplacedExistingEntry);
+    EXPECT_EQ(number_to_string.size(), 2u);
+    EXPECT_EQ(number_to_string.get(2).value(), "Deux");
+    EXPECT(!number_to_string.get(3).has_value());
+
+    FlatHashTable<int> table;
+    EXPECT_EQ(table.set(1), HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(table.set(1, AK::HashSetExistingEntryBehavior::Keep), HashSetResult::KeptExistingEntry);
+}
+
+TEST_CASE(range_loop)
+{
+    FlatHashMap<ByteString, int> map;
+    map.set("One", 1);
+    map.set("Two", 2);
+    map.set("Three", 3);
+
+    int sum = 0;
+    size_t count = 0;
+    for (auto& [key, value] : map) {
+        EXPECT_EQ(map.get(key).value(), value);
+        sum += value;
+        ++count;
+    }
+    EXPECT_EQ(count, 3u);
+    EXPECT_EQ(sum, 6);
+}
+
+TEST_CASE(many_values)
+{
+    FlatHashMap<int, int> map;
+    for (int i = 0; i < 10'000; ++i)
+        EXPECT_EQ(map.set(i, i * 2), HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(map.size(), 10'000u);
+
+    for (int i = 0; i < 10'000; ++i)
+        EXPECT_EQ(map.get(i).value(), i * 2);
+    for (int i = 10'000; i < 20'000; ++i)
+        EXPECT(!map.contains(i));
+}
+
+TEST_CASE(many_strings)
+{
+    FlatHashTable<ByteString> strings;
+    for (int i = 0; i < 999; ++i)
+        EXPECT_EQ(strings.set(ByteString::number(i)), HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(strings.size(), 999u);
+    for (int i = 0; i < 999; ++i)
+        EXPECT(strings.contains(ByteString::number(i)));
+    for (int i = 0; i < 999; ++i)
+        EXPECT_EQ(strings.remove(ByteString::number(i)), true);
+    EXPECT_EQ(strings.is_empty(), true);
+}
+
+TEST_CASE(many_collisions)
+{
+    struct StrongCollision : public DefaultTraits<int> {
+        static unsigned hash(int) { return 0; }
+    };
+
+    FlatHashTable<int, StrongCollision> table;
+    for (int i = 0; i < 999; ++i)
+        EXPECT_EQ(table.set(i), HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(table.set(-1), HashSetResult::InsertedNewEntry);
+
+    for (int i = 0; i < 999; ++i)
+        EXPECT(table.contains(i));
+    EXPECT(table.contains(-1));
+
+    for (int i = 0; i < 999; i += 2)
+        EXPECT_EQ(table.remove(i), true);
+    for (int i = 0; i < 999; ++i)
+        EXPECT_EQ(table.contains(i), i % 2 == 1);
+    EXPECT(table.contains(-1));
+}
+
+TEST_CASE(remove_and_reinsert)
+{
+    FlatHashMap<int, int> map;
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 100; ++i)
+            map.set(round * 100 + i, i);
+        for (int i = 0; i < 100; ++i)
+            EXPECT(map.remove(round * 100 + i));
+        EXPECT(map.is_empty());
+    }
+
+    // Deleted slots get reused rather than the table growing forever.
+    EXPECT(map.capacity() <= 256u);
+}
+
+TEST_CASE(remove_all_matching)
+{
+    FlatHashMap<int, int> map;
+    for (int i = 0; i < 100; ++i)
+        map.set(i, i);
+
+    EXPECT_EQ(map.remove_all_matching([](int key, int) { return key % 3 == 0; }), true);
+    EXPECT_EQ(map.size(), 66u);
+    EXPECT_EQ(map.remove_all_matching([](int, int) { return false; }), false);
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(map.contains(i), i % 3 != 0);
+}
+
+TEST_CASE(iterator_removal)
+{
+    FlatHashMap<int, int> map;
+    map.set(0, 0);
+    map.set(1, 1);
+    auto it = map.find(0);
+    map.remove(it);
+    EXPECT_EQ(map.size(), 1u);
+    EXPECT_EQ(map.begin()->key, 1);
+}
+
+TEST_CASE(take_and_ensure)
+{
+    FlatHashMap<ByteString, int> map;
+    map.ensure("a") = 1;
+    EXPECT_EQ(map.ensure("a", [] { return 2; }), 1);
+    EXPECT_EQ(map.ensure("b", [] { return 2; }), 2);
+
+    EXPECT_EQ(map.take("a"), 1);
+    EXPECT(!map.take("a").has_value());
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST_CASE(non_trivial_values)
+{
+    FlatHashMap<int, NonnullOwnPtr<ByteString>> map;
+    for (int i = 0; i < 100; ++i)
+        map.set(i, make<ByteString>(ByteString::number(i)));
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(*map.get(i).value(), ByteString::number(i));
+
+    map.clear_with_capacity();
+    EXPECT(map.is_empty());
+    EXPECT(map.capacity() > 0u);
+}
+
+TEST_CASE(copy_and_move)
+{
+    FlatHashMap<int, ByteString> original;
+    for (int i = 0; i < 50; ++i)
+        original.set(i, ByteString::number(i));
+
+    auto copy = original;
+    EXPECT_EQ(copy.size(), 50u);
+    EXPECT_EQ(copy.get(42).value(), "42");
+
+    auto moved = move(original);
+    EXPECT_EQ(moved.size(), 50u);
+    EXPECT(original.is_empty());
+
+    auto cloned = MUST(moved.clone());
+    EXPECT_EQ(cloned.size(), 50u);
+    EXPECT_EQ(cloned.get(7).value(), "7");
+}
+
+TEST_CASE(hash_compatible_lookup)
+{
+    FlatHashMap<String, int> map;
+    map.set("Hello"_string, 1);
+    EXPECT(map.contains("Hello"sv));
+    EXPECT_EQ(map.get("Hello"sv), 1);
+    EXPECT(map.remove("Hello"sv));
+    EXPECT(map.is_empty());
+}
+
+TEST_CASE(ensure_capacity)
+{
+    FlatHashMap<int, int> map;
+    map.ensure_capacity(1000);
+    auto capacity = map.capacity();
+    for (int i = 0; i < 1000; ++i)
+        map.set(i, i);
+    EXPECT_EQ(map.capacity(), capacity);
+}
+
+static constexpr int benchmark_key_count = 100'000;
+static constexpr int benchmark_rounds = 10;
+
+template<typename Map>
+static void benchmark_insertion()
+{
+    for (int round = 0; round < benchmark_rounds; ++round) {
+        Map map;
+        for (int i = 0; i < benchmark_key_count; ++i)
+            map.set(i, i);
+        EXPECT_EQ(map.size(), static_cast<size_t>(benchmark_key_count));
+    }
+}
+
+template<typename Map>
+static void benchmark_lookup(bool keys_are_present)
+{
+    Map map;
+    for (int i = 0; i < benchmark_key_count; ++i)
+        map.set(i, i);
+
+    auto first_key = keys_are_present ? 0 : benchmark_key_count;
+    size_t found = 0;
+    for (int round = 0; round < benchmark_rounds; ++round) {
+        for (int i = first_key; i < first_key + benchmark_key_count; ++i)
+            found += map.contains(i);
+    }
+    EXPECT_EQ(found, keys_are_present ? static_cast<size_t>(benchmark_key_count * benchmark_rounds) : 0u);
+}
+
+template<typename Map>
+static void benchmark_string_lookup()
+{
+    Map map;
+    Vector<ByteString> keys;
+    for (int i = 0; i < benchmark_key_count; ++i) {
+        keys.append(ByteString::formatted("key-{}", i));
+        map.set(keys.last(), i);
+    }
+
+    size_t found = 0;
+    for (int round = 0; round < benchmark_rounds; ++round) {
+        for (auto& key : keys)
+            found += map.contains(key);
+    }
+    EXPECT_EQ(found, static_cast<size_t>(benchmark_key_count * benchmark_rounds));
+}
+
+template<typename Map>
+static void benchmark_removal()
+{
+    for (int round = 0; round < benchmark_rounds; ++round) {
+        Map map;
+        for (int i = 0; i < benchmark_key_count; ++i)
+            map.set(i, i);
+        for (int i = 0; i < benchmark_key_count; ++i)
+            map.remove(i);
+        EXPECT(map.is_empty());
+    }
+}
+
+BENCHMARK_CASE(insertion_hash_map)
+{
+    benchmark_insertion<HashMap<int, int>>();
+}
+
+BENCHMARK_CASE(insertion_flat_hash_map)
+{
+    benchmark_insertion<FlatHashMap<int, int>>();
+}
+
+BENCHMARK_CASE(successful_lookup_hash_map)
+{
+    benchmark_lookup<HashMap<int, int>>(true);
+}
+
+BENCHMARK_CASE(successful_lookup_flat_hash_map)
+{
+    benchmark_lookup<FlatHashMap<int, int>>(true);
+}
+
+BENCHMARK_CASE(failed_lookup_hash_map)
+{
+    benchmark_lookup<HashMap<int, int>>(false);
+}
+
+BENCHMARK_CASE(failed_lookup_flat_hash_map)
+{
+    benchmark_lookup<FlatHashMap<int, int>>(false);
+}
+
+BENCHMARK_CASE(string_lookup_hash_map)
+{
+    benchmark_string_lookup<HashMap<ByteString, int>>();
+}
+
+BENCHMARK_CASE(string_lookup_flat_hash_map)
+{
+    benchmark_string_lookup<FlatHashMap<ByteString, int>>();
+}
+
+BENCHMARK_CASE(removal_hash_map)
+{
+    benchmark_removal<HashMap<int, int>>();
+}
+
+BENCHMARK_CASE(removal_flat_hash_map)
+{
+    benchmark_removal<FlatHashMap<int, int>>();
+}
@@ -7,6 +7,9 @@
 #include <LibTest/TestCase.h>
 
 #include <AK/ByteBuffer.h>
+#include <AK/String.h>
+#include <AK/StringBuilder.h>
+#include <AK/Utf16View.h>
 #include <AK/Utf8View.h>
 
 TEST_CASE(decode_ascii)
@@ -323,3 +326,115 @@ TEST_CASE(for_each_split_view)
     EXPECT_EQ(gather(SplitBehavior::KeepEmpty | SplitBehavior::KeepTrailingSeparator),
         Vector({ "."sv, "."sv, "."sv, "Well."sv, "."sv, "hello."sv, "friends!."sv, "."sv, "."sv, ""sv }));
 }
+
+TEST_CASE(long_ascii_runs)
+{
+    // Long enough that runs of ASCII are looked at a whole block at a time, with the interesting bytes at every position.
+    for (size_t position = 0; position < 80; ++position) {
+        StringBuilder builder;
+        builder.append_repeated('a', position);
+        builder.append("λ"sv);
+        builder.append_repeated('b', 80 - position);
+        auto valid = builder.to_byte_string();
+
+        size_t valid_bytes = 0;
+        Utf8View valid_view { valid.view() };
+        EXPECT(valid_view.validate(valid_bytes));
+        EXPECT_EQ(valid_bytes, 82u);
+        EXPECT_EQ(valid_view.length(), 81u);
+
+        auto utf16 = MUST(utf8_to_utf16(valid_view));
+        EXPECT_EQ(utf16.size(), 81u);
+        EXPECT_EQ(utf16[position], 0x3bbu);
+        EXPECT_EQ(utf16[0], position == 0 ? 0x3bbu : static_cast<u16>('a'));
+        EXPECT_EQ(utf16.last(), static_cast<u16>('b'));
+        EXPECT_EQ(utf16_code_unit_length_from_utf8(valid.view()), 81u);
+
+        auto invalid = ByteString::formatted("{}\xff{}", ByteString::repeated('a', position), ByteString::repeated('b', 80 - position));
+        Utf8View invalid_view { invalid.view() };
+        EXPECT(!invalid_view.validate(valid_bytes));
+        EXPECT_EQ(valid_bytes, position);
+        EXPECT_EQ(invalid_view.length(), 81u);
+        EXPECT(String::from_utf8(invalid.view()).is_error());
+    }
+}
+
+static ByteString make_benchmark_text(StringView word)
+{
+    StringBuilder builder;
+    while (builder.length() < 1 * MiB) {
+        builder.append(word);
+        builder.append(' ');
+    }
+    return builder.to_byte_string();
+}
+
+static constexpr size_t benchmark_rounds = 100;
+
+static void benchmark_validate(StringView word)
+{
+    auto text = make_benchmark_text(word);
+    for (size_t i = 0; i < benchmark_rounds; ++i)
+        EXPECT(Utf8View { text.view() }.validate());
+}
+
+static void benchmark_length(StringView word)
+{
+    auto text = make_benchmark_text(word);
+    for (size_t i = 0; i < benchmark_rounds; ++i)
+        EXPECT(Utf8View { text.view() }.length() > 0);
+}
+
+static void benchmark_utf8_to_utf16(StringView word)
+{
+    auto text = make_benchmark_text(word);
+    for (size_t i = 0; i < benchmark_rounds / 10; ++i)
+        EXPECT(!MUST(utf8_to_utf16(text.view())).is_empty());
+}
+
+static void benchmark_string_from_utf8(StringView word)
+{
+    auto text = make_benchmark_text(word);
+    for (size_t i = 0; i < benchmark_rounds; ++i)
+        EXPECT(!String::from_utf8(text.view()).is_error());
+}
+
+BENCHMARK_CASE(validate_ascii)
+{
+    benchmark_validate("Lorem ipsum dolor sit amet"sv);
+}
+
+BENCHMARK_CASE(validate_mostly_ascii)
+{
+    benchmark_validate("Schöne Grüße aus Köln"sv);
+}
+
+BENCHMARK_CASE(validate_non_ascii)
+{
+    benchmark_validate("こんにちは世界"sv);
+}
+
+BENCHMARK_CASE(length_ascii)
+{
+    benchmark_length("Lorem ipsum dolor sit amet"sv);
+}
+
+BENCHMARK_CASE(length_non_ascii)
+{
+    benchmark_length("こんにちは世界"sv);
+}
+
+BENCHMARK_CASE(utf8_to_utf16_ascii)
+{
+    benchmark_utf8_to_utf16("Lorem ipsum dolor sit amet"sv);
+}
+
+BENCHMARK_CASE(utf8_to_utf16_non_ascii)
+{
+    benchmark_utf8_to_utf16("こんにちは世界"sv);
+}
+
+BENCHMARK_CASE(string_from_utf8_ascii)
+{
+    benchmark_string_from_utf8("Lorem ipsum dolor sit amet"sv);
+}
@@ -106,3 +106,87 @@ ViewportPaintable (Viewport<#document>) [0,0 800x600]
  
 )"sv);
 }
+
+TEST_CASE(test_generate_diff_of_large_texts)
+{
+    StringBuilder old_builder;
+    StringBuilder new_builder;
+    for (size_t i = 0; i < 50'000; ++i) {
+        old_builder.appendff("line {}\n", i);
+        if (i == 25'000)
+            new_builder.append("changed line\n"sv);
+        else
+            new_builder.appendff("line {}\n", i);
+    }
+
+    auto old_text = old_builder.to_byte_string();
+    auto new_text = new_builder.to_byte_string();
+
+    for (auto algorithm : { Diff::Algorithm::Myers, Diff::Algorithm::Patience }) {
+        auto result = MUST(Diff::from_text(old_text, new_text, 0, algorithm));
+        EXPECT_EQ(result.size(), 1u);
+        EXPECT_EQ(result[0].location.old_range.start_line, 25'001u);
+        EXPECT_EQ(result[0].lines.size(), 2u);
+        EXPECT_EQ(result[0].lines[0].operation, Diff::Line::Operation::Removal);
+        EXPECT_EQ(result[0].lines[0].content, "line 25000"sv);
+        EXPECT_EQ(result[0].lines[1].operation, Diff::Line::Operation::Addition);
+        EXPECT_EQ(result[0].lines[1].content, "changed line"sv);
+    }
+}
+
+TEST_CASE(test_generate_patience_diff)
+{
+    StringView old_text = R"(int add(int a, int b)
+{
+    return a + b;
+}
+
+int sub(int a, int b)
+{
+    return a - b;
+}
+)"sv;
+
+    StringView new_text = R"(int sub(int a, int b)
+{
+    return a - b;
+}
+
+int add(int a, int b)
+{
+    return a + b;
+}
+)"sv;
+
+    // The shortest diff matches up the braces and the blank line of both functions, changing every other line.
+    auto result = MUST(Diff::from_text(old_text, new_text, 0, Diff::Algorithm::Myers));
+    EXPECT_EQ(result.size(), 4u);
+
+    // A patience diff only matches up lines which are unique to either text, and so moves a whole function.
+    result = MUST(Diff::from_text(old_text, new_text, 0, Diff::Algorithm::Patience));
+    EXPECT_EQ(result.size(), 2u);
+
+    auto hunk1_stream = make<AllocatingMemoryStream>();
+    MUST(Diff::write_unified(result[0], *hunk1_stream));
+
+    auto hunk1 = MUST(hunk1_stream->read_until_eof());
+    EXPECT_EQ(StringView { hunk1 }, R"(@@ -1,5 +0,0 @@
+-int add(int a, int b)
+-{
+-    return a + b;
+-}
+-
+)"sv);
+
+    auto hunk2_stream = make<AllocatingMemoryStream>();
+    MUST(Diff::write_unified(result[1], *hunk2_stream));
+
+    auto hunk2 = MUST(hunk2_stream->read_until_eof());
+    EXPECT_EQ(StringView { hunk2 }, R"(@@ -8,0 +4,5 @@
++}
++
++int add(int a, int b)
++{
++    return a + b;
+)"sv);
+}
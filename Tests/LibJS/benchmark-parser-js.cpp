@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringBuilder.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Lexer.h>
+#include <LibJS/Parser.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+constexpr size_t module_count = 5'000;
+constexpr size_t called_module_stride = 50;
+
+// Looks like the output of a bundler: lots of module functions, of which a page load only ends up calling a few.
+static ByteString make_bundle()
+{
+    StringBuilder builder;
+    builder.append("var modules = [];\n"sv);
+    for (size_t i = 0; i < module_count; ++i) {
+        builder.appendff(R"~~~(modules.push(function (exports) {{
+    var scale = {};
+    function describe(value) {{
+        var pattern = /[a-z]+\d*/g;
+        var parts = `${{value}}-${{ {{ id: scale }}.id }}`.match(pattern);
+        return parts ? parts.length : 0;
+    }}
+    function compute(values) {{
+        var total = 0;
+        for (var j = 0; j < values.length; ++j)
+            total += values[j] * scale / 2;
+        return total + describe("item" + total);
+    }}
+    exports.compute = compute;
+}});
+)~~~",
+            i);
+    }
+    builder.appendff(R"~~~(
+var result = 0;
+for (var i = 0; i < modules.length; i += {}) {{
+    var exports = {{}};
+    modules[i](exports);
+    result += exports.compute([1, 2, 3]);
+}}
+result;
+)~~~",
+        called_module_stride);
+    return builder.to_byte_string();
+}
+
+auto bundle = make_bundle();
+
+static void parse_bundle(bool lazy_function_parsing_enabled)
+{
+    auto parser = JS::Parser(JS::Lexer(bundle, "bundle.js"sv));
+    parser.set_lazy_function_parsing_enabled(lazy_function_parsing_enabled);
+    auto program = parser.parse_program();
+    EXPECT(!parser.has_errors());
+}
+
+static JS::Value run_bundle(bool lazy_function_parsing_enabled)
+{
+    // Every run gets its own VM, as the VM would otherwise hand out the cached AST of the previous run.
+    auto vm = MUST(JS::VM::create());
+    vm->set_lazy_function_parsing_enabled(lazy_function_parsing_enabled);
+
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& realm = *root_execution_context->realm;
+
+    auto script_or_error = JS::Script::parse(bundle, realm, "bundle.js"sv);
+    EXPECT(!script_or_error.is_error());
+    if (script_or_error.is_error())
+        return JS::js_undefined();
+
+    auto result = vm->bytecode_interpreter().run(*script_or_error.value());
+    EXPECT(!result.is_error());
+    if (result.is_error())
+        return JS::js_undefined();
+    return result.release_value();
+}
+
+TEST_CASE(lazily_parsed_bundle_gives_same_result)
+{
+    auto eager_result = run_bundle(false);
+    auto lazy_result = run_bundle(true);
+    EXPECT(eager_result.is_number());
+    EXPECT(lazy_result.is_number());
+    EXPECT_EQ(eager_result.as_double(), lazy_result.as_double());
+}
+
+BENCHMARK_CASE(parse_bundle_eagerly)
+{
+    parse_bundle(false);
+}
+
+BENCHMARK_CASE(parse_bundle_lazily)
+{
+    parse_bundle(true);
+}
+
+BENCHMARK_CASE(run_bundle_eagerly)
+{
+    (void)run_bundle(false);
+}
+
+BENCHMARK_CASE(run_bundle_lazily)
+{
+    (void)run_bundle(true);
+}
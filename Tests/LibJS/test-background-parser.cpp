@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringBuilder.h>
+#include <LibCore/EventLoop.h>
+#include <LibJS/BackgroundParser.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Runtime/ValueInlines.h>
+#include <LibJS/Script.h>
+#include <LibJS/SourceTextModule.h>
+#include <LibTest/TestCase.h>
+#include <pthread.h>
+
+// Big enough that parsing it takes a while, so the VM can go away before the parser thread is done with it.
+static ByteString large_source()
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < 20'000; ++i)
+        builder.appendff("function f{}(a, b) {{ return a + b * {}; }}\n", i, i);
+    builder.append("f19999(1, 2);\n"sv);
+    return builder.to_byte_string();
+}
+
+TEST_CASE(parse_script_in_background_and_run_it)
+{
+    Core::EventLoop loop;
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& realm = *root_execution_context->realm;
+
+    auto main_thread = pthread_self();
+    bool did_complete = false;
+    Optional<JS::Value> result;
+
+    auto source = large_source();
+    vm->background_parser().parse(source, "large.js"sv, 1, JS::Program::Type::Script, [&](auto program_or_errors) {
+        did_complete = true;
+        EXPECT(pthread_equal(pthread_self(), main_thread));
+        if (program_or_errors.is_error()) {
+            FAIL("Unexpected parse error");
+            return;
+        }
+
+        // The program was parsed on the parser thread, but the script and its bytecode are created here.
+        auto script = JS::Script::create(realm, "large.js"sv, program_or_errors.release_value());
+        auto completion = vm->bytecode_interpreter().run(*script);
+        if (!completion.is_error())
+            result = completion.release_value();
+    });
+
+    // The completion callback is only ever invoked from the event loop.
+    EXPECT(!did_complete);
+    loop.spin_until([&] { return did_complete; });
+
+    EXPECT(result.has_value());
+    EXPECT_EQ(result->as_double(), 19999.0 * 2 + 1);
+}
+
+TEST_CASE(parse_module_in_background)
+{
+    Core::EventLoop loop;
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& realm = *root_execution_context->realm;
+
+    bool did_complete = false;
+    auto source = ByteString::formatted("{}export default 42;\n", large_source());
+    vm->background_parser().parse(source, "large.mjs"sv, 1, JS::Program::Type::Module, [&](auto program_or_errors) {
+        did_complete = true;
+        if (program_or_errors.is_error()) {
+            FAIL("Unexpected parse error");
+            return;
+        }
+        auto module = JS::SourceTextModule::create(realm, "large.mjs"sv, program_or_errors.release_value());
+        EXPECT_EQ(module->filename(), "large.mjs"sv);
+    });
+
+    loop.spin_until([&] { return did_complete; });
+}
+
+TEST_CASE(syntax_errors_are_reported_on_the_main_thread)
+{
+    Core::EventLoop loop;
+    auto vm = MUST(JS::VM::create());
+
+    auto main_thread = pthread_self();
+    bool did_complete = false;
+    auto source = ByteString::formatted("{}function (\n", large_source());
+    vm->background_parser().parse(source, "broken.js"sv, 1, JS::Program::Type::Script, [&](auto program_or_errors) {
+        did_complete = true;
+        EXPECT(pthread_equal(pthread_self(), main_thread));
+        EXPECT(program_or_errors.is_error());
+        if (program_or_errors.is_error()) {
+            EXPECT(!program_or_errors.error().is_empty());
+            auto const& position = program_or_errors.error().first().position;
+            EXPECT(position.has_value() && position->line > 20000u);
+        }
+    });
+
+    loop.spin_until([&] { return did_complete; });
+
+    // Programs that fail to parse aren't cached, so the error is reported again.
+    did_complete = false;
+    vm->background_parser().parse(source, "broken.js"sv, 1, JS::Program::Type::Script, [&](auto program_or_errors) {
+        did_complete = true;
+        EXPECT(program_or_errors.is_error());
+    });
+    loop.spin_until([&] { return did_complete; });
+}
+
+TEST_CASE(vm_torn_down_before_parsing_completes)
+{
+    Core::EventLoop loop;
+    bool did_complete = false;
+
+    {
+        auto vm = MUST(JS::VM::create());
+        auto source = large_source();
+        vm->background_parser().parse(source, "large.js"sv, 1, JS::Program::Type::Script, [&](auto) {
+            did_complete = true;
+        });
+        // Dropping the VM takes the background parser with it, which waits for its thread to finish the job.
+    }
+
+    // The parser thread has handed its result to the event loop by now, but there's no one left to take it.
+    for (size_t i = 0; i < 10; ++i)
+        loop.pump(Core::EventLoop::WaitMode::PollForEvents);
+    EXPECT(!did_complete);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/MemoryStream.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Bytecode/Profiler.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Runtime/ValueInlines.h>
+#include <LibJS/Script.h>
+#include <LibTest/TestCase.h>
+
+static constexpr u64 iteration_count = 2'000'000;
+
+static constexpr auto source = R"~~~(
+function spin(n) {
+    let x = 0;
+    for (let i = 0; i < n; ++i)
+        x = x ^ i;
+    return x;
+}
+spin(2000000);
+)~~~"sv;
+
+static ByteString read_all(AllocatingMemoryStream& stream)
+{
+    auto buffer = MUST(stream.read_until_eof());
+    return ByteString { buffer.bytes() };
+}
+
+static JS::Bytecode::Profiler& run_with_profiler(JS::VM& vm, JS::Realm& realm, JS::Bytecode::Profiler::Options options)
+{
+    vm.bytecode_interpreter().set_profiler(make<JS::Bytecode::Profiler>(vm, options));
+
+    auto script = MUST(JS::Script::parse(source, realm, "profile.js"sv));
+    auto result = vm.bytecode_interpreter().run(*script);
+    EXPECT(!result.is_error());
+    return *vm.bytecode_interpreter().profiler();
+}
+
+TEST_CASE(folded_stacks)
+{
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& profiler = run_with_profiler(*vm, *root_execution_context->realm, { .sampling_interval = Duration::from_microseconds(50), .count_instructions = false });
+
+    EXPECT(profiler.sample_count() > 0u);
+
+    AllocatingMemoryStream stream;
+    MUST(profiler.write_folded_stacks(stream));
+    auto output = read_all(stream);
+
+    // Every line is a stack of frames from the outermost inwards, followed by its number of samples.
+    u64 total_sample_count = 0;
+    bool saw_spin = false;
+    for (auto line : output.split_view('\n')) {
+        auto separator = line.find_last(' ');
+        EXPECT(separator.has_value());
+        if (!separator.has_value())
+            continue;
+
+        auto stack = line.substring_view(0, *separator);
+        auto count = line.substring_view(*separator + 1).to_number<u64>();
+        EXPECT(count.has_value());
+        total_sample_count += count.value_or(0);
+
+        EXPECT(stack.starts_with("(top level) (profile.js:"sv));
+        if (stack.contains(";spin (profile.js:2:"sv))
+            saw_spin = true;
+    }
+
+    EXPECT_EQ(total_sample_count, profiler.sample_count());
+    EXPECT(saw_spin);
+}
+
+TEST_CASE(instruction_counts)
+{
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& profiler = run_with_profiler(*vm, *root_execution_context->realm, { .sampling_interval = Duration::from_milliseconds(1), .count_instructions = true });
+
+    // The loop body is the only place with an XOR in it.
+    EXPECT_EQ(profiler.instruction_count(JS::Bytecode::Instruction::Type::BitwiseXor), iteration_count);
+    EXPECT(profiler.instruction_count(JS::Bytecode::Instruction::Type::Call) >= 1u);
+    EXPECT_EQ(profiler.instruction_count(JS::Bytecode::Instruction::Type::Yield), 0u);
+
+    AllocatingMemoryStream stream;
+    MUST(profiler.write_instruction_counts(stream));
+    auto output = read_all(stream);
+
+    bool saw_xor = false;
+    for (auto line : output.split_view('\n')) {
+        auto parts = line.split_view(' ');
+        if (parts.last() != "BitwiseXor"sv)
+            continue;
+        saw_xor = true;
+        EXPECT_EQ(parts.first().to_number<u64>().value_or(0), iteration_count);
+    }
+    EXPECT(saw_xor);
+    EXPECT(output.ends_with("total\n"sv));
+}
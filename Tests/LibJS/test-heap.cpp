@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/WeakPtr.h>
+#include <LibJS/Heap/Heap.h>
+#include <LibJS/Runtime/Accessor.h>
+#include <LibJS/Runtime/Array.h>
+#include <LibJS/Runtime/BigInt.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/NativeFunction.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Runtime/ValueInlines.h>
+#include <LibTest/TestCase.h>
+
+using CollectionType = JS::Heap::CollectionType;
+
+static constexpr size_t chain_count = 500;
+static constexpr size_t chain_length = 20;
+
+static size_t count_live_cells(JS::Heap& heap, StringView class_name)
+{
+    size_t count = 0;
+    heap.for_each_live_cell([&](JS::Cell* cell) {
+        if (cell->class_name() == class_name)
+            ++count;
+    });
+    return count;
+}
+
+// Every element of the array starts a chain of objects linked through their "next" property. Each object also has a
+// BigInt and an accessor, which are swept lazily.
+static JS::NonnullGCPtr<JS::Array> create_chains(JS::Realm& realm, Vector<WeakPtr<JS::Cell>>& objects)
+{
+    auto& vm = realm.vm();
+    auto array = MUST(JS::Array::create(realm, 0));
+    for (size_t i = 0; i < chain_count; ++i) {
+        JS::GCPtr<JS::Object> next;
+        for (size_t j = chain_length; j > 0; --j) {
+            auto object = JS::Object::create(realm, nullptr);
+            object->define_direct_property("next"_fly_string, next ? JS::Value(next.ptr()) : JS::js_null(), JS::default_attributes);
+            object->define_direct_property("index"_fly_string, JS::BigInt::create(vm, Crypto::SignedBigInteger(static_cast<i32>(i * chain_length + j))), JS::default_attributes);
+            object->define_direct_accessor("accessor"_fly_string, realm.intrinsics().throw_type_error_function(), nullptr, JS::default_attributes);
+            objects.append(object->make_weak_ptr<JS::Cell>());
+            next = object;
+        }
+        MUST(array->create_data_property_or_throw(i, JS::Value(next.ptr())));
+    }
+    return array;
+}
+
+static NEVER_INLINE void create_garbage(JS::Realm& realm)
+{
+    auto& vm = realm.vm();
+    for (size_t i = 0; i < chain_count * chain_length; ++i) {
+        auto object = JS::Object::create(realm, nullptr);
+        object->define_direct_property("garbage"_fly_string, JS::BigInt::create(vm, Crypto::SignedBigInteger(-1)), JS::default_attributes);
+        object->define_direct_accessor("accessor"_fly_string, nullptr, nullptr, JS::default_attributes);
+    }
+}
+
+static void expect_chains_are_intact(JS::Array& array, Vector<WeakPtr<JS::Cell>> const& objects)
+{
+    for (auto const& object : objects)
+        EXPECT(object);
+
+    for (size_t i = 0; i < chain_count; ++i) {
+        auto value = array.indexed_properties().get(i);
+        EXPECT(value.has_value());
+        auto* object = &value->value.as_object();
+        for (size_t j = 1; j <= chain_length; ++j) {
+            auto index = object->get_without_side_effects("index"_fly_string);
+            EXPECT(index.is_bigint());
+            EXPECT_EQ(index.as_bigint().big_integer(), Crypto::SignedBigInteger(static_cast<i32>(i * chain_length + j)));
+
+            auto accessor = MUST(object->internal_get_own_property("accessor"_fly_string));
+            EXPECT(accessor.has_value());
+            EXPECT(accessor->get.has_value() && *accessor->get);
+
+            auto next = object->get_without_side_effects("next"_fly_string);
+            if (j == chain_length) {
+                EXPECT(next.is_null());
+                break;
+            }
+            object = &next.as_object();
+        }
+    }
+}
+
+TEST_CASE(parallel_marking_keeps_reachable_cells_alive)
+{
+    for (size_t thread_count : { 1, 2, 4, 8 }) {
+        auto vm = MUST(JS::VM::create());
+        vm->heap().set_marking_thread_count(thread_count);
+        auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+        auto& realm = *root_execution_context->realm;
+
+        Vector<WeakPtr<JS::Cell>> objects;
+        auto array = JS::make_handle(create_chains(realm, objects));
+
+        // The garbage in between reuses the cells of everything that died, including the ones swept lazily.
+        for (size_t i = 0; i < 3; ++i) {
+            vm->heap().collect_garbage(CollectionType::CollectGarbage);
+            expect_chains_are_intact(*array, objects);
+            create_garbage(realm);
+        }
+    }
+}
+
+TEST_CASE(lazily_swept_blocks_are_swept_before_being_reused)
+{
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& realm = *root_execution_context->realm;
+    auto& heap = vm->heap();
+    auto& allocator = *JS::BigInt::cell_allocator.allocator;
+
+    auto big_ints_before = count_live_cells(heap, "BigInt"sv);
+    create_garbage(realm);
+
+    heap.collect_garbage(CollectionType::CollectGarbage);
+    EXPECT(allocator.sweeps_lazily());
+    EXPECT(allocator.has_unswept_blocks());
+
+    // Allocating sweeps as many blocks as it takes to find a free cell.
+    auto big_int = JS::make_handle(JS::BigInt::create(*vm, Crypto::SignedBigInteger(42)));
+    EXPECT_EQ(big_int->big_integer(), Crypto::SignedBigInteger(42));
+
+    // Looking at all live cells sweeps all of the blocks. Only a few dead BigInts may be kept alive by stale pointers
+    // on the stack.
+    auto big_ints_after = count_live_cells(heap, "BigInt"sv);
+    EXPECT(!allocator.has_unswept_blocks());
+    EXPECT(big_ints_after < big_ints_before + 100);
+}
+
+static NEVER_INLINE WeakPtr<JS::Cell> store_young_getter(JS::Realm& realm, JS::Accessor& accessor)
+{
+    auto getter = JS::NativeFunction::create(realm, "getter"sv, [](auto&) -> JS::ThrowCompletionOr<JS::Value> {
+        return JS::js_undefined();
+    });
+    accessor.set_getter(getter);
+    return getter->make_weak_ptr<JS::Cell>();
+}
+
+TEST_CASE(young_survivors_of_unswept_blocks_are_remembered)
+{
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& realm = *root_execution_context->realm;
+    auto& heap = vm->heap();
+    heap.set_generational_collection_enabled(true);
+
+    // The accessor survives this collection, but stays young until its block is swept.
+    auto accessor = JS::make_handle(JS::Accessor::create(*vm, nullptr, nullptr));
+    heap.collect_garbage(CollectionType::CollectGarbage);
+    EXPECT(!accessor->is_old());
+
+    // So the write barrier doesn't remember it here, and sweeping its block has to.
+    auto getter = store_young_getter(realm, *accessor);
+    EXPECT(!accessor->is_remembered());
+
+    heap.collect_garbage(CollectionType::CollectYoungGeneration);
+    EXPECT(accessor->is_old());
+    EXPECT(getter);
+    EXPECT_EQ(accessor->getter(), getter.ptr());
+
+    heap.set_generational_collection_enabled(false);
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringBuilder.h>
+#include <LibJS/ProgramCache.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibJS/SourceCode.h>
+#include <LibTest/TestCase.h>
+
+// Returns a script that is long enough to be cached, and different for every seed.
+static ByteString make_source(size_t seed, size_t length = JS::ProgramCache::min_source_length)
+{
+    StringBuilder builder;
+    builder.appendff("var seed = {};\n", seed);
+    while (builder.length() < length)
+        builder.append("seed = seed + 1;\n"sv);
+    return builder.to_byte_string();
+}
+
+static NonnullRefPtr<JS::Program> parse(JS::ProgramCache& cache, StringView source, StringView filename = "test.js"sv, size_t line_number_offset = 1)
+{
+    if (auto program = cache.get(source, filename, line_number_offset, JS::Program::Type::Script))
+        return program.release_nonnull();
+
+    auto program = MUST(JS::Script::parse_program(source, filename, line_number_offset));
+    cache.set(source, line_number_offset, program);
+    return program;
+}
+
+TEST_CASE(parsing_the_same_source_again_hits)
+{
+    auto vm = MUST(JS::VM::create());
+    auto root_execution_context = JS::create_simple_execution_context<JS::GlobalObject>(*vm);
+    auto& realm = *root_execution_context->realm;
+    auto& cache = vm->program_cache();
+    auto source = make_source(0);
+
+    auto first_script = MUST(JS::Script::parse(source, realm, "test.js"sv));
+    EXPECT_EQ(cache.miss_count(), 1u);
+    EXPECT_EQ(cache.hit_count(), 0u);
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_EQ(cache.total_source_length(), source.length());
+
+    // The source text is compared, not the string it is stored in.
+    ByteString copy_of_source { source.view() };
+    auto second_script = MUST(JS::Script::parse(copy_of_source, realm, "test.js"sv));
+    EXPECT_EQ(cache.miss_count(), 1u);
+    EXPECT_EQ(cache.hit_count(), 1u);
+    EXPECT_EQ(&first_script->parse_node(), &second_script->parse_node());
+    EXPECT_NE(first_script.ptr(), second_script.ptr());
+}
+
+TEST_CASE(parsing_different_sources_misses)
+{
+    JS::ProgramCache cache;
+    auto source = make_source(0);
+    auto program = parse(cache, source);
+    EXPECT_EQ(cache.miss_count(), 1u);
+
+    // Anything that ends up in the AST has to match, since the AST keeps it in its source ranges.
+    EXPECT_NE(parse(cache, make_source(1)).ptr(), program.ptr());
+    EXPECT_NE(parse(cache, source, "other.js"sv).ptr(), program.ptr());
+    EXPECT_NE(parse(cache, source, "test.js"sv, 2).ptr(), program.ptr());
+    EXPECT(!cache.get(source, "test.js"sv, 1, JS::Program::Type::Module));
+    EXPECT_EQ(cache.miss_count(), 5u);
+    EXPECT_EQ(cache.hit_count(), 0u);
+
+    EXPECT_EQ(parse(cache, source).ptr(), program.ptr());
+    EXPECT_EQ(cache.hit_count(), 1u);
+}
+
+TEST_CASE(short_sources_are_not_cached)
+{
+    JS::ProgramCache cache;
+    auto source = make_source(0, 0);
+    EXPECT(source.length() < JS::ProgramCache::min_source_length);
+
+    auto program = parse(cache, source);
+    EXPECT_NE(parse(cache, source).ptr(), program.ptr());
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.hit_count(), 0u);
+    EXPECT_EQ(cache.miss_count(), 0u);
+}
+
+TEST_CASE(least_recently_used_programs_are_evicted)
+{
+    JS::ProgramCache cache;
+    Vector<ByteString> sources;
+    for (size_t i = 0; i < 4; ++i)
+        sources.append(make_source(i));
+    cache.set_capacity(sources[0].length() + sources[1].length() + sources[2].length());
+
+    auto program_0 = parse(cache, sources[0]);
+    auto program_1 = parse(cache, sources[1]);
+    auto program_2 = parse(cache, sources[2]);
+    EXPECT_EQ(cache.size(), 3u);
+
+    // Using the first program makes the second one the least recently used, so that one has to make room.
+    EXPECT_EQ(parse(cache, sources[0]).ptr(), program_0.ptr());
+    parse(cache, sources[3]);
+    EXPECT_EQ(cache.size(), 3u);
+    EXPECT(cache.total_source_length() <= cache.capacity());
+
+    EXPECT_EQ(parse(cache, sources[0]).ptr(), program_0.ptr());
+    EXPECT_EQ(parse(cache, sources[2]).ptr(), program_2.ptr());
+    EXPECT(!cache.get(sources[1], "test.js"sv, 1, JS::Program::Type::Script));
+
+    // Sources that don't fit at all are never cached.
+    auto long_source = make_source(4, cache.capacity() + 1);
+    parse(cache, long_source);
+    EXPECT(!cache.get(long_source, "test.js"sv, 1, JS::Program::Type::Script));
+    EXPECT_EQ(cache.size(), 3u);
+}
+
+TEST_CASE(shrinking_the_capacity_evicts_programs)
+{
+    JS::ProgramCache cache;
+    auto program_0 = parse(cache, make_source(0));
+    auto program_1 = parse(cache, make_source(1));
+    EXPECT_EQ(cache.size(), 2u);
+
+    cache.set_capacity(make_source(1).length());
+    EXPECT_EQ(cache.size(), 1u);
+    EXPECT_EQ(parse(cache, make_source(1)).ptr(), program_1.ptr());
+
+    // A capacity of zero disables the cache.
+    cache.set_capacity(0);
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.total_source_length(), 0u);
+    EXPECT_NE(parse(cache, make_source(1)).ptr(), program_1.ptr());
+    EXPECT_EQ(cache.size(), 0u);
+}
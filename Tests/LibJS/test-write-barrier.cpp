@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/WeakPtr.h>
+#include <LibJS/Heap/Heap.h>
+#include <LibJS/Runtime/Accessor.h>
+#include <LibJS/Runtime/Array.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/NativeFunction.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Runtime/ValueInlines.h>
+#include <LibTest/TestCase.h>
+
+using CollectionType = JS::Heap::CollectionType;
+
+// Every test stores a pointer to a young cell in an old one, and checks that the write barrier put the old cell in the
+// remembered set. The young cell is only reachable through the old one, so it has to survive a collection of the young
+// generation, and be promoted by it.
+// NOTE: The young cells are created in helpers that aren't inlined, to keep pointers to them off the stack as far as we
+//       can. The stack is scanned conservatively, so a stale pointer could still keep one alive, but not make the old
+//       cell remembered.
+
+struct Fixture {
+    Fixture()
+        : vm(MUST(JS::VM::create()))
+        , root_execution_context(JS::create_simple_execution_context<JS::GlobalObject>(*vm))
+    {
+        heap().set_generational_collection_enabled(true);
+    }
+
+    ~Fixture()
+    {
+        heap().set_generational_collection_enabled(false);
+    }
+
+    JS::Heap& heap() { return vm->heap(); }
+    JS::Realm& realm() { return *root_execution_context->realm; }
+
+    // Makes the cell survive a full collection, which promotes it to the old generation.
+    template<typename T>
+    JS::Handle<T> make_old(JS::NonnullGCPtr<T> cell)
+    {
+        auto handle = JS::make_handle(cell);
+        heap().collect_garbage(CollectionType::CollectGarbage);
+        EXPECT(cell->is_old());
+        EXPECT(!cell->is_remembered());
+        return handle;
+    }
+
+    void collect_young_generation_and_expect_survival(JS::Cell const& old_cell, WeakPtr<JS::Cell> const& young_cell)
+    {
+        EXPECT(old_cell.is_remembered());
+        EXPECT(young_cell);
+        EXPECT(!young_cell->is_old());
+
+        heap().collect_garbage(CollectionType::CollectYoungGeneration);
+
+        EXPECT(young_cell);
+        EXPECT(young_cell->is_old());
+        EXPECT(!old_cell.is_remembered());
+    }
+
+    NonnullRefPtr<JS::VM> vm;
+    NonnullOwnPtr<JS::ExecutionContext> root_execution_context;
+};
+
+static NEVER_INLINE WeakPtr<JS::Cell> store_young_object_in_property(JS::Realm& realm, JS::Object& old_object)
+{
+    auto young_object = JS::Object::create(realm, nullptr);
+    old_object.define_direct_property("young"_fly_string, young_object, JS::default_attributes);
+    return young_object->make_weak_ptr<JS::Cell>();
+}
+
+TEST_CASE(young_object_in_property_of_old_object)
+{
+    Fixture fixture;
+    auto old_object = fixture.make_old(JS::Object::create(fixture.realm(), nullptr));
+
+    auto young_object = store_young_object_in_property(fixture.realm(), *old_object);
+    fixture.collect_young_generation_and_expect_survival(*old_object, young_object);
+
+    auto value = old_object->get_without_side_effects("young"_fly_string);
+    EXPECT(value.is_object());
+    EXPECT_EQ(&value.as_object(), young_object.ptr());
+}
+
+static NEVER_INLINE WeakPtr<JS::Cell> store_young_object_in_element(JS::Realm& realm, JS::Array& old_array)
+{
+    auto young_object = JS::Object::create(realm, nullptr);
+    MUST(old_array.create_data_property_or_throw(0, young_object));
+    return young_object->make_weak_ptr<JS::Cell>();
+}
+
+TEST_CASE(young_object_in_element_of_old_array)
+{
+    Fixture fixture;
+    auto old_array = fixture.make_old(MUST(JS::Array::create(fixture.realm(), 0)));
+
+    auto young_object = store_young_object_in_element(fixture.realm(), *old_array);
+    fixture.collect_young_generation_and_expect_survival(*old_array, young_object);
+
+    auto value = old_array->indexed_properties().get(0);
+    EXPECT(value.has_value());
+    EXPECT_EQ(&value->value.as_object(), young_object.ptr());
+}
+
+static NEVER_INLINE WeakPtr<JS::Cell> store_young_prototype(JS::Realm& realm, JS::Object& old_object)
+{
+    // This makes the object point to a new shape through a GCPtr, and only the shape points to the prototype.
+    auto young_prototype = JS::Object::create(realm, nullptr);
+    MUST(old_object.internal_set_prototype_of(young_prototype));
+    return young_prototype->make_weak_ptr<JS::Cell>();
+}
+
+TEST_CASE(young_prototype_of_old_object)
+{
+    Fixture fixture;
+    auto old_object = fixture.make_old(JS::Object::create(fixture.realm(), nullptr));
+
+    auto young_prototype = store_young_prototype(fixture.realm(), *old_object);
+    fixture.collect_young_generation_and_expect_survival(*old_object, young_prototype);
+
+    EXPECT_EQ(MUST(old_object->internal_get_prototype_of()), young_prototype.ptr());
+}
+
+static NEVER_INLINE WeakPtr<JS::Cell> store_young_getter(JS::Realm& realm, JS::Accessor& old_accessor)
+{
+    auto young_getter = JS::NativeFunction::create(realm, "getter"sv, [](auto&) -> JS::ThrowCompletionOr<JS::Value> {
+        return JS::js_undefined();
+    });
+    old_accessor.set_getter(young_getter);
+    return young_getter->make_weak_ptr<JS::Cell>();
+}
+
+TEST_CASE(young_function_in_gc_pointer_of_old_cell)
+{
+    Fixture fixture;
+    auto old_accessor = fixture.make_old(JS::Accessor::create(*fixture.vm, nullptr, nullptr));
+
+    auto young_getter = store_young_getter(fixture.realm(), *old_accessor);
+    fixture.collect_young_generation_and_expect_survival(*old_accessor, young_getter);
+
+    EXPECT_EQ(old_accessor->getter(), young_getter.ptr());
+}
@@ -6,12 +6,15 @@
 
 #include <LibTest/TestCase.h> // import first, to prevent warning of VERIFY* redefinition
 
+#include <AK/Array.h>
 #include <AK/Debug.h>
+#include <AK/DeprecatedFlyString.h>
 #include <AK/StringBuilder.h>
 #include <AK/Tuple.h>
 #include <LibRegex/Regex.h>
 #include <LibRegex/RegexDebug.h>
 #include <LibRegex/RegexMatcher.h>
+#include <pthread.h>
 #include <stdio.h>
 
 static ECMAScriptOptions match_test_api_options(ECMAScriptOptions const options)
@@ -1220,3 +1223,180 @@ TEST_CASE(mismatching_brackets)
         EXPECT_EQ(re.parser_result.error, regex::Error::MismatchingBracket);
     }
 }
+
+TEST_CASE(catastrophic_backtracking)
+{
+    // These take exponential time to backtrack through, so the matcher has to give up on backtracking and search
+    // without it instead.
+    auto lots_of_a_s = ByteString::repeated('a', 5'000);
+    auto lots_of_x_s = ByteString::repeated('x', 5'000);
+    {
+        Regex<ECMA262> re("(a|aa)*c"sv);
+        EXPECT_EQ(re.match(lots_of_a_s).success, false);
+    }
+    {
+        Regex<ECMA262> re("(?:a{1,2})*c"sv);
+        EXPECT_EQ(re.match(lots_of_a_s).success, false);
+    }
+    {
+        Regex<ECMA262> re("(a|aa)*c"sv);
+        auto result = re.match(ByteString::formatted("{}baac", lots_of_a_s));
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.matches.first().view.to_byte_string(), "aac"sv);
+        EXPECT_EQ(result.matches.first().column, 5'001u);
+        EXPECT_EQ(result.capture_group_matches.first()[0].view.to_byte_string(), "a"sv);
+    }
+    {
+        Regex<ECMA262> re("(x+x+)+y"sv, ECMAScriptFlags::Global);
+        auto result = re.match(ByteString::formatted("{}zxxyxxxy", lots_of_x_s));
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.count, 2u);
+        EXPECT_EQ(result.matches[0].view.to_byte_string(), "xxy"sv);
+        EXPECT_EQ(result.matches[1].view.to_byte_string(), "xxxy"sv);
+        EXPECT_EQ(result.capture_group_matches[0][0].view.to_byte_string(), "xx"sv);
+        EXPECT_EQ(result.capture_group_matches[1][0].view.to_byte_string(), "xxx"sv);
+    }
+}
+
+TEST_CASE(search_prefilter)
+{
+    {
+        Regex<ECMA262> re("ERROR .* timeout"sv, ECMAScriptFlags::Global);
+        EXPECT_EQ(re.parser_result.optimization_data.literal_prefix, "ERROR "sv);
+        auto result = re.match("INFO all good\nERROR: fine\nERROR connection timeout\n"sv);
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.count, 1u);
+        EXPECT_EQ(result.matches.first().view.to_byte_string(), "ERROR connection timeout"sv);
+        EXPECT_EQ(result.matches.first().column, 26u);
+    }
+    {
+        Regex<ECMA262> re("(foo)bar"sv, ECMAScriptFlags::Global);
+        auto result = re.match("foofoo foobar fobar foobar"sv);
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.count, 2u);
+        EXPECT_EQ(result.matches[0].column, 7u);
+        EXPECT_EQ(result.matches[1].column, 20u);
+        EXPECT_EQ(result.capture_group_matches[1][0].view.to_byte_string(), "foo"sv);
+    }
+    {
+        Regex<ECMA262> re("[b-d]x|yz"sv, ECMAScriptFlags::Global);
+        EXPECT_EQ(re.parser_result.optimization_data.starting_characters.size(), 4u);
+        auto result = re.match("aaaaaaaaaaaaaaaaaaaaaaabxaaaayzcdx"sv);
+        EXPECT_EQ(result.count, 3u);
+        EXPECT_EQ(result.matches[0].view.to_byte_string(), "bx"sv);
+        EXPECT_EQ(result.matches[1].view.to_byte_string(), "yz"sv);
+        EXPECT_EQ(result.matches[2].view.to_byte_string(), "dx"sv);
+    }
+    {
+        Regex<ECMA262> re("timeout"sv, ECMAScriptFlags::Global | ECMAScriptFlags::Insensitive);
+        auto result = re.match("a request TimeOut, another TIMEOUT"sv);
+        EXPECT_EQ(result.count, 2u);
+        EXPECT_EQ(result.matches[0].view.to_byte_string(), "TimeOut"sv);
+        EXPECT_EQ(result.matches[1].view.to_byte_string(), "TIMEOUT"sv);
+    }
+    {
+        // A match could start anywhere, so there's nothing to prefilter on.
+        Regex<ECMA262> re("x*y?"sv, ECMAScriptFlags::Global);
+        EXPECT(re.parser_result.optimization_data.starting_characters.is_empty());
+        Regex<ECMA262> lookahead_re("(?=a)\\w"sv, ECMAScriptFlags::Global);
+        EXPECT(lookahead_re.parser_result.optimization_data.starting_characters.is_empty());
+    }
+}
+
+BENCHMARK_CASE(search_prefilter_performance)
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < 100'000; ++i)
+        builder.appendff("INFO request {} served in {}ms\n", i, i % 100);
+    builder.append("ERROR request 100000 timeout\n"sv);
+    auto log = builder.to_byte_string();
+
+    Regex<ECMA262> re("ERROR .* timeout"sv, ECMAScriptFlags::Global);
+    auto result = re.match(log);
+    EXPECT_EQ(result.success, true);
+    EXPECT_EQ(result.count, 1u);
+}
+
+TEST_CASE(regex_cache)
+{
+    RegexCache<ECMA262> cache;
+    cache.set_capacity(2);
+
+    {
+        auto re = cache.compile("(?<year>\\d{4})-(?<month>\\d{2})"sv, ECMAScriptFlags::Global);
+        auto result = re.match("on 2024-07"sv);
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.capture_group_matches.first()[0].capture_group_name, "year");
+    }
+    {
+        auto re = cache.compile("(?<year>\\d{4})-(?<month>\\d{2})"sv, ECMAScriptFlags::Global);
+        EXPECT_EQ(cache.statistics().hits, 1u);
+        auto result = re.match("on 2024-07"sv);
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.capture_group_matches.first()[0].view.to_byte_string(), "2024"sv);
+        EXPECT_EQ(result.capture_group_matches.first()[0].capture_group_name, "year");
+    }
+
+    // The same pattern with different options is compiled separately.
+    auto insensitive_re = cache.compile("abc"sv, ECMAScriptFlags::Insensitive);
+    EXPECT_EQ(insensitive_re.match("ABC"sv).success, true);
+    EXPECT_EQ(cache.statistics().misses, 2u);
+
+    // Patterns that fail to compile aren't cached.
+    auto broken_re = cache.compile("(abc"sv);
+    EXPECT_NE(broken_re.parser_result.error, regex::Error::NoError);
+    broken_re = cache.compile("(abc"sv);
+    EXPECT_NE(broken_re.parser_result.error, regex::Error::NoError);
+    EXPECT_EQ(cache.statistics().entries, 2u);
+
+    // Regexes keep working after their pattern has been evicted.
+    auto re = cache.compile("(?<word>\\w+)"sv);
+    auto statistics = cache.statistics();
+    EXPECT_EQ(statistics.evictions, 1u);
+    EXPECT_EQ(statistics.entries, 2u);
+    cache.clear();
+    auto result = re.match("hello"sv);
+    EXPECT_EQ(result.success, true);
+    EXPECT_EQ(result.capture_group_matches.first()[0].capture_group_name, "word");
+}
+
+TEST_CASE(regex_cache_from_multiple_threads)
+{
+    static constexpr size_t thread_count = 8;
+    static constexpr size_t iteration_count = 500;
+
+    // The names of the capture groups are fly strings, which every thread gets from the cache.
+    DeprecatedFlyString::enable_sharing_between_threads();
+
+    // With room for only one pattern, entries get evicted while other threads still use Regexes copied from them.
+    RegexCache<ECMA262> cache;
+    cache.set_capacity(1);
+
+    Array<pthread_t, thread_count> threads {};
+    for (auto& thread : threads) {
+        auto result = pthread_create(
+            &thread, nullptr, [](void* param) -> void* {
+                auto& cache = *static_cast<RegexCache<ECMA262>*>(param);
+                for (size_t i = 0; i < iteration_count; ++i) {
+                    auto pattern = i % 2 ? "(?<year>\\d{4})-(?<month>\\d{2})"sv : "(?<year>\\d{4})/(?<month>\\d{2})"sv;
+                    auto subject = i % 2 ? "on 2024-07"sv : "on 2024/07"sv;
+                    auto re = cache.compile(pattern, ECMAScriptFlags::Global);
+                    auto result = re.match(subject);
+                    if (!result.success || result.capture_group_matches.first()[0].capture_group_name != "year"sv)
+                        return reinterpret_cast<void*>(1);
+                }
+                return nullptr;
+            },
+            &cache);
+        EXPECT_EQ(result, 0);
+    }
+
+    for (auto& thread : threads) {
+        void* thread_result = nullptr;
+        EXPECT_EQ(pthread_join(thread, &thread_result), 0);
+        EXPECT_EQ(thread_result, nullptr);
+    }
+
+    auto statistics = cache.statistics();
+    EXPECT_EQ(statistics.hits + statistics.misses, thread_count * iteration_count);
+}
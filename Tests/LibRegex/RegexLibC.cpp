@@ -6,8 +6,10 @@
 
 #include <LibTest/TestCase.h>
 
+#include <AK/Array.h>
 #include <AK/StringBuilder.h>
 #include <AK/Vector.h>
+#include <pthread.h>
 #include <regex.h>
 #include <stdio.h>
 
@@ -1157,3 +1159,38 @@ TEST_CASE(bre_basic)
     EXPECT_EQ(regexec(&regex, "17", 0, NULL, 0), REG_NOMATCH);
     regfree(&regex);
 }
+
+TEST_CASE(regcomp_from_multiple_threads)
+{
+    static constexpr size_t thread_count = 8;
+    static constexpr size_t iteration_count = 500;
+
+    Array<pthread_t, thread_count> threads {};
+    for (auto& thread : threads) {
+        auto result = pthread_create(
+            &thread, nullptr, [](void*) -> void* {
+                for (size_t i = 0; i < iteration_count; ++i) {
+                    // Every thread compiles the same few patterns, so most of them are shared through the cache.
+                    auto pattern = ByteString::formatted("^(ab|cd)+{}$", i % 4);
+                    auto subject = ByteString::formatted("abcdab{}", i % 4);
+
+                    regex_t regex;
+                    if (regcomp(&regex, pattern.characters(), REG_EXTENDED) != REG_NOERR)
+                        return reinterpret_cast<void*>(1);
+                    auto result = regexec(&regex, subject.characters(), 0, nullptr, 0);
+                    regfree(&regex);
+                    if (result != REG_NOERR)
+                        return reinterpret_cast<void*>(1);
+                }
+                return nullptr;
+            },
+            nullptr);
+        EXPECT_EQ(result, 0);
+    }
+
+    for (auto& thread : threads) {
+        void* thread_result = nullptr;
+        EXPECT_EQ(pthread_join(thread, &thread_result), 0);
+        EXPECT_EQ(thread_result, nullptr);
+    }
+}
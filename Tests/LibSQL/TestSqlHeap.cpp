@@ -6,19 +6,37 @@
 
 #include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
+#include <LibCore/File.h>
 #include <LibCore/System.h>
+#include <LibSQL/BlockCache.h>
 #include <LibSQL/Heap.h>
 #include <LibTest/TestCase.h>
 
 static constexpr auto db_path = "/tmp/test.db"sv;
 
-static NonnullRefPtr<SQL::Heap> create_heap()
+static constexpr auto crashed_db_path = "/tmp/test-crashed.db"sv;
+
+static NonnullRefPtr<SQL::Heap> create_heap(StringView path = db_path)
 {
-    auto heap = MUST(SQL::Heap::create(db_path));
+    auto heap = MUST(SQL::Heap::create(path));
     MUST(heap->open());
     return heap;
 }
 
+// Copies the heap file and its write-ahead log as they are on disk right now, as if the process had crashed.
+static void copy_heap_files_as_crashed()
+{
+    auto copy_file = [](ByteString const& from, ByteString const& to) {
+        auto source = MUST(Core::File::open(from, Core::File::OpenMode::Read));
+        auto contents = MUST(source->read_until_eof());
+        auto destination = MUST(Core::File::open(to, Core::File::OpenMode::Write | Core::File::OpenMode::Truncate));
+        MUST(destination->write_until_depleted(contents));
+    };
+
+    copy_file(db_path, crashed_db_path);
+    copy_file(ByteString::formatted("{}-wal", db_path), ByteString::formatted("{}-wal", crashed_db_path));
+}
+
 TEST_CASE(heap_write_large_storage_without_flush)
 {
     ScopeGuard guard([]() { MUST(Core::System::unlink(db_path)); });
@@ -192,3 +210,137 @@ TEST_CASE(heap_free_storage)
     auto new_heap_size = MUST(heap->file_size_in_bytes());
     EXPECT(new_heap_size <= heap_size);
 }
+
+TEST_CASE(heap_recover_committed_transactions_from_wal)
+{
+    ScopeGuard guard([]() {
+        MUST(Core::System::unlink(db_path));
+        MUST(Core::System::unlink(crashed_db_path));
+    });
+
+    StringBuilder builder;
+    MUST(builder.try_append_repeated('x', SQL::Block::DATA_SIZE * 4));
+    auto long_string = builder.string_view();
+
+    SQL::Block::Index storage_block_id = 0;
+    {
+        auto heap = create_heap();
+        storage_block_id = heap->request_new_block_index();
+        TRY_OR_FAIL(heap->write_storage(storage_block_id, long_string.bytes()));
+        MUST(heap->flush());
+
+        // Not committed, so this should not survive the crash.
+        TRY_OR_FAIL(heap->write_storage(heap->request_new_block_index(), long_string.bytes()));
+
+        copy_heap_files_as_crashed();
+    }
+
+    auto heap = create_heap(crashed_db_path);
+    EXPECT(heap->has_block(storage_block_id));
+    auto stored_long_string = TRY_OR_FAIL(heap->read_storage(storage_block_id));
+    EXPECT_EQ(long_string.bytes(), stored_long_string.bytes());
+    EXPECT_EQ(MUST(heap->file_size_in_bytes()), (storage_block_id + 4) * SQL::Block::SIZE);
+}
+
+TEST_CASE(heap_discard_torn_transaction_from_wal)
+{
+    ScopeGuard guard([]() {
+        MUST(Core::System::unlink(db_path));
+        MUST(Core::System::unlink(crashed_db_path));
+    });
+
+    StringBuilder builder;
+    MUST(builder.try_append_repeated('x', SQL::Block::DATA_SIZE));
+    auto first_string = builder.string_view();
+
+    SQL::Block::Index first_index = 0;
+    SQL::Block::Index second_index = 0;
+    {
+        auto heap = create_heap();
+        first_index = heap->request_new_block_index();
+        TRY_OR_FAIL(heap->write_storage(first_index, first_string.bytes()));
+        MUST(heap->flush());
+
+        second_index = heap->request_new_block_index();
+        TRY_OR_FAIL(heap->write_storage(second_index, "second"sv.bytes()));
+        MUST(heap->flush());
+
+        copy_heap_files_as_crashed();
+    }
+
+    // Flip the last byte of the log, which belongs to the commit frame of the second transaction.
+    {
+        auto log = MUST(Core::File::open(ByteString::formatted("{}-wal", crashed_db_path), Core::File::OpenMode::ReadWrite));
+        auto last_byte_offset = MUST(log->seek(-1, SeekMode::FromEndPosition));
+        auto last_byte = MUST(log->read_value<u8>());
+        MUST(log->seek(last_byte_offset, SeekMode::SetPosition));
+        MUST(log->write_value<u8>(last_byte ^ 0xff));
+    }
+
+    auto heap = create_heap(crashed_db_path);
+    EXPECT(heap->has_block(first_index));
+    EXPECT(!heap->has_block(second_index));
+    auto stored_first_string = TRY_OR_FAIL(heap->read_storage(first_index));
+    EXPECT_EQ(first_string.bytes(), stored_first_string.bytes());
+}
+
+TEST_CASE(heap_block_cache_serves_repeated_reads)
+{
+    ScopeGuard guard([]() { MUST(Core::System::unlink(db_path)); });
+    auto heap = create_heap();
+    auto storage_block_id = heap->request_new_block_index();
+
+    StringBuilder builder;
+    MUST(builder.try_append_repeated('x', SQL::Block::DATA_SIZE * 4));
+    auto long_string = builder.string_view();
+    TRY_OR_FAIL(heap->write_storage(storage_block_id, long_string.bytes()));
+    MUST(heap->flush());
+
+    // The first read caches the blocks; the second one is served entirely from the cache.
+    TRY_OR_FAIL(heap->read_storage(storage_block_id));
+    auto statistics = heap->block_cache_statistics();
+
+    auto stored_long_string = TRY_OR_FAIL(heap->read_storage(storage_block_id));
+    EXPECT_EQ(long_string.bytes(), stored_long_string.bytes());
+    EXPECT_EQ(heap->block_cache_statistics().hits, statistics.hits + 4);
+    EXPECT_EQ(heap->block_cache_statistics().misses, statistics.misses);
+
+    // Blocks updated in a commit must not be served from the cache in their old form.
+    builder.clear();
+    MUST(builder.try_append_repeated('y', SQL::Block::DATA_SIZE * 4));
+    auto other_string = builder.string_view();
+    TRY_OR_FAIL(heap->write_storage(storage_block_id, other_string.bytes()));
+    MUST(heap->flush());
+
+    auto stored_other_string = TRY_OR_FAIL(heap->read_storage(storage_block_id));
+    EXPECT_EQ(other_string.bytes(), stored_other_string.bytes());
+}
+
+TEST_CASE(heap_block_cache_reads_ahead_and_stays_within_capacity)
+{
+    ScopeGuard guard([]() { MUST(Core::System::unlink(db_path)); });
+
+    StringBuilder builder;
+    MUST(builder.try_append_repeated('x', SQL::Block::DATA_SIZE * 40));
+    auto long_string = builder.string_view();
+
+    SQL::Block::Index storage_block_id = 0;
+    {
+        auto heap = create_heap();
+        storage_block_id = heap->request_new_block_index();
+        TRY_OR_FAIL(heap->write_storage(storage_block_id, long_string.bytes()));
+    }
+
+    auto heap = MUST(SQL::Heap::create(db_path));
+    heap->set_block_cache_capacity(8);
+    MUST(heap->open());
+
+    auto stored_long_string = TRY_OR_FAIL(heap->read_storage(storage_block_id));
+    EXPECT_EQ(long_string.bytes(), stored_long_string.bytes());
+
+    auto statistics = heap->block_cache_statistics();
+    EXPECT_EQ(statistics.capacity, 8u);
+    EXPECT(statistics.cached_blocks <= 8u);
+    EXPECT(statistics.read_ahead_blocks > 0u);
+    EXPECT(statistics.evictions > 0u);
+}
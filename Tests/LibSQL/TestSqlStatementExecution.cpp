@@ -9,6 +9,8 @@
 
 #include <AK/QuickSort.h>
 #include <AK/ScopeGuard.h>
+#include <AK/TypeCasts.h>
+#include <LibSQL/AST/Operators.h>
 #include <LibSQL/AST/Parser.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Result.h>
@@ -384,6 +386,249 @@ TEST_CASE(select_inner_join)
     EXPECT_EQ(result[0].row[2].to_byte_string(), "Test_12");
 }
 
+TEST_CASE(select_with_key_lookup)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+    auto result = execute(database,
+        "INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES "
+        "( 'Test_1', 42 ), "
+        "( 'Test_2', 43 ), "
+        "( 'Test_3', 44 ), "
+        "( 'Test_4', 45 ), "
+        "( 'Test_5', 46 );");
+    EXPECT(result.size() == 5);
+
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 44;");
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0], "Test_3"sv);
+
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE 45 = IntColumn;");
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0], "Test_4"sv);
+
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = ? AND TextColumn = ?;", placeholders(42, "Test_1"sv));
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0], "Test_1"sv);
+
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = 42 AND TextColumn = 'Test_2';");
+    EXPECT(result.is_empty());
+
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn = NULL;");
+    EXPECT(result.is_empty());
+
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn BETWEEN 43 AND 45;");
+    EXPECT_EQ(result.size(), 3u);
+    for (auto& row : result) {
+        EXPECT(row.row[0] != "Test_1"sv);
+        EXPECT(row.row[0] != "Test_5"sv);
+    }
+
+    result = execute(database, "SELECT TextColumn FROM TestSchema.TestTable WHERE IntColumn NOT BETWEEN 43 AND 45;");
+    EXPECT_EQ(result.size(), 2u);
+}
+
+TEST_CASE(explain_select)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_two_tables(database);
+
+    auto result = execute(database, "EXPLAIN SELECT * FROM TestSchema.TestTable1;");
+    EXPECT_EQ(result.command(), SQL::SQLCommand::Explain);
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0], "SCAN TESTSCHEMA.TESTTABLE1"sv);
+
+    result = execute(database, "EXPLAIN SELECT * FROM TestSchema.TestTable1 WHERE IntColumn = 42 AND TextColumn1 LIKE 'T%';");
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0], "SEARCH TESTSCHEMA.TESTTABLE1 USING KEY (INTCOLUMN=?) FILTER (1 TERMS)"sv);
+
+    result = execute(database, "EXPLAIN SELECT * FROM TestSchema.TestTable1 WHERE IntColumn > 42 ORDER BY TextColumn1 LIMIT 2;");
+    EXPECT_EQ(result.size(), 3u);
+    EXPECT_EQ(result[0].row[0], "SCAN TESTSCHEMA.TESTTABLE1 RANGE (INTCOLUMN>?)"sv);
+    EXPECT_EQ(result[1].row[0], "SORT (1 TERMS)"sv);
+    EXPECT_EQ(result[2].row[0], "LIMIT"sv);
+
+    // The table with the key lookup is read first, and the join term is evaluated when the second table is joined.
+    result = execute(database,
+        "EXPLAIN QUERY PLAN SELECT * FROM TestSchema.TestTable1, TestSchema.TestTable2 "
+        "WHERE TestTable1.IntColumn = TestTable2.IntColumn AND TextColumn2 = 'Test_12';");
+    EXPECT_EQ(result.size(), 2u);
+    EXPECT_EQ(result[0].row[0], "SEARCH TESTSCHEMA.TESTTABLE2 USING KEY (TEXTCOLUMN2=?)"sv);
+    EXPECT_EQ(result[1].row[0], "HASH JOIN SCAN TESTSCHEMA.TESTTABLE1 ON (TESTTABLE2.INTCOLUMN=TESTTABLE1.INTCOLUMN)"sv);
+
+    // Terms which do not compare columns for equality are evaluated for every pair of rows.
+    result = execute(database,
+        "EXPLAIN SELECT * FROM TestSchema.TestTable1, TestSchema.TestTable2 "
+        "WHERE TestTable1.IntColumn < TestTable2.IntColumn;");
+    EXPECT_EQ(result.size(), 2u);
+    EXPECT_EQ(result[0].row[0], "SCAN TESTSCHEMA.TESTTABLE1"sv);
+    EXPECT_EQ(result[1].row[0], "NESTED LOOP JOIN SCAN TESTSCHEMA.TESTTABLE2 ON (1 TERMS)"sv);
+}
+
+TEST_CASE(select_join_with_pushed_down_terms)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_two_tables(database);
+    auto result = execute(database,
+        "INSERT INTO TestSchema.TestTable1 ( TextColumn1, IntColumn ) VALUES "
+        "( 'Test_1', 42 ), "
+        "( 'Test_2', 43 ), "
+        "( 'Test_3', 44 );");
+    EXPECT(result.size() == 3);
+    result = execute(database,
+        "INSERT INTO TestSchema.TestTable2 ( TextColumn2, IntColumn ) VALUES "
+        "( 'Test_10', 42 ), "
+        "( 'Test_11', 43 ), "
+        "( 'Test_12', 43 );");
+    EXPECT(result.size() == 3);
+
+    result = execute(database,
+        "SELECT TextColumn1, TextColumn2 FROM TestSchema.TestTable1, TestSchema.TestTable2 "
+        "WHERE TestTable1.IntColumn = TestTable2.IntColumn AND TextColumn2 = 'Test_12';");
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0], "Test_2"sv);
+    EXPECT_EQ(result[0].row[1], "Test_12"sv);
+
+    result = execute(database,
+        "SELECT TextColumn1, TextColumn2 FROM TestSchema.TestTable1, TestSchema.TestTable2 "
+        "WHERE TestTable1.IntColumn = TestTable2.IntColumn AND TestTable1.IntColumn > 42;");
+    EXPECT_EQ(result.size(), 2u);
+    for (auto& row : result)
+        EXPECT_EQ(row.row[0], "Test_2"sv);
+
+    // Ambiguous column names are not pushed down, and still fail when evaluated.
+    auto ambiguous_result = try_execute(database, "SELECT * FROM TestSchema.TestTable1, TestSchema.TestTable2 WHERE IntColumn = 42;");
+    EXPECT(ambiguous_result.is_error());
+    EXPECT_EQ(ambiguous_result.release_error().error(), SQL::SQLErrorCode::AmbiguousColumnName);
+}
+
+TEST_CASE(select_hash_join)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_two_tables(database);
+    auto result = execute(database,
+        "INSERT INTO TestSchema.TestTable1 ( TextColumn1, IntColumn ) VALUES "
+        "( 'Test_1', 42 ), "
+        "( 'Test_2', 43 ), "
+        "( 'Test_3', 43 ), "
+        "( 'Test_4', 44 );");
+    EXPECT(result.size() == 4);
+    result = execute(database,
+        "INSERT INTO TestSchema.TestTable2 ( TextColumn2, IntColumn ) VALUES "
+        "( 'Test_10', 43 ), "
+        "( 'Test_11', 44 ), "
+        "( 'Test_12', 45 );");
+    EXPECT(result.size() == 3);
+
+    // The smaller table is the one which is hashed.
+    result = execute(database,
+        "EXPLAIN SELECT * FROM TestSchema.TestTable1, TestSchema.TestTable2 "
+        "WHERE TestTable1.IntColumn = TestTable2.IntColumn AND TextColumn1 < TextColumn2;");
+    EXPECT_EQ(result.size(), 2u);
+    EXPECT_EQ(result[0].row[0], "SCAN TESTSCHEMA.TESTTABLE1"sv);
+    EXPECT_EQ(result[1].row[0], "HASH JOIN SCAN TESTSCHEMA.TESTTABLE2 ON (TESTTABLE1.INTCOLUMN=TESTTABLE2.INTCOLUMN) AND (1 TERMS)"sv);
+
+    result = execute(database,
+        "SELECT TextColumn1, TextColumn2 FROM TestSchema.TestTable1, TestSchema.TestTable2 "
+        "WHERE TestTable1.IntColumn = TestTable2.IntColumn ORDER BY TextColumn1;");
+    EXPECT_EQ(result.size(), 3u);
+    EXPECT_EQ(result[0].row[0], "Test_2"sv);
+    EXPECT_EQ(result[0].row[1], "Test_10"sv);
+    EXPECT_EQ(result[1].row[0], "Test_3"sv);
+    EXPECT_EQ(result[1].row[1], "Test_10"sv);
+    EXPECT_EQ(result[2].row[0], "Test_4"sv);
+    EXPECT_EQ(result[2].row[1], "Test_11"sv);
+
+    result = execute(database,
+        "SELECT TextColumn1, TextColumn2 FROM TestSchema.TestTable1, TestSchema.TestTable2 "
+        "WHERE TestTable1.IntColumn = TestTable2.IntColumn AND TextColumn1 <> 'Test_2';");
+    EXPECT_EQ(result.size(), 2u);
+    for (auto& row : result)
+        EXPECT(row.row[0] != "Test_2"sv);
+
+    // The row counts the planner works with follow the rows which are deleted.
+    result = execute(database, "DELETE FROM TestSchema.TestTable1 WHERE IntColumn = 43;");
+    EXPECT_EQ(result.size(), 2u);
+    EXPECT_EQ(MUST(database->row_count(*MUST(database->get_table("TESTSCHEMA", "TESTTABLE1")))), 2u);
+
+    result = execute(database,
+        "EXPLAIN SELECT * FROM TestSchema.TestTable1, TestSchema.TestTable2 "
+        "WHERE TestTable1.IntColumn = TestTable2.IntColumn;");
+    EXPECT_EQ(result.size(), 2u);
+    EXPECT_EQ(result[0].row[0], "SCAN TESTSCHEMA.TESTTABLE2"sv);
+    EXPECT_EQ(result[1].row[0], "HASH JOIN SCAN TESTSCHEMA.TESTTABLE1 ON (TESTTABLE2.INTCOLUMN=TESTTABLE1.INTCOLUMN)"sv);
+
+    result = execute(database,
+        "SELECT TextColumn1, TextColumn2 FROM TestSchema.TestTable1, TestSchema.TestTable2 "
+        "WHERE TestTable1.IntColumn = TestTable2.IntColumn;");
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row[0], "Test_4"sv);
+    EXPECT_EQ(result[0].row[1], "Test_11"sv);
+}
+
+TEST_CASE(select_merge_join)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_schema(database);
+    auto result = execute(database, "CREATE TABLE TestSchema.Prices ( Product text, Price float );");
+    EXPECT_EQ(result.command(), SQL::SQLCommand::Create);
+    result = execute(database, "CREATE TABLE TestSchema.Offers ( Shop text, Price float );");
+    EXPECT_EQ(result.command(), SQL::SQLCommand::Create);
+
+    result = execute(database,
+        "INSERT INTO TestSchema.Prices ( Product, Price ) VALUES "
+        "( 'Apple', 1.5 ), "
+        "( 'Pear', 2.25 ), "
+        "( 'Plum', 1.5 ), "
+        "( 'Fig', 4.0 );");
+    EXPECT(result.size() == 4);
+    result = execute(database,
+        "INSERT INTO TestSchema.Offers ( Shop, Price ) VALUES "
+        "( 'Corner', 1.5 ), "
+        "( 'Market', 2.25 ), "
+        "( 'Mall', 1.5 );");
+    EXPECT(result.size() == 3);
+
+    // Floating point values are compared with a tolerance, so they are joined by sorting rather than hashing.
+    result = execute(database,
+        "EXPLAIN SELECT * FROM TestSchema.Prices, TestSchema.Offers WHERE Prices.Price = Offers.Price;");
+    EXPECT_EQ(result.size(), 2u);
+    EXPECT_EQ(result[0].row[0], "SCAN TESTSCHEMA.PRICES"sv);
+    EXPECT_EQ(result[1].row[0], "MERGE JOIN SCAN TESTSCHEMA.OFFERS ON (PRICES.PRICE=OFFERS.PRICE)"sv);
+
+    result = execute(database,
+        "SELECT Product, Shop FROM TestSchema.Prices, TestSchema.Offers "
+        "WHERE Prices.Price = Offers.Price ORDER BY Product, Shop;");
+    EXPECT_EQ(result.size(), 5u);
+    EXPECT_EQ(result[0].row[0], "Apple"sv);
+    EXPECT_EQ(result[0].row[1], "Corner"sv);
+    EXPECT_EQ(result[1].row[0], "Apple"sv);
+    EXPECT_EQ(result[1].row[1], "Mall"sv);
+    EXPECT_EQ(result[2].row[0], "Pear"sv);
+    EXPECT_EQ(result[2].row[1], "Market"sv);
+    EXPECT_EQ(result[3].row[0], "Plum"sv);
+    EXPECT_EQ(result[3].row[1], "Corner"sv);
+    EXPECT_EQ(result[4].row[0], "Plum"sv);
+    EXPECT_EQ(result[4].row[1], "Mall"sv);
+
+    result = execute(database,
+        "SELECT Product, Shop FROM TestSchema.Prices, TestSchema.Offers "
+        "WHERE Prices.Price = Offers.Price AND Shop <> 'Mall';");
+    EXPECT_EQ(result.size(), 3u);
+    for (auto& row : result)
+        EXPECT(row.row[1] != "Mall"sv);
+}
+
 TEST_CASE(select_with_like)
 {
     ScopeGuard guard([]() { unlink(db_name); });
@@ -634,6 +879,70 @@ TEST_CASE(select_with_order_limit_and_offset)
     EXPECT_EQ(result[9].row[1].to_int<i32>(), 19);
 }
 
+TEST_CASE(select_with_order_spilled_to_disk)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+    for (auto count = 0; count < 200; count++) {
+        auto result = execute(database,
+            ByteString::formatted("INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES ( 'Test_{}', {} );", count, (count * 7) % 50));
+        EXPECT(result.size() == 1);
+    }
+
+    auto expected = execute(database, "SELECT TextColumn, IntColumn FROM TestSchema.TestTable ORDER BY IntColumn;");
+    EXPECT_EQ(expected.size(), 200u);
+
+    // Every row exceeds the budget, so every row is written to its own run, and there are too many runs to
+    // merge at once.
+    database->set_sort_memory_budget(1);
+
+    auto result = execute(database, "SELECT TextColumn, IntColumn FROM TestSchema.TestTable ORDER BY IntColumn;");
+    EXPECT_EQ(result.size(), 200u);
+    for (size_t i = 0; i < result.size(); ++i) {
+        EXPECT_EQ(result[i].row[0], expected[i].row[0]);
+        EXPECT_EQ(result[i].row[1], expected[i].row[1]);
+        if (i > 0)
+            EXPECT(result[i - 1].row[1].to_int<i32>().value() <= result[i].row[1].to_int<i32>().value());
+    }
+
+    result = execute(database, "SELECT TextColumn, IntColumn FROM TestSchema.TestTable ORDER BY IntColumn DESC, TextColumn LIMIT 10 OFFSET 5;");
+    EXPECT_EQ(result.size(), 10u);
+
+    database->set_sort_memory_budget(SQL::Database::DEFAULT_SORT_MEMORY_BUDGET);
+    expected = execute(database, "SELECT TextColumn, IntColumn FROM TestSchema.TestTable ORDER BY IntColumn DESC, TextColumn LIMIT 10 OFFSET 5;");
+    EXPECT_EQ(expected.size(), 10u);
+
+    for (size_t i = 0; i < result.size(); ++i)
+        EXPECT_EQ(result[i].row[0], expected[i].row[0]);
+}
+
+TEST_CASE(select_with_order_and_limit_keeps_first_rows)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+    for (auto count = 0; count < 100; count++) {
+        auto result = execute(database,
+            ByteString::formatted("INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES ( 'Test_{}', {} );", count, count % 10));
+        EXPECT(result.size() == 1);
+    }
+
+    auto all_rows = execute(database, "SELECT TextColumn, IntColumn FROM TestSchema.TestTable ORDER BY IntColumn;");
+    EXPECT_EQ(all_rows.size(), 100u);
+
+    // Rows with equal sort keys are produced in the same order, whether or not only the first rows are kept.
+    auto result = execute(database, "SELECT TextColumn, IntColumn FROM TestSchema.TestTable ORDER BY IntColumn LIMIT 15 OFFSET 3;");
+    EXPECT_EQ(result.size(), 15u);
+    for (size_t i = 0; i < result.size(); ++i)
+        EXPECT_EQ(result[i].row[0], all_rows[i + 3].row[0]);
+
+    result = execute(database, "SELECT TextColumn, IntColumn FROM TestSchema.TestTable ORDER BY IntColumn LIMIT 0;");
+    EXPECT(result.is_empty());
+}
+
 TEST_CASE(select_with_limit_out_of_bounds)
 {
     ScopeGuard guard([]() { unlink(db_name); });
@@ -664,6 +973,51 @@ TEST_CASE(select_with_offset_out_of_bounds)
     EXPECT_EQ(result.size(), 0u);
 }
 
+TEST_CASE(select_through_cursor)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = MUST(SQL::Database::create(db_name));
+    MUST(database->open());
+    create_table(database);
+    for (auto count = 0; count < 100; count++) {
+        auto result = execute(database,
+            ByteString::formatted("INSERT INTO TestSchema.TestTable ( TextColumn, IntColumn ) VALUES ( 'Test_{}', {} );", count, count));
+        EXPECT(result.size() == 1);
+    }
+
+    auto create_cursor = [&](StringView sql) {
+        auto parser = SQL::AST::Parser(SQL::AST::Lexer(sql));
+        auto statement = parser.next_statement();
+        EXPECT(!parser.has_errors());
+
+        auto cursor = SQL::AST::Cursor::create(database, verify_cast<SQL::AST::Select>(*statement), {});
+        EXPECT(!cursor.is_error());
+        return cursor.release_value();
+    };
+
+    auto cursor = create_cursor("SELECT TextColumn, IntColumn FROM TestSchema.TestTable WHERE IntColumn >= 10 ORDER BY IntColumn DESC LIMIT 5;"sv);
+    EXPECT_EQ(cursor->column_names().size(), 2u);
+    EXPECT_EQ(cursor->column_names()[0], "TEXTCOLUMN");
+    EXPECT_EQ(cursor->column_names()[1], "INTCOLUMN");
+
+    for (auto expected = 99; expected > 94; --expected) {
+        auto row = MUST(cursor->next());
+        EXPECT(row.has_value());
+        EXPECT_EQ((*row)[0].to_byte_string(), ByteString::formatted("Test_{}", expected));
+        EXPECT_EQ((*row)[1].to_int<i32>(), expected);
+    }
+    EXPECT(!MUST(cursor->next()).has_value());
+    EXPECT(!MUST(cursor->next()).has_value());
+
+    // A cursor only reads as many rows as are asked of it.
+    cursor = create_cursor("SELECT IntColumn FROM TestSchema.TestTable WHERE IntColumn > 41;"sv);
+    for (auto count = 0; count < 3; ++count) {
+        auto row = MUST(cursor->next());
+        EXPECT(row.has_value());
+        EXPECT((*row)[0].to_int<i32>().value() > 41);
+    }
+}
+
 TEST_CASE(describe_table)
 {
     ScopeGuard guard([]() { unlink(db_name); });
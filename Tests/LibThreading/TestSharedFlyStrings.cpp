@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/ByteString.h>
+#include <AK/DeprecatedFlyString.h>
+#include <AK/Vector.h>
+#include <LibTest/TestCase.h>
+#include <LibThreading/Thread.h>
+
+static constexpr size_t thread_count = 8;
+static constexpr size_t iteration_count = 2000;
+static constexpr size_t key_count = 64;
+
+static ByteString key(size_t index)
+{
+    return ByteString::formatted("identifier_{}", index);
+}
+
+TEST_CASE(intern_and_release_from_multiple_threads)
+{
+    DeprecatedFlyString::enable_sharing_between_threads();
+
+    // The first half of the keys stays interned on this thread the whole time. Other threads keep interning and
+    // dropping the second half, so those get destroyed and interned again while other threads look them up.
+    IGNORE_USE_IN_ESCAPING_LAMBDA Vector<DeprecatedFlyString> held;
+    for (size_t i = 0; i < key_count / 2; ++i)
+        held.append(key(i));
+
+    IGNORE_USE_IN_ESCAPING_LAMBDA Atomic<size_t> failures { 0 };
+    Vector<NonnullRefPtr<Threading::Thread>> threads;
+    for (size_t thread_index = 0; thread_index < thread_count; ++thread_index) {
+        threads.append(Threading::Thread::construct([&held, &failures, thread_index]() -> intptr_t {
+            auto fail = [&] {
+                ++failures;
+                return 1;
+            };
+
+            for (size_t i = 0; i < iteration_count; ++i) {
+                auto index = (i * 7 + thread_index) % key_count;
+                auto name = key(index);
+
+                DeprecatedFlyString fly_string { name };
+                DeprecatedFlyString copy = fly_string;
+                if (fly_string != name.view() || copy.impl() != DeprecatedFlyString(name.view()).impl())
+                    return fail();
+                if (index < held.size() && fly_string.impl() != held[index].impl())
+                    return fail();
+
+                // Empty strings all share one impl, which every thread references.
+                ByteString empty;
+                DeprecatedFlyString empty_fly_string { empty };
+                if (!empty_fly_string.is_empty())
+                    return fail();
+            }
+            return 0;
+        }));
+        threads.last()->start();
+    }
+
+    for (auto& thread : threads)
+        EXPECT(!thread->join().is_error());
+    EXPECT_EQ(failures.load(), 0u);
+
+    // Every key still has exactly one impl, whether it was kept alive throughout or not.
+    for (size_t i = 0; i < key_count; ++i) {
+        auto name = key(i);
+        DeprecatedFlyString a { name };
+        DeprecatedFlyString b { name.view() };
+        EXPECT_EQ(a.impl(), b.impl());
+        if (i < held.size())
+            EXPECT_EQ(a.impl(), held[i].impl());
+    }
+}
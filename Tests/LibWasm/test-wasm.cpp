@@ -7,11 +7,16 @@
 #include <AK/MemoryStream.h>
 #include <LibTest/JavaScriptTestRunner.h>
 #include <LibWasm/AbstractMachine/BytecodeInterpreter.h>
+#include <LibWasm/AbstractMachine/GuardedMemory.h>
+#include <LibWasm/AbstractMachine/LoweredFunction.h>
 #include <LibWasm/Types.h>
 #include <string.h>
 
 TEST_ROOT("Userland/Libraries/LibWasm/Tests");
 
+TESTJS_PROGRAM_FLAG(use_guarded_memories, "Back memories with guard pages by default instead of bounds checking accesses", "guarded-memories", 0);
+TESTJS_PROGRAM_FLAG(disable_jit, "Never compile functions to native code, lower them for the interpreter instead", "no-jit", 0);
+
 TESTJS_GLOBAL_FUNCTION(read_binary_wasm_file, readBinaryWasmFile)
 {
     auto& realm = *vm.current_realm();
@@ -50,14 +55,18 @@ public:
     }
 
     static Wasm::AbstractMachine& machine() { return m_machine; }
+    bool is_jit_enabled() const { return m_jit_enabled; }
     Wasm::Module& module() { return *m_module; }
     Wasm::ModuleInstance& module_instance() { return *m_module_instance; }
 
-    static JS::ThrowCompletionOr<WebAssemblyModule*> create(JS::Realm& realm, NonnullRefPtr<Wasm::Module> module, HashMap<Wasm::Linker::Name, Wasm::ExternValue> const& imports)
+    static JS::ThrowCompletionOr<WebAssemblyModule*> create(JS::Realm& realm, NonnullRefPtr<Wasm::Module> module, HashMap<Wasm::Linker::Name, Wasm::ExternValue> const& imports, bool use_guarded_memories, bool jit_enabled)
     {
         auto& vm = realm.vm();
+        // This applies to all memories allocated from here on, including the ones of the spectest namespace.
+        m_machine.store().set_use_guard_pages(use_guarded_memories ? Wasm::MemoryInstance::UseGuardPages::Yes : Wasm::MemoryInstance::UseGuardPages::No);
         auto instance = realm.heap().allocate<WebAssemblyModule>(realm, realm.intrinsics().object_prototype());
         instance->m_module = move(module);
+        instance->m_jit_enabled = jit_enabled;
         Wasm::Linker linker(*instance->m_module);
         linker.link(imports);
         linker.link(spec_test_namespace());
@@ -76,6 +85,8 @@ public:
 
 private:
     JS_DECLARE_NATIVE_FUNCTION(get_export);
+    JS_DECLARE_NATIVE_FUNCTION(get_memory);
+    JS_DECLARE_NATIVE_FUNCTION(get_lowered_opcodes);
     JS_DECLARE_NATIVE_FUNCTION(wasm_invoke);
 
     static HashMap<Wasm::Linker::Name, Wasm::ExternValue> const& spec_test_namespace()
@@ -148,11 +159,14 @@ private:
 
     static HashMap<Wasm::Linker::Name, Wasm::ExternValue> s_spec_test_namespace;
     static Wasm::AbstractMachine m_machine;
+    static StackInfo s_stack_info;
     RefPtr<Wasm::Module> m_module;
     OwnPtr<Wasm::ModuleInstance> m_module_instance;
+    bool m_jit_enabled { true };
 };
 
 Wasm::AbstractMachine WebAssemblyModule::m_machine;
+StackInfo WebAssemblyModule::s_stack_info;
 HashMap<Wasm::Linker::Name, Wasm::ExternValue> WebAssemblyModule::s_spec_test_namespace;
 
 TESTJS_GLOBAL_FUNCTION(parse_webassembly_module, parseWebAssemblyModule)
@@ -183,7 +197,24 @@ TESTJS_GLOBAL_FUNCTION(parse_webassembly_module, parseWebAssemblyModule)
         }
     }
 
-    return JS::Value(TRY(WebAssemblyModule::create(realm, result.release_value(), imports)));
+    auto guarded_memories = use_guarded_memories;
+    auto jit_enabled = !disable_jit;
+    if (auto options_value = vm.argument(2); options_value.is_object()) {
+        auto& options = options_value.as_object();
+        auto guarded_memories_value = TRY(options.get("guardedMemories"));
+        if (!guarded_memories_value.is_undefined())
+            guarded_memories = guarded_memories_value.to_boolean();
+        auto jit_value = TRY(options.get("jit"));
+        if (!jit_value.is_undefined())
+            jit_enabled = jit_value.to_boolean();
+    }
+
+    return JS::Value(TRY(WebAssemblyModule::create(realm, result.release_value(), imports, guarded_memories, jit_enabled)));
+}
+
+TESTJS_GLOBAL_FUNCTION(guarded_memories_supported, guardedMemoriesSupported)
+{
+    return JS::Value(Wasm::GuardedMemory::is_supported());
 }
 
 TESTJS_GLOBAL_FUNCTION(compare_typed_arrays, compareTypedArrays)
@@ -278,6 +309,8 @@ void WebAssemblyModule::initialize(JS::Realm& realm)
 {
     Base::initialize(realm);
     define_native_function(realm, "getExport", get_export, 1, JS::default_attributes);
+    define_native_function(realm, "getMemory", get_memory, 1, JS::default_attributes);
+    define_native_function(realm, "getLoweredOpcodes", get_lowered_opcodes, 1, JS::default_attributes);
     define_native_function(realm, "invoke", wasm_invoke, 1, JS::default_attributes);
 }
 
@@ -323,8 +356,71 @@ JS_DEFINE_NATIVE_FUNCTION(WebAssemblyModule::get_export)
     return vm.throw_completion<JS::TypeError>(TRY_OR_THROW_OOM(vm, String::formatted("'{}' could not be found", name)));
 }
 
+JS_DEFINE_NATIVE_FUNCTION(WebAssemblyModule::get_memory)
+{
+    auto& realm = *vm.current_realm();
+    auto name = TRY(vm.argument(0).to_byte_string(vm));
+    auto this_value = vm.this_value();
+    auto object = TRY(this_value.to_object(vm));
+    if (!is<WebAssemblyModule>(*object))
+        return vm.throw_completion<JS::TypeError>("Not a WebAssemblyModule"sv);
+    auto& instance = static_cast<WebAssemblyModule&>(*object);
+    for (auto& entry : instance.module_instance().exports()) {
+        if (entry.name() != name)
+            continue;
+        auto address = entry.value().get_pointer<Wasm::MemoryAddress>();
+        if (!address)
+            return vm.throw_completion<JS::TypeError>(TRY_OR_THROW_OOM(vm, String::formatted("'{}' does not refer to a memory", name)));
+        auto* memory = m_machine.store().get(*address);
+        if (!memory)
+            return vm.throw_completion<JS::TypeError>("Invalid memory address"sv);
+
+        // The base address is exposed so that tests can check whether memory.grow moved the memory.
+        auto result = JS::Object::create(realm, realm.intrinsics().object_prototype());
+        MUST(result->create_data_property_or_throw("guarded", JS::Value(memory->is_guarded())));
+        MUST(result->create_data_property_or_throw("base", JS::BigInt::create(vm, Crypto::SignedBigInteger { Crypto::UnsignedBigInteger { static_cast<u64>(reinterpret_cast<FlatPtr>(memory->bytes().data())) } })));
+        MUST(result->create_data_property_or_throw("size", JS::Value(static_cast<double>(memory->size()))));
+        return result;
+    }
+    return vm.throw_completion<JS::TypeError>(TRY_OR_THROW_OOM(vm, String::formatted("'{}' could not be found", name)));
+}
+
+JS_DEFINE_NATIVE_FUNCTION(WebAssemblyModule::get_lowered_opcodes)
+{
+    auto& realm = *vm.current_realm();
+    auto name = TRY(vm.argument(0).to_byte_string(vm));
+    auto this_value = vm.this_value();
+    auto object = TRY(this_value.to_object(vm));
+    if (!is<WebAssemblyModule>(*object))
+        return vm.throw_completion<JS::TypeError>("Not a WebAssemblyModule"sv);
+    auto& instance = static_cast<WebAssemblyModule&>(*object);
+    for (auto& entry : instance.module_instance().exports()) {
+        if (entry.name() != name)
+            continue;
+        auto address = entry.value().get_pointer<Wasm::FunctionAddress>();
+        if (!address)
+            return vm.throw_completion<JS::TypeError>(TRY_OR_THROW_OOM(vm, String::formatted("'{}' does not refer to a function", name)));
+        auto* function = m_machine.store().get(*address)->get_pointer<Wasm::WasmFunction>();
+        if (!function)
+            return vm.throw_completion<JS::TypeError>(TRY_OR_THROW_OOM(vm, String::formatted("'{}' is not a Wasm function", name)));
+        auto const* lowered_function = function->lowered_function(m_machine.store());
+        if (!lowered_function)
+            return vm.throw_completion<JS::TypeError>(TRY_OR_THROW_OOM(vm, String::formatted("'{}' could not be lowered", name)));
+        return JS::Array::create_from<Wasm::LoweredInstruction>(realm, lowered_function->instructions(), [&](auto const& instruction) {
+            return JS::Value(JS::PrimitiveString::create(vm, Wasm::lowered_opcode_name(instruction.opcode)));
+        });
+    }
+    return vm.throw_completion<JS::TypeError>(TRY_OR_THROW_OOM(vm, String::formatted("'{}' could not be found", name)));
+}
+
 JS_DEFINE_NATIVE_FUNCTION(WebAssemblyModule::wasm_invoke)
 {
+    auto this_value = vm.this_value();
+    auto object = TRY(this_value.to_object(vm));
+    if (!is<WebAssemblyModule>(*object))
+        return vm.throw_completion<JS::TypeError>("Not a WebAssemblyModule"sv);
+    auto& instance = static_cast<WebAssemblyModule&>(*object);
+
     auto address = static_cast<unsigned long>(TRY(vm.argument(0).to_double(vm)));
     Wasm::FunctionAddress function_address { address };
     auto function_instance = WebAssemblyModule::machine().store().get(function_address);
@@ -399,7 +495,9 @@ JS_DEFINE_NATIVE_FUNCTION(WebAssemblyModule::wasm_invoke)
     }
 
     auto functype = WebAssemblyModule::machine().store().get(function_address)->visit([&](auto& func) { return func.type(); });
-    auto result = WebAssemblyModule::machine().invoke(function_address, arguments);
+    Wasm::BytecodeInterpreter interpreter(s_stack_info);
+    interpreter.set_jit_enabled(interpreter.is_jit_enabled() && instance.is_jit_enabled());
+    auto result = WebAssemblyModule::machine().invoke(interpreter, function_address, arguments);
     if (result.is_trap())
         return vm.throw_completion<JS::TypeError>(TRY_OR_THROW_OOM(vm, String::formatted("Execution trapped: {}", result.trap().reason)));
 
@@ -6,61 +6,324 @@
  */
 
 #include "Generator.h"
+#include <AK/HashMap.h>
 
 namespace Diff {
 
-ErrorOr<Vector<Hunk>> from_text(StringView old_text, StringView new_text, size_t context)
+enum class Edit : u8 {
+    Keep,
+    Remove,
+    Add,
+};
+
+using EditScript = Vector<Edit>;
+
+static ErrorOr<void> append_edits(EditScript& script, Edit edit, size_t count)
+{
+    TRY(script.try_ensure_capacity(script.size() + count));
+    for (size_t i = 0; i < count; ++i)
+        script.unchecked_append(edit);
+    return {};
+}
+
+// Strips the lines which both texts start and end with, and diffs what remains in between with the given function.
+template<typename Callback>
+static ErrorOr<void> diff_between_common_lines(ReadonlySpan<u32> old_lines, ReadonlySpan<u32> new_lines, EditScript& script, Callback diff_remaining_lines)
+{
+    size_t prefix = 0;
+    while (prefix < old_lines.size() && prefix < new_lines.size() && old_lines[prefix] == new_lines[prefix])
+        ++prefix;
+
+    size_t suffix = 0;
+    while (suffix < old_lines.size() - prefix && suffix < new_lines.size() - prefix
+        && old_lines[old_lines.size() - suffix - 1] == new_lines[new_lines.size() - suffix - 1])
+        ++suffix;
+
+    TRY(append_edits(script, Edit::Keep, prefix));
+
+    auto remaining_old_lines = old_lines.slice(prefix, old_lines.size() - prefix - suffix);
+    auto remaining_new_lines = new_lines.slice(prefix, new_lines.size() - prefix - suffix);
+
+    if (remaining_old_lines.is_empty())
+        TRY(append_edits(script, Edit::Add, remaining_new_lines.size()));
+    else if (remaining_new_lines.is_empty())
+        TRY(append_edits(script, Edit::Remove, remaining_old_lines.size()));
+    else
+        TRY(diff_remaining_lines(remaining_old_lines, remaining_new_lines));
+
+    return append_edits(script, Edit::Keep, suffix);
+}
+
+static ErrorOr<void> myers_diff(ReadonlySpan<u32> old_lines, ReadonlySpan<u32> new_lines, EditScript& script);
+
+// Searches for the middle snake of the shortest edit script, by following the furthest reaching paths of the
+// script from both ends of the texts at once until they overlap (E. Myers, "An O(ND) Difference Algorithm and
+// Its Variations", 1986). The texts are then split at the overlap, and either half is diffed on its own. This
+// only needs space for one row of furthest reaching paths per direction, rather than for the whole edit graph.
+static ErrorOr<void> myers_bisect(ReadonlySpan<u32> old_lines, ReadonlySpan<u32> new_lines, EditScript& script)
+{
+    auto old_size = static_cast<ssize_t>(old_lines.size());
+    auto new_size = static_cast<ssize_t>(new_lines.size());
+
+    auto max_d = (old_size + new_size + 1) / 2;
+    auto offset = max_d;
+    auto length = 2 * max_d + 2;
+
+    // The furthest reaching x position on each diagonal k (where k = x - y), searching forwards and backwards.
+    Vector<ssize_t> forward;
+    Vector<ssize_t> backward;
+    TRY(forward.try_resize(length));
+    TRY(backward.try_resize(length));
+    forward.span().fill(-1);
+    backward.span().fill(-1);
+    forward[offset + 1] = 0;
+    backward[offset + 1] = 0;
+
+    auto delta = old_size - new_size;
+
+    // If the difference in length is odd, the paths overlap on a forward step, otherwise on a backward step.
+    bool overlaps_going_forward = delta % 2 != 0;
+
+    // Diagonals on which the paths have run off the edge of the edit graph need not be followed any further.
+    ssize_t forward_k_start = 0;
+    ssize_t forward_k_end = 0;
+    ssize_t backward_k_start = 0;
+    ssize_t backward_k_end = 0;
+
+    auto split = [&](ssize_t x, ssize_t y) -> ErrorOr<void> {
+        TRY(myers_diff(old_lines.slice(0, x), new_lines.slice(0, y), script));
+        return myers_diff(old_lines.slice(x), new_lines.slice(y), script);
+    };
+
+    for (ssize_t d = 0; d < max_d; ++d) {
+        for (auto k = -d + forward_k_start; k <= d - forward_k_end; k += 2) {
+            auto k_offset = offset + k;
+
+            ssize_t x = 0;
+            if (k == -d || (k != d && forward[k_offset - 1] < forward[k_offset + 1]))
+                x = forward[k_offset + 1];
+            else
+                x = forward[k_offset - 1] + 1;
+
+            auto y = x - k;
+            while (x < old_size && y < new_size && old_lines[x] == new_lines[y]) {
+                ++x;
+                ++y;
+            }
+            forward[k_offset] = x;
+
+            if (x > old_size) {
+                forward_k_end += 2;
+            } else if (y > new_size) {
+                forward_k_start += 2;
+            } else if (overlaps_going_forward) {
+                auto backward_k_offset = offset + delta - k;
+                if (backward_k_offset >= 0 && backward_k_offset < length && backward[backward_k_offset] != -1) {
+                    if (x >= old_size - backward[backward_k_offset])
+                        return split(x, y);
+                }
+            }
+        }
+
+        for (auto k = -d + backward_k_start; k <= d - backward_k_end; k += 2) {
+            auto k_offset = offset + k;
+
+            ssize_t x = 0;
+            if (k == -d || (k != d && backward[k_offset - 1] < backward[k_offset + 1]))
+                x = backward[k_offset + 1];
+            else
+                x = backward[k_offset - 1] + 1;
+
+            auto y = x - k;
+            while (x < old_size && y < new_size && old_lines[old_size - x - 1] == new_lines[new_size - y - 1]) {
+                ++x;
+                ++y;
+            }
+            backward[k_offset] = x;
+
+            if (x > old_size) {
+                backward_k_end += 2;
+            } else if (y > new_size) {
+                backward_k_start += 2;
+            } else if (!overlaps_going_forward) {
+                auto forward_k_offset = offset + delta - k;
+                if (forward_k_offset >= 0 && forward_k_offset < length && forward[forward_k_offset] != -1) {
+                    auto forward_x = forward[forward_k_offset];
+                    auto forward_y = offset + forward_x - forward_k_offset;
+                    if (forward_x >= old_size - x)
+                        return split(forward_x, forward_y);
+                }
+            }
+        }
+    }
+
+    // The texts have no lines in common.
+    TRY(append_edits(script, Edit::Remove, old_lines.size()));
+    return append_edits(script, Edit::Add, new_lines.size());
+}
+
+static ErrorOr<void> myers_diff(ReadonlySpan<u32> old_lines, ReadonlySpan<u32> new_lines, EditScript& script)
+{
+    return diff_between_common_lines(old_lines, new_lines, script, [&](auto remaining_old_lines, auto remaining_new_lines) {
+        return myers_bisect(remaining_old_lines, remaining_new_lines, script);
+    });
+}
+
+struct Anchor {
+    size_t old_index { 0 };
+    size_t new_index { 0 };
+};
+
+// Finds the longest sequence of anchors (which are ordered by their old index) whose new indices increase as well.
+static ErrorOr<Vector<Anchor>> longest_increasing_sequence(Vector<Anchor> const& anchors)
+{
+    // The anchor ending the best sequence of each length found so far, and the anchor preceding each anchor in
+    // the best sequence ending in it.
+    Vector<size_t> sequence_ends;
+    Vector<Optional<size_t>> predecessors;
+    TRY(predecessors.try_resize(anchors.size()));
+
+    for (size_t i = 0; i < anchors.size(); ++i) {
+        size_t low = 0;
+        size_t high = sequence_ends.size();
+        while (low < high) {
+            auto middle = low + (high - low) / 2;
+            if (anchors[sequence_ends[middle]].new_index < anchors[i].new_index)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+
+        if (low > 0)
+            predecessors[i] = sequence_ends[low - 1];
+
+        if (low == sequence_ends.size())
+            TRY(sequence_ends.try_append(i));
+        else
+            sequence_ends[low] = i;
+    }
+
+    Vector<Anchor> sequence;
+    TRY(sequence.try_resize(sequence_ends.size()));
+
+    Optional<size_t> index = sequence_ends.is_empty() ? Optional<size_t> {} : sequence_ends.last();
+    for (size_t i = sequence.size(); i > 0; --i) {
+        sequence[i - 1] = anchors[*index];
+        index = predecessors[*index];
+    }
+
+    return sequence;
+}
+
+static ErrorOr<void> patience_diff(ReadonlySpan<u32> old_lines, ReadonlySpan<u32> new_lines, EditScript& script)
+{
+    return diff_between_common_lines(old_lines, new_lines, script, [&](auto remaining_old_lines, auto remaining_new_lines) -> ErrorOr<void> {
+        struct Occurrences {
+            size_t old_count { 0 };
+            size_t new_count { 0 };
+            size_t old_index { 0 };
+            size_t new_index { 0 };
+        };
+
+        HashMap<u32, Occurrences> occurrences;
+        for (size_t i = 0; i < remaining_old_lines.size(); ++i) {
+            auto& line = occurrences.ensure(remaining_old_lines[i]);
+            ++line.old_count;
+            line.old_index = i;
+        }
+        for (size_t i = 0; i < remaining_new_lines.size(); ++i) {
+            if (auto line = occurrences.find(remaining_new_lines[i]); line != occurrences.end()) {
+                ++line->value.new_count;
+                line->value.new_index = i;
+            }
+        }
+
+        Vector<Anchor> unique_lines;
+        for (size_t i = 0; i < remaining_old_lines.size(); ++i) {
+            auto const& line = occurrences.get(remaining_old_lines[i]).value();
+            if (line.old_count == 1 && line.new_count == 1)
+                TRY(unique_lines.try_append({ i, line.new_index }));
+        }
+
+        if (unique_lines.is_empty())
+            return myers_bisect(remaining_old_lines, remaining_new_lines, script);
+
+        size_t old_start = 0;
+        size_t new_start = 0;
+
+        for (auto const& anchor : TRY(longest_increasing_sequence(unique_lines))) {
+            TRY(patience_diff(
+                remaining_old_lines.slice(old_start, anchor.old_index - old_start),
+                remaining_new_lines.slice(new_start, anchor.new_index - new_start),
+                script));
+            TRY(append_edits(script, Edit::Keep, 1));
+
+            old_start = anchor.old_index + 1;
+            new_start = anchor.new_index + 1;
+        }
+
+        return patience_diff(remaining_old_lines.slice(old_start), remaining_new_lines.slice(new_start), script);
+    });
+}
+
+Optional<Algorithm> algorithm_from_name(StringView name)
+{
+    if (name == "myers"sv)
+        return Algorithm::Myers;
+    if (name == "patience"sv)
+        return Algorithm::Patience;
+    return {};
+}
+
+ErrorOr<Vector<Hunk>> from_text(StringView old_text, StringView new_text, size_t context, Algorithm algorithm)
 {
     auto old_lines = old_text.lines();
     auto new_lines = new_text.lines();
 
-    /**
-     * This is a simple implementation of the Longest Common Subsequence algorithm (over
-     * the lines of the text as opposed to the characters). A Dynamic programming approach
-     * is used here.
-     */
+    // Number the distinct lines of both texts, so that comparing two lines is a matter of comparing two numbers.
+    HashMap<StringView, u32> line_numbers;
+    auto number_lines = [&](Vector<StringView> const& lines) -> ErrorOr<Vector<u32>> {
+        Vector<u32> numbers;
+        TRY(numbers.try_ensure_capacity(lines.size()));
 
-    enum class Direction {
-        Down,     // Added a new line
-        Right,    // Removed a line
-        Diagonal, // Line remained the same
-    };
+        for (auto const& line : lines) {
+            auto number = TRY(line_numbers.try_ensure(line, [&] { return static_cast<u32>(line_numbers.size()); }));
+            numbers.unchecked_append(number);
+        }
 
-    // A single cell in the DP-matrix. Cell (i, j) represents the longest common
-    // sub-sequence of lines between old_lines[0 : i] and new_lines[0 : j].
-    struct Cell {
-        size_t length;
-        Direction direction;
+        return numbers;
     };
 
-    auto dp_matrix = Vector<Cell>();
-    TRY(dp_matrix.try_resize((old_lines.size() + 1) * (new_lines.size() + 1)));
+    auto old_line_numbers = TRY(number_lines(old_lines));
+    auto new_line_numbers = TRY(number_lines(new_lines));
+
+    EditScript script;
+    switch (algorithm) {
+    case Algorithm::Myers:
+        TRY(myers_diff(old_line_numbers, new_line_numbers, script));
+        break;
+    case Algorithm::Patience:
+        TRY(patience_diff(old_line_numbers, new_line_numbers, script));
+        break;
+    }
 
-    auto dp = [&dp_matrix, width = old_lines.size() + 1](size_t i, size_t j) -> Cell& {
-        return dp_matrix[i + width * j];
-    };
+    // Within every run of changed lines, list the removed lines before the added ones.
+    for (size_t start = 0; start < script.size();) {
+        if (script[start] == Edit::Keep) {
+            ++start;
+            continue;
+        }
 
-    // Initialize the first row and column
-    for (size_t i = 0; i <= old_lines.size(); ++i)
-        dp(i, new_lines.size()) = { 0, Direction::Right };
-
-    for (size_t j = 0; j <= new_lines.size(); ++j)
-        dp(old_lines.size(), 0) = { 0, Direction::Down };
-
-    // Fill in the rest of the DP table
-    for (int i = old_lines.size() - 1; i >= 0; --i) {
-        for (int j = new_lines.size() - 1; j >= 0; --j) {
-            if (old_lines[i] == new_lines[j]) {
-                dp(i, j) = { dp(i + 1, j + 1).length + 1, Direction::Diagonal };
-            } else {
-                auto down = dp(i, j + 1).length;
-                auto right = dp(i + 1, j).length;
-                if (down > right)
-                    dp(i, j) = { down, Direction::Down };
-                else
-                    dp(i, j) = { right, Direction::Right };
-            }
+        size_t end = start;
+        size_t removals = 0;
+        for (; end < script.size() && script[end] != Edit::Keep; ++end) {
+            if (script[end] == Edit::Remove)
+                ++removals;
         }
+
+        for (size_t i = start; i < end; ++i)
+            script[i] = i - start < removals ? Edit::Remove : Edit::Add;
+        start = end;
     }
 
     Vector<Hunk> hunks;
@@ -97,10 +360,8 @@ ErrorOr<Vector<Hunk>> from_text(StringView old_text, StringView new_text, size_t
     };
 
     size_t current_context = 0;
-    while (i < old_lines.size() && j < new_lines.size()) {
-
-        auto& cell = dp(i, j);
-        if (cell.direction == Direction::Down) {
+    for (auto edit : script) {
+        if (edit == Edit::Add) {
             if (cur_hunk.lines.is_empty())
                 TRY(set_up_hunk_prepended_with_context(cur_hunk));
             TRY(cur_hunk.lines.try_append(Line { Line::Operation::Addition, TRY(String::from_utf8(new_lines[j])) }));
@@ -108,7 +369,7 @@ ErrorOr<Vector<Hunk>> from_text(StringView old_text, StringView new_text, size_t
 
             ++j;
             current_context = 0;
-        } else if (cell.direction == Direction::Right) {
+        } else if (edit == Edit::Remove) {
             if (cur_hunk.lines.is_empty())
                 TRY(set_up_hunk_prepended_with_context(cur_hunk));
             TRY(cur_hunk.lines.try_append(Line { Line::Operation::Removal, TRY(String::from_utf8(old_lines[i])) }));
@@ -138,23 +399,7 @@ ErrorOr<Vector<Hunk>> from_text(StringView old_text, StringView new_text, size_t
         }
     }
 
-    while (i < old_lines.size()) {
-        if (cur_hunk.lines.is_empty())
-            TRY(set_up_hunk_prepended_with_context(cur_hunk));
-
-        TRY(cur_hunk.lines.try_append(Line { Line::Operation::Removal, TRY(String::from_utf8(old_lines[i])) }));
-        cur_hunk.location.old_range.number_of_lines++;
-        ++i;
-    }
-
-    while (j < new_lines.size()) {
-        if (cur_hunk.lines.is_empty())
-            TRY(set_up_hunk_prepended_with_context(cur_hunk));
-        TRY(cur_hunk.lines.try_append(Line { Line::Operation::Addition, TRY(String::from_utf8(new_lines[j])) }));
-        cur_hunk.location.new_range.number_of_lines++;
-
-        ++j;
-    }
+    VERIFY(i == old_lines.size() && j == new_lines.size());
 
     if (!cur_hunk.lines.is_empty())
         TRY(flush_hunk());
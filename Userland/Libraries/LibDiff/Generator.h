@@ -8,9 +8,21 @@
 
 #include "Hunks.h"
 #include <AK/Error.h>
+#include <AK/Optional.h>
 
 namespace Diff {
 
-ErrorOr<Vector<Hunk>> from_text(StringView old_text, StringView new_text, size_t context = 0);
+enum class Algorithm {
+    // Finds a shortest edit script between the two texts, in O((N+M)D) time and O(N+M) space.
+    Myers,
+
+    // Matches up the lines which occur exactly once in both texts first, and only diffs the lines between them.
+    // This produces more readable hunks for reordered blocks of code, though not always the shortest ones.
+    Patience,
+};
+
+Optional<Algorithm> algorithm_from_name(StringView);
+
+ErrorOr<Vector<Hunk>> from_text(StringView old_text, StringView new_text, size_t context = 0, Algorithm = Algorithm::Myers);
 
 }
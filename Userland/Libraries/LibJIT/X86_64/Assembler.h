@@ -67,7 +67,7 @@ struct X86_64Assembler {
         Reg reg {};
         u64 offset_or_immediate { 0 };
 
-        static Operand Register(Reg reg)
+        static constexpr Operand Register(Reg reg)
         {
             Operand operand;
             operand.type = Type::Reg;
@@ -303,15 +303,21 @@ struct X86_64Assembler {
         emit8(rex.raw);
     }
 
-    void shift_right(Operand dst, Operand count)
+    void shift_right(Operand dst, Optional<Operand> count)
     {
         VERIFY(dst.type == Operand::Type::Reg);
-        VERIFY(count.type == Operand::Type::Imm);
-        VERIFY(count.fits_in_u8());
-        emit_rex_for_slash(dst, REX_W::Yes);
-        emit8(0xc1);
-        emit_modrm_slash(5, dst);
-        emit8(count.offset_or_immediate);
+        if (count.has_value()) {
+            VERIFY(count->type == Operand::Type::Imm);
+            VERIFY(count->fits_in_u8());
+            emit_rex_for_slash(dst, REX_W::Yes);
+            emit8(0xc1);
+            emit_modrm_slash(5, dst);
+            emit8(count->offset_or_immediate);
+        } else {
+            emit_rex_for_slash(dst, REX_W::Yes);
+            emit8(0xd3);
+            emit_modrm_slash(5, dst);
+        }
     }
 
     void mov(Operand dst, Operand src, Patchable patchable = Patchable::No)
@@ -385,6 +391,20 @@ struct X86_64Assembler {
 
     void mov8(Operand dst, Operand src, Extension extension = Extension::ZeroExtend)
     {
+        if (dst.type == Operand::Type::Mem64BaseAndOffset && src.type == Operand::Type::Reg) {
+            // mov r/m8, r8
+            // NOTE: Without a REX prefix, registers 4 to 7 would encode AH, CH, DH and BH instead.
+            if (to_underlying(src.reg) >= 4 && to_underlying(src.reg) < 8) {
+                REX rex { .B = to_underlying(dst.reg) >= 8, .X = 0, .R = 0, .W = 0 };
+                emit8(rex.raw);
+            } else {
+                emit_rex_for_mr(dst, src, REX_W::No);
+            }
+            emit8(0x88);
+            emit_modrm_mr(dst, src);
+            return;
+        }
+
         VERIFY(dst.type == Operand::Type::Reg && src.type == Operand::Type::Mem64BaseAndOffset);
         // mov[sz]x r32, r/m8
         emit_rex_for_rm(dst, src, REX_W::No);
@@ -395,6 +415,15 @@ struct X86_64Assembler {
 
     void mov16(Operand dst, Operand src, Extension extension = Extension::ZeroExtend)
     {
+        if (dst.type == Operand::Type::Mem64BaseAndOffset && src.type == Operand::Type::Reg) {
+            // mov r/m16, r16
+            emit8(0x66);
+            emit_rex_for_mr(dst, src, REX_W::No);
+            emit8(0x89);
+            emit_modrm_mr(dst, src);
+            return;
+        }
+
         VERIFY(dst.type == Operand::Type::Reg && src.is_register_or_memory());
         // mov[sz]x r32, r/m16
         emit_rex_for_rm(dst, src, REX_W::No);
@@ -405,6 +434,14 @@ struct X86_64Assembler {
 
     void mov32(Operand dst, Operand src, Extension extension = Extension::ZeroExtend)
     {
+        if (dst.type == Operand::Type::Mem64BaseAndOffset && src.type == Operand::Type::Reg) {
+            // mov r/m32, r32
+            emit_rex_for_mr(dst, src, REX_W::No);
+            emit8(0x89);
+            emit_modrm_mr(dst, src);
+            return;
+        }
+
         VERIFY(dst.type == Operand::Type::Reg && src.is_register_or_memory());
         if (extension == Extension::ZeroExtend) {
             // mov r32, r/m32
@@ -543,6 +580,27 @@ struct X86_64Assembler {
         }
     }
 
+    void cmp32(Operand lhs, Operand rhs)
+    {
+        if (lhs.is_register_or_memory() && rhs.type == Operand::Type::Reg) {
+            emit_rex_for_mr(lhs, rhs, REX_W::No);
+            emit8(0x39);
+            emit_modrm_mr(lhs, rhs);
+        } else if (lhs.is_register_or_memory() && rhs.type == Operand::Type::Imm && rhs.fits_in_i8()) {
+            emit_rex_for_slash(lhs, REX_W::No);
+            emit8(0x83);
+            emit_modrm_slash(7, lhs);
+            emit8(rhs.offset_or_immediate);
+        } else if (lhs.is_register_or_memory() && rhs.type == Operand::Type::Imm && rhs.fits_in_i32()) {
+            emit_rex_for_slash(lhs, REX_W::No);
+            emit8(0x81);
+            emit_modrm_slash(7, lhs);
+            emit32(rhs.offset_or_immediate);
+        } else {
+            VERIFY_NOT_REACHED();
+        }
+    }
+
     void test(Operand lhs, Operand rhs)
     {
         if (lhs.is_register_or_memory() && rhs.type == Operand::Type::Reg) {
@@ -560,6 +618,17 @@ struct X86_64Assembler {
         }
     }
 
+    void test32(Operand lhs, Operand rhs)
+    {
+        if (lhs.is_register_or_memory() && rhs.type == Operand::Type::Reg) {
+            emit_rex_for_mr(lhs, rhs, REX_W::No);
+            emit8(0x85);
+            emit_modrm_mr(lhs, rhs);
+        } else {
+            VERIFY_NOT_REACHED();
+        }
+    }
+
     void jump_if(Condition condition, Label& label)
     {
         emit8(0x0F);
@@ -640,6 +709,28 @@ struct X86_64Assembler {
         }
     }
 
+    void bitwise_xor(Operand dst, Operand src)
+    {
+        // xor dst,src
+        if (dst.is_register_or_memory() && src.type == Operand::Type::Reg) {
+            emit_rex_for_mr(dst, src, REX_W::Yes);
+            emit8(0x31);
+            emit_modrm_mr(dst, src);
+        } else if (dst.type == Operand::Type::Reg && src.type == Operand::Type::Imm && src.fits_in_i8()) {
+            emit_rex_for_slash(dst, REX_W::Yes);
+            emit8(0x83);
+            emit_modrm_slash(6, dst);
+            emit8(src.offset_or_immediate);
+        } else if (dst.type == Operand::Type::Reg && src.type == Operand::Type::Imm && src.fits_in_i32()) {
+            emit_rex_for_slash(dst, REX_W::Yes);
+            emit8(0x81);
+            emit_modrm_slash(6, dst);
+            emit32(src.offset_or_immediate);
+        } else {
+            VERIFY_NOT_REACHED();
+        }
+    }
+
     void bitwise_xor32(Operand dst, Operand src)
     {
         if (dst.is_register_or_memory() && src.type == Operand::Type::Reg) {
@@ -663,7 +754,13 @@ struct X86_64Assembler {
 
     void mul(Operand dest, Operand src)
     {
-        if (dest.type == Operand::Type::FReg && src.type == Operand::Type::FReg) {
+        if (dest.type == Operand::Type::Reg && src.is_register_or_memory()) {
+            // imul dest, src (64-bit signed)
+            emit_rex_for_rm(dest, src, REX_W::Yes);
+            emit8(0x0f);
+            emit8(0xaf);
+            emit_modrm_rm(dest, src);
+        } else if (dest.type == Operand::Type::FReg && src.type == Operand::Type::FReg) {
             emit8(0xf2);
             emit8(0x0f);
             emit8(0x59);
@@ -39,6 +39,7 @@ namespace JS {
 class Declaration;
 class ClassDeclaration;
 class FunctionDeclaration;
+class FunctionExpression;
 class Identifier;
 class MemberExpression;
 class VariableDeclaration;
@@ -575,6 +576,16 @@ public:
 
 class FunctionBody final : public ScopeNode {
 public:
+    // Bodies that were skipped by the pre-parser have no children, they only remember where their function starts.
+    // The function is parsed in full when it's called for the first time, see Parser::parse_lazy_function().
+    struct LazyFunction {
+        ByteString source;
+        Position function_start;
+        Program::Type program_type { Program::Type::Script };
+        bool strict_mode { false };
+        mutable RefPtr<FunctionExpression const> parsed_function;
+    };
+
     explicit FunctionBody(SourceRange source_range)
         : ScopeNode(move(source_range))
     {
@@ -584,8 +595,13 @@ public:
 
     bool in_strict_mode() const { return m_in_strict_mode; }
 
+    bool is_lazy() const { return m_lazy_function; }
+    LazyFunction const& lazy_function() const { return *m_lazy_function; }
+    void set_lazy_function(LazyFunction lazy_function) { m_lazy_function = make<LazyFunction>(move(lazy_function)); }
+
 private:
     bool m_in_strict_mode { false };
+    OwnPtr<LazyFunction> m_lazy_function;
 };
 
 class Expression : public ASTNode {
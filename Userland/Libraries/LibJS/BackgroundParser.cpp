@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteString.h>
+#include <AK/DeprecatedFlyString.h>
+#include <AK/WeakPtr.h>
+#include <LibCore/EventLoop.h>
+#include <LibJS/BackgroundParser.h>
+#include <LibJS/ProgramCache.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibJS/SourceTextModule.h>
+#include <LibThreading/ThreadPool.h>
+
+namespace JS {
+
+// NOTE: Everything in here is created on the VM's thread and moved to the parser thread, where nothing else refers to
+//       it anymore. The results are moved back the same way, so none of the reference counts involved are ever touched
+//       by two threads at once.
+struct BackgroundParser::Job {
+    u64 id { 0 };
+    ByteString source_text;
+    ByteString filename;
+    size_t line_number_offset { 1 };
+    Program::Type program_type { Program::Type::Script };
+    bool lazy_function_parsing_enabled { false };
+    WeakPtr<BackgroundParser> parser;
+    Core::EventLoop* event_loop { nullptr };
+};
+
+class BackgroundParser::ParserThread final : public Threading::ThreadPool<Job> {
+public:
+    ParserThread()
+        : ThreadPool([](Job job) { run(move(job)); }, 1)
+    {
+    }
+
+private:
+    static void run(Job job)
+    {
+        auto program_or_errors = [&]() -> ProgramOrErrors {
+            if (job.program_type == Program::Type::Module)
+                return SourceTextModule::parse_program(job.source_text, job.filename, job.lazy_function_parsing_enabled);
+            return Script::parse_program(job.source_text, job.filename, job.line_number_offset, job.lazy_function_parsing_enabled);
+        }();
+
+        auto* event_loop = job.event_loop;
+        event_loop->deferred_invoke([job = move(job), program_or_errors = move(program_or_errors)]() mutable {
+            if (auto* parser = job.parser.ptr())
+                parser->did_parse(job.id, job.source_text, job.line_number_offset, move(program_or_errors));
+        });
+        event_loop->wake();
+    }
+};
+
+BackgroundParser::BackgroundParser(VM& vm)
+    : m_vm(vm)
+{
+}
+
+BackgroundParser::~BackgroundParser() = default;
+
+void BackgroundParser::parse(StringView source_text, StringView filename, size_t line_number_offset, Program::Type program_type, OnComplete on_complete)
+{
+    if (program_type == Program::Type::Module)
+        line_number_offset = 0;
+
+    if (auto program = m_vm.program_cache().get(source_text, filename, line_number_offset, program_type)) {
+        Core::deferred_invoke([program = program.release_nonnull(), on_complete = move(on_complete)]() mutable {
+            on_complete(move(program));
+        });
+        return;
+    }
+
+    // The parser thread is only started once something needs it. Identifiers interned there are the same fly strings
+    // the VM's thread uses, so their reference counts have to become atomic before it starts.
+    if (!m_parser_thread) {
+        DeprecatedFlyString::enable_sharing_between_threads();
+        m_parser_thread = make<ParserThread>();
+    }
+
+    auto job_id = m_next_job_id++;
+    m_pending_jobs.set(job_id, move(on_complete));
+
+    m_parser_thread->submit({
+        .id = job_id,
+        .source_text = source_text,
+        .filename = filename,
+        .line_number_offset = line_number_offset,
+        .program_type = program_type,
+        .lazy_function_parsing_enabled = m_vm.lazy_function_parsing_enabled(),
+        .parser = make_weak_ptr(),
+        .event_loop = &Core::EventLoop::current(),
+    });
+}
+
+void BackgroundParser::did_parse(u64 job_id, ByteString const& source_text, size_t line_number_offset, ProgramOrErrors program_or_errors)
+{
+    auto on_complete = m_pending_jobs.take(job_id);
+    VERIFY(on_complete.has_value());
+
+    if (!program_or_errors.is_error())
+        m_vm.program_cache().set(source_text, line_number_offset, program_or_errors.value());
+
+    (*on_complete)(move(program_or_errors));
+}
+
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/OwnPtr.h>
+#include <AK/Result.h>
+#include <AK/Weakable.h>
+#include <LibJS/AST.h>
+#include <LibJS/Forward.h>
+#include <LibJS/ParserError.h>
+
+namespace JS {
+
+// Parses the source text of scripts and modules on a background thread, so that large ones don't keep the thread that
+// runs JS from doing anything else in the meantime.
+//
+// A parsed Program holds no GC cells, so it can be handed over to the VM's thread as a whole. There, the completion
+// callback turns it into a Script or SourceTextModule with Script::create() or SourceTextModule::create().
+class BackgroundParser : public Weakable<BackgroundParser> {
+    AK_MAKE_NONCOPYABLE(BackgroundParser);
+    AK_MAKE_NONMOVABLE(BackgroundParser);
+
+public:
+    using ProgramOrErrors = Result<NonnullRefPtr<Program>, Vector<ParserError>>;
+    using OnComplete = Function<void(ProgramOrErrors)>;
+
+    explicit BackgroundParser(VM&);
+    ~BackgroundParser();
+
+    // The line number offset is ignored for modules. on_complete is invoked from the event loop that this is called on,
+    // and isn't touched by any other thread.
+    void parse(StringView source_text, StringView filename, size_t line_number_offset, Program::Type, OnComplete on_complete);
+
+private:
+    struct Job;
+    class ParserThread;
+
+    void did_parse(u64 job_id, ByteString const& source_text, size_t line_number_offset, ProgramOrErrors);
+
+    VM& m_vm;
+    OwnPtr<ParserThread> m_parser_thread;
+    HashMap<u64, OnComplete> m_pending_jobs;
+    u64 m_next_job_id { 0 };
+};
+
+}
@@ -7,13 +7,40 @@
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Executable.h>
 #include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Op.h>
 #include <LibJS/Bytecode/RegexTable.h>
+#include <LibJS/Runtime/Shape.h>
 #include <LibJS/SourceCode.h>
 
 namespace JS::Bytecode {
 
 JS_DEFINE_ALLOCATOR(Executable);
 
+PropertyLookupCache::Entry& PropertyLookupCache::entry_to_fill_for(Shape const& shape)
+{
+    auto shape_of_entry = [](Entry const& entry) -> Shape const* {
+        return entry.from_shape ? entry.from_shape.ptr() : entry.shape.ptr();
+    };
+
+    for (auto& entry : entries) {
+        if (shape_of_entry(entry) == &shape) {
+            entry = {};
+            return entry;
+        }
+    }
+    for (auto& entry : entries) {
+        if (!shape_of_entry(entry)) {
+            entry = {};
+            return entry;
+        }
+    }
+
+    for (size_t i = entries.size() - 1; i > 0; --i)
+        entries[i] = move(entries[i - 1]);
+    entries[0] = {};
+    return entries[0];
+}
+
 Executable::Executable(
     Vector<u8> bytecode,
     NonnullOwnPtr<IdentifierTable> identifier_table,
@@ -83,6 +110,61 @@ void Executable::dump() const
     warnln("");
 }
 
+void Executable::dump_property_lookup_cache_statistics() const
+{
+    auto cache_index_of = [](Instruction const& instruction) -> Optional<u32> {
+        switch (instruction.type()) {
+        case Instruction::Type::GetById:
+            return static_cast<Op::GetById const&>(instruction).cache_index();
+        case Instruction::Type::GetByIdWithThis:
+            return static_cast<Op::GetByIdWithThis const&>(instruction).cache_index();
+        case Instruction::Type::GetLength:
+            return static_cast<Op::GetLength const&>(instruction).cache_index();
+        case Instruction::Type::GetLengthWithThis:
+            return static_cast<Op::GetLengthWithThis const&>(instruction).cache_index();
+        case Instruction::Type::PutById:
+            return static_cast<Op::PutById const&>(instruction).cache_index();
+        case Instruction::Type::PutByIdWithThis:
+            return static_cast<Op::PutByIdWithThis const&>(instruction).cache_index();
+        default:
+            return {};
+        }
+    };
+
+    bool printed_header = false;
+    for (InstructionStreamIterator it(bytecode, this); !it.at_end(); ++it) {
+        auto cache_index = cache_index_of(*it);
+        if (!cache_index.has_value())
+            continue;
+        auto const& cache = property_lookup_caches[*cache_index];
+        if (cache.hit_count == 0 && cache.miss_count == 0)
+            continue;
+
+        if (!printed_header) {
+            warnln("\033[37;1mProperty lookup caches of\033[0m \"{}\"", name);
+            printed_header = true;
+        }
+
+        size_t shape_count = 0;
+        size_t transition_count = 0;
+        for (auto const& entry : cache.entries) {
+            if (entry.shape)
+                ++shape_count;
+            if (entry.from_shape)
+                ++transition_count;
+        }
+        warnln("[{:4x}] {:8} hits {:8} misses {} shapes ({} transitions)   {}",
+            it.offset(),
+            cache.hit_count,
+            cache.miss_count,
+            shape_count,
+            transition_count,
+            (*it).to_byte_string(*this));
+    }
+    if (printed_header)
+        warnln("");
+}
+
 void Executable::visit_edges(Visitor& visitor)
 {
     Base::visit_edges(visitor);
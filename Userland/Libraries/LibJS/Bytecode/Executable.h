@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/DeprecatedFlyString.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
@@ -23,13 +24,27 @@
 namespace JS::Bytecode {
 
 struct PropertyLookupCache {
-    WeakPtr<Shape> shape;
-    Optional<u32> property_offset;
-    WeakPtr<Object> prototype;
-    WeakPtr<PrototypeChainValidity> prototype_chain_validity;
+    static constexpr size_t max_number_of_shapes_to_remember = 4;
+
+    struct Entry {
+        // Set if the property was added by a store, in which case the object went from this shape to `shape`.
+        WeakPtr<Shape> from_shape;
+        WeakPtr<Shape> shape;
+        Optional<u32> property_offset;
+        WeakPtr<Object> prototype;
+        WeakPtr<PrototypeChainValidity> prototype_chain_validity;
+    };
+
+    // Returns a cleared entry to remember what happened to an object of this shape in. If every entry is taken by
+    // some other shape, the one that was filled in first is given up.
+    Entry& entry_to_fill_for(Shape const&);
+
+    AK::Array<Entry, max_number_of_shapes_to_remember> entries;
+    u32 hit_count { 0 };
+    u32 miss_count { 0 };
 };
 
-struct GlobalVariableCache : public PropertyLookupCache {
+struct GlobalVariableCache : public PropertyLookupCache::Entry {
     u64 environment_serial_number { 0 };
     Optional<u32> environment_binding_index;
 };
@@ -103,6 +118,7 @@ public:
     [[nodiscard]] UnrealizedSourceRange source_range_at(size_t offset) const;
 
     void dump() const;
+    void dump_property_lookup_cache_statistics() const;
 
 private:
     virtual void visit_edges(Visitor&) override;
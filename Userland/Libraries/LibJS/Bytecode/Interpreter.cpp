@@ -366,6 +366,17 @@ FLATTEN_ON_CLANG void Interpreter::run_bytecode(size_t entry_point)
     };
 #undef SET_UP_LABEL
 
+    // While profiling, every instruction is dispatched to its profile_* label first, which shows it to the profiler
+    // before going on to the actual handler. That way, running without a profiler doesn't cost anything extra.
+    static void* const profiling_dispatch_table[] = {
+#define SET_UP_LABEL(name) &&profile_##name,
+        ENUMERATE_BYTECODE_OPS(SET_UP_LABEL)
+    };
+#undef SET_UP_LABEL
+
+    auto* profiler = m_profiler.ptr();
+    void* const* dispatch_table = profiler ? profiling_dispatch_table : bytecode_dispatch_table;
+
 #define DISPATCH_NEXT(name)                                                                         \
     do {                                                                                            \
         if constexpr (Op::name::IsVariableLength)                                                   \
@@ -373,13 +384,22 @@ FLATTEN_ON_CLANG void Interpreter::run_bytecode(size_t entry_point)
         else                                                                                        \
             program_counter += sizeof(Op::name);                                                    \
         auto& next_instruction = *reinterpret_cast<Instruction const*>(&bytecode[program_counter]); \
-        goto* bytecode_dispatch_table[static_cast<size_t>(next_instruction.type())];                \
+        goto* dispatch_table[static_cast<size_t>(next_instruction.type())];                         \
     } while (0)
 
     for (;;) {
     start:
         for (;;) {
-            goto* bytecode_dispatch_table[static_cast<size_t>((*reinterpret_cast<Instruction const*>(&bytecode[program_counter])).type())];
+            goto* dispatch_table[static_cast<size_t>((*reinterpret_cast<Instruction const*>(&bytecode[program_counter])).type())];
+
+#define PROFILE_INSTRUCTION(name)                                     \
+    profile_##name:                                                   \
+    {                                                                 \
+        profiler->will_execute_instruction(Instruction::Type::name);  \
+        goto handle_##name;                                           \
+    }
+            ENUMERATE_BYTECODE_OPS(PROFILE_INSTRUCTION)
+#undef PROFILE_INSTRUCTION
 
         handle_GetArgument: {
             auto const& instruction = *reinterpret_cast<Op::GetArgument const*>(&bytecode[program_counter]);
@@ -732,8 +752,14 @@ Interpreter::ResultAndReturnRegister Interpreter::run_executable(Executable& exe
         running_execution_context.registers_and_constants_and_locals[executable.number_of_registers + i] = executable.constants[i];
     }
 
+    if (m_profiler)
+        m_profiler->will_run_executable();
+
     run_bytecode(entry_point.value_or(0));
 
+    if (m_profiler)
+        m_profiler->did_run_executable();
+
     dbgln_if(JS_BYTECODE_DEBUG, "Bytecode::Interpreter did run unit {:p}", &executable);
 
     if constexpr (JS_BYTECODE_DEBUG) {
@@ -966,7 +992,7 @@ inline ThrowCompletionOr<Value> get_by_id(VM& vm, Optional<IdentifierTableIndex>
 {
     if constexpr (mode == GetByIdMode::Length) {
         if (base_value.is_string()) {
-            return Value(base_value.as_string().utf16_string().length_in_code_units());
+            return Value(base_value.as_string().length_in_utf16_code_units());
         }
     }
 
@@ -981,44 +1007,43 @@ inline ThrowCompletionOr<Value> get_by_id(VM& vm, Optional<IdentifierTableIndex>
 
     auto& shape = base_obj->shape();
 
-    if (cache.prototype) {
-        // OPTIMIZATION: If the prototype chain hasn't been mutated in a way that would invalidate the cache, we can use it.
-        bool can_use_cache = [&]() -> bool {
-            if (&shape != cache.shape)
-                return false;
-            if (!cache.prototype_chain_validity)
-                return false;
-            if (!cache.prototype_chain_validity->is_valid())
-                return false;
-            return true;
-        }();
-        if (can_use_cache) {
-            auto value = cache.prototype->get_direct(cache.property_offset.value());
+    // OPTIMIZATION: Property lookups at a given site tend to see only a few different shapes, so we remember what we found for each of them.
+    for (auto& cache_entry : cache.entries) {
+        if (&shape != cache_entry.shape)
+            continue;
+        if (cache_entry.prototype) {
+            // OPTIMIZATION: If the prototype chain hasn't been mutated in a way that would invalidate the cache, we can use it.
+            if (!cache_entry.prototype_chain_validity || !cache_entry.prototype_chain_validity->is_valid())
+                continue;
+            ++cache.hit_count;
+            auto value = cache_entry.prototype->get_direct(cache_entry.property_offset.value());
             if (value.is_accessor())
                 return TRY(call(vm, value.as_accessor().getter(), this_value));
             return value;
         }
-    } else if (&shape == cache.shape) {
+
         // OPTIMIZATION: If the shape of the object hasn't changed, we can use the cached property offset.
-        auto value = base_obj->get_direct(cache.property_offset.value());
+        ++cache.hit_count;
+        auto value = base_obj->get_direct(cache_entry.property_offset.value());
         if (value.is_accessor())
             return TRY(call(vm, value.as_accessor().getter(), this_value));
         return value;
     }
+    ++cache.miss_count;
 
     CacheablePropertyMetadata cacheable_metadata;
     auto value = TRY(base_obj->internal_get(executable.get_identifier(property), this_value, &cacheable_metadata));
 
     if (cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
-        cache = {};
-        cache.shape = shape;
-        cache.property_offset = cacheable_metadata.property_offset.value();
+        auto& cache_entry = cache.entry_to_fill_for(shape);
+        cache_entry.shape = shape;
+        cache_entry.property_offset = cacheable_metadata.property_offset.value();
     } else if (cacheable_metadata.type == CacheablePropertyMetadata::Type::InPrototypeChain) {
-        cache = {};
-        cache.shape = &base_obj->shape();
-        cache.property_offset = cacheable_metadata.property_offset.value();
-        cache.prototype = *cacheable_metadata.prototype;
-        cache.prototype_chain_validity = *cacheable_metadata.prototype->shape().prototype_chain_validity();
+        auto& cache_entry = cache.entry_to_fill_for(base_obj->shape());
+        cache_entry.shape = &base_obj->shape();
+        cache_entry.property_offset = cacheable_metadata.property_offset.value();
+        cache_entry.prototype = *cacheable_metadata.prototype;
+        cache_entry.prototype_chain_validity = *cacheable_metadata.prototype->shape().prototype_chain_validity();
     }
 
     return value;
@@ -1188,17 +1213,69 @@ inline ThrowCompletionOr<void> put_by_property_key(VM& vm, Value base, Value thi
         break;
     }
     case Op::PropertyKind::KeyValue: {
-        if (cache && cache->shape == &object->shape()) {
-            object->put_direct(*cache->property_offset, value);
-            return {};
+        auto& shape = object->shape();
+        if (cache) {
+            for (auto& cache_entry : cache->entries) {
+                if (cache_entry.from_shape) {
+                    // OPTIMIZATION: If an object of this shape has had the property added by this store before, and nothing along
+                    //               the prototype chain could have changed that since, we can take the same transition.
+                    if (&shape != cache_entry.from_shape || !cache_entry.shape)
+                        continue;
+                    if (shape.prototype() && (!cache_entry.prototype_chain_validity || !cache_entry.prototype_chain_validity->is_valid()))
+                        continue;
+                    if (!this_value.is_object() || &this_value.as_object() != object.ptr())
+                        continue;
+                    // NOTE: Exotic objects may share shapes with ordinary ones, but not the way they add properties.
+                    if (!object->has_ordinary_set_and_define_own_property())
+                        continue;
+                    if (!object->put_direct_with_transition(*cache_entry.shape, value))
+                        continue;
+                    ++cache->hit_count;
+                    return {};
+                }
+                if (&shape == cache_entry.shape) {
+                    ++cache->hit_count;
+                    object->put_direct(*cache_entry.property_offset, value);
+                    return {};
+                }
+            }
+            ++cache->miss_count;
         }
 
         CacheablePropertyMetadata cacheable_metadata;
         bool succeeded = TRY(object->internal_set(name, value, this_value, &cacheable_metadata));
 
         if (succeeded && cache && cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
-            cache->shape = object->shape();
-            cache->property_offset = cacheable_metadata.property_offset.value();
+            auto& cache_entry = cache->entry_to_fill_for(object->shape());
+            cache_entry.shape = object->shape();
+            cache_entry.property_offset = cacheable_metadata.property_offset.value();
+        } else if (succeeded && cache && cacheable_metadata.type == CacheablePropertyMetadata::Type::AddedOwnProperty) {
+            // We can only take the transition again if it added exactly this property to the end of the object's storage,
+            // and if no prototype could start to get in the way without invalidating its prototype chain.
+            auto& new_shape = object->shape();
+            bool can_cache_transition = [&] {
+                if (&new_shape == &shape || shape.is_dictionary() || new_shape.is_dictionary() || shape.is_prototype_shape())
+                    return false;
+                if (new_shape.property_count() != shape.property_count() + 1)
+                    return false;
+                if (!this_value.is_object() || &this_value.as_object() != object.ptr())
+                    return false;
+                if (!object->has_ordinary_set_and_define_own_property())
+                    return false;
+                for (auto const* prototype = shape.prototype(); prototype; prototype = prototype->shape().prototype()) {
+                    if (prototype->shape().is_dictionary() || !prototype->shape().prototype_chain_validity())
+                        return false;
+                }
+                return true;
+            }();
+            if (can_cache_transition) {
+                auto& cache_entry = cache->entry_to_fill_for(shape);
+                cache_entry.from_shape = shape;
+                cache_entry.shape = new_shape;
+                cache_entry.property_offset = shape.property_count();
+                if (auto const* prototype = shape.prototype())
+                    cache_entry.prototype_chain_validity = *prototype->shape().prototype_chain_validity();
+            }
         }
 
         if (!succeeded && vm.in_strict_mode()) {
@@ -1301,6 +1378,7 @@ inline ThrowCompletionOr<void> put_by_value(VM& vm, Value base, Optional<Depreca
                 auto existing_value = maybe_value->value;
                 if (!existing_value.is_accessor()) {
                     storage->put(index, value);
+                    object.did_store_edge(value);
                     return {};
                 }
             }
@@ -1423,7 +1501,7 @@ inline Value new_regexp(VM& vm, ParsedRegex const& parsed_regex, ByteString cons
 
     // 3. Return ! RegExpCreate(pattern, flags).
     auto& realm = *vm.current_realm();
-    Regex<ECMA262> regex(parsed_regex.regex, parsed_regex.pattern, parsed_regex.flags);
+    auto regex = RegexCache<ECMA262>::the().compile(parsed_regex.regex, parsed_regex.pattern, parsed_regex.flags);
     // NOTE: We bypass RegExpCreate and subsequently RegExpAlloc as an optimization to use the already parsed values.
     auto regexp_object = RegExpObject::create(realm, move(regex), pattern, flags);
     // RegExpAlloc has these two steps from the 'Legacy RegExp features' proposal.
@@ -1619,11 +1697,13 @@ inline ThrowCompletionOr<void> append(VM& vm, Value lhs, Value rhs, bool is_spre
         size_t i = lhs_size;
         TRY(get_iterator_values(vm, rhs, [&i, &lhs_array](Value iterator_value) -> Optional<Completion> {
             lhs_array.indexed_properties().put(i, iterator_value, default_attributes);
+            lhs_array.did_store_edge(iterator_value);
             ++i;
             return {};
         }));
     } else {
         lhs_array.indexed_properties().put(lhs_size, rhs, default_attributes);
+        lhs_array.did_store_edge(rhs);
     }
 
     return {};
@@ -8,6 +8,7 @@
 
 #include <LibJS/Bytecode/Executable.h>
 #include <LibJS/Bytecode/Label.h>
+#include <LibJS/Bytecode/Profiler.h>
 #include <LibJS/Bytecode/Register.h>
 #include <LibJS/Forward.h>
 #include <LibJS/Heap/Cell.h>
@@ -80,6 +81,10 @@ public:
 
     ExecutionContext& running_execution_context() { return *m_running_execution_context; }
 
+    // Takes effect for executables that start running after the profiler is installed.
+    void set_profiler(OwnPtr<Profiler> profiler) { m_profiler = move(profiler); }
+    Profiler* profiler() { return m_profiler.ptr(); }
+
 private:
     void run_bytecode(size_t entry_point);
 
@@ -99,6 +104,7 @@ private:
     Span<Value> m_arguments;
     Span<Value> m_registers_and_constants_and_locals;
     ExecutionContext* m_running_execution_context { nullptr };
+    OwnPtr<Profiler> m_profiler;
 };
 
 extern bool g_dump_bytecode;
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/QuickSort.h>
+#include <AK/Stream.h>
+#include <AK/StringBuilder.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Profiler.h>
+#include <LibJS/Runtime/ECMAScriptFunctionObject.h>
+#include <LibJS/Runtime/ExecutionContext.h>
+#include <LibJS/Runtime/PrimitiveString.h>
+#include <LibJS/Runtime/VM.h>
+
+namespace JS::Bytecode {
+
+static constexpr StringView instruction_type_names[] = {
+#define __BYTECODE_OP(op) #op##sv,
+    ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+};
+
+Profiler::Profiler(VM& vm, Options options)
+    : m_vm(vm)
+    , m_options(options)
+{
+    VERIFY(m_options.sampling_interval > Duration::zero());
+}
+
+Profiler::~Profiler() = default;
+
+void Profiler::will_run_executable()
+{
+    // Whatever happened since the interpreter was last left had nothing to do with JS, so it isn't sampled.
+    if (m_executable_depth++ == 0)
+        m_last_sample_time = MonotonicTime::now();
+}
+
+void Profiler::did_run_executable()
+{
+    // The profiler may have been installed while some executable was already running.
+    if (m_executable_depth == 0)
+        return;
+
+    // Pick up time spent in native code since the last instruction, while its caller is still on the stack.
+    if (m_executable_depth == 1)
+        take_sample_if_due();
+    --m_executable_depth;
+}
+
+void Profiler::take_sample_if_due()
+{
+    m_instructions_until_clock_check = instructions_between_clock_checks;
+
+    auto interval_in_nanoseconds = m_options.sampling_interval.to_nanoseconds();
+    auto elapsed_intervals = (MonotonicTime::now() - m_last_sample_time).to_nanoseconds() / interval_in_nanoseconds;
+    if (elapsed_intervals <= 0)
+        return;
+
+    // If we didn't get to look at the clock for a while, the stack we are in now gets all of the intervals that passed.
+    m_last_sample_time += Duration::from_nanoseconds(elapsed_intervals * interval_in_nanoseconds);
+    take_sample(elapsed_intervals);
+}
+
+Profiler::Frame Profiler::frame_for(ExecutionContext const& context)
+{
+    Frame frame;
+    if (context.function_name)
+        frame.function_name = context.function_name->byte_string();
+
+    if (context.function && is<ECMAScriptFunctionObject>(*context.function)) {
+        auto source_range = static_cast<ECMAScriptFunctionObject const&>(*context.function).ecmascript_code().unrealized_source_range();
+        frame.source_code = source_range.source_code;
+        frame.source_offset = source_range.start_offset;
+        if (frame.function_name.is_empty())
+            frame.function_name = "(anonymous)"sv;
+    } else if (context.executable) {
+        frame.source_code = context.executable->source_code;
+        if (frame.function_name.is_empty())
+            frame.function_name = "(top level)"sv;
+    }
+    return frame;
+}
+
+void Profiler::take_sample(u64 weight)
+{
+    m_frames.clear_with_capacity();
+    for (auto const* context : m_vm.execution_context_stack())
+        m_frames.append(frame_for(*context));
+
+    auto* node = &m_root;
+    for (auto& frame : m_frames) {
+        Node* child = nullptr;
+        for (auto& candidate : node->children) {
+            if (candidate->frame == frame) {
+                child = candidate.ptr();
+                break;
+            }
+        }
+        if (!child) {
+            auto new_child = make<Node>();
+            new_child->frame = move(frame);
+            child = new_child.ptr();
+            node->children.append(move(new_child));
+        }
+        node = child;
+    }
+
+    node->sample_count += weight;
+    m_sample_count += weight;
+}
+
+ErrorOr<void> Profiler::write_folded_stacks(Stream& stream) const
+{
+    StringBuilder stack;
+    for (auto const& child : m_root.children)
+        TRY(write_folded_stacks(stream, *child, stack));
+    return {};
+}
+
+ErrorOr<void> Profiler::write_folded_stacks(Stream& stream, Node const& node, StringBuilder& stack) const
+{
+    auto length_before_frame = stack.length();
+    if (length_before_frame != 0)
+        stack.append(';');
+
+    // Semicolons separate the frames and newlines the stacks, so neither can appear in a frame.
+    for (auto ch : node.frame.function_name.view())
+        stack.append(ch == ';' || ch == '\n' ? ' ' : ch);
+    if (node.frame.source_code) {
+        auto position = node.frame.source_code->range_from_offsets(node.frame.source_offset, node.frame.source_offset).start;
+        auto filename = node.frame.source_code->filename().bytes_as_string_view();
+        stack.appendff(" ({}:{}:{})", filename.replace(";"sv, " "sv, ReplaceMode::All), position.line, position.column);
+    }
+
+    if (node.sample_count != 0)
+        TRY(stream.write_formatted("{} {}\n", stack.string_view(), node.sample_count));
+
+    for (auto const& child : node.children)
+        TRY(write_folded_stacks(stream, *child, stack));
+
+    stack.trim(stack.length() - length_before_frame);
+    return {};
+}
+
+ErrorOr<void> Profiler::write_instruction_counts(Stream& stream) const
+{
+    Vector<size_t, instruction_type_count> types;
+    u64 total_count = 0;
+    for (size_t type = 0; type < instruction_type_count; ++type) {
+        if (m_instruction_counts[type] == 0)
+            continue;
+        types.append(type);
+        total_count += m_instruction_counts[type];
+    }
+    quick_sort(types, [&](auto a, auto b) { return m_instruction_counts[a] > m_instruction_counts[b]; });
+
+    for (auto type : types) {
+        auto count = m_instruction_counts[type];
+        TRY(stream.write_formatted("{:>14} {:>6.2}%  {}\n", count, static_cast<double>(count) * 100 / total_count, instruction_type_names[type]));
+    }
+    TRY(stream.write_formatted("{:>14}          total\n", total_count));
+    return {};
+}
+
+}
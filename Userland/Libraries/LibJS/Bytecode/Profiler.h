@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/ByteString.h>
+#include <AK/Forward.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/RefPtr.h>
+#include <AK/Time.h>
+#include <AK/Vector.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Forward.h>
+#include <LibJS/SourceCode.h>
+
+namespace JS::Bytecode {
+
+// Samples the JS call stack at a fixed interval while bytecode is running, and optionally counts how often each kind of
+// instruction is executed. While a profiler is installed, the interpreter runs every instruction past it first.
+//
+// Samples are only taken between instructions, so time spent in native code is attributed to the JS stack that
+// called it once the next instruction runs. Time spent outside of the interpreter altogether isn't attributed at all.
+class Profiler {
+    AK_MAKE_NONCOPYABLE(Profiler);
+    AK_MAKE_NONMOVABLE(Profiler);
+
+public:
+    struct Options {
+        Duration sampling_interval { Duration::from_milliseconds(1) };
+        bool count_instructions { false };
+    };
+
+    Profiler(VM&, Options);
+    ~Profiler();
+
+    ALWAYS_INLINE void will_execute_instruction(Instruction::Type type)
+    {
+        if (m_options.count_instructions)
+            ++m_instruction_counts[to_underlying(type)];
+        // Looking at the clock for every instruction would slow everything down a lot more than the sampling itself.
+        if (--m_instructions_until_clock_check == 0)
+            take_sample_if_due();
+    }
+
+    void will_run_executable();
+    void did_run_executable();
+
+    u64 sample_count() const { return m_sample_count; }
+    u64 instruction_count(Instruction::Type type) const { return m_instruction_counts[to_underlying(type)]; }
+
+    // Writes the sampled stacks in the "folded" format understood by flamegraph.pl, speedscope and friends: one line
+    // per distinct stack, with the frames from the outermost inwards separated by semicolons, followed by the number
+    // of samples that were taken in it.
+    ErrorOr<void> write_folded_stacks(Stream&) const;
+
+    ErrorOr<void> write_instruction_counts(Stream&) const;
+
+private:
+    static constexpr u32 instructions_between_clock_checks = 1024;
+    static constexpr size_t instruction_type_count = 0
+#define __BYTECODE_OP(op) +1
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+        ;
+
+    // A JS function, or the top-level code of a script or module.
+    struct Frame {
+        ByteString function_name;
+        RefPtr<SourceCode const> source_code;
+        u32 source_offset { 0 };
+
+        bool operator==(Frame const&) const = default;
+    };
+
+    struct Node {
+        Frame frame;
+        u64 sample_count { 0 };
+        Vector<NonnullOwnPtr<Node>> children;
+    };
+
+    static Frame frame_for(ExecutionContext const&);
+    void take_sample_if_due();
+    void take_sample(u64 weight);
+
+    ErrorOr<void> write_folded_stacks(Stream&, Node const&, StringBuilder& stack) const;
+
+    VM& m_vm;
+    Options m_options;
+
+    Node m_root;
+    u64 m_sample_count { 0 };
+    Vector<Frame> m_frames;
+
+    size_t m_executable_depth { 0 };
+    MonotonicTime m_last_sample_time { MonotonicTime::now() };
+    u32 m_instructions_until_clock_check { instructions_between_clock_checks };
+
+    AK::Array<u64, instruction_type_count> m_instruction_counts {};
+};
+
+}
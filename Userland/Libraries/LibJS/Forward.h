@@ -154,6 +154,7 @@ namespace JS {
 class ASTNode;
 class Accessor;
 struct AsyncGeneratorRequest;
+class BackgroundParser;
 class BigInt;
 class BoundFunction;
 class Cell;
@@ -198,6 +199,7 @@ class Parser;
 struct ParserError;
 class PrimitiveString;
 class Program;
+class ProgramCache;
 class PromiseCapability;
 class PromiseReaction;
 class PropertyAttributes;
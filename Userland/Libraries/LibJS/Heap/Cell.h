@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Badge.h>
 #include <AK/Format.h>
 #include <AK/Forward.h>
@@ -27,15 +28,52 @@ namespace JS {
 #    define IGNORE_GC
 #endif
 
-#define JS_CELL(class_, base_class)                \
-public:                                            \
-    using Base = base_class;                       \
-    virtual StringView class_name() const override \
-    {                                              \
-        return #class_##sv;                        \
-    }                                              \
+#define JS_CELL(class_, base_class)                                    \
+public:                                                                \
+    using Base = base_class;                                           \
+    virtual StringView class_name() const override                     \
+    {                                                                  \
+        return #class_##sv;                                            \
+    }                                                                  \
+    virtual bool uses_write_barrier() const override                   \
+    {                                                                  \
+        return JS::Detail::class_uses_write_barrier<class_>();         \
+    }                                                                  \
     friend class JS::Heap;
 
+// Opts a cell class into the write barrier, see Cell::uses_write_barrier(). This isn't inherited by subclasses, as they
+// may add edges of their own.
+#define JS_USES_WRITE_BARRIER(class_) \
+public:                               \
+    using WriteBarrierClass = class_
+
+// Opts a cell class with its own allocator into lazy sweeping, see CellAllocator::sweeps_lazily(). Its finalize() must
+// do nothing, its destructor may only release memory that the cell owns, and nothing may point to it weakly. This isn't
+// inherited by subclasses.
+#define JS_SWEEPS_LAZILY(class_) \
+public:                          \
+    using LazilySweptClass = class_
+
+namespace Detail {
+
+template<typename T>
+constexpr bool class_uses_write_barrier()
+{
+    if constexpr (requires { typename T::WriteBarrierClass; })
+        return IsSame<typename T::WriteBarrierClass, T>;
+    return false;
+}
+
+template<typename T>
+constexpr bool class_sweeps_lazily()
+{
+    if constexpr (requires { typename T::LazilySweptClass; })
+        return IsSame<typename T::LazilySweptClass, T>;
+    return false;
+}
+
+}
+
 class Cell : public Weakable<Cell> {
     AK_MAKE_NONCOPYABLE(Cell);
     AK_MAKE_NONMOVABLE(Cell);
@@ -47,6 +85,14 @@ public:
     bool is_marked() const { return m_mark; }
     void set_marked(bool b) { m_mark = b; }
 
+    // Marks the cell and returns whether it was already marked. This is safe to call from several marking threads at once.
+    bool test_and_set_marked()
+    {
+        if (AK::atomic_load(&m_mark, AK::memory_order_relaxed))
+            return true;
+        return AK::atomic_exchange(&m_mark, true, AK::memory_order_relaxed);
+    }
+
     enum class State : bool {
         Live,
         Dead,
@@ -55,8 +101,33 @@ public:
     State state() const { return m_state; }
     void set_state(State state) { m_state = state; }
 
+    // Cells start out young and become old once they have survived a garbage collection.
+    bool is_old() const { return m_old; }
+    void set_old(bool b) { m_old = b; }
+
     virtual StringView class_name() const = 0;
 
+    // Cells of classes that use the write barrier call did_store_edge() whenever they store a pointer to another cell
+    // after being constructed, which assigning to a GCPtr member does by itself. An old cell that starts pointing to a
+    // young one is put in the heap's remembered set, and only those are looked at when collecting the young generation.
+    // All old cells of other classes have to be looked at, as any of their stores may have created such an edge.
+    virtual bool uses_write_barrier() const { return false; }
+
+    ALWAYS_INLINE void did_store_edge(Cell const* target)
+    {
+        if (m_old && !m_remembered && target && !target->m_old)
+            remember();
+    }
+
+    ALWAYS_INLINE void did_store_edge(Value const& value)
+    {
+        if (m_old && !m_remembered)
+            did_store_edge_slow(value);
+    }
+
+    bool is_remembered() const { return m_remembered; }
+    void set_remembered(Badge<Heap>, bool b) { m_remembered = b; }
+
     class Visitor {
     public:
         void visit(Cell* cell)
@@ -177,9 +248,15 @@ protected:
     void set_overrides_must_survive_garbage_collection(bool b) { m_overrides_must_survive_garbage_collection = b; }
 
 private:
-    bool m_mark : 1 { false };
+    void remember();
+    void did_store_edge_slow(Value const&);
+
+    // NOTE: This isn't part of the bitfield below, so marking threads can set it without touching the other flags.
+    bool m_mark { false };
     bool m_overrides_must_survive_garbage_collection : 1 { false };
     State m_state : 1 { State::Live };
+    bool m_old : 1 { false };
+    bool m_remembered : 1 { false };
 };
 
 }
@@ -12,9 +12,10 @@
 
 namespace JS {
 
-CellAllocator::CellAllocator(size_t cell_size, char const* class_name)
+CellAllocator::CellAllocator(size_t cell_size, char const* class_name, SweepsLazily sweeps_lazily)
     : m_class_name(class_name)
     , m_cell_size(cell_size)
+    , m_sweeps_lazily(sweeps_lazily)
 {
 }
 
@@ -23,6 +24,10 @@ Cell* CellAllocator::allocate_cell(Heap& heap)
     if (!m_list_node.is_in_list())
         heap.register_cell_allocator({}, *this);
 
+    // Blocks that the last collection left unswept are reused before any new ones are created.
+    while (m_usable_blocks.is_empty() && !m_unswept_blocks.is_empty())
+        sweep_unswept_block(*m_unswept_blocks.first());
+
     if (m_usable_blocks.is_empty()) {
         auto block = HeapBlock::create_with_cell_size(heap, *this, m_cell_size, m_class_name);
         auto block_ptr = reinterpret_cast<FlatPtr>(block.ptr());
@@ -30,6 +35,7 @@ Cell* CellAllocator::allocate_cell(Heap& heap)
             m_min_block_address = block_ptr;
         if (m_max_block_address < block_ptr)
             m_max_block_address = block_ptr;
+        heap.did_create_heap_block({}, *block);
         m_usable_blocks.append(*block.leak_ptr());
     }
 
@@ -43,10 +49,7 @@ Cell* CellAllocator::allocate_cell(Heap& heap)
 
 void CellAllocator::block_did_become_empty(Badge<Heap>, HeapBlock& block)
 {
-    block.m_list_node.remove();
-    // NOTE: HeapBlocks are managed by the BlockAllocator, so we don't want to `delete` the block here.
-    block.~HeapBlock();
-    m_block_allocator.deallocate_block(&block);
+    destroy_block(block);
 }
 
 void CellAllocator::block_did_become_usable(Badge<Heap>, HeapBlock& block)
@@ -55,4 +58,37 @@ void CellAllocator::block_did_become_usable(Badge<Heap>, HeapBlock& block)
     m_usable_blocks.append(block);
 }
 
+void CellAllocator::block_was_left_unswept(Badge<Heap>, HeapBlock& block)
+{
+    VERIFY(sweeps_lazily());
+    m_unswept_blocks.append(block);
+}
+
+void CellAllocator::sweep_unswept_blocks(Badge<Heap>)
+{
+    while (!m_unswept_blocks.is_empty())
+        sweep_unswept_block(*m_unswept_blocks.first());
+}
+
+void CellAllocator::sweep_unswept_block(HeapBlock& block)
+{
+    if (!block.heap().sweep_unswept_block({}, block)) {
+        destroy_block(block);
+        return;
+    }
+    if (block.is_full())
+        m_full_blocks.append(block);
+    else
+        m_usable_blocks.append(block);
+}
+
+void CellAllocator::destroy_block(HeapBlock& block)
+{
+    block.m_list_node.remove();
+    block.heap().did_destroy_heap_block({}, block);
+    // NOTE: HeapBlocks are managed by the BlockAllocator, so we don't want to `delete` the block here.
+    block.~HeapBlock();
+    m_block_allocator.deallocate_block(&block);
+}
+
 }
@@ -23,11 +23,20 @@ namespace JS {
 
 class CellAllocator {
 public:
-    CellAllocator(size_t cell_size, char const* class_name = nullptr);
+    enum class SweepsLazily {
+        No,
+        Yes,
+    };
+
+    CellAllocator(size_t cell_size, char const* class_name = nullptr, SweepsLazily = SweepsLazily::No);
     ~CellAllocator() = default;
 
     size_t cell_size() const { return m_cell_size; }
 
+    // Full collections leave the blocks of allocators that sweep lazily as they are, and their cells keep the mark bits
+    // from the collection. A block is swept once it's needed for an allocation, or at the start of the next collection.
+    bool sweeps_lazily() const { return m_sweeps_lazily == SweepsLazily::Yes; }
+
     Cell* allocate_cell(Heap&);
 
     template<typename Callback>
@@ -41,11 +50,19 @@ public:
             if (callback(block) == IterationDecision::Break)
                 return IterationDecision::Break;
         }
+        for (auto& block : m_unswept_blocks) {
+            if (callback(block) == IterationDecision::Break)
+                return IterationDecision::Break;
+        }
         return IterationDecision::Continue;
     }
 
     void block_did_become_empty(Badge<Heap>, HeapBlock&);
     void block_did_become_usable(Badge<Heap>, HeapBlock&);
+    void block_was_left_unswept(Badge<Heap>, HeapBlock&);
+
+    bool has_unswept_blocks() const { return !m_unswept_blocks.is_empty(); }
+    void sweep_unswept_blocks(Badge<Heap>);
 
     IntrusiveListNode<CellAllocator> m_list_node;
     using List = IntrusiveList<&CellAllocator::m_list_node>;
@@ -55,14 +72,19 @@ public:
     FlatPtr max_block_address() const { return m_max_block_address; }
 
 private:
+    void sweep_unswept_block(HeapBlock&);
+    void destroy_block(HeapBlock&);
+
     char const* const m_class_name { nullptr };
     size_t const m_cell_size;
+    SweepsLazily const m_sweeps_lazily { SweepsLazily::No };
 
     BlockAllocator m_block_allocator;
 
     using BlockList = IntrusiveList<&HeapBlock::m_list_node>;
     BlockList m_full_blocks;
     BlockList m_usable_blocks;
+    BlockList m_unswept_blocks;
     FlatPtr m_min_block_address { explode_byte(0xff) };
     FlatPtr m_max_block_address { 0 };
 };
@@ -73,7 +95,7 @@ public:
     using CellType = T;
 
     TypeIsolatingCellAllocator(char const* class_name)
-        : allocator(sizeof(T), class_name)
+        : allocator(sizeof(T), class_name, Detail::class_sweeps_lazily<T>() ? CellAllocator::SweepsLazily::Yes : CellAllocator::SweepsLazily::No)
     {
     }
 
@@ -6,11 +6,31 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
+#include <AK/Platform.h>
 #include <AK/Traits.h>
 #include <AK/Types.h>
 
 namespace JS {
 
+namespace Detail {
+
+// The number of heaps that currently keep track of generations, see Heap::set_generational_collection_enabled().
+extern size_t g_generational_heap_count;
+
+void gc_pointer_write_barrier_slow(void const* slot, void const* target);
+
+// Storing a pointer to a young cell in a GCPtr that is a member of an old cell puts that cell in the remembered set
+// of its heap. GCPtrs that don't live inside of a cell (on the stack, in out-of-line vectors, etc.) are ignored, and so
+// are the ones being constructed, as a cell that is still being constructed can't be old.
+ALWAYS_INLINE void gc_pointer_write_barrier(void const* slot, void const* target)
+{
+    if (target && AK::atomic_load(&g_generational_heap_count, AK::memory_order_relaxed))
+        gc_pointer_write_barrier_slow(slot, target);
+}
+
+}
+
 template<typename T>
 class GCPtr;
 
@@ -38,17 +58,25 @@ public:
     {
     }
 
+    NonnullGCPtr(NonnullGCPtr const&) = default;
+
+    NonnullGCPtr& operator=(NonnullGCPtr const& other)
+    {
+        assign(other.ptr());
+        return *this;
+    }
+
     template<typename U>
     NonnullGCPtr& operator=(NonnullGCPtr<U> const& other)
     requires(IsConvertible<U*, T*>)
     {
-        m_ptr = static_cast<T*>(other.ptr());
+        assign(static_cast<T*>(other.ptr()));
         return *this;
     }
 
     NonnullGCPtr& operator=(T& other)
     {
-        m_ptr = &other;
+        assign(&other);
         return *this;
     }
 
@@ -56,7 +84,7 @@ public:
     NonnullGCPtr& operator=(U& other)
     requires(IsConvertible<U*, T*>)
     {
-        m_ptr = &static_cast<T&>(other);
+        assign(&static_cast<T&>(other));
         return *this;
     }
 
@@ -71,6 +99,12 @@ public:
     operator T&() const { return *m_ptr; }
 
 private:
+    ALWAYS_INLINE void assign(T* ptr)
+    {
+        Detail::gc_pointer_write_barrier(this, ptr);
+        m_ptr = ptr;
+    }
+
     T* m_ptr { nullptr };
 };
 
@@ -113,17 +147,25 @@ public:
     {
     }
 
+    GCPtr(GCPtr const&) = default;
+
+    GCPtr& operator=(GCPtr const& other)
+    {
+        assign(other.ptr());
+        return *this;
+    }
+
     template<typename U>
     GCPtr& operator=(GCPtr<U> const& other)
     requires(IsConvertible<U*, T*>)
     {
-        m_ptr = static_cast<T*>(other.ptr());
+        assign(static_cast<T*>(other.ptr()));
         return *this;
     }
 
     GCPtr& operator=(NonnullGCPtr<T> const& other)
     {
-        m_ptr = other.ptr();
+        assign(other.ptr());
         return *this;
     }
 
@@ -131,13 +173,13 @@ public:
     GCPtr& operator=(NonnullGCPtr<U> const& other)
     requires(IsConvertible<U*, T*>)
     {
-        m_ptr = static_cast<T*>(other.ptr());
+        assign(static_cast<T*>(other.ptr()));
         return *this;
     }
 
     GCPtr& operator=(T& other)
     {
-        m_ptr = &other;
+        assign(&other);
         return *this;
     }
 
@@ -145,13 +187,13 @@ public:
     GCPtr& operator=(U& other)
     requires(IsConvertible<U*, T*>)
     {
-        m_ptr = &static_cast<T&>(other);
+        assign(&static_cast<T&>(other));
         return *this;
     }
 
     GCPtr& operator=(T* other)
     {
-        m_ptr = other;
+        assign(other);
         return *this;
     }
 
@@ -159,7 +201,7 @@ public:
     GCPtr& operator=(U* other)
     requires(IsConvertible<U*, T*>)
     {
-        m_ptr = static_cast<T*>(other);
+        assign(static_cast<T*>(other));
         return *this;
     }
 
@@ -183,6 +225,12 @@ public:
     operator T*() const { return m_ptr; }
 
 private:
+    ALWAYS_INLINE void assign(T* ptr)
+    {
+        Detail::gc_pointer_write_barrier(this, ptr);
+        m_ptr = ptr;
+    }
+
     T* m_ptr { nullptr };
 };
 
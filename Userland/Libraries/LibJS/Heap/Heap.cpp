@@ -6,6 +6,7 @@
  */
 
 #include <AK/Badge.h>
+#include <AK/BuiltinWrappers.h>
 #include <AK/Debug.h>
 #include <AK/HashTable.h>
 #include <AK/JsonArray.h>
@@ -22,6 +23,9 @@
 #include <LibJS/Runtime/Object.h>
 #include <LibJS/Runtime/WeakContainer.h>
 #include <LibJS/SafeFunction.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/ThreadPool.h>
 #include <setjmp.h>
 
 #ifdef AK_OS_SERENITY
@@ -63,8 +67,9 @@ Heap::Heap(VM& vm)
 Heap::~Heap()
 {
     vm().string_cache().clear();
-    vm().byte_string_cache().clear();
+    vm().utf16_string_cache().clear();
     collect_garbage(CollectionType::CollectEverything);
+    set_generational_collection_enabled(false);
 }
 
 void Heap::will_allocate(size_t size)
@@ -72,6 +77,11 @@ void Heap::will_allocate(size_t size)
     if (should_collect_on_every_allocation()) {
         m_allocated_bytes_since_last_gc = 0;
         collect_garbage();
+    } else if (m_generational_collection_enabled) {
+        if (m_allocated_bytes_since_last_gc + size > YOUNG_GENERATION_BYTES_THRESHOLD) {
+            m_allocated_bytes_since_last_gc = 0;
+            collect_garbage(CollectionType::CollectYoungGeneration);
+        }
     } else if (m_allocated_bytes_since_last_gc + size > m_gc_bytes_threshold) {
         m_allocated_bytes_since_last_gc = 0;
         collect_garbage();
@@ -253,6 +263,7 @@ private:
 
 AK::JsonObject Heap::dump_graph()
 {
+    sweep_unswept_blocks();
     HashMap<Cell*, HeapRoot> roots;
     gather_roots(roots);
     GraphConstructorVisitor visitor(*this, roots);
@@ -271,20 +282,83 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
 #endif
 
     Core::ElapsedTimer collection_measurement_timer;
-    if (print_report)
-        collection_measurement_timer.start();
+    collection_measurement_timer.start();
 
-    if (collection_type == CollectionType::CollectGarbage) {
-        if (m_gc_deferrals) {
-            m_should_gc_when_deferral_ends = true;
-            return;
+    // Once enough cells have been promoted since the last full collection, the old generation needs to be looked at again.
+    if (collection_type == CollectionType::CollectYoungGeneration) {
+        if (!m_generational_collection_enabled || m_promoted_bytes_since_last_full_gc > m_gc_bytes_threshold)
+            collection_type = CollectionType::CollectGarbage;
+    }
+
+    if (collection_type != CollectionType::CollectEverything && m_gc_deferrals) {
+        m_should_gc_when_deferral_ends = true;
+        if (collection_type == CollectionType::CollectGarbage)
+            m_collection_type_when_deferral_ends = CollectionType::CollectGarbage;
+        return;
+    }
+
+    // Liveness is only tracked through mark bits in unswept blocks, and marking is about to change them.
+    sweep_unswept_blocks();
+
+    if (collection_type == CollectionType::CollectYoungGeneration) {
+        collect_young_generation(print_report, collection_measurement_timer);
+        m_young_collection_pause_times.record(collection_measurement_timer.elapsed_time());
+    } else {
+        if (collection_type == CollectionType::CollectGarbage) {
+            HashMap<Cell*, HeapRoot> roots;
+            gather_roots(roots);
+            mark_live_cells(roots);
         }
-        HashMap<Cell*, HeapRoot> roots;
-        gather_roots(roots);
-        mark_live_cells(roots);
+        finalize_unmarked_cells();
+        sweep_dead_cells(collection_type == CollectionType::CollectEverything ? SweepLazily::No : SweepLazily::Yes, print_report, collection_measurement_timer);
+        m_full_collection_pause_times.record(collection_measurement_timer.elapsed_time());
+    }
+
+    if (print_report) {
+        m_full_collection_pause_times.dump("Full collection"sv);
+        m_young_collection_pause_times.dump("Young generation collection"sv);
+    }
+}
+
+void Heap::PauseTimeHistogram::record(Duration pause_time)
+{
+    auto microseconds = static_cast<u64>(max<i64>(pause_time.to_microseconds(), 0));
+    auto bucket = min<size_t>(sizeof(u64) * 8 - count_leading_zeroes_safe(microseconds), bucket_count - 1);
+    ++m_buckets[bucket];
+    ++m_pause_count;
+    m_longest_pause = max(m_longest_pause, pause_time);
+}
+
+// Returns an upper bound for the given percentile, as precise as the buckets allow.
+Duration Heap::PauseTimeHistogram::percentile(size_t percent) const
+{
+    auto rank = ceil_div(m_pause_count * percent, static_cast<size_t>(100));
+    size_t pause_count = 0;
+    for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+        pause_count += m_buckets[bucket];
+        if (pause_count >= rank)
+            return min(Duration::from_microseconds(1ll << bucket), m_longest_pause);
     }
-    finalize_unmarked_cells();
-    sweep_dead_cells(print_report, collection_measurement_timer);
+    return m_longest_pause;
+}
+
+void Heap::PauseTimeHistogram::dump(StringView name) const
+{
+    if (m_pause_count == 0)
+        return;
+
+    dbgln("{} pause times", name);
+    dbgln("=============================================");
+    dbgln("    Collections: {}", m_pause_count);
+    dbgln("            p50: <= {} us", percentile(50).to_microseconds());
+    dbgln("            p90: <= {} us", percentile(90).to_microseconds());
+    dbgln("            p99: <= {} us", percentile(99).to_microseconds());
+    dbgln("            Max: {} us", m_longest_pause.to_microseconds());
+    for (size_t bucket = 0; bucket < bucket_count; ++bucket) {
+        if (m_buckets[bucket] != 0)
+            dbgln("    < {:>8} us: {}", 1ull << bucket, m_buckets[bucket]);
+    }
+    dbgln("=============================================");
 }
 
 void Heap::gather_roots(HashMap<Cell*, HeapRoot>& roots)
@@ -388,29 +462,112 @@ NO_SANITIZE_ADDRESS void Heap::gather_conservative_roots(HashMap<Cell*, HeapRoot
     });
 }
 
+// Marking work that any marking thread can pick up. Every thread works on a stack of cells of its own, and only hands
+// out part of it while other threads have run out of work.
+class SharedMarkingWorklist {
+    AK_MAKE_NONCOPYABLE(SharedMarkingWorklist);
+    AK_MAKE_NONMOVABLE(SharedMarkingWorklist);
+
+public:
+    explicit SharedMarkingWorklist(size_t thread_count)
+        : m_thread_count(thread_count)
+    {
+    }
+
+    bool has_idle_threads() const { return m_idle_thread_count.load(AK::MemoryOrder::memory_order_relaxed) > 0; }
+
+    void give(Vector<NonnullGCPtr<Cell>> cells)
+    {
+        Threading::MutexLocker locker(m_mutex);
+        m_chunks.append(move(cells));
+        m_work_available.signal();
+    }
+
+    // Blocks until there is work to take. Returns false once all threads have run out of work.
+    bool take(Vector<NonnullGCPtr<Cell>>& cells)
+    {
+        Threading::MutexLocker locker(m_mutex);
+        m_idle_thread_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        while (m_chunks.is_empty() && !m_done) {
+            if (m_idle_thread_count.load(AK::MemoryOrder::memory_order_relaxed) == m_thread_count) {
+                m_done = true;
+                m_work_available.broadcast();
+                break;
+            }
+            m_work_available.wait();
+        }
+        if (m_done)
+            return false;
+
+        cells = m_chunks.take_last();
+        m_idle_thread_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    Threading::Mutex m_mutex;
+    Threading::ConditionVariable m_work_available { m_mutex };
+    Vector<Vector<NonnullGCPtr<Cell>>> m_chunks;
+    Atomic<size_t> m_idle_thread_count { 0 };
+    size_t const m_thread_count;
+    bool m_done { false };
+};
+
+class MarkingThreadPool final : public Threading::ThreadPool<Function<void()>> {
+public:
+    explicit MarkingThreadPool(size_t thread_count)
+        : ThreadPool([](Function<void()> work) { work(); }, thread_count)
+    {
+    }
+};
+
 class MarkingVisitor final : public Cell::Visitor {
 public:
-    explicit MarkingVisitor(Heap& heap, HashMap<Cell*, HeapRoot> const& roots)
-        : m_heap(heap)
+    enum class OnlyYoungCells {
+        No,
+        Yes,
+    };
+
+    // The blocks that possible pointers are checked against. They don't change while marking.
+    struct LiveHeapBlocks {
+        HashTable<HeapBlock*> blocks;
+        FlatPtr min_address { 0 };
+        FlatPtr max_address { 0 };
+    };
+
+    static LiveHeapBlocks gather_live_heap_blocks(Heap& heap)
     {
-        m_heap.find_min_and_max_block_addresses(m_min_block_address, m_max_block_address);
-        m_heap.for_each_block([&](auto& block) {
-            m_all_live_heap_blocks.set(&block);
+        LiveHeapBlocks live_heap_blocks;
+        heap.find_min_and_max_block_addresses(live_heap_blocks.min_address, live_heap_blocks.max_address);
+        heap.for_each_block([&](auto& block) {
+            live_heap_blocks.blocks.set(&block);
             return IterationDecision::Continue;
         });
+        return live_heap_blocks;
+    }
 
-        for (auto* root : roots.keys()) {
-            visit(root);
-        }
+    explicit MarkingVisitor(LiveHeapBlocks const& live_heap_blocks, OnlyYoungCells only_young_cells = OnlyYoungCells::No)
+        : m_live_heap_blocks(live_heap_blocks)
+        , m_only_young_cells(only_young_cells == OnlyYoungCells::Yes)
+    {
+    }
+
+    // Every marking thread has a visitor of its own, which shares work with the others through the worklist.
+    MarkingVisitor(MarkingVisitor const& other, SharedMarkingWorklist& shared_worklist)
+        : m_live_heap_blocks(other.m_live_heap_blocks)
+        , m_only_young_cells(other.m_only_young_cells)
+        , m_shared_worklist(&shared_worklist)
+    {
     }
 
+    void share_work_with(SharedMarkingWorklist& shared_worklist) { m_shared_worklist = &shared_worklist; }
+
     virtual void visit_impl(Cell& cell) override
     {
-        if (cell.is_marked())
+        if (!try_mark(cell))
             return;
         dbgln_if(HEAP_DEBUG, "  ! {}", &cell);
 
-        cell.set_marked(true);
         m_work_queue.append(cell);
     }
 
@@ -420,40 +577,74 @@ public:
 
         auto* raw_pointer_sized_values = reinterpret_cast<FlatPtr const*>(bytes.data());
         for (size_t i = 0; i < (bytes.size() / sizeof(FlatPtr)); ++i)
-            add_possible_value(possible_pointers, raw_pointer_sized_values[i], HeapRoot { .type = HeapRoot::Type::HeapFunctionCapturedPointer }, m_min_block_address, m_max_block_address);
+            add_possible_value(possible_pointers, raw_pointer_sized_values[i], HeapRoot { .type = HeapRoot::Type::HeapFunctionCapturedPointer }, m_live_heap_blocks.min_address, m_live_heap_blocks.max_address);
 
-        for_each_cell_among_possible_pointers(m_all_live_heap_blocks, possible_pointers, [&](Cell* cell, FlatPtr) {
-            if (cell->is_marked())
-                return;
+        for_each_cell_among_possible_pointers(m_live_heap_blocks.blocks, possible_pointers, [&](Cell* cell, FlatPtr) {
             if (cell->state() != Cell::State::Live)
                 return;
-            cell->set_marked(true);
+            if (!try_mark(*cell))
+                return;
             m_work_queue.append(*cell);
         });
     }
 
     void mark_all_live_cells()
     {
-        while (!m_work_queue.is_empty()) {
-            m_work_queue.take_last()->visit_edges(*this);
-        }
+        do {
+            while (!m_work_queue.is_empty()) {
+                m_work_queue.take_last()->visit_edges(*this);
+                if (m_shared_worklist)
+                    share_work_if_needed();
+            }
+        } while (m_shared_worklist && m_shared_worklist->take(m_work_queue));
     }
 
 private:
-    Heap& m_heap;
+    // Returns whether the cell was newly marked, and so still needs to be visited.
+    bool try_mark(Cell& cell)
+    {
+        if (m_only_young_cells && cell.is_old())
+            return false;
+        if (m_shared_worklist)
+            return !cell.test_and_set_marked();
+        if (cell.is_marked())
+            return false;
+        cell.set_marked(true);
+        return true;
+    }
+
+    void share_work_if_needed()
+    {
+        static constexpr size_t min_cells_to_share = 64;
+        if (m_work_queue.size() < 2 * min_cells_to_share || !m_shared_worklist->has_idle_threads())
+            return;
+
+        // The bottom of the stack was pushed first, so it's the part we're least likely to get to soon.
+        auto cells_to_share = m_work_queue.size() / 2;
+        Vector<NonnullGCPtr<Cell>> cells;
+        cells.ensure_capacity(cells_to_share);
+        for (size_t i = 0; i < cells_to_share; ++i)
+            cells.unchecked_append(m_work_queue[i]);
+        m_work_queue.remove(0, cells_to_share);
+        m_shared_worklist->give(move(cells));
+    }
+
+    LiveHeapBlocks const& m_live_heap_blocks;
+    bool m_only_young_cells { false };
+    SharedMarkingWorklist* m_shared_worklist { nullptr };
     Vector<NonnullGCPtr<Cell>> m_work_queue;
-    HashTable<HeapBlock*> m_all_live_heap_blocks;
-    FlatPtr m_min_block_address;
-    FlatPtr m_max_block_address;
 };
 
 void Heap::mark_live_cells(HashMap<Cell*, HeapRoot> const& roots)
 {
     dbgln_if(HEAP_DEBUG, "mark_live_cells:");
 
-    MarkingVisitor visitor(*this, roots);
+    auto live_heap_blocks = MarkingVisitor::gather_live_heap_blocks(*this);
+    MarkingVisitor visitor(live_heap_blocks);
+    for (auto* root : roots.keys())
+        visitor.visit(root);
 
-    visitor.mark_all_live_cells();
+    mark_all_reachable_cells(visitor);
 
     for (auto& inverse_root : m_uprooted_cells)
         inverse_root->set_marked(false);
@@ -461,6 +652,36 @@ void Heap::mark_live_cells(HashMap<Cell*, HeapRoot> const& roots)
     m_uprooted_cells.clear();
 }
 
+void Heap::mark_all_reachable_cells(MarkingVisitor& visitor)
+{
+    if (!m_marking_thread_pool) {
+        visitor.mark_all_live_cells();
+        return;
+    }
+
+    SharedMarkingWorklist shared_worklist(m_marking_thread_count);
+    visitor.share_work_with(shared_worklist);
+    for (size_t i = 1; i < m_marking_thread_count; ++i) {
+        m_marking_thread_pool->submit([&visitor, &shared_worklist] {
+            MarkingVisitor helper_visitor(visitor, shared_worklist);
+            helper_visitor.mark_all_live_cells();
+        });
+    }
+    visitor.mark_all_live_cells();
+    m_marking_thread_pool->wait_for_all();
+}
+
+void Heap::set_marking_thread_count(size_t thread_count)
+{
+    VERIFY(!m_collecting_garbage);
+
+    m_marking_thread_count = max<size_t>(thread_count, 1);
+    if (m_marking_thread_count == 1)
+        m_marking_thread_pool = nullptr;
+    else
+        m_marking_thread_pool = make<MarkingThreadPool>(m_marking_thread_count - 1);
+}
+
 bool Heap::cell_must_survive_garbage_collection(Cell const& cell)
 {
     if (!cell.overrides_must_survive_garbage_collection({}))
@@ -471,6 +692,9 @@ bool Heap::cell_must_survive_garbage_collection(Cell const& cell)
 void Heap::finalize_unmarked_cells()
 {
     for_each_block([&](auto& block) {
+        // Classes that are swept lazily don't have anything to finalize.
+        if (block.cell_allocator().sweeps_lazily())
+            return IterationDecision::Continue;
         block.template for_each_cell_in_state<Cell::State::Live>([](Cell* cell) {
             if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell))
                 cell->finalize();
@@ -479,11 +703,18 @@ void Heap::finalize_unmarked_cells()
     });
 }
 
-void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measurement_timer)
+// NOTE: Dead cells run their destructors here, and those can unregister themselves from caches and other structures
+//       that the mutator relies on, so they can't be swept concurrently. Only the blocks of classes that opt into lazy
+//       sweeping are left for later, see CellAllocator::sweeps_lazily().
+void Heap::sweep_dead_cells(SweepLazily sweep_lazily, bool print_report, Core::ElapsedTimer const& measurement_timer)
 {
     dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
     Vector<HeapBlock*, 32> empty_blocks;
     Vector<HeapBlock*, 32> full_blocks_that_became_usable;
+    Vector<HeapBlock*, 32> unswept_blocks;
+
+    // Remembered cells may die here, so this has to happen before sweeping them.
+    forget_remembered_cells();
 
     size_t collected_cells = 0;
     size_t live_cells = 0;
@@ -491,6 +722,13 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
     size_t live_cell_bytes = 0;
 
     for_each_block([&](auto& block) {
+        if (sweep_lazily == SweepLazily::Yes && block.cell_allocator().sweeps_lazily()) {
+            // We don't know how many of its cells are alive without looking at them, so assume that all of them are.
+            unswept_blocks.append(&block);
+            live_cell_bytes += block.cell_count() * block.cell_size();
+            return IterationDecision::Continue;
+        }
+
         bool block_has_live_cells = false;
         bool block_was_full = block.is_full();
         block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
@@ -501,6 +739,7 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
                 collected_cell_bytes += block.cell_size();
             } else {
                 cell->set_marked(false);
+                cell->set_old(m_generational_collection_enabled);
                 block_has_live_cells = true;
                 ++live_cells;
                 live_cell_bytes += block.cell_size();
@@ -513,6 +752,11 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
         return IterationDecision::Continue;
     });
 
+    // Every survivor is old now if we're keeping track of generations, including the ones that were still young. The ones
+    // in unswept blocks are promoted once they're swept.
+    m_young_cells.clear();
+    m_promoted_bytes_since_last_full_gc = 0;
+
     for (auto& weak_container : m_weak_containers)
         weak_container.remove_dead_cells({});
 
@@ -526,6 +770,9 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
         block->cell_allocator().block_did_become_usable({}, *block);
     }
 
+    for (auto* block : unswept_blocks)
+        block->cell_allocator().block_was_left_unswept({}, *block);
+
     if constexpr (HEAP_DEBUG) {
         for_each_block([&](auto& block) {
             dbgln(" > Live HeapBlock @ {}: cell_size={}", &block, block.cell_size());
@@ -550,10 +797,241 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
         dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
         dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
         dbgln("   Freed blocks: {} ({} bytes)", empty_blocks.size(), empty_blocks.size() * HeapBlock::block_size);
+        dbgln(" Unswept blocks: {} ({} bytes)", unswept_blocks.size(), unswept_blocks.size() * HeapBlock::block_size);
+        dbgln("Marking threads: {}", m_marking_thread_count);
         dbgln("=============================================");
     }
 }
 
+void Heap::collect_young_generation(bool print_report, Core::ElapsedTimer const& measurement_timer)
+{
+    HashMap<Cell*, HeapRoot> roots;
+    gather_roots(roots);
+    mark_live_young_cells(roots);
+    finalize_unmarked_young_cells();
+    sweep_dead_young_cells(print_report, measurement_timer);
+}
+
+void Heap::mark_live_young_cells(HashMap<Cell*, HeapRoot> const& roots)
+{
+    dbgln_if(HEAP_DEBUG, "mark_live_young_cells:");
+
+    auto live_heap_blocks = MarkingVisitor::gather_live_heap_blocks(*this);
+    MarkingVisitor visitor(live_heap_blocks, MarkingVisitor::OnlyYoungCells::Yes);
+    for (auto* root : roots.keys())
+        visitor.visit(root);
+
+    // Old cells that may point into the young generation have their edges visited, but marking stops at old cells, so
+    // none of the old generation is traced through. For classes that use the write barrier, those are exactly the cells
+    // in the remembered set.
+    for (auto* cell : m_remembered_cells)
+        cell->visit_edges(visitor);
+
+    // FIXME: Cells store pointers to other cells in many ways (GCPtrs, Values, out-of-line vectors, raw pointers). Only
+    //        stores to GCPtr members and to the properties of objects are caught by the write barrier, so the old cells
+    //        of classes that don't opt into it still have to be looked at.
+    for_each_block([&](auto& block) {
+        block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            if (cell->is_old() && !cell->uses_write_barrier() && !cell->is_remembered())
+                cell->visit_edges(visitor);
+        });
+        return IterationDecision::Continue;
+    });
+
+    mark_all_reachable_cells(visitor);
+
+    // Old cells can only die in a full collection, so keep them around until then.
+    m_uprooted_cells.remove_all_matching([](auto& cell) {
+        if (cell->is_old())
+            return false;
+        cell->set_marked(false);
+        return true;
+    });
+}
+
+void Heap::finalize_unmarked_young_cells()
+{
+    for (auto* cell : m_young_cells) {
+        if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell))
+            cell->finalize();
+    }
+}
+
+void Heap::sweep_dead_young_cells(bool print_report, Core::ElapsedTimer const& measurement_timer)
+{
+    dbgln_if(HEAP_DEBUG, "sweep_dead_young_cells:");
+
+    // Maps every block we deallocated from to whether it was full before that.
+    HashMap<HeapBlock*, bool> affected_blocks;
+
+    size_t collected_cells = 0;
+    size_t promoted_cells = 0;
+    size_t collected_cell_bytes = 0;
+    size_t promoted_cell_bytes = 0;
+
+    for (auto* cell : m_young_cells) {
+        auto* block = HeapBlock::from_cell(cell);
+        if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell)) {
+            dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
+            affected_blocks.ensure(block, [&] { return block->is_full(); });
+            block->deallocate(cell);
+            ++collected_cells;
+            collected_cell_bytes += block->cell_size();
+        } else {
+            cell->set_marked(false);
+            cell->set_old(true);
+            ++promoted_cells;
+            promoted_cell_bytes += block->cell_size();
+        }
+    }
+
+    m_young_cells.clear_with_capacity();
+    m_promoted_bytes_since_last_full_gc += promoted_cell_bytes;
+
+    // There are no young cells left for old cells to point to.
+    forget_remembered_cells();
+
+    for (auto& weak_container : m_weak_containers)
+        weak_container.remove_dead_cells({});
+
+    size_t freed_block_count = 0;
+    for (auto& [block, block_was_full] : affected_blocks) {
+        bool block_has_live_cells = false;
+        block->for_each_cell_in_state<Cell::State::Live>([&](Cell*) {
+            block_has_live_cells = true;
+        });
+        if (!block_has_live_cells) {
+            dbgln_if(HEAP_DEBUG, " - HeapBlock empty @ {}: cell_size={}", block, block->cell_size());
+            block->cell_allocator().block_did_become_empty({}, *block);
+            ++freed_block_count;
+        } else if (block_was_full) {
+            dbgln_if(HEAP_DEBUG, " - HeapBlock usable again @ {}: cell_size={}", block, block->cell_size());
+            block->cell_allocator().block_did_become_usable({}, *block);
+        }
+    }
+
+    if (print_report) {
+        Duration const time_spent = measurement_timer.elapsed_time();
+
+        dbgln("Young generation collection report");
+        dbgln("=============================================");
+        dbgln("       Time spent: {} ms", time_spent.to_milliseconds());
+        dbgln("   Promoted cells: {} ({} bytes)", promoted_cells, promoted_cell_bytes);
+        dbgln("  Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
+        dbgln("     Freed blocks: {} ({} bytes)", freed_block_count, freed_block_count * HeapBlock::block_size);
+        dbgln("Promoted since last full collection: {} bytes", m_promoted_bytes_since_last_full_gc);
+        dbgln("=============================================");
+    }
+}
+
+void Heap::set_generational_collection_enabled(bool enabled)
+{
+    if (m_generational_collection_enabled == enabled)
+        return;
+    sweep_unswept_blocks();
+    m_generational_collection_enabled = enabled;
+    if (enabled)
+        AK::atomic_fetch_add(&Detail::g_generational_heap_count, size_t { 1 }, AK::memory_order_relaxed);
+    else
+        AK::atomic_fetch_sub(&Detail::g_generational_heap_count, size_t { 1 }, AK::memory_order_relaxed);
+
+    // Cells that were allocated while we weren't keeping track of the young generation are promoted right away.
+    // They will be looked at again in the next full collection. Without generations, every cell is young, so the
+    // write barrier never has anything to remember.
+    for_each_block([&](auto& block) {
+        block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            cell->set_old(enabled);
+        });
+        return IterationDecision::Continue;
+    });
+    m_young_cells.clear();
+    forget_remembered_cells();
+}
+
+void Heap::remember_cell(Badge<Cell>, Cell& cell)
+{
+    cell.set_remembered({}, true);
+    m_remembered_cells.append(&cell);
+}
+
+void Heap::forget_remembered_cells()
+{
+    for (auto* cell : m_remembered_cells)
+        cell->set_remembered({}, false);
+    m_remembered_cells.clear_with_capacity();
+}
+
+Cell* Heap::live_cell_containing(FlatPtr address) const
+{
+    auto* block = reinterpret_cast<HeapBlock*>(address & ~(HeapBlock::block_size - 1));
+    if (!m_blocks.contains(block))
+        return nullptr;
+    auto* cell = block->cell_from_possible_pointer(address);
+    if (!cell || cell->state() != Cell::State::Live)
+        return nullptr;
+    return cell;
+}
+
+bool Heap::sweep_unswept_block(Badge<CellAllocator>, HeapBlock& block)
+{
+    bool block_has_live_cells = false;
+    block.for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+        if (!cell->is_marked()) {
+            dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
+            block.deallocate(cell);
+            return;
+        }
+        cell->set_marked(false);
+        block_has_live_cells = true;
+
+        // The write barrier ignored stores to survivors that were still young, so any of them may point to a young cell.
+        if (m_generational_collection_enabled && !cell->is_old()) {
+            cell->set_old(true);
+            cell->set_remembered({}, true);
+            m_remembered_cells.append(cell);
+        }
+    });
+    return block_has_live_cells;
+}
+
+void Heap::sweep_unswept_blocks()
+{
+    for (auto& allocator : m_all_cell_allocators) {
+        if (allocator.has_unswept_blocks())
+            allocator.sweep_unswept_blocks({});
+    }
+}
+
+void Heap::did_create_heap_block(Badge<CellAllocator>, HeapBlock& block)
+{
+    m_blocks.set(&block);
+}
+
+void Heap::did_destroy_heap_block(Badge<CellAllocator>, HeapBlock& block)
+{
+    m_blocks.remove(&block);
+}
+
+size_t Detail::g_generational_heap_count { 0 };
+
+void Detail::gc_pointer_write_barrier_slow(void const* slot, void const* target)
+{
+    // The target is always a cell, so its block is valid and tells us which heap the store happened in.
+    auto target_address = bit_cast<FlatPtr>(target);
+    auto* target_block = reinterpret_cast<HeapBlock*>(target_address & ~(HeapBlock::block_size - 1));
+    auto& heap = target_block->heap();
+    if (!heap.is_generational_collection_enabled())
+        return;
+
+    // NOTE: This skips the entries of freelists, which are dead cells.
+    auto* target_cell = target_block->cell_from_possible_pointer(target_address);
+    if (!target_cell || target_cell->is_old() || target_cell->state() != Cell::State::Live)
+        return;
+
+    if (auto* owner = heap.live_cell_containing(bit_cast<FlatPtr>(slot)))
+        owner->did_store_edge(target_cell);
+}
+
 void Heap::defer_gc()
 {
     ++m_gc_deferrals;
@@ -566,8 +1044,9 @@ void Heap::undefer_gc()
 
     if (!m_gc_deferrals) {
         if (m_should_gc_when_deferral_ends)
-            collect_garbage();
+            collect_garbage(m_collection_type_when_deferral_ends);
         m_should_gc_when_deferral_ends = false;
+        m_collection_type_when_deferral_ends = CollectionType::CollectYoungGeneration;
     }
 }
 
@@ -6,11 +6,14 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/Badge.h>
 #include <AK/HashTable.h>
 #include <AK/IntrusiveList.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/OwnPtr.h>
+#include <AK/Time.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
@@ -28,6 +31,9 @@
 
 namespace JS {
 
+class MarkingThreadPool;
+class MarkingVisitor;
+
 class Heap : public HeapBase {
     AK_MAKE_NONCOPYABLE(Heap);
     AK_MAKE_NONMOVABLE(Heap);
@@ -60,6 +66,7 @@ public:
 
     enum class CollectionType {
         CollectGarbage,
+        CollectYoungGeneration,
         CollectEverything,
     };
 
@@ -69,6 +76,23 @@ public:
     bool should_collect_on_every_allocation() const { return m_should_collect_on_every_allocation; }
     void set_should_collect_on_every_allocation(bool b) { m_should_collect_on_every_allocation = b; }
 
+    // In generational mode, allocations trigger collections of the young generation only, and the whole heap is
+    // only collected once enough cells have been promoted to the old generation.
+    bool is_generational_collection_enabled() const { return m_generational_collection_enabled; }
+    void set_generational_collection_enabled(bool);
+
+    // Marking is split across this many threads, including the one that collects garbage.
+    // NOTE: This is only safe if the visit_edges() of every cell can run concurrently with the others.
+    size_t marking_thread_count() const { return m_marking_thread_count; }
+    void set_marking_thread_count(size_t);
+
+    // Called by the write barrier when an old cell that uses it starts pointing to a young cell.
+    void remember_cell(Badge<Cell>, Cell&);
+
+    // Returns the live cell that the given address points into, if there is one. The address doesn't have to be in
+    // this heap at all.
+    Cell* live_cell_containing(FlatPtr) const;
+
     void did_create_handle(Badge<HandleImpl>, HandleImpl&);
     void did_destroy_handle(Badge<HandleImpl>, HandleImpl&);
 
@@ -86,8 +110,24 @@ public:
 
     void register_cell_allocator(Badge<CellAllocator>, CellAllocator&);
 
+    void did_create_heap_block(Badge<CellAllocator>, HeapBlock&);
+    void did_destroy_heap_block(Badge<CellAllocator>, HeapBlock&);
+
+    // Sweeps a block that the last full collection left unswept, and returns whether any of its cells are still alive.
+    bool sweep_unswept_block(Badge<CellAllocator>, HeapBlock&);
+
     void uproot_cell(Cell* cell);
 
+    template<typename Callback>
+    void for_each_live_cell(Callback callback)
+    {
+        sweep_unswept_blocks();
+        for_each_block([&](auto& block) {
+            block.template for_each_cell_in_state<Cell::State::Live>(callback);
+            return IterationDecision::Continue;
+        });
+    }
+
 private:
     friend class MarkingVisitor;
     friend class GraphConstructorVisitor;
@@ -104,21 +144,42 @@ private:
         will_allocate(sizeof(T));
         if constexpr (requires { T::cell_allocator.allocator.get().allocate_cell(*this); }) {
             if constexpr (IsSame<T, typename decltype(T::cell_allocator)::CellType>) {
-                return T::cell_allocator.allocator.get().allocate_cell(*this);
+                return did_allocate_cell(T::cell_allocator.allocator.get().allocate_cell(*this));
             }
         }
-        return allocator_for_size(sizeof(T)).allocate_cell(*this);
+        return did_allocate_cell(allocator_for_size(sizeof(T)).allocate_cell(*this));
     }
 
     void will_allocate(size_t);
 
+    // NOTE: This has to happen before the cell is constructed, as constructing it may end a GC deferral and collect.
+    ALWAYS_INLINE Cell* did_allocate_cell(Cell* cell)
+    {
+        if (m_generational_collection_enabled)
+            m_young_cells.append(cell);
+        return cell;
+    }
+
     void find_min_and_max_block_addresses(FlatPtr& min_address, FlatPtr& max_address);
     void gather_roots(HashMap<Cell*, HeapRoot>&);
     void gather_conservative_roots(HashMap<Cell*, HeapRoot>&);
     void gather_asan_fake_stack_roots(HashMap<FlatPtr, HeapRoot>&, FlatPtr, FlatPtr min_block_address, FlatPtr max_block_address);
     void mark_live_cells(HashMap<Cell*, HeapRoot> const& live_cells);
+    void mark_all_reachable_cells(MarkingVisitor&);
     void finalize_unmarked_cells();
-    void sweep_dead_cells(bool print_report, Core::ElapsedTimer const&);
+
+    enum class SweepLazily {
+        No,
+        Yes,
+    };
+    void sweep_dead_cells(SweepLazily, bool print_report, Core::ElapsedTimer const&);
+    void sweep_unswept_blocks();
+
+    void collect_young_generation(bool print_report, Core::ElapsedTimer const&);
+    void mark_live_young_cells(HashMap<Cell*, HeapRoot> const& roots);
+    void finalize_unmarked_young_cells();
+    void sweep_dead_young_cells(bool print_report, Core::ElapsedTimer const&);
+    void forget_remembered_cells();
 
     ALWAYS_INLINE CellAllocator& allocator_for_size(size_t cell_size)
     {
@@ -140,14 +201,42 @@ private:
         }
     }
 
+    // Pause times of past collections, bucketed by powers of two of microseconds.
+    class PauseTimeHistogram {
+    public:
+        void record(Duration);
+        void dump(StringView name) const;
+
+    private:
+        Duration percentile(size_t) const;
+
+        static constexpr size_t bucket_count = 32;
+        AK::Array<size_t, bucket_count> m_buckets {};
+        size_t m_pause_count { 0 };
+        Duration m_longest_pause;
+    };
+
+    PauseTimeHistogram m_full_collection_pause_times;
+    PauseTimeHistogram m_young_collection_pause_times;
+
     static constexpr size_t GC_MIN_BYTES_THRESHOLD { 4 * 1024 * 1024 };
     size_t m_gc_bytes_threshold { GC_MIN_BYTES_THRESHOLD };
     size_t m_allocated_bytes_since_last_gc { 0 };
 
     bool m_should_collect_on_every_allocation { false };
 
+    static constexpr size_t YOUNG_GENERATION_BYTES_THRESHOLD { 2 * 1024 * 1024 };
+    bool m_generational_collection_enabled { false };
+    Vector<Cell*> m_young_cells;
+    Vector<Cell*> m_remembered_cells;
+    size_t m_promoted_bytes_since_last_full_gc { 0 };
+
+    size_t m_marking_thread_count { 1 };
+    OwnPtr<MarkingThreadPool> m_marking_thread_pool;
+
     Vector<NonnullOwnPtr<CellAllocator>> m_size_based_cell_allocators;
     CellAllocator::List m_all_cell_allocators;
+    HashTable<HeapBlock*> m_blocks;
 
     HandleImpl::List m_handles;
     MarkedVectorBase::List m_marked_vectors;
@@ -158,6 +247,7 @@ private:
 
     size_t m_gc_deferrals { 0 };
     bool m_should_gc_when_deferral_ends { false };
+    CollectionType m_collection_type_when_deferral_ends { CollectionType::CollectYoungGeneration };
 
     bool m_collecting_garbage { false };
 };
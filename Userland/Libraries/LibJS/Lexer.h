@@ -12,6 +12,7 @@
 #include <AK/HashMap.h>
 #include <AK/String.h>
 #include <AK/StringView.h>
+#include <LibJS/Position.h>
 
 namespace JS {
 
@@ -19,6 +20,9 @@ class Lexer {
 public:
     explicit Lexer(StringView source, StringView filename = "(unknown)"sv, size_t line_number = 1, size_t line_column = 0);
 
+    // Starts at the token at the given position of the source, for parsing a part of it again.
+    Lexer(ByteString source, StringView filename, Position const& start);
+
     Token next();
 
     ByteString const& source() const { return m_source; }
@@ -29,6 +33,8 @@ public:
     Token force_slash_as_regex();
 
 private:
+    Lexer(ByteString source, StringView filename, size_t line_number, size_t line_column, size_t start_offset);
+
     void consume();
     bool consume_exponent();
     bool consume_octal_number();
@@ -80,8 +86,6 @@ private:
 
     Optional<size_t> m_hit_invalid_unicode;
 
-    static HashMap<DeprecatedFlyString, TokenType> s_keywords;
-
     struct ParsedIdentifiers : public RefCounted<ParsedIdentifiers> {
         // Resolved identifiers must be kept alive for the duration of the parsing stage, otherwise
         // the only references to these strings are deleted by the Token destructor.
@@ -675,6 +675,13 @@ Parser::Parser(Lexer lexer, Program::Type program_type, Optional<EvalInitialStat
     }
 }
 
+Parser::Parser(Lexer lexer, Program::Type program_type, NonnullRefPtr<SourceCode const> source_code)
+    : m_source_code(move(source_code))
+    , m_state(move(lexer), program_type)
+    , m_program_type(program_type)
+{
+}
+
 Associativity Parser::operator_associativity(TokenType type) const
 {
     switch (type) {
@@ -2864,6 +2871,106 @@ NonnullRefPtr<FunctionBody const> Parser::parse_function_body(Vector<FunctionPar
     return function_body;
 }
 
+RefPtr<FunctionBody const> Parser::try_skip_function_body(Vector<FunctionParameter> const& parameters, Position const& function_start)
+{
+    // A directive prologue could make the function strict, which changes how it has to be checked and called.
+    if (match(TokenType::StringLiteral))
+        return nullptr;
+
+    auto rule_start = push_start();
+    save_state();
+
+    // Any name in the body might refer to a binding of the surrounding code, so all of them are treated like they
+    // are captured. That keeps those bindings out of locals, which is all the surrounding code needs to know.
+    HashTable<DeprecatedFlyString> referenced_names;
+    bool might_contain_direct_call_to_eval = false;
+    size_t depth = 0;
+    Token previous_token;
+
+    while (true) {
+        auto const& token = m_state.current_token;
+        switch (token.type()) {
+        case TokenType::CurlyOpen:
+            ++depth;
+            break;
+        case TokenType::CurlyClose:
+            if (depth == 0) {
+                discard_saved_state();
+
+                auto function_body = create_ast_node<FunctionBody>({ m_source_code, rule_start.position(), position() });
+                m_state.current_scope_pusher->set_scope_node(function_body);
+                m_state.current_scope_pusher->set_function_parameters(parameters);
+                if (m_state.strict_mode)
+                    function_body->set_strict_mode();
+
+                for (auto const& name : referenced_names)
+                    (void)create_identifier_and_register_in_current_scope({ m_source_code, rule_start.position(), position() }, name);
+                if (might_contain_direct_call_to_eval)
+                    m_state.current_scope_pusher->set_contains_direct_call_to_eval();
+
+                function_body->set_lazy_function({
+                    .source = m_state.lexer.source(),
+                    .function_start = function_start,
+                    .program_type = m_program_type,
+                    .strict_mode = m_state.strict_mode,
+                });
+                return function_body;
+            }
+            --depth;
+            break;
+        case TokenType::Identifier:
+        case TokenType::Async:
+        case TokenType::Await:
+        case TokenType::Let:
+        case TokenType::Yield:
+            if (token.type() == TokenType::Identifier && token.value() == "eval"sv)
+                might_contain_direct_call_to_eval = true;
+            referenced_names.set(token.DeprecatedFlyString_value());
+            break;
+        case TokenType::Slash:
+        case TokenType::SlashEquals:
+            // The lexer decides between division and regular expressions by looking at the previous token, but the
+            // parser overrules it after keywords, some contextual names, and closing parentheses and braces that end
+            // a statement. Rather than tracking the grammar to tell these apart, the full parser deals with those.
+            switch (previous_token.type()) {
+            case TokenType::Identifier:
+                if (previous_token.value().is_one_of("of"sv, "target"sv, "meta"sv)) {
+                    load_state();
+                    return nullptr;
+                }
+                break;
+            case TokenType::BigIntLiteral:
+            case TokenType::BracketClose:
+            case TokenType::NumericLiteral:
+            case TokenType::RegexLiteral:
+            case TokenType::StringLiteral:
+            case TokenType::TemplateLiteralEnd:
+                break;
+            default:
+                load_state();
+                return nullptr;
+            }
+            break;
+        case TokenType::EscapedKeyword:
+        case TokenType::PrivateIdentifier:
+        case TokenType::UnterminatedRegexLiteral:
+        case TokenType::UnterminatedStringLiteral:
+        case TokenType::UnterminatedTemplateLiteral:
+        case TokenType::Invalid:
+        case TokenType::Eof:
+            // Private names have to be checked against the enclosing classes, and anything malformed should be
+            // reported right away, so these are left to the full parser.
+            load_state();
+            return nullptr;
+        default:
+            break;
+        }
+
+        previous_token = m_state.current_token;
+        m_state.current_token = m_state.lexer.next();
+    }
+}
+
 NonnullRefPtr<BlockStatement const> Parser::parse_block_statement()
 {
     auto rule_start = push_start();
@@ -2903,12 +3010,14 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u16 parse_options, O
     else
         function_kind = FunctionKind::Normal;
     RefPtr<Identifier const> name;
+    Optional<Position> function_keyword_position;
     if (parse_options & FunctionNodeParseOptions::CheckForFunctionAndName) {
         if (function_kind == FunctionKind::Normal && match(TokenType::Async) && !next_token().trivia_contains_line_terminator()) {
             function_kind = FunctionKind::Async;
             consume(TokenType::Async);
             parse_options |= FunctionNodeParseOptions::IsAsyncFunction;
         }
+        function_keyword_position = position();
         consume(TokenType::Function);
         if (match(TokenType::Asterisk)) {
             function_kind = function_kind == FunctionKind::Normal ? FunctionKind::Generator : FunctionKind::AsyncGenerator;
@@ -2966,6 +3075,16 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u16 parse_options, O
 
         consume(TokenType::CurlyOpen);
 
+        // Only plain functions are parsed lazily, as nothing in their bodies can refer to the this, arguments or
+        // new.target of the surrounding code.
+        auto can_be_parsed_lazily = m_lazy_function_parsing_enabled
+            && function_kind == FunctionKind::Normal
+            && (parse_options & ~FunctionNodeParseOptions::HasDefaultExportName) == FunctionNodeParseOptions::CheckForFunctionAndName;
+        if (can_be_parsed_lazily) {
+            if (auto body = try_skip_function_body(parameters, *function_keyword_position))
+                return body.release_nonnull();
+        }
+
         auto body = parse_function_body(parameters, function_kind, parsing_insights);
         return body;
     }();
@@ -5189,4 +5308,24 @@ Parser Parser::parse_function_body_from_string(ByteString const& body_string, u1
     return body_parser;
 }
 
+Parser Parser::parse_lazy_function(FunctionBody const& lazy_body, RefPtr<FunctionExpression const>& function)
+{
+    auto const& lazy_function = lazy_body.lazy_function();
+    auto source_code = NonnullRefPtr<SourceCode const> { lazy_body.source_code() };
+    auto lexer = Lexer { lazy_function.source, source_code->filename().bytes_as_string_view(), lazy_function.function_start };
+
+    auto parser = Parser { move(lexer), lazy_function.program_type, move(source_code) };
+    parser.m_state.strict_mode = lazy_function.strict_mode;
+    // Nested functions are only parsed once they're called, too.
+    parser.m_lazy_function_parsing_enabled = true;
+    {
+        // The scopes around the function are gone, so this stands in for them. Names that aren't declared in the
+        // function itself end up being looked up in its environment, which is always correct.
+        auto enclosing_scope = ScopePusher::function_scope(parser);
+        function = parser.parse_function_node<FunctionExpression>();
+    }
+
+    return parser;
+}
+
 }
@@ -57,6 +57,11 @@ public:
 
     NonnullRefPtr<Program> parse_program(bool starts_in_strict_mode = false);
 
+    // When enabled, the bodies of plain function declarations and expressions are only scanned for the names they
+    // might capture, and are parsed in full once the function is called for the first time. Syntax errors inside of
+    // these bodies are only reported at that point.
+    void set_lazy_function_parsing_enabled(bool enabled) { m_lazy_function_parsing_enabled = enabled; }
+
     template<typename FunctionNodeType>
     NonnullRefPtr<FunctionNodeType> parse_function_node(u16 parse_options = FunctionNodeParseOptions::CheckForFunctionAndName, Optional<Position> const& function_start = {});
     Vector<FunctionParameter> parse_formal_parameters(int& function_length, u16 parse_options = 0);
@@ -212,10 +217,15 @@ public:
     friend ThrowCompletionOr<NonnullGCPtr<ECMAScriptFunctionObject>> FunctionConstructor::create_dynamic_function(VM&, FunctionObject&, FunctionObject*, FunctionKind, ReadonlySpan<String> parameter_args, String const& body_arg);
 
     static Parser parse_function_body_from_string(ByteString const& body_string, u16 parse_options, Vector<FunctionParameter> const& parameters, FunctionKind kind, FunctionParsingInsights&);
+    static Parser parse_lazy_function(FunctionBody const& lazy_body, RefPtr<FunctionExpression const>& function);
 
 private:
     friend class ScopePusher;
 
+    Parser(Lexer lexer, Program::Type program_type, NonnullRefPtr<SourceCode const> source_code);
+
+    RefPtr<FunctionBody const> try_skip_function_body(Vector<FunctionParameter> const& parameters, Position const& function_start);
+
     void parse_script(Program& program, bool starts_in_strict_mode);
     void parse_module(Program& program);
 
@@ -343,5 +353,6 @@ private:
     Vector<ParserState> m_saved_state;
     HashMap<size_t, TokenMemoization> m_token_memoizations;
     Program::Type m_program_type;
+    bool m_lazy_function_parsing_enabled { false };
 };
 }
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/ProgramCache.h>
+#include <LibJS/SourceCode.h>
+
+namespace JS {
+
+ProgramCache::~ProgramCache() = default;
+
+RefPtr<Program> ProgramCache::get(StringView source_text, StringView filename, size_t line_number_offset, Program::Type type)
+{
+    if (m_capacity == 0 || source_text.length() < min_source_length)
+        return nullptr;
+
+    auto source_hash = source_text.hash();
+    for (size_t i = m_entries.size(); i > 0; --i) {
+        auto& entry = m_entries[i - 1];
+        if (entry.source_hash != source_hash || entry.source_length != source_text.length() || entry.line_number_offset != line_number_offset)
+            continue;
+
+        auto const& source_code = entry.program->source_code();
+        if (entry.program->type() != type || source_code.filename() != filename || source_code.code() != source_text)
+            continue;
+
+        auto program = entry.program;
+        if (i != m_entries.size())
+            m_entries.append(m_entries.take(i - 1));
+        ++m_hit_count;
+        return program;
+    }
+    ++m_miss_count;
+    return nullptr;
+}
+
+void ProgramCache::set(StringView source_text, size_t line_number_offset, NonnullRefPtr<Program> program)
+{
+    if (source_text.length() < min_source_length || source_text.length() > m_capacity)
+        return;
+
+    evict_until_total_source_length_is_at_most(m_capacity - source_text.length());
+
+    m_entries.append({ source_text.hash(), source_text.length(), line_number_offset, move(program) });
+    m_total_source_length += source_text.length();
+}
+
+void ProgramCache::clear()
+{
+    m_entries.clear();
+    m_total_source_length = 0;
+}
+
+void ProgramCache::set_capacity(size_t capacity)
+{
+    m_capacity = capacity;
+    evict_until_total_source_length_is_at_most(capacity);
+}
+
+void ProgramCache::evict_until_total_source_length_is_at_most(size_t total_source_length)
+{
+    while (m_total_source_length > total_source_length) {
+        auto entry = m_entries.take_first();
+        m_total_source_length -= entry.source_length;
+    }
+}
+
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Vector.h>
+#include <LibJS/AST.h>
+
+namespace JS {
+
+// Keeps the ASTs of recently parsed scripts and modules around, so parsing the same source text again (for example,
+// a library that every page of a site loads) doesn't have to lex and parse it again.
+// Functions keep their bytecode on their AST nodes, so everything compiled for a cached program is reused as well.
+// NOTE: The capacity is measured in bytes of source text, which the AST is several times larger than.
+class ProgramCache {
+    AK_MAKE_NONCOPYABLE(ProgramCache);
+    AK_MAKE_NONMOVABLE(ProgramCache);
+
+public:
+    ProgramCache() = default;
+    ~ProgramCache();
+
+    // Anything shorter than this is cheap enough to just parse again.
+    static constexpr size_t min_source_length = 4 * KiB;
+    static constexpr size_t default_capacity = 8 * MiB;
+
+    RefPtr<Program> get(StringView source_text, StringView filename, size_t line_number_offset, Program::Type);
+    void set(StringView source_text, size_t line_number_offset, NonnullRefPtr<Program>);
+
+    void clear();
+
+    // Evicts the least recently used programs until the rest fit. A capacity of zero disables the cache.
+    size_t capacity() const { return m_capacity; }
+    void set_capacity(size_t);
+
+    size_t size() const { return m_entries.size(); }
+    size_t total_source_length() const { return m_total_source_length; }
+
+    size_t hit_count() const { return m_hit_count; }
+    size_t miss_count() const { return m_miss_count; }
+
+private:
+    struct Entry {
+        unsigned source_hash { 0 };
+        size_t source_length { 0 };
+        size_t line_number_offset { 0 };
+        NonnullRefPtr<Program> program;
+    };
+
+    void evict_until_total_source_length_is_at_most(size_t);
+
+    // Ordered from least to most recently used.
+    Vector<Entry> m_entries;
+    size_t m_total_source_length { 0 };
+    size_t m_capacity { default_capacity };
+
+    size_t m_hit_count { 0 };
+    size_t m_miss_count { 0 };
+};
+
+}
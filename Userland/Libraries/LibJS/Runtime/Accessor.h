@@ -16,6 +16,8 @@ namespace JS {
 class Accessor final : public Cell {
     JS_CELL(Accessor, Cell);
     JS_DECLARE_ALLOCATOR(Accessor);
+    JS_USES_WRITE_BARRIER(Accessor);
+    JS_SWEEPS_LAZILY(Accessor);
 
 public:
     static NonnullGCPtr<Accessor> create(VM& vm, FunctionObject* getter, FunctionObject* setter)
@@ -24,10 +26,16 @@ public:
     }
 
     FunctionObject* getter() const { return m_getter; }
-    void set_getter(FunctionObject* getter) { m_getter = getter; }
+    void set_getter(FunctionObject* getter)
+    {
+        m_getter = getter;
+    }
 
     FunctionObject* setter() const { return m_setter; }
-    void set_setter(FunctionObject* setter) { m_setter = setter; }
+    void set_setter(FunctionObject* setter)
+    {
+        m_setter = setter;
+    }
 
     void visit_edges(Cell::Visitor& visitor) override
     {
@@ -184,9 +184,17 @@ ThrowCompletionOr<MarkedVector<Value>> sort_indexed_properties(VM& vm, Object co
     // 1. Let items be a new empty List.
     auto items = MarkedVector<Value> { vm.heap() };
 
+    // OPTIMIZATION: Every element of a packed array is present, so they can be collected without any [[HasProperty]] or [[Get]].
+    auto const* packed_storage = packed_element_storage(object);
+    if (packed_storage && packed_storage->array_like_size() == length) {
+        items.ensure_capacity(length);
+        for (size_t k = 0; k < length; ++k)
+            items.unchecked_append(packed_storage->elements()[k]);
+    }
+
     // 2. Let k be 0.
     // 3. Repeat, while k < len,
-    for (size_t k = 0; k < length; ++k) {
+    for (size_t k = items.size(); k < length; ++k) {
         // a. Let Pk be ! ToString(𝔽(k)).
         auto property_key = PropertyKey { k };
 
@@ -284,6 +292,49 @@ ThrowCompletionOr<double> compare_array_elements(VM& vm, Value x, Value y, Funct
     return 0;
 }
 
+// Returns the storage of an array without holes, or null. Every index below the length of such an array is an own, writable
+// data property, so reading or overwriting them directly is indistinguishable from going through [[Get]] and [[Set]].
+SimpleIndexedPropertyStorage const* packed_element_storage(Object const& object)
+{
+    if (!is<Array>(object) || object.may_interfere_with_indexed_property_access())
+        return nullptr;
+    auto const* storage = object.indexed_properties().storage();
+    if (!storage || !storage->is_simple_storage())
+        return nullptr;
+    auto const& simple_storage = static_cast<SimpleIndexedPropertyStorage const&>(*storage);
+    if (!simple_storage.is_packed())
+        return nullptr;
+    return &simple_storage;
+}
+
+SimpleIndexedPropertyStorage* packed_element_storage(Object& object)
+{
+    return const_cast<SimpleIndexedPropertyStorage*>(packed_element_storage(const_cast<Object const&>(object)));
+}
+
+// Returns true if [[Set]] of the index that is the length of this array would just add a new element. That is the case if
+// neither the array nor anything on its prototype chain has an opinion about indices above its length.
+bool can_append_elements_directly(Object& object)
+{
+    if (!is<Array>(object) || object.may_interfere_with_indexed_property_access())
+        return false;
+    auto& array = static_cast<Array&>(object);
+    if (!array.length_is_writable() || !MUST(array.is_extensible()))
+        return false;
+    auto const* storage = array.indexed_properties().storage();
+    if (storage && !storage->is_simple_storage())
+        return false;
+
+    auto& intrinsics = array.shape().realm().intrinsics();
+    auto const* array_prototype = array.shape().prototype();
+    if (array_prototype != intrinsics.array_prototype().ptr() || !array_prototype->indexed_properties().is_empty())
+        return false;
+    auto const* object_prototype = array_prototype->prototype();
+    if (object_prototype != intrinsics.object_prototype().ptr() || !object_prototype->indexed_properties().is_empty())
+        return false;
+    return !object_prototype->prototype();
+}
+
 // NON-STANDARD: Used to return the value of the ephemeral length property
 ThrowCompletionOr<Optional<PropertyDescriptor>> Array::internal_get_own_property(PropertyKey const& property_key) const
 {
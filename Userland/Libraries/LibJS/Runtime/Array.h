@@ -22,6 +22,7 @@ namespace JS {
 class Array : public Object {
     JS_OBJECT(Array, Object);
     JS_DECLARE_ALLOCATOR(Array);
+    JS_USES_WRITE_BARRIER(Array);
 
 public:
     static ThrowCompletionOr<NonnullGCPtr<Array>> create(Realm&, u64 length, Object* prototype = nullptr);
@@ -47,6 +48,9 @@ public:
     virtual ThrowCompletionOr<bool> internal_delete(PropertyKey const&) override;
     virtual ThrowCompletionOr<MarkedVector<Value>> internal_own_property_keys() const override final;
 
+    // Storing to "length" or to an index past the end has to update the length.
+    virtual bool has_ordinary_set_and_define_own_property() const override final { return false; }
+
     [[nodiscard]] bool length_is_writable() const { return m_length_writable; }
 
 protected:
@@ -66,4 +70,9 @@ enum class Holes {
 ThrowCompletionOr<MarkedVector<Value>> sort_indexed_properties(VM&, Object const&, size_t length, Function<ThrowCompletionOr<double>(Value, Value)> const& sort_compare, Holes holes);
 ThrowCompletionOr<double> compare_array_elements(VM&, Value x, Value y, FunctionObject* comparefn);
 
+// Non-standard: Fast paths for arrays whose elements live in a SimpleIndexedPropertyStorage.
+SimpleIndexedPropertyStorage const* packed_element_storage(Object const&);
+SimpleIndexedPropertyStorage* packed_element_storage(Object&);
+bool can_append_elements_directly(Object&);
+
 }
@@ -7,8 +7,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/Function.h>
 #include <AK/HashTable.h>
+#include <AK/QuickSort.h>
 #include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
 #include <LibJS/Runtime/AbstractOperations.h>
@@ -379,6 +381,14 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::fill)
     else
         to = min(relative_end, length);
 
+    // OPTIMIZATION: The elements of packed arrays can be overwritten without going through [[Set]].
+    if (auto* storage = packed_element_storage(this_object); storage && storage->array_like_size() >= to) {
+        for (u64 i = from; i < to; i++)
+            storage->put(i, vm.argument(0));
+        this_object->did_store_edge(vm.argument(0));
+        return this_object;
+    }
+
     for (u64 i = from; i < to; i++)
         TRY(this_object->set(i, vm.argument(0), Object::ShouldThrowExceptions::Yes));
 
@@ -742,6 +752,27 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::includes)
             from_index = from_argument;
     }
     auto value_to_find = vm.argument(0);
+
+    // OPTIMIZATION: Search packed arrays without a [[Get]] for every element.
+    if (auto const* storage = packed_element_storage(this_object); storage && storage->array_like_size() >= length) {
+        auto const& elements = storage->elements();
+        if (storage->element_kind() == SimpleIndexedPropertyStorage::ElementKind::PackedInt32) {
+            if (!value_to_find.is_number())
+                return Value(false);
+            auto number_to_find = value_to_find.as_double();
+            for (u64 i = from_index; i < length; ++i) {
+                if (elements[i].as_i32() == number_to_find)
+                    return Value(true);
+            }
+            return Value(false);
+        }
+        for (u64 i = from_index; i < length; ++i) {
+            if (same_value_zero(elements[i], value_to_find))
+                return Value(true);
+        }
+        return Value(false);
+    }
+
     for (u64 i = from_index; i < length; ++i) {
         auto element = TRY(this_object->get(i));
         if (same_value_zero(element, value_to_find))
@@ -795,6 +826,26 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::index_of)
         k = max(length + n, 0);
     }
 
+    // OPTIMIZATION: Search packed arrays without a [[HasProperty]] and [[Get]] for every element.
+    if (auto const* storage = packed_element_storage(object); storage && storage->array_like_size() >= length) {
+        auto const& elements = storage->elements();
+        if (storage->element_kind() == SimpleIndexedPropertyStorage::ElementKind::PackedInt32) {
+            if (!search_element.is_number())
+                return Value(-1);
+            auto number_to_find = search_element.as_double();
+            for (; k < length; ++k) {
+                if (elements[k].as_i32() == number_to_find)
+                    return Value(k);
+            }
+            return Value(-1);
+        }
+        for (; k < length; ++k) {
+            if (is_strictly_equal(search_element, elements[k]))
+                return Value(k);
+        }
+        return Value(-1);
+    }
+
     // 10. Repeat, while k < len,
     for (; k < length; ++k) {
         auto property_key = PropertyKey { k };
@@ -958,13 +1009,18 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::map)
         // a. Let Pk be ! ToString(𝔽(k)).
         auto property_key = PropertyKey { k };
 
+        // OPTIMIZATION: The elements of packed arrays are always present, and can be read without a [[Get]].
+        //               The callback may change the array, so this has to be checked again for every element.
+        auto const* storage = packed_element_storage(object);
+        bool is_packed_element = storage && k < storage->array_like_size();
+
         // b. Let kPresent be ? HasProperty(O, Pk).
-        auto k_present = TRY(object->has_property(property_key));
+        auto k_present = is_packed_element ? true : TRY(object->has_property(property_key));
 
         // c. If kPresent is true, then
         if (k_present) {
             // i. Let kValue be ? Get(O, Pk).
-            auto k_value = TRY(object->get(property_key));
+            auto k_value = is_packed_element ? storage->elements()[k] : TRY(object->get(property_key));
 
             // ii. Let mappedValue be ? Call(callbackfn, thisArg, « kValue, 𝔽(k), O »).
             auto mapped_value = TRY(call(vm, callback_function.as_function(), this_arg, k_value, Value(k), object));
@@ -1005,6 +1061,16 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::push)
     auto new_length = length + argument_count;
     if (new_length > MAX_ARRAY_LIKE_INDEX)
         return vm.throw_completion<TypeError>(ErrorType::ArrayMaxSize);
+
+    // OPTIMIZATION: Append to arrays directly if no [[Set]] along the way would do anything else.
+    if (new_length <= NumericLimits<i32>::max() && can_append_elements_directly(this_object)) {
+        for (size_t i = 0; i < argument_count; ++i) {
+            this_object->indexed_properties().append(vm.argument(i));
+            this_object->did_store_edge(vm.argument(i));
+        }
+        return Value(new_length);
+    }
+
     for (size_t i = 0; i < argument_count; ++i)
         TRY(this_object->set(length + i, vm.argument(i), Object::ShouldThrowExceptions::Yes));
     auto new_length_value = Value(new_length);
@@ -1395,6 +1461,39 @@ ThrowCompletionOr<void> array_merge_sort(VM& vm, Function<ThrowCompletionOr<doub
     return {};
 }
 
+static StringView int32_to_decimal_string(i32 value, AK::Array<char, 11>& buffer)
+{
+    auto magnitude = value < 0 ? 0u - static_cast<u32>(value) : static_cast<u32>(value);
+    size_t start = buffer.size();
+    do {
+        buffer[--start] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0)
+        buffer[--start] = '-';
+    return { buffer.data() + start, buffer.size() - start };
+}
+
+// Sorts like CompareArrayElements without a comparefn would. Two Int32 values only have the same string representation if
+// they are the same value, so the sort doesn't have to be stable.
+static void sort_int32_elements_by_string_representation(SimpleIndexedPropertyStorage& storage)
+{
+    auto length = storage.array_like_size();
+    Vector<i32> values;
+    values.ensure_capacity(length);
+    for (size_t i = 0; i < length; ++i)
+        values.unchecked_append(storage.elements()[i].as_i32());
+
+    quick_sort(values, [](i32 a, i32 b) {
+        AK::Array<char, 11> a_buffer;
+        AK::Array<char, 11> b_buffer;
+        return int32_to_decimal_string(a, a_buffer) < int32_to_decimal_string(b, b_buffer);
+    });
+
+    for (size_t i = 0; i < length; ++i)
+        storage.put(i, Value(values[i]));
+}
+
 // 23.1.3.30 Array.prototype.sort ( comparefn ), https://tc39.es/ecma262/#sec-array.prototype.sort
 JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
 {
@@ -1409,6 +1508,13 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
     // 3. Let len be ? LengthOfArrayLike(obj).
     auto length = TRY(length_of_array_like(vm, object));
 
+    // OPTIMIZATION: Sorting Int32 values by their string representations doesn't need any strings to be created.
+    if (auto* storage = packed_element_storage(object); storage && comparefn.is_undefined()
+        && storage->element_kind() == SimpleIndexedPropertyStorage::ElementKind::PackedInt32 && storage->array_like_size() == length) {
+        sort_int32_elements_by_string_representation(*storage);
+        return object;
+    }
+
     // 4. Let SortCompare be a new Abstract Closure with parameters (x, y) that captures comparefn and performs the following steps when called:
     Function<ThrowCompletionOr<double>(Value, Value)> sort_compare = [&](auto x, auto y) -> ThrowCompletionOr<double> {
         // a. Return ? CompareArrayElements(x, y, comparefn).
@@ -1424,6 +1530,14 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
     // 7. Let j be 0.
     size_t j = 0;
 
+    // OPTIMIZATION: If the array is still packed after all the calls to comparefn, the sorted elements can be written back without [[Set]].
+    if (auto* storage = packed_element_storage(object); storage && storage->array_like_size() >= item_count) {
+        for (; j < item_count; ++j) {
+            storage->put(j, sorted_list[j]);
+            object->did_store_edge(sorted_list[j]);
+        }
+    }
+
     // 8. Repeat, while j < itemCount,
     for (; j < item_count; ++j) {
         // a. Perform ? Set(obj, ! ToString(𝔽(j)), sortedList[j], true).
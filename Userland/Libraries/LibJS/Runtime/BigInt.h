@@ -18,6 +18,8 @@ namespace JS {
 class BigInt final : public Cell {
     JS_CELL(BigInt, Cell);
     JS_DECLARE_ALLOCATOR(BigInt);
+    JS_USES_WRITE_BARRIER(BigInt);
+    JS_SWEEPS_LAZILY(BigInt);
 
 public:
     [[nodiscard]] static NonnullGCPtr<BigInt> create(VM&, Crypto::SignedBigInteger);
@@ -123,11 +123,15 @@ ThrowCompletionOr<void> DeclarativeEnvironment::initialize_binding_direct(VM& vm
     VERIFY(binding.initialized == false);
 
     // 2. If hint is not normal, perform ? AddDisposableResource(envRec, V, hint).
-    if (hint != Environment::InitializeBindingHint::Normal)
+    if (hint != Environment::InitializeBindingHint::Normal) {
         TRY(add_disposable_resource(vm, m_disposable_resource_stack, value, hint));
+        if (!m_disposable_resource_stack.is_empty())
+            did_store_edge(m_disposable_resource_stack.last().dispose_method.ptr());
+    }
 
     // 3. Set the bound value for N in envRec to V.
     binding.value = value;
+    did_store_edge(value);
 
     // 4. Record that the binding for N in envRec has been initialized.
     binding.initialized = true;
@@ -178,6 +182,7 @@ ThrowCompletionOr<void> DeclarativeEnvironment::set_mutable_binding_direct(VM& v
 
     if (binding.mutable_) {
         binding.value = value;
+        did_store_edge(value);
     } else {
         if (strict)
             return vm.throw_completion<TypeError>(ErrorType::InvalidAssignToConst);
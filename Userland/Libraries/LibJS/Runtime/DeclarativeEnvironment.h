@@ -18,6 +18,8 @@ namespace JS {
 class DeclarativeEnvironment : public Environment {
     JS_ENVIRONMENT(DeclarativeEnvironment, Environment);
     JS_DECLARE_ALLOCATOR(DeclarativeEnvironment);
+    JS_USES_WRITE_BARRIER(DeclarativeEnvironment);
+    JS_SWEEPS_LAZILY(DeclarativeEnvironment);
 
     struct Binding {
         DeprecatedFlyString name;
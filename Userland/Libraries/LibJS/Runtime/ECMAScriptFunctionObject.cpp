@@ -13,6 +13,8 @@
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Lexer.h>
+#include <LibJS/Parser.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/AsyncFunctionDriverWrapper.h>
@@ -91,6 +93,14 @@ ECMAScriptFunctionObject::ECMAScriptFunctionObject(DeprecatedFlyString name, Byt
     // 15. Set F.[[ScriptOrModule]] to GetActiveScriptOrModule().
     m_script_or_module = vm().get_active_script_or_module();
 
+    if (is<FunctionBody>(*m_ecmascript_code))
+        m_has_lazy_body = static_cast<FunctionBody const&>(*m_ecmascript_code).is_lazy();
+
+    prepare_function_declaration_instantiation(parsing_insights);
+}
+
+void ECMAScriptFunctionObject::prepare_function_declaration_instantiation(FunctionParsingInsights const& parsing_insights)
+{
     // 15.1.3 Static Semantics: IsSimpleParameterList, https://tc39.es/ecma262/#sec-static-semantics-issimpleparameterlist
     m_has_simple_parameter_list = all_of(m_formal_parameters, [&](auto& parameter) {
         if (parameter.is_rest)
@@ -335,6 +345,48 @@ ECMAScriptFunctionObject::ECMAScriptFunctionObject(DeprecatedFlyString name, Byt
     m_uses_this = parsing_insights.uses_this;
 }
 
+ThrowCompletionOr<void> ECMAScriptFunctionObject::parse_lazy_body()
+{
+    auto& vm = this->vm();
+    auto const& lazy_body = static_cast<FunctionBody const&>(*m_ecmascript_code);
+    auto const& lazy_function = lazy_body.lazy_function();
+
+    // Every closure created from the same function shares its body, so it only has to be parsed once.
+    if (!lazy_function.parsed_function) {
+        RefPtr<FunctionExpression const> function;
+        auto parser = Parser::parse_lazy_function(lazy_body, function);
+        if (parser.has_errors()) {
+            auto error = parser.errors()[0];
+            return vm.throw_completion<SyntaxError>(error.to_string());
+        }
+        lazy_function.parsed_function = move(function);
+    }
+
+    auto const& function = *lazy_function.parsed_function;
+    VERIFY(function.is_strict_mode() == m_strict);
+
+    m_ecmascript_code = function.body();
+    m_formal_parameters = function.parameters();
+    m_local_variables_names = function.local_variables_names();
+    m_might_need_arguments_object = function.might_need_arguments_object();
+    m_contains_direct_call_to_eval = function.contains_direct_call_to_eval();
+    m_has_lazy_body = false;
+
+    // Start over, the parameters of the placeholder were already accounted for.
+    m_has_parameter_expressions = false;
+    m_has_duplicates = false;
+    m_parameter_names.clear();
+    m_functions_to_initialize.clear();
+    m_var_names_to_initialize_binding.clear();
+    m_function_names_to_initialize_binding.clear();
+    m_function_environment_bindings_count = 0;
+    m_var_environment_bindings_count = 0;
+    m_lex_environment_bindings_count = 0;
+
+    prepare_function_declaration_instantiation(function.parsing_insights());
+    return {};
+}
+
 void ECMAScriptFunctionObject::initialize(Realm& realm)
 {
     auto& vm = this->vm();
@@ -574,6 +626,8 @@ ThrowCompletionOr<void> ECMAScriptFunctionObject::prepare_for_ordinary_call(Exec
     auto& vm = this->vm();
 
     // Non-standard
+    if (m_has_lazy_body)
+        TRY(parse_lazy_body());
     callee_context.is_strict_mode = m_strict;
 
     // 1. Let callerContext be the running execution context.
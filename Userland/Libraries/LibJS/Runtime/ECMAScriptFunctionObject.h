@@ -114,6 +114,9 @@ private:
     virtual bool is_ecmascript_function_object() const override { return true; }
     virtual void visit_edges(Visitor&) override;
 
+    void prepare_function_declaration_instantiation(FunctionParsingInsights const&);
+    ThrowCompletionOr<void> parse_lazy_body();
+
     ThrowCompletionOr<void> prepare_for_ordinary_call(ExecutionContext& callee_context, Object* new_target);
     void ordinary_call_bind_this(ExecutionContext&, Value this_argument);
 
@@ -127,7 +130,7 @@ private:
     // Internal Slots of ECMAScript Function Objects, https://tc39.es/ecma262/#table-internal-slots-of-ecmascript-function-objects
     GCPtr<Environment> m_environment;                                        // [[Environment]]
     GCPtr<PrivateEnvironment> m_private_environment;                         // [[PrivateEnvironment]]
-    Vector<FunctionParameter> const m_formal_parameters;                     // [[FormalParameters]]
+    Vector<FunctionParameter> m_formal_parameters;                           // [[FormalParameters]]
     NonnullRefPtr<Statement const> m_ecmascript_code;                        // [[ECMAScriptCode]]
     GCPtr<Realm> m_realm;                                                    // [[Realm]]
     ScriptOrModule m_script_or_module;                                       // [[ScriptOrModule]]
@@ -163,6 +166,7 @@ private:
     Vector<FunctionDeclaration const&> m_functions_to_initialize;
     bool m_arguments_object_needed { false };
     bool m_is_module_wrapper { false };
+    bool m_has_lazy_body { false };
     bool m_function_environment_needed { false };
     bool m_uses_this { false };
     Vector<VariableNameToInitialize> m_var_names_to_initialize_binding;
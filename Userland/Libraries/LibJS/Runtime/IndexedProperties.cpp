@@ -18,6 +18,24 @@ SimpleIndexedPropertyStorage::SimpleIndexedPropertyStorage(Vector<Value>&& initi
     , m_array_size(initial_values.size())
     , m_packed_elements(move(initial_values))
 {
+    for (auto value : m_packed_elements)
+        generalize_element_kind_for(value);
+}
+
+void SimpleIndexedPropertyStorage::generalize_element_kind_for(Value value)
+{
+    if (value.is_empty()) {
+        m_element_kind = ElementKind::Holey;
+        return;
+    }
+    auto kind_of_value = [&] {
+        if (value.is_int32())
+            return ElementKind::PackedInt32;
+        if (value.is_number())
+            return ElementKind::PackedNumber;
+        return ElementKind::Packed;
+    }();
+    m_element_kind = max(m_element_kind, kind_of_value);
 }
 
 bool SimpleIndexedPropertyStorage::has_index(u32 index) const
@@ -48,16 +66,20 @@ void SimpleIndexedPropertyStorage::put(u32 index, Value value, PropertyAttribute
     VERIFY(attributes == default_attributes);
 
     if (index >= m_array_size) {
+        if (index > m_array_size)
+            m_element_kind = ElementKind::Holey;
         m_array_size = index + 1;
         grow_storage_if_needed();
     }
     m_packed_elements[index] = value;
+    generalize_element_kind_for(value);
 }
 
 void SimpleIndexedPropertyStorage::remove(u32 index)
 {
     VERIFY(index < m_array_size);
     m_packed_elements[index] = {};
+    m_element_kind = ElementKind::Holey;
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_first()
@@ -76,6 +98,8 @@ ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 
 bool SimpleIndexedPropertyStorage::set_array_like_size(size_t new_size)
 {
+    if (new_size > m_array_size)
+        m_element_kind = ElementKind::Holey;
     m_array_size = new_size;
     m_packed_elements.resize_and_keep_capacity(new_size);
     return true;
@@ -58,6 +58,15 @@ private:
 
 class SimpleIndexedPropertyStorage final : public IndexedPropertyStorage {
 public:
+    // What is known about the elements below array_like_size(), from most to least specific. Like a shape, a storage
+    // only ever moves on to less specific kinds, so fast paths can rely on the kind until they store something themselves.
+    enum class ElementKind : u8 {
+        PackedInt32,
+        PackedNumber,
+        Packed,
+        Holey,
+    };
+
     SimpleIndexedPropertyStorage()
         : IndexedPropertyStorage(IsSimpleStorage::Yes)
     {
@@ -78,6 +87,9 @@ public:
 
     Vector<Value> const& elements() const { return m_packed_elements; }
 
+    ElementKind element_kind() const { return m_element_kind; }
+    bool is_packed() const { return m_element_kind != ElementKind::Holey; }
+
     [[nodiscard]] bool inline_has_index(u32 index) const
     {
         return index < m_array_size && !m_packed_elements.data()[index].is_empty();
@@ -94,9 +106,11 @@ private:
     friend GenericIndexedPropertyStorage;
 
     void grow_storage_if_needed();
+    void generalize_element_kind_for(Value);
 
     size_t m_array_size { 0 };
     Vector<Value> m_packed_elements;
+    ElementKind m_element_kind { ElementKind::PackedInt32 };
 };
 
 class GenericIndexedPropertyStorage final : public IndexedPropertyStorage {
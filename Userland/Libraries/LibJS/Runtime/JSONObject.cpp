@@ -4,14 +4,15 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/FloatingPointStringConversions.h>
 #include <AK/Function.h>
+#include <AK/GenericLexer.h>
 #include <AK/JsonArray.h>
 #include <AK/JsonObject.h>
 #include <AK/JsonParser.h>
+#include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
 #include <AK/TypeCasts.h>
-#include <AK/Utf16View.h>
-#include <AK/Utf8View.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/BigIntObject.h>
@@ -107,7 +108,9 @@ ThrowCompletionOr<Optional<ByteString>> JSONObject::stringify_impl(VM& vm, Value
 
     auto wrapper = Object::create(realm, realm.intrinsics().object_prototype());
     MUST(wrapper->create_data_property_or_throw(ByteString::empty(), value));
-    return serialize_json_property(vm, state, ByteString::empty(), wrapper);
+    if (!TRY(serialize_json_property(vm, state, ByteString::empty(), wrapper)))
+        return Optional<ByteString> {};
+    return state.builder.to_byte_string();
 }
 
 // 25.5.2 JSON.stringify ( value [ , replacer [ , space ] ] ), https://tc39.es/ecma262/#sec-json.stringify
@@ -128,11 +131,18 @@ JS_DEFINE_NATIVE_FUNCTION(JSONObject::stringify)
 }
 
 // 25.5.2.1 SerializeJSONProperty ( state, key, holder ), https://tc39.es/ecma262/#sec-serializejsonproperty
-ThrowCompletionOr<Optional<ByteString>> JSONObject::serialize_json_property(VM& vm, StringifyState& state, PropertyKey const& key, Object* holder)
+ThrowCompletionOr<bool> JSONObject::serialize_json_property(VM& vm, StringifyState& state, PropertyKey const& key, Object* holder)
 {
     // 1. Let value be ? Get(holder, key).
     auto value = TRY(holder->get(key));
 
+    return serialize_json_value(vm, state, key, holder, value);
+}
+
+// 25.5.2.1 SerializeJSONProperty ( state, key, holder ), https://tc39.es/ecma262/#sec-serializejsonproperty
+// NOTE: This is everything after step 1, for callers that already know the value of the property.
+ThrowCompletionOr<bool> JSONObject::serialize_json_value(VM& vm, StringifyState& state, PropertyKey const& key, Object* holder, Value value)
+{
     // 2. If Type(value) is Object or BigInt, then
     if (value.is_object() || value.is_bigint()) {
         // a. Let toJSON be ? GetV(value, "toJSON").
@@ -178,26 +188,35 @@ ThrowCompletionOr<Optional<ByteString>> JSONObject::serialize_json_property(VM&
     }
 
     // 5. If value is null, return "null".
-    if (value.is_null())
-        return "null"sv;
+    if (value.is_null()) {
+        state.builder.append("null"sv);
+        return true;
+    }
 
     // 6. If value is true, return "true".
     // 7. If value is false, return "false".
-    if (value.is_boolean())
-        return value.as_bool() ? "true"sv : "false"sv;
+    if (value.is_boolean()) {
+        state.builder.append(value.as_bool() ? "true"sv : "false"sv);
+        return true;
+    }
 
     // 8. If Type(value) is String, return QuoteJSONString(value).
-    if (value.is_string())
-        return quote_json_string(value.as_string().byte_string());
+    if (value.is_string()) {
+        quote_json_string(state.builder, value.as_string().byte_string());
+        return true;
+    }
 
     // 9. If Type(value) is Number, then
     if (value.is_number()) {
         // a. If value is finite, return ! ToString(value).
-        if (value.is_finite_number())
-            return MUST(value.to_byte_string(vm));
-
+        if (value.is_int32())
+            state.builder.appendff("{}", value.as_i32());
+        else if (value.is_finite_number())
+            state.builder.append(MUST(value.to_byte_string(vm)));
         // b. Return "null".
-        return "null"sv;
+        else
+            state.builder.append("null"sv);
+        return true;
     }
 
     // 10. If Type(value) is BigInt, throw a TypeError exception.
@@ -211,158 +230,192 @@ ThrowCompletionOr<Optional<ByteString>> JSONObject::serialize_json_property(VM&
 
         // b. If isArray is true, return ? SerializeJSONArray(state, value).
         if (is_array)
-            return TRY(serialize_json_array(vm, state, value.as_object()));
-
+            TRY(serialize_json_array(vm, state, value.as_object()));
         // c. Return ? SerializeJSONObject(state, value).
-        return TRY(serialize_json_object(vm, state, value.as_object()));
+        else
+            TRY(serialize_json_object(vm, state, value.as_object()));
+        return true;
     }
 
     // 12. Return undefined.
-    return Optional<ByteString> {};
+    return false;
+}
+
+// The own properties of ordinary objects without indexed properties are enumerated in the order of their shape, so their
+// keys can be taken from there instead of from a list of key strings made by EnumerableOwnProperties.
+static Shape const* shape_to_enumerate_own_properties_of(Object const& object)
+{
+    if (!object.eligible_for_own_property_enumeration_fast_path() || !object.indexed_properties().is_empty())
+        return nullptr;
+    // Dictionaries change in place, which the property table can't do while we are iterating over it.
+    if (object.shape().is_dictionary())
+        return nullptr;
+    return &object.shape();
 }
 
 // 25.5.2.4 SerializeJSONObject ( state, value ), https://tc39.es/ecma262/#sec-serializejsonobject
-ThrowCompletionOr<ByteString> JSONObject::serialize_json_object(VM& vm, StringifyState& state, Object& object)
+ThrowCompletionOr<void> JSONObject::serialize_json_object(VM& vm, StringifyState& state, Object& object)
 {
     if (state.seen_objects.contains(&object))
         return vm.throw_completion<TypeError>(ErrorType::JsonCircular);
 
     state.seen_objects.set(&object);
-    ByteString previous_indent = state.indent;
-    state.indent = ByteString::formatted("{}{}", state.indent, state.gap);
-    Vector<ByteString> property_strings;
+    ++state.indent_level;
+
+    auto& builder = state.builder;
+    builder.append('{');
+    bool has_properties = false;
 
-    auto process_property = [&](PropertyKey const& key) -> ThrowCompletionOr<void> {
+    auto process_property = [&](PropertyKey const& key, Optional<Value> value = {}) -> ThrowCompletionOr<void> {
         if (key.is_symbol())
             return {};
-        auto serialized_property_string = TRY(serialize_json_property(vm, state, key, &object));
-        if (serialized_property_string.has_value()) {
-            property_strings.append(ByteString::formatted(
-                "{}:{}{}",
-                quote_json_string(key.to_string()),
-                state.gap.is_empty() ? "" : " ",
-                serialized_property_string));
-        }
+
+        // The key is written before the value is known, and taken back out if the value turns out not to be serialized.
+        auto length_before_property = builder.length();
+        if (has_properties)
+            builder.append(',');
+        append_newline_and_indent(state);
+        if (key.is_string())
+            quote_json_string(builder, key.as_string().view());
+        else
+            quote_json_string(builder, key.to_string());
+        builder.append(':');
+        if (!state.gap.is_empty())
+            builder.append(' ');
+
+        auto did_serialize_property = value.has_value()
+            ? TRY(serialize_json_value(vm, state, key, &object, *value))
+            : TRY(serialize_json_property(vm, state, key, &object));
+        if (did_serialize_property)
+            has_properties = true;
+        else
+            builder.trim(builder.length() - length_before_property);
         return {};
     };
 
     if (state.property_list.has_value()) {
-        auto property_list = state.property_list.value();
-        for (auto& property : property_list)
+        for (auto& property : *state.property_list)
             TRY(process_property(property));
+    } else if (auto const* shape = shape_to_enumerate_own_properties_of(object)) {
+        for (auto const& it : shape->property_table()) {
+            if (!it.key.is_string() || !it.value.attributes.is_enumerable())
+                continue;
+
+            // As long as the object keeps the shape the keys were taken from, data properties can be read straight out
+            // of its storage. Empty values are intrinsics that haven't been materialized yet.
+            Optional<Value> value;
+            if (&object.shape() == shape) {
+                auto stored_value = object.get_direct(it.value.offset);
+                if (!stored_value.is_empty() && !stored_value.is_accessor())
+                    value = stored_value;
+            }
+            TRY(process_property(PropertyKey { it.key.as_string(), PropertyKey::StringMayBeNumber::No }, value));
+        }
     } else {
         auto property_list = TRY(object.enumerable_own_property_names(PropertyKind::Key));
         for (auto& property : property_list)
             TRY(process_property(property.as_string().byte_string()));
     }
-    StringBuilder builder;
-    if (property_strings.is_empty()) {
-        builder.append("{}"sv);
-    } else {
-        bool first = true;
-        builder.append('{');
-        if (state.gap.is_empty()) {
-            for (auto& property_string : property_strings) {
-                if (!first)
-                    builder.append(',');
-                first = false;
-                builder.append(property_string);
-            }
-        } else {
-            builder.append('\n');
-            builder.append(state.indent);
-            auto separator = ByteString::formatted(",\n{}", state.indent);
-            for (auto& property_string : property_strings) {
-                if (!first)
-                    builder.append(separator);
-                first = false;
-                builder.append(property_string);
-            }
-            builder.append('\n');
-            builder.append(previous_indent);
-        }
-        builder.append('}');
-    }
+
+    --state.indent_level;
+    if (has_properties)
+        append_newline_and_indent(state);
+    builder.append('}');
 
     state.seen_objects.remove(&object);
-    state.indent = previous_indent;
-    return builder.to_byte_string();
+    return {};
 }
 
 // 25.5.2.5 SerializeJSONArray ( state, value ), https://tc39.es/ecma262/#sec-serializejsonarray
-ThrowCompletionOr<ByteString> JSONObject::serialize_json_array(VM& vm, StringifyState& state, Object& object)
+ThrowCompletionOr<void> JSONObject::serialize_json_array(VM& vm, StringifyState& state, Object& object)
 {
     if (state.seen_objects.contains(&object))
         return vm.throw_completion<TypeError>(ErrorType::JsonCircular);
 
     state.seen_objects.set(&object);
-    ByteString previous_indent = state.indent;
-    state.indent = ByteString::formatted("{}{}", state.indent, state.gap);
-    Vector<ByteString> property_strings;
+    ++state.indent_level;
 
     auto length = TRY(length_of_array_like(vm, object));
 
-    // Optimization
-    property_strings.ensure_capacity(length);
+    auto& builder = state.builder;
+    builder.append('[');
 
     for (size_t i = 0; i < length; ++i) {
-        auto serialized_property_string = TRY(serialize_json_property(vm, state, i, &object));
-        if (!serialized_property_string.has_value()) {
-            property_strings.append("null"sv);
-        } else {
-            property_strings.append(serialized_property_string.release_value());
-        }
-    }
+        if (i > 0)
+            builder.append(',');
+        append_newline_and_indent(state);
+
+        // Elements of packed arrays are plain data properties, so they can be read without a full [[Get]]. This has to be
+        // checked again for every element, as serializing the previous ones may have changed the array.
+        bool did_serialize_element;
+        if (auto const* storage = packed_element_storage(object); storage && i < storage->array_like_size())
+            did_serialize_element = TRY(serialize_json_value(vm, state, i, &object, storage->elements()[i]));
+        else
+            did_serialize_element = TRY(serialize_json_property(vm, state, i, &object));
 
-    StringBuilder builder;
-    if (property_strings.is_empty()) {
-        builder.append("[]"sv);
-    } else {
-        if (state.gap.is_empty()) {
-            builder.append('[');
-            bool first = true;
-            for (auto& property_string : property_strings) {
-                if (!first)
-                    builder.append(',');
-                first = false;
-                builder.append(property_string);
-            }
-            builder.append(']');
-        } else {
-            builder.append("[\n"sv);
-            builder.append(state.indent);
-            auto separator = ByteString::formatted(",\n{}", state.indent);
-            bool first = true;
-            for (auto& property_string : property_strings) {
-                if (!first)
-                    builder.append(separator);
-                first = false;
-                builder.append(property_string);
-            }
-            builder.append('\n');
-            builder.append(previous_indent);
-            builder.append(']');
-        }
+        if (!did_serialize_element)
+            builder.append("null"sv);
     }
 
+    --state.indent_level;
+    if (length > 0)
+        append_newline_and_indent(state);
+    builder.append(']');
+
     state.seen_objects.remove(&object);
-    state.indent = previous_indent;
-    return builder.to_byte_string();
+    return {};
+}
+
+void JSONObject::append_newline_and_indent(StringifyState& state)
+{
+    if (state.gap.is_empty())
+        return;
+    state.builder.append('\n');
+    for (size_t i = 0; i < state.indent_level; ++i)
+        state.builder.append(state.gap);
 }
 
 // 25.5.2.2 QuoteJSONString ( value ), https://tc39.es/ecma262/#sec-quotejsonstring
-ByteString JSONObject::quote_json_string(ByteString string)
+void JSONObject::quote_json_string(StringBuilder& builder, StringView string)
 {
     // 1. Let product be the String value consisting solely of the code unit 0x0022 (QUOTATION MARK).
-    StringBuilder builder;
     builder.append('"');
 
+    // OPTIMIZATION: Most code points are copied over as they are, so we append as many of them at a time as we can.
+    //               Everything that needs escaping is ASCII, except for lone surrogates, whose encoding starts with 0xED.
+    size_t unescaped_start = 0;
+    auto append_unescaped_code_points = [&](size_t end) {
+        builder.append(string.substring_view(unescaped_start, end - unescaped_start));
+    };
+
     // 2. For each code point C of StringToCodePoints(value), do
-    auto utf_view = Utf8View(string);
-    for (auto code_point : utf_view) {
+    for (size_t i = 0; i < string.length();) {
+        auto byte = static_cast<u8>(string[i]);
+
+        if (byte == 0xed && i + 2 < string.length() && (static_cast<u8>(string[i + 1]) & 0xe0) == 0xa0) {
+            // b. Else if C has a numeric value less than 0x0020 (SPACE), or if C has the same numeric value as a leading surrogate or trailing surrogate, then
+            append_unescaped_code_points(i);
+            u32 code_point = ((byte & 0x0f) << 12) | ((static_cast<u8>(string[i + 1]) & 0x3f) << 6) | (static_cast<u8>(string[i + 2]) & 0x3f);
+            // i. Let unit be the code unit whose numeric value is that of C.
+            // ii. Set product to the string-concatenation of product and UnicodeEscape(unit).
+            builder.appendff("\\u{:04x}", code_point);
+            i += 3;
+            unescaped_start = i;
+            continue;
+        }
+
+        // c. Else,
+        //    i. Set product to the string-concatenation of product and UTF16EncodeCodePoint(C).
+        if (byte >= 0x20 && byte != '"' && byte != '\\') {
+            ++i;
+            continue;
+        }
+
+        append_unescaped_code_points(i);
+
         // a. If C is listed in the “Code Point” column of Table 70, then
         // i. Set product to the string-concatenation of product and the escape sequence for C as specified in the “Escape Sequence” column of the corresponding row.
-        switch (code_point) {
+        switch (byte) {
         case '\b':
             builder.append("\\b"sv);
             break;
@@ -385,26 +438,339 @@ ByteString JSONObject::quote_json_string(ByteString string)
             builder.append("\\\\"sv);
             break;
         default:
-            // b. Else if C has a numeric value less than 0x0020 (SPACE), or if C has the same numeric value as a leading surrogate or trailing surrogate, then
-            if (code_point < 0x20 || is_unicode_surrogate(code_point)) {
-                // i. Let unit be the code unit whose numeric value is that of C.
-                // ii. Set product to the string-concatenation of product and UnicodeEscape(unit).
-                builder.appendff("\\u{:04x}", code_point);
-            }
-            // c. Else,
-            else {
-                // i. Set product to the string-concatenation of product and UTF16EncodeCodePoint(C).
-                builder.append_code_point(code_point);
-            }
+            builder.appendff("\\u{:04x}", byte);
         }
+        ++i;
+        unescaped_start = i;
     }
+    append_unescaped_code_points(string.length());
+
     // 3. Set product to the string-concatenation of product and the code unit 0x0022 (QUOTATION MARK).
     builder.append('"');
-
-    // 4. Return product.
-    return builder.to_byte_string();
 }
 
+// Parses JSON text straight into JS values, without going through an intermediate JsonValue tree.
+class JSONTextParser : public GenericLexer {
+public:
+    JSONTextParser(VM& vm, StringView text)
+        : GenericLexer(text)
+        , m_vm(vm)
+        , m_realm(*vm.current_realm())
+        , m_values(vm.heap())
+        , m_recent_shapes(vm.heap())
+    {
+    }
+
+    ThrowCompletionOr<Value> parse()
+    {
+        auto value = TRY(parse_value());
+        skip_whitespace();
+        if (!is_eof())
+            return malformed();
+        return value;
+    }
+
+private:
+    static constexpr size_t max_nesting_depth = JsonParser::max_nesting_depth;
+    static constexpr size_t max_recent_shapes = 16;
+
+    Completion malformed() const { return m_vm.throw_completion<SyntaxError>(ErrorType::JsonMalformed); }
+
+    void skip_whitespace()
+    {
+        ignore_while([](char ch) { return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r'; });
+    }
+
+    static bool is_unescaped_string_character(char ch)
+    {
+        return ch != '"' && ch != '\\' && !is_ascii_c0_control(ch);
+    }
+
+    ThrowCompletionOr<Value> parse_value()
+    {
+        skip_whitespace();
+        switch (peek()) {
+        case '{':
+            return parse_object();
+        case '[':
+            return parse_array();
+        case '"':
+            return Value(PrimitiveString::create(m_vm, ByteString { TRY(parse_string()) }));
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            return parse_number();
+        case 't':
+            if (consume_specific("true"sv))
+                return Value(true);
+            break;
+        case 'f':
+            if (consume_specific("false"sv))
+                return Value(false);
+            break;
+        case 'n':
+            if (consume_specific("null"sv))
+                return js_null();
+            break;
+        }
+        return malformed();
+    }
+
+    // The returned view points into either the source text or m_string_builder, so it is only valid until the next string is parsed.
+    ThrowCompletionOr<StringView> parse_string()
+    {
+        if (!consume_specific('"'))
+            return malformed();
+
+        // Most strings don't contain any escape sequences, and can be used straight from the source text.
+        auto start = tell();
+        ignore_while(is_unescaped_string_character);
+        if (consume_specific('"'))
+            return m_input.substring_view(start, tell() - start - 1);
+
+        m_string_builder.clear();
+        m_string_builder.append(m_input.substring_view(start, tell() - start));
+        while (consume_specific('\\')) {
+            auto escaped_character = peek();
+            if (is_eof())
+                return malformed();
+            ignore();
+
+            switch (escaped_character) {
+            case '"':
+            case '\\':
+            case '/':
+                m_string_builder.append(escaped_character);
+                break;
+            case 'b':
+                m_string_builder.append('\b');
+                break;
+            case 'f':
+                m_string_builder.append('\f');
+                break;
+            case 'n':
+                m_string_builder.append('\n');
+                break;
+            case 'r':
+                m_string_builder.append('\r');
+                break;
+            case 't':
+                m_string_builder.append('\t');
+                break;
+            case 'u': {
+                auto code_point = decode_single_or_paired_surrogate();
+                if (code_point.is_error())
+                    return malformed();
+                m_string_builder.append_code_point(code_point.value());
+                break;
+            }
+            default:
+                return malformed();
+            }
+
+            m_string_builder.append(consume_while(is_unescaped_string_character));
+        }
+
+        // Anything other than the closing quote is either the end of the text or a control character.
+        if (!consume_specific('"'))
+            return malformed();
+        return m_string_builder.string_view();
+    }
+
+    ThrowCompletionOr<Value> parse_number()
+    {
+        auto start = tell();
+        auto is_negative = consume_specific('-');
+
+        if (!is_ascii_digit(peek()))
+            return malformed();
+        if (peek() == '0' && is_ascii_digit(peek(1)))
+            return malformed();
+
+        i32 integer = 0;
+        size_t digit_count = 0;
+        for (; is_ascii_digit(peek()); ++digit_count) {
+            auto digit = consume() - '0';
+            if (digit_count < 9)
+                integer = integer * 10 + digit;
+        }
+
+        auto is_integer = true;
+        if (consume_specific('.')) {
+            if (!is_ascii_digit(peek()))
+                return malformed();
+            ignore_while(is_ascii_digit);
+            is_integer = false;
+        }
+        if (consume_specific('e') || consume_specific('E')) {
+            if (!consume_specific('+'))
+                consume_specific('-');
+            if (!is_ascii_digit(peek()))
+                return malformed();
+            ignore_while(is_ascii_digit);
+            is_integer = false;
+        }
+
+        // Most numbers in JSON are integers that are small enough to not need the floating point parser.
+        if (is_integer && digit_count <= 9) {
+            if (is_negative && integer == 0)
+                return Value(-0.0);
+            return Value(is_negative ? -integer : integer);
+        }
+
+        auto text = m_input.substring_view(start, tell() - start);
+        auto const* text_end = text.characters_without_null_termination() + text.length();
+        auto result = parse_first_floating_point<double>(text.characters_without_null_termination(), text_end);
+        if (!result.parsed_value() || result.end_ptr != text_end)
+            return malformed();
+        return Value(result.value);
+    }
+
+    ThrowCompletionOr<Value> parse_object()
+    {
+        if (m_nesting_depth >= max_nesting_depth)
+            return malformed();
+        ++m_nesting_depth;
+        ScopeGuard nesting_depth_guard { [this] { --m_nesting_depth; } };
+
+        ignore(); // '{'
+
+        // Members are kept on the key and value stacks until the object can be created with all of them at once.
+        auto first_key = m_keys.size();
+        auto first_value = m_values.size();
+
+        skip_whitespace();
+        if (!consume_specific('}')) {
+            for (;;) {
+                skip_whitespace();
+                auto key = TRY(parse_string());
+                m_keys.append(DeprecatedFlyString { key });
+
+                skip_whitespace();
+                if (!consume_specific(':'))
+                    return malformed();
+
+                auto value = TRY(parse_value());
+                m_values.append(value);
+
+                skip_whitespace();
+                if (consume_specific('}'))
+                    break;
+                if (!consume_specific(','))
+                    return malformed();
+            }
+        }
+
+        auto object = create_object(m_keys.span().slice(first_key), m_values.span().slice(first_value));
+        m_keys.shrink(first_key);
+        m_values.shrink(first_value);
+        return Value(object);
+    }
+
+    ThrowCompletionOr<Value> parse_array()
+    {
+        if (m_nesting_depth >= max_nesting_depth)
+            return malformed();
+        ++m_nesting_depth;
+        ScopeGuard nesting_depth_guard { [this] { --m_nesting_depth; } };
+
+        ignore(); // '['
+
+        auto first_element = m_values.size();
+
+        skip_whitespace();
+        if (!consume_specific(']')) {
+            for (;;) {
+                auto element = TRY(parse_value());
+                m_values.append(element);
+
+                skip_whitespace();
+                if (consume_specific(']'))
+                    break;
+                if (!consume_specific(','))
+                    return malformed();
+            }
+        }
+
+        auto array = MUST(Array::create(m_realm, 0));
+        auto elements = m_values.span().slice(first_element);
+        for (size_t i = 0; i < elements.size(); ++i)
+            array->define_direct_property(i, elements[i], default_attributes);
+        m_values.shrink(first_element);
+        return Value(array);
+    }
+
+    static bool shape_has_keys(Shape const& shape, ReadonlySpan<DeprecatedFlyString> keys)
+    {
+        if (shape.property_count() != keys.size())
+            return false;
+        size_t index = 0;
+        for (auto const& it : shape.property_table()) {
+            if (!it.key.is_string() || it.key.as_string() != keys[index] || it.value.offset != index)
+                return false;
+            ++index;
+        }
+        return true;
+    }
+
+    NonnullGCPtr<Object> create_object(ReadonlySpan<DeprecatedFlyString> keys, ReadonlySpan<Value> values)
+    {
+        if (keys.is_empty())
+            return Object::create(m_realm, m_realm.intrinsics().object_prototype());
+
+        // JSON tends to contain lots of objects with the same keys in the same order. If one like this was parsed recently,
+        // the shape it ended up with can be used right away instead of going through a transition for every key.
+        for (size_t i = 0; i < m_recent_shapes.size(); ++i) {
+            auto& shape = *m_recent_shapes[i];
+            if (!shape_has_keys(shape, keys))
+                continue;
+
+            if (i != 0) {
+                m_recent_shapes.remove(i);
+                m_recent_shapes.prepend(&shape);
+            }
+            auto object = Object::create_with_premade_shape(shape);
+            for (size_t j = 0; j < values.size(); ++j)
+                object->put_direct(j, values[j]);
+            return object;
+        }
+
+        auto object = Object::create(m_realm, m_realm.intrinsics().object_prototype());
+        for (size_t i = 0; i < keys.size(); ++i)
+            object->define_direct_property(keys[i], values[i], default_attributes);
+
+        // Array indices and duplicate keys don't end up in the shape, and dictionaries are never shared between objects.
+        auto& shape = object->shape();
+        if (!shape.is_dictionary() && shape.property_count() == keys.size()) {
+            if (m_recent_shapes.size() == max_recent_shapes)
+                m_recent_shapes.take_last();
+            m_recent_shapes.prepend(&shape);
+        }
+        return object;
+    }
+
+    VM& m_vm;
+    Realm& m_realm;
+
+    // Values of objects and arrays that haven't been created yet.
+    MarkedVector<Value> m_values;
+    Vector<DeprecatedFlyString> m_keys;
+
+    // Most recently used first.
+    MarkedVector<Shape*> m_recent_shapes;
+
+    StringBuilder m_string_builder;
+    size_t m_nesting_depth { 0 };
+};
+
 // 25.5.1 JSON.parse ( text [ , reviver ] ), https://tc39.es/ecma262/#sec-json.parse
 JS_DEFINE_NATIVE_FUNCTION(JSONObject::parse)
 {
@@ -413,10 +779,7 @@ JS_DEFINE_NATIVE_FUNCTION(JSONObject::parse)
     auto string = TRY(vm.argument(0).to_byte_string(vm));
     auto reviver = vm.argument(1);
 
-    auto json = JsonValue::from_string(string);
-    if (json.is_error())
-        return vm.throw_completion<SyntaxError>(ErrorType::JsonMalformed);
-    Value unfiltered = parse_json_value(vm, json.value());
+    Value unfiltered = TRY(JSONTextParser(vm, string).parse());
     if (reviver.is_function()) {
         auto root = Object::create(realm, realm.intrinsics().object_prototype());
         auto root_name = ByteString::empty();
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/StringBuilder.h>
 #include <LibJS/Runtime/Object.h>
 
 namespace JS {
@@ -30,16 +31,22 @@ private:
     struct StringifyState {
         GCPtr<FunctionObject> replacer_function;
         HashTable<GCPtr<Object>> seen_objects;
-        ByteString indent { ByteString::empty() };
+        // The indent is always the gap repeated this many times.
+        size_t indent_level { 0 };
         ByteString gap;
         Optional<Vector<ByteString>> property_list;
+        // Everything is serialized straight into this one builder.
+        StringBuilder builder;
     };
 
     // Stringify helpers
-    static ThrowCompletionOr<Optional<ByteString>> serialize_json_property(VM&, StringifyState&, PropertyKey const& key, Object* holder);
-    static ThrowCompletionOr<ByteString> serialize_json_object(VM&, StringifyState&, Object&);
-    static ThrowCompletionOr<ByteString> serialize_json_array(VM&, StringifyState&, Object&);
-    static ByteString quote_json_string(ByteString);
+    // These append to the state's builder, and return false for values that aren't serialized at all.
+    static ThrowCompletionOr<bool> serialize_json_property(VM&, StringifyState&, PropertyKey const& key, Object* holder);
+    static ThrowCompletionOr<bool> serialize_json_value(VM&, StringifyState&, PropertyKey const& key, Object* holder, Value);
+    static ThrowCompletionOr<void> serialize_json_object(VM&, StringifyState&, Object&);
+    static ThrowCompletionOr<void> serialize_json_array(VM&, StringifyState&, Object&);
+    static void quote_json_string(StringBuilder&, StringView);
+    static void append_newline_and_indent(StringifyState&);
 
     // Parse helpers
     static Object* parse_json_object(VM&, JsonObject const&);
@@ -552,6 +552,7 @@ ThrowCompletionOr<void> Object::private_field_add(PrivateName const& name, Value
 
     // 4. Append PrivateElement { [[Key]]: P, [[Kind]]: field, [[Value]]: value } to O.[[PrivateElements]].
     m_private_elements->empend(name, PrivateElement::Kind::Field, value);
+    did_store_edge(value);
 
     // 5. Return unused.
     return {};
@@ -579,6 +580,7 @@ ThrowCompletionOr<void> Object::private_method_or_accessor_add(PrivateElement el
         m_private_elements = make<Vector<PrivateElement>>();
 
     // 5. Append method to O.[[PrivateElements]].
+    did_store_edge(element.value);
     m_private_elements->append(move(element));
 
     // 6. Return unused.
@@ -635,6 +637,7 @@ ThrowCompletionOr<void> Object::private_set(PrivateName const& name, Value value
     if (entry->kind == PrivateElement::Kind::Field) {
         // a. Set entry.[[Value]] to value.
         entry->value = value;
+        did_store_edge(value);
         return {};
     }
     // 4. Else if entry.[[Kind]] is method, then
@@ -985,7 +988,7 @@ ThrowCompletionOr<bool> Object::ordinary_set_with_own_descriptor(PropertyKey con
         // b. If parent is not null, then
         if (parent) {
             // i. Return ? parent.[[Set]](P, V, Receiver).
-            return TRY(parent->internal_set(property_key, value, receiver));
+            return TRY(parent->internal_set(property_key, value, receiver, cacheable_metadata));
         }
         // c. Else,
         else {
@@ -1027,7 +1030,7 @@ ThrowCompletionOr<bool> Object::ordinary_set_with_own_descriptor(PropertyKey con
             // iii. Let valueDesc be the PropertyDescriptor { [[Value]]: V }.
             auto value_descriptor = PropertyDescriptor { .value = value };
 
-            if (cacheable_metadata && own_descriptor.has_value() && own_descriptor->property_offset.has_value() && shape().is_cacheable()) {
+            if (cacheable_metadata && &receiver_object == this && own_descriptor.has_value() && own_descriptor->property_offset.has_value() && shape().is_cacheable()) {
                 *cacheable_metadata = CacheablePropertyMetadata {
                     .type = CacheablePropertyMetadata::Type::OwnProperty,
                     .property_offset = own_descriptor->property_offset.value(),
@@ -1044,7 +1047,17 @@ ThrowCompletionOr<bool> Object::ordinary_set_with_own_descriptor(PropertyKey con
             VERIFY(!receiver_object.storage_has(property_key));
 
             // ii. Return ? CreateDataProperty(Receiver, P, V).
-            return TRY(receiver_object.create_data_property(property_key, value));
+            auto succeeded = TRY(receiver_object.create_data_property(property_key, value));
+
+            // Non-standard: Let the caller know that nothing along the prototype chain got in the way of adding the property.
+            if (succeeded && cacheable_metadata && receiver_object.shape().is_cacheable()) {
+                *cacheable_metadata = CacheablePropertyMetadata {
+                    .type = CacheablePropertyMetadata::Type::AddedOwnProperty,
+                    .property_offset = {},
+                    .prototype = nullptr,
+                };
+            }
+            return succeeded;
         }
     }
 
@@ -1176,8 +1189,11 @@ Optional<ValueAndAttributes> Object::storage_get(PropertyKey const& property_key
             return {};
 
         if (m_has_intrinsic_accessors) {
-            if (auto accessor = find_intrinsic_accessor(this, property_key); accessor.has_value())
-                const_cast<Object&>(*this).m_storage[metadata->offset] = (*accessor)(shape().realm());
+            if (auto accessor = find_intrinsic_accessor(this, property_key); accessor.has_value()) {
+                auto& self = const_cast<Object&>(*this);
+                self.m_storage[metadata->offset] = (*accessor)(shape().realm());
+                self.did_store_edge(self.m_storage[metadata->offset]);
+            }
         }
 
         value = m_storage[metadata->offset];
@@ -1205,6 +1221,7 @@ void Object::storage_set(PropertyKey const& property_key, ValueAndAttributes con
     if (property_key.is_number()) {
         auto index = property_key.as_number();
         m_indexed_properties.put(index, value, attributes);
+        did_store_edge(value);
         return;
     }
 
@@ -1226,6 +1243,7 @@ void Object::storage_set(PropertyKey const& property_key, ValueAndAttributes con
         else
             set_shape(*m_shape->create_put_transition(property_key_string_or_symbol, attributes));
         m_storage.append(value);
+        did_store_edge(value);
         return;
     }
 
@@ -1237,6 +1255,7 @@ void Object::storage_set(PropertyKey const& property_key, ValueAndAttributes con
     }
 
     m_storage[metadata->offset] = value;
+    did_store_edge(value);
 }
 
 void Object::storage_delete(PropertyKey const& property_key)
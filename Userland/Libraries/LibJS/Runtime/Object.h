@@ -47,6 +47,7 @@ struct CacheablePropertyMetadata {
         NotCacheable,
         OwnProperty,
         InPrototypeChain,
+        AddedOwnProperty,
     };
     Type type { Type::NotCacheable };
     Optional<u32> property_offset;
@@ -56,6 +57,7 @@ struct CacheablePropertyMetadata {
 class Object : public Cell {
     JS_CELL(Object, Cell);
     JS_DECLARE_ALLOCATOR(Object);
+    JS_USES_WRITE_BARRIER(Object);
 
 public:
     static NonnullGCPtr<Object> create_prototype(Realm&, Object* prototype);
@@ -156,6 +158,15 @@ public:
     //       might not hold when property access behaves differently.
     bool may_interfere_with_indexed_property_access() const { return m_may_interfere_with_indexed_property_access; }
 
+    // Non-standard: Whether [[Set]] and [[DefineOwnProperty]] behave like those of an ordinary object for any property.
+    //               Inline caches rely on this to add properties to the object's storage without calling either.
+    //               Objects that may interfere with indexed property access are all exotic, so they're excluded by default.
+    virtual bool has_ordinary_set_and_define_own_property() const { return !m_may_interfere_with_indexed_property_access; }
+
+    // Non-standard: Whether the enumerable own string keys of the object are exactly those of its indexed properties and
+    //               its shape, so they can be enumerated without going through [[OwnPropertyKeys]].
+    virtual bool eligible_for_own_property_enumeration_fast_path() const { return !m_may_interfere_with_indexed_property_access; }
+
     ThrowCompletionOr<bool> ordinary_set_with_own_descriptor(PropertyKey const&, Value, Value, Optional<PropertyDescriptor>, CacheablePropertyMetadata* = nullptr);
 
     // 10.4.7 Immutable Prototype Exotic Objects, https://tc39.es/ecma262/#sec-immutable-prototype-exotic-objects
@@ -209,11 +220,34 @@ public:
     virtual void visit_edges(Cell::Visitor&) override;
 
     Value get_direct(size_t index) const { return m_storage[index]; }
-    void put_direct(size_t index, Value value) { m_storage[index] = value; }
+    void put_direct(size_t index, Value value)
+    {
+        m_storage[index] = value;
+        did_store_edge(value);
+    }
+
+    // Non-standard: Adds the one property that a put transition of the current shape adds, for inline caches that have
+    // already made sure that storing the property would end up doing exactly that. Returns false if the object isn't extensible.
+    [[nodiscard]] bool put_direct_with_transition(Shape& new_shape, Value value)
+    {
+        if (!m_is_extensible)
+            return false;
+        VERIFY(new_shape.property_count() == m_storage.size() + 1);
+        set_shape(new_shape);
+        m_storage.append(value);
+        did_store_edge(value);
+        return true;
+    }
 
     IndexedProperties const& indexed_properties() const { return m_indexed_properties; }
+    // NOTE: Storing values through this has to be followed by did_store_edge(), see Cell::uses_write_barrier().
     IndexedProperties& indexed_properties() { return m_indexed_properties; }
-    void set_indexed_property_elements(Vector<Value>&& values) { m_indexed_properties = IndexedProperties(move(values)); }
+    void set_indexed_property_elements(Vector<Value>&& values)
+    {
+        for (auto value : values)
+            did_store_edge(value);
+        m_indexed_properties = IndexedProperties(move(values));
+    }
 
     Shape& shape() { return *m_shape; }
     Shape const& shape() const { return *m_shape; }
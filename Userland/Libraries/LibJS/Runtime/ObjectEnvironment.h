@@ -13,6 +13,7 @@ namespace JS {
 class ObjectEnvironment final : public Environment {
     JS_ENVIRONMENT(ObjectEnvironment, Environment);
     JS_DECLARE_ALLOCATOR(ObjectEnvironment);
+    JS_USES_WRITE_BARRIER(ObjectEnvironment);
 
 public:
     enum class IsWithEnvironment {
@@ -26,6 +26,8 @@ PrimitiveString::PrimitiveString(PrimitiveString& lhs, PrimitiveString& rhs)
     , m_lhs(&lhs)
     , m_rhs(&rhs)
 {
+    if (lhs.m_length_in_utf16_code_units != unknown_length && rhs.m_length_in_utf16_code_units != unknown_length)
+        m_length_in_utf16_code_units = lhs.m_length_in_utf16_code_units + rhs.m_length_in_utf16_code_units;
 }
 
 PrimitiveString::PrimitiveString(String string)
@@ -45,12 +47,26 @@ PrimitiveString::PrimitiveString(Utf16String string)
 
 PrimitiveString::~PrimitiveString()
 {
-    if (has_utf8_string())
-        vm().string_cache().remove(*m_utf8_string);
-    if (has_utf16_string())
-        vm().utf16_string_cache().remove(*m_utf16_string);
-    if (has_byte_string())
-        vm().byte_string_cache().remove(*m_byte_string);
+    // NOTE: Another string with the same contents may have been interned in the meantime if this one was taken out of
+    //       the cache, so we only remove the entry if it's still ours.
+    auto remove_from_cache = [this](auto& cache, auto const& key) {
+        if (auto it = cache.find(key); it != cache.end() && it->value == this)
+            cache.remove(it);
+    };
+
+    switch (m_interned_as) {
+    case InternedAs::None:
+        break;
+    case InternedAs::UTF8String:
+        remove_from_cache(vm().string_cache(), m_utf8_string->bytes_as_string_view());
+        break;
+    case InternedAs::ByteString:
+        remove_from_cache(vm().string_cache(), m_byte_string->view());
+        break;
+    case InternedAs::UTF16String:
+        remove_from_cache(vm().utf16_string_cache(), *m_utf16_string);
+        break;
+    }
 }
 
 void PrimitiveString::visit_edges(Cell::Visitor& visitor)
@@ -143,10 +159,8 @@ ThrowCompletionOr<Optional<Value>> PrimitiveString::get(VM& vm, PropertyKey cons
     if (property_key.is_symbol())
         return Optional<Value> {};
     if (property_key.is_string()) {
-        if (property_key.as_string() == vm.names.length.as_string()) {
-            auto length = utf16_string().length_in_code_units();
-            return Value(static_cast<double>(length));
-        }
+        if (property_key.as_string() == vm.names.length.as_string())
+            return Value(static_cast<double>(length_in_utf16_code_units()));
     }
     auto index = canonical_numeric_index_string(property_key, CanonicalIndexMode::IgnoreNumericRoundtrip);
     if (!index.is_index())
@@ -169,11 +183,15 @@ NonnullGCPtr<PrimitiveString> PrimitiveString::create(VM& vm, Utf16String string
             return vm.single_ascii_character_string(static_cast<u8>(code_unit));
     }
 
+    if (string.length_in_code_units() > max_interned_string_length)
+        return vm.heap().allocate_without_realm<PrimitiveString>(move(string));
+
     auto& string_cache = vm.utf16_string_cache();
     if (auto it = string_cache.find(string); it != string_cache.end())
         return *it->value;
 
     auto new_string = vm.heap().allocate_without_realm<PrimitiveString>(string);
+    new_string->m_interned_as = InternedAs::UTF16String;
     string_cache.set(move(string), new_string);
     return *new_string;
 }
@@ -189,12 +207,16 @@ NonnullGCPtr<PrimitiveString> PrimitiveString::create(VM& vm, String string)
             return vm.single_ascii_character_string(ch);
     }
 
+    if (string.bytes().size() > max_interned_string_length)
+        return vm.heap().allocate_without_realm<PrimitiveString>(move(string));
+
     auto& string_cache = vm.string_cache();
-    if (auto it = string_cache.find(string); it != string_cache.end())
+    if (auto it = string_cache.find(string.bytes_as_string_view()); it != string_cache.end())
         return *it->value;
 
-    auto new_string = vm.heap().allocate_without_realm<PrimitiveString>(string);
-    string_cache.set(move(string), new_string);
+    auto new_string = vm.heap().allocate_without_realm<PrimitiveString>(move(string));
+    new_string->m_interned_as = InternedAs::UTF8String;
+    string_cache.set(new_string->m_utf8_string->bytes_as_string_view(), new_string);
     return *new_string;
 }
 
@@ -219,14 +241,17 @@ NonnullGCPtr<PrimitiveString> PrimitiveString::create(VM& vm, ByteString string)
             return vm.single_ascii_character_string(ch);
     }
 
-    auto& string_cache = vm.byte_string_cache();
-    auto it = string_cache.find(string);
-    if (it == string_cache.end()) {
-        auto new_string = vm.heap().allocate_without_realm<PrimitiveString>(string);
-        string_cache.set(move(string), new_string);
-        return *new_string;
-    }
-    return *it->value;
+    if (string.length() > max_interned_string_length)
+        return vm.heap().allocate_without_realm<PrimitiveString>(move(string));
+
+    auto& string_cache = vm.string_cache();
+    if (auto it = string_cache.find(string.view()); it != string_cache.end())
+        return *it->value;
+
+    auto new_string = vm.heap().allocate_without_realm<PrimitiveString>(move(string));
+    new_string->m_interned_as = InternedAs::ByteString;
+    string_cache.set(new_string->m_byte_string->view(), new_string);
+    return *new_string;
 }
 
 NonnullGCPtr<PrimitiveString> PrimitiveString::create(VM& vm, DeprecatedFlyString const& string)
@@ -251,9 +276,102 @@ NonnullGCPtr<PrimitiveString> PrimitiveString::create(VM& vm, PrimitiveString& l
     if (rhs_empty)
         return lhs;
 
+    // Building a short string a few pieces at a time shouldn't leave a rope behind, so we concatenate the pieces right
+    // away. This doesn't apply to appending to a long string, where the rope is what keeps us from copying the whole
+    // string every time (and going quadratic in a loop).
+    if (!lhs.m_is_rope && !rhs.m_is_rope
+        && lhs.length_in_storage_units() + rhs.length_in_storage_units() <= max_eagerly_flattened_concatenation_length) {
+        if (lhs.has_utf16_string() && rhs.has_utf16_string()) {
+            Utf16Data code_units;
+            code_units.ensure_capacity(lhs.m_utf16_string->length_in_code_units() + rhs.m_utf16_string->length_in_code_units());
+            code_units.extend(lhs.m_utf16_string->string());
+            code_units.extend(rhs.m_utf16_string->string());
+            return create(vm, Utf16String::create(move(code_units)));
+        }
+
+        // NOTE: A high surrogate at the end of lhs and a low surrogate at the start of rhs have to be joined into one code
+        //       point, which only resolving a rope takes care of. Surrogates encoded as UTF-8 start with 0xED.
+        auto lhs_string = lhs.utf8_string_view();
+        auto rhs_string = rhs.utf8_string_view();
+        if (lhs_string.length() < 3 || static_cast<u8>(lhs_string[lhs_string.length() - 3]) != 0xed || static_cast<u8>(rhs_string[0]) != 0xed) {
+            StringBuilder builder(lhs_string.length() + rhs_string.length());
+            builder.append(lhs_string);
+            builder.append(rhs_string);
+            return create(vm, builder.to_string_without_validation());
+        }
+    }
+
     return vm.heap().allocate_without_realm<PrimitiveString>(lhs, rhs);
 }
 
+size_t PrimitiveString::length_in_storage_units() const
+{
+    VERIFY(!m_is_rope);
+    if (has_utf8_string())
+        return m_utf8_string->bytes().size();
+    if (has_byte_string())
+        return m_byte_string->length();
+    if (has_utf16_string())
+        return m_utf16_string->length_in_code_units();
+    VERIFY_NOT_REACHED();
+}
+
+size_t PrimitiveString::flat_length_in_utf16_code_units() const
+{
+    VERIFY(!m_is_rope);
+    if (m_length_in_utf16_code_units == unknown_length) {
+        if (has_utf16_string())
+            m_length_in_utf16_code_units = m_utf16_string->length_in_code_units();
+        else if (has_utf8_string())
+            m_length_in_utf16_code_units = AK::utf16_code_unit_length_from_utf8(m_utf8_string->bytes_as_string_view());
+        else if (has_byte_string())
+            m_length_in_utf16_code_units = AK::utf16_code_unit_length_from_utf8(*m_byte_string);
+        else
+            VERIFY_NOT_REACHED();
+    }
+    return m_length_in_utf16_code_units;
+}
+
+size_t PrimitiveString::length_in_utf16_code_units() const
+{
+    if (m_length_in_utf16_code_units != unknown_length)
+        return m_length_in_utf16_code_units;
+    if (!m_is_rope)
+        return flat_length_in_utf16_code_units();
+
+    // NOTE: Concatenation never joins code units, so the length of a rope is simply the sum of the lengths of its
+    //       halves. Like when resolving a rope, we go through the tree without recursing, and remember the length of
+    //       every node on the way so that the next rope built on top of this one only needs to look at the new part.
+    Vector<PrimitiveString const*> stack;
+    stack.append(this);
+    while (!stack.is_empty()) {
+        auto const* current = stack.last();
+        if (current->m_length_in_utf16_code_units != unknown_length) {
+            stack.take_last();
+            continue;
+        }
+        if (!current->m_is_rope) {
+            (void)current->flat_length_in_utf16_code_units();
+            stack.take_last();
+            continue;
+        }
+
+        auto lhs_length = current->m_lhs->m_length_in_utf16_code_units;
+        auto rhs_length = current->m_rhs->m_length_in_utf16_code_units;
+        if (lhs_length != unknown_length && rhs_length != unknown_length) {
+            current->m_length_in_utf16_code_units = lhs_length + rhs_length;
+            stack.take_last();
+            continue;
+        }
+        if (lhs_length == unknown_length)
+            stack.append(current->m_lhs);
+        if (rhs_length == unknown_length)
+            stack.append(current->m_rhs);
+    }
+
+    return m_length_in_utf16_code_units;
+}
+
 void PrimitiveString::resolve_rope_if_needed(EncodingPreference preference) const
 {
     if (!m_is_rope)
@@ -287,6 +405,7 @@ void PrimitiveString::resolve_rope_if_needed(EncodingPreference preference) cons
             code_units.extend(current->utf16_string().string());
 
         m_utf16_string = Utf16String::create(move(code_units));
+        m_length_in_utf16_code_units = m_utf16_string->length_in_code_units();
         m_is_rope = false;
         m_lhs = nullptr;
         m_rhs = nullptr;
@@ -361,4 +480,42 @@ void PrimitiveString::resolve_rope_if_needed(EncodingPreference preference) cons
     m_rhs = nullptr;
 }
 
+void StringStorageStatistics::add(PrimitiveString const& string)
+{
+    if (string.is_rope()) {
+        ++rope_count;
+        return;
+    }
+
+    ++flat_string_count;
+    if (string.is_interned())
+        ++interned_string_count;
+
+    size_t encoding_count = 0;
+    if (string.has_utf8_string()) {
+        utf8_string_bytes += string.utf8_string_view().length();
+        ++encoding_count;
+    }
+    if (string.has_byte_string()) {
+        byte_string_bytes += string.byte_string().length();
+        ++encoding_count;
+    }
+    if (string.has_utf16_string()) {
+        utf16_string_bytes += string.utf16_string_view().length_in_code_units() * sizeof(u16);
+        ++encoding_count;
+    }
+    if (encoding_count > 1)
+        ++strings_with_multiple_encodings;
+}
+
+void StringStorageStatistics::dump() const
+{
+    warnln("\033[37;1mString storage\033[0m");
+    warnln("{:10} flat strings ({} interned, {} in more than one encoding)", flat_string_count, interned_string_count, strings_with_multiple_encodings);
+    warnln("{:10} ropes", rope_count);
+    warnln("{:10} bytes of UTF-8 strings", utf8_string_bytes);
+    warnln("{:10} bytes of byte strings", byte_string_bytes);
+    warnln("{:10} bytes of UTF-16 strings", utf16_string_bytes);
+}
+
 }
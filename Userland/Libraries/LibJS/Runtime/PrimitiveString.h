@@ -8,6 +8,7 @@
 #pragma once
 
 #include <AK/ByteString.h>
+#include <AK/NumericLimits.h>
 #include <AK/Optional.h>
 #include <AK/String.h>
 #include <AK/StringView.h>
@@ -23,6 +24,7 @@ namespace JS {
 class PrimitiveString final : public Cell {
     JS_CELL(PrimitiveString, Cell);
     JS_DECLARE_ALLOCATOR(PrimitiveString);
+    JS_USES_WRITE_BARRIER(PrimitiveString);
 
 public:
     [[nodiscard]] static NonnullGCPtr<PrimitiveString> create(VM&, Utf16String);
@@ -51,6 +53,12 @@ public:
     [[nodiscard]] Utf16View utf16_string_view() const;
     bool has_utf16_string() const { return m_utf16_string.has_value(); }
 
+    // The length of the string as seen by JS. This doesn't need to flatten a rope.
+    size_t length_in_utf16_code_units() const;
+
+    bool is_rope() const { return m_is_rope; }
+    bool is_interned() const { return m_interned_as != InternedAs::None; }
+
     ThrowCompletionOr<Optional<Value>> get(VM&, PropertyKey const&) const;
 
 private:
@@ -61,13 +69,37 @@ private:
 
     virtual void visit_edges(Cell::Visitor&) override;
 
+    // Only short strings are interned: they make up most property keys and repeatedly created strings, while hashing a
+    // long string whenever it's created would rarely pay off.
+    static constexpr size_t max_interned_string_length = 256;
+
+    // Concatenations that add up to at most this many bytes or code units produce a flat string instead of a rope, as a
+    // rope node and the strings it keeps alive take up more memory than the short result would.
+    static constexpr size_t max_eagerly_flattened_concatenation_length = 32;
+
+    static constexpr size_t unknown_length = NumericLimits<size_t>::max();
+
     enum class EncodingPreference {
         UTF8,
         UTF16,
     };
     void resolve_rope_if_needed(EncodingPreference) const;
 
+    size_t length_in_storage_units() const;
+    size_t flat_length_in_utf16_code_units() const;
+
+    // Which of the VM's string caches this string is interned in, and under which of its encodings.
+    enum class InternedAs : u8 {
+        None,
+        UTF8String,
+        ByteString,
+        UTF16String,
+    };
+
     mutable bool m_is_rope { false };
+    InternedAs m_interned_as { InternedAs::None };
+
+    mutable size_t m_length_in_utf16_code_units { unknown_length };
 
     mutable GCPtr<PrimitiveString> m_lhs;
     mutable GCPtr<PrimitiveString> m_rhs;
@@ -77,4 +109,20 @@ private:
     mutable Optional<Utf16String> m_utf16_string;
 };
 
+// How much memory the strings on the heap take up, for finding out where string-heavy code spends its memory. Storage
+// shared between strings is counted once for each of them.
+struct StringStorageStatistics {
+    void add(PrimitiveString const&);
+    void dump() const;
+
+    size_t flat_string_count { 0 };
+    size_t rope_count { 0 };
+    size_t interned_string_count { 0 };
+    size_t strings_with_multiple_encodings { 0 };
+
+    size_t utf8_string_bytes { 0 };
+    size_t byte_string_bytes { 0 };
+    size_t utf16_string_bytes { 0 };
+};
+
 }
@@ -53,6 +53,8 @@ private:
 
     virtual bool is_function() const override { return m_target->is_function(); }
     virtual bool is_proxy_object() const final { return true; }
+    virtual bool has_ordinary_set_and_define_own_property() const override { return false; }
+    virtual bool eligible_for_own_property_enumeration_fast_path() const override { return false; }
 
     NonnullGCPtr<Object> m_target;
     NonnullGCPtr<Object> m_handler;
@@ -14,7 +14,9 @@
 #include <AK/StringBuilder.h>
 #include <LibFileSystem/FileSystem.h>
 #include <LibJS/AST.h>
+#include <LibJS/BackgroundParser.h>
 #include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/ProgramCache.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/ArrayBuffer.h>
@@ -63,6 +65,7 @@ static constexpr auto single_ascii_character_strings = make_single_ascii_charact
 
 VM::VM(OwnPtr<CustomData> custom_data, ErrorMessages error_messages)
     : m_heap(*this)
+    , m_program_cache(make<ProgramCache>())
     , m_error_messages(move(error_messages))
     , m_custom_data(move(custom_data))
 {
@@ -201,6 +204,13 @@ Bytecode::Interpreter& VM::bytecode_interpreter()
     return *m_bytecode_interpreter;
 }
 
+BackgroundParser& VM::background_parser()
+{
+    if (!m_background_parser)
+        m_background_parser = make<BackgroundParser>(*this);
+    return *m_background_parser;
+}
+
 struct ExecutionContextRootsCollector : public Cell::Visitor {
     virtual void visit_impl(Cell& cell) override
     {
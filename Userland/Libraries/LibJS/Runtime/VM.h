@@ -56,6 +56,13 @@ public:
     Heap& heap() { return m_heap; }
     Heap const& heap() const { return m_heap; }
 
+    ProgramCache& program_cache() { return *m_program_cache; }
+    BackgroundParser& background_parser();
+
+    // Scripts and modules are parsed with Parser::set_lazy_function_parsing_enabled() when this is set.
+    bool lazy_function_parsing_enabled() const { return m_lazy_function_parsing_enabled; }
+    void set_lazy_function_parsing_enabled(bool enabled) { m_lazy_function_parsing_enabled = enabled; }
+
     Bytecode::Interpreter& bytecode_interpreter();
 
     void dump_backtrace() const;
@@ -70,16 +77,13 @@ public:
     JS_ENUMERATE_WELL_KNOWN_SYMBOLS
 #undef __JS_ENUMERATE
 
-    HashMap<String, GCPtr<PrimitiveString>>& string_cache()
+    // Strings created from UTF-8 and from byte strings share this cache, keyed by their bytes. The keys point into the
+    // strings themselves, which is fine as they remove themselves from the cache when they are swept.
+    HashMap<StringView, GCPtr<PrimitiveString>>& string_cache()
     {
         return m_string_cache;
     }
 
-    HashMap<ByteString, GCPtr<PrimitiveString>>& byte_string_cache()
-    {
-        return m_byte_string_cache;
-    }
-
     HashMap<Utf16String, GCPtr<PrimitiveString>>& utf16_string_cache()
     {
         return m_utf16_string_cache;
@@ -306,12 +310,15 @@ private:
 
     void set_well_known_symbols(WellKnownSymbols well_known_symbols) { m_well_known_symbols = move(well_known_symbols); }
 
-    HashMap<String, GCPtr<PrimitiveString>> m_string_cache;
-    HashMap<ByteString, GCPtr<PrimitiveString>> m_byte_string_cache;
+    HashMap<StringView, GCPtr<PrimitiveString>> m_string_cache;
     HashMap<Utf16String, GCPtr<PrimitiveString>> m_utf16_string_cache;
 
     Heap m_heap;
 
+    // NOTE: Cached programs hold handles to their bytecode, so this has to go away before the heap does.
+    NonnullOwnPtr<ProgramCache> m_program_cache;
+    OwnPtr<BackgroundParser> m_background_parser;
+
     Vector<ExecutionContext*> m_execution_context_stack;
 
     Vector<Vector<ExecutionContext*>> m_saved_execution_context_stacks;
@@ -350,6 +357,7 @@ private:
     OwnPtr<Bytecode::Interpreter> m_bytecode_interpreter;
 
     bool m_dynamic_imports_allowed { false };
+    bool m_lazy_function_parsing_enabled { false };
 };
 
 template<typename GlobalObjectType, typename... Args>
@@ -7,6 +7,7 @@
 #include <LibJS/AST.h>
 #include <LibJS/Lexer.h>
 #include <LibJS/Parser.h>
+#include <LibJS/ProgramCache.h>
 #include <LibJS/Runtime/VM.h>
 #include <LibJS/Script.h>
 
@@ -17,15 +18,32 @@ JS_DEFINE_ALLOCATOR(Script);
 // 16.1.5 ParseScript ( sourceText, realm, hostDefined ), https://tc39.es/ecma262/#sec-parse-script
 Result<NonnullGCPtr<Script>, Vector<ParserError>> Script::parse(StringView source_text, Realm& realm, StringView filename, HostDefined* host_defined, size_t line_number_offset)
 {
+    auto& program_cache = realm.vm().program_cache();
+    if (auto script = program_cache.get(source_text, filename, line_number_offset, Program::Type::Script))
+        return create(realm, filename, script.release_nonnull(), host_defined);
+
     // 1. Let script be ParseText(sourceText, Script).
+    // 2. If script is a List of errors, return body.
+    auto script = TRY(parse_program(source_text, filename, line_number_offset, realm.vm().lazy_function_parsing_enabled()));
+
+    program_cache.set(source_text, line_number_offset, script);
+
+    // 3. Return Script Record { [[Realm]]: realm, [[ECMAScriptCode]]: script, [[HostDefined]]: hostDefined }.
+    return create(realm, filename, move(script), host_defined);
+}
+
+Result<NonnullRefPtr<Program>, Vector<ParserError>> Script::parse_program(StringView source_text, StringView filename, size_t line_number_offset, bool lazy_function_parsing_enabled)
+{
     auto parser = Parser(Lexer(source_text, filename, line_number_offset));
+    parser.set_lazy_function_parsing_enabled(lazy_function_parsing_enabled);
     auto script = parser.parse_program();
-
-    // 2. If script is a List of errors, return body.
     if (parser.has_errors())
         return parser.errors();
+    return script;
+}
 
-    // 3. Return Script Record { [[Realm]]: realm, [[ECMAScriptCode]]: script, [[HostDefined]]: hostDefined }.
+NonnullGCPtr<Script> Script::create(Realm& realm, StringView filename, NonnullRefPtr<Program> script, HostDefined* host_defined)
+{
     return realm.heap().allocate_without_realm<Script>(realm, filename, move(script), host_defined);
 }
 
@@ -29,6 +29,11 @@ public:
     virtual ~Script() override;
     static Result<NonnullGCPtr<Script>, Vector<ParserError>> parse(StringView source_text, Realm&, StringView filename = {}, HostDefined* = nullptr, size_t line_number_offset = 1);
 
+    // The two halves of parse(). Parsing the source text touches neither the heap nor the VM, so it may happen on another
+    // thread, after which the Script is created on the thread that owns the realm.
+    static Result<NonnullRefPtr<Program>, Vector<ParserError>> parse_program(StringView source_text, StringView filename = {}, size_t line_number_offset = 1, bool lazy_function_parsing_enabled = false);
+    static NonnullGCPtr<Script> create(Realm&, StringView filename, NonnullRefPtr<Program>, HostDefined* = nullptr);
+
     Realm& realm() { return *m_realm; }
     Program const& parse_node() const { return *m_parse_node; }
     Vector<ModuleWithSpecifier>& loaded_modules() { return m_loaded_modules; }
@@ -9,6 +9,7 @@
 #include <AK/QuickSort.h>
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Parser.h>
+#include <LibJS/ProgramCache.h>
 #include <LibJS/Runtime/AsyncFunctionDriverWrapper.h>
 #include <LibJS/Runtime/ECMAScriptFunctionObject.h>
 #include <LibJS/Runtime/GlobalEnvironment.h>
@@ -129,13 +130,30 @@ void SourceTextModule::visit_edges(Cell::Visitor& visitor)
 Result<NonnullGCPtr<SourceTextModule>, Vector<ParserError>> SourceTextModule::parse(StringView source_text, Realm& realm, StringView filename, Script::HostDefined* host_defined)
 {
     // 1. Let body be ParseText(sourceText, Module).
+    auto& program_cache = realm.vm().program_cache();
+    auto body = program_cache.get(source_text, filename, 0, Program::Type::Module);
+    if (!body) {
+        // 2. If body is a List of errors, return body.
+        body = TRY(parse_program(source_text, filename, realm.vm().lazy_function_parsing_enabled()));
+
+        program_cache.set(source_text, 0, *body);
+    }
+
+    return create(realm, filename, body.release_nonnull(), host_defined);
+}
+
+Result<NonnullRefPtr<Program>, Vector<ParserError>> SourceTextModule::parse_program(StringView source_text, StringView filename, bool lazy_function_parsing_enabled)
+{
     auto parser = Parser(Lexer(source_text, filename), Program::Type::Module);
+    parser.set_lazy_function_parsing_enabled(lazy_function_parsing_enabled);
     auto body = parser.parse_program();
-
-    // 2. If body is a List of errors, return body.
     if (parser.has_errors())
         return parser.errors();
+    return body;
+}
 
+NonnullGCPtr<SourceTextModule> SourceTextModule::create(Realm& realm, StringView filename, NonnullRefPtr<Program> body, Script::HostDefined* host_defined)
+{
     // 3. Let requestedModules be the ModuleRequests of body.
     auto requested_modules = module_requests(*body);
 
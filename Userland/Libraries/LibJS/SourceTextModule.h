@@ -23,6 +23,10 @@ public:
 
     static Result<NonnullGCPtr<SourceTextModule>, Vector<ParserError>> parse(StringView source_text, Realm&, StringView filename = {}, Script::HostDefined* host_defined = nullptr);
 
+    // The two halves of parse(), see Script::parse_program() and Script::create().
+    static Result<NonnullRefPtr<Program>, Vector<ParserError>> parse_program(StringView source_text, StringView filename = {}, bool lazy_function_parsing_enabled = false);
+    static NonnullGCPtr<SourceTextModule> create(Realm&, StringView filename, NonnullRefPtr<Program> body, Script::HostDefined* host_defined = nullptr);
+
     Program const& parse_node() const { return *m_ecmascript_code; }
 
     virtual ThrowCompletionOr<Vector<DeprecatedFlyString>> get_exported_names(VM& vm, Vector<Module*> export_star_set) override;
@@ -0,0 +1,74 @@
+describe("packed arrays", () => {
+    test("sorting Int32 elements uses their string representations", () => {
+        const array = [10, 9, 1, -1, -10, 0, 2147483647, -2147483648, 100];
+        expect(array.sort()).toBe(array);
+        expect(array).toEqual([-1, -10, -2147483648, 0, 1, 10, 100, 2147483647, 9]);
+    });
+
+    test("sorting with a comparator that makes the array holey", () => {
+        const array = [3, 1, 2];
+        array.sort((a, b) => {
+            delete array[0];
+            return a - b;
+        });
+        expect(array).toEqual([1, 2, 3]);
+    });
+
+    test("indexOf and includes with elements of different kinds", () => {
+        const int32s = [1, 2, 3];
+        expect(int32s.indexOf(2)).toBe(1);
+        expect(int32s.indexOf(2.5)).toBe(-1);
+        expect(int32s.indexOf("2")).toBe(-1);
+        expect(int32s.includes(-0)).toBeFalse();
+        expect([0].includes(-0)).toBeTrue();
+        expect([0].indexOf(-0)).toBe(0);
+
+        const numbers = [1.5, NaN, 3];
+        expect(numbers.indexOf(NaN)).toBe(-1);
+        expect(numbers.includes(NaN)).toBeTrue();
+        expect(numbers.indexOf(3, -1)).toBe(2);
+
+        const values = [1, "a", null, undefined];
+        expect(values.indexOf(undefined)).toBe(3);
+        expect(values.includes("a")).toBeTrue();
+    });
+
+    test("fill only touches the given range", () => {
+        const array = [1, 2, 3, 4];
+        expect(array.fill("x", 1, 3)).toBe(array);
+        expect(array).toEqual([1, "x", "x", 4]);
+    });
+
+    test("map sees changes that the callback makes to the array", () => {
+        const array = [1, 2, 3];
+        const result = array.map((value, index) => {
+            if (index === 0) array[2] = 30;
+            return value * 2;
+        });
+        expect(result).toEqual([2, 4, 60]);
+    });
+
+    test("push respects indexed setters on the prototype", () => {
+        let setterValue;
+        Object.defineProperty(Array.prototype, 1, {
+            set(value) {
+                setterValue = value;
+            },
+            configurable: true,
+        });
+        try {
+            const array = [0];
+            expect(array.push("a")).toBe(2);
+            expect(setterValue).toBe("a");
+            expect(Object.hasOwn(array, 1)).toBeFalse();
+        } finally {
+            delete Array.prototype[1];
+            Array.prototype.length = 0;
+        }
+    });
+
+    test("push to frozen and non-extensible arrays throws", () => {
+        expect(() => Object.freeze([1]).push(2)).toThrow(TypeError);
+        expect(() => Object.preventExtensions([1]).push(2)).toThrow(TypeError);
+    });
+});
@@ -74,3 +74,44 @@ test("does not truncate large integers", () => {
     expect(JSON.parse("18446744073709551616")).toEqual(18446744073709551616);
     expect(JSON.parse("18446744073709551617")).toEqual(18446744073709551617);
 });
+
+test("objects with the same keys", () => {
+    const objects = JSON.parse('[{"a":1,"b":2},{"a":3,"b":4},{"b":5,"a":6},{"a":7},{"a":8,"b":9,"c":10}]');
+    expect(objects).toEqual([{ a: 1, b: 2 }, { a: 3, b: 4 }, { b: 5, a: 6 }, { a: 7 }, { a: 8, b: 9, c: 10 }]);
+    expect(Object.keys(objects[1])).toEqual(["a", "b"]);
+    expect(Object.keys(objects[2])).toEqual(["b", "a"]);
+
+    objects[0].c = 11;
+    expect(objects[1].c).toBeUndefined();
+});
+
+test("duplicate and numeric keys", () => {
+    const objects = JSON.parse('[{"a":1,"b":2,"a":3},{"a":1,"b":2,"a":3},{"1":"x","0":"y","z":"w"}]');
+    expect(Object.keys(objects[0])).toEqual(["a", "b"]);
+    expect(objects[0].a).toBe(3);
+    expect(objects[1]).toEqual(objects[0]);
+    expect(Object.keys(objects[2])).toEqual(["0", "1", "z"]);
+});
+
+test("escape sequences", () => {
+    expect(JSON.parse('"a\\"b\\\\c\\/d\\be\\ff\\ng\\rh\\ti"')).toBe('a"b\\c/d\be\ff\ng\rh\ti');
+    expect(JSON.parse('"\\u0041\\ud83d\\ude04\\ud83d"')).toBe("A😄\ud83d");
+    expect(JSON.parse('{"\\u0061":1}')).toEqual({ a: 1 });
+    expect(() => JSON.parse('"\\x41"')).toThrow(SyntaxError);
+    expect(() => JSON.parse('"a\nb"')).toThrow(SyntaxError);
+    expect(() => JSON.parse('"abc')).toThrow(SyntaxError);
+});
+
+test("numbers", () => {
+    expect(JSON.parse("[0,-1,123456789,1234567890,-2147483648,1.5,1e3,1E-3,-2.5e+2]")).toEqual([
+        0, -1, 123456789, 1234567890, -2147483648, 1.5, 1000, 0.001, -250,
+    ]);
+    ["01", "1.", ".5", "1e", "1e+", "-", "+1", "--1"].forEach(text => {
+        expect(() => JSON.parse(text)).toThrow(SyntaxError);
+    });
+});
+
+test("deep nesting", () => {
+    expect(JSON.parse("[".repeat(500) + "]".repeat(500))).toHaveLength(1);
+    expect(() => JSON.parse("[".repeat(100000) + "]".repeat(100000))).toThrow(SyntaxError);
+});
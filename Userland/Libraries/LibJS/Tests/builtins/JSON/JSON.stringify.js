@@ -97,3 +97,47 @@ describe("errors", () => {
         });
     });
 });
+
+describe("objects and arrays changing while being serialized", () => {
+    test("properties deleted and added by toJSON", () => {
+        const object = {
+            a: {
+                toJSON() {
+                    delete object.b;
+                    object.c = 3;
+                    return 1;
+                },
+            },
+            b: 2,
+        };
+        expect(JSON.stringify(object)).toBe('{"a":1}');
+    });
+
+    test("property changed into a getter by toJSON", () => {
+        const object = {
+            a: {
+                toJSON() {
+                    Object.defineProperty(object, "b", { get: () => "getter", enumerable: true });
+                    return 1;
+                },
+            },
+            b: 2,
+        };
+        expect(JSON.stringify(object)).toBe('{"a":1,"b":"getter"}');
+    });
+
+    test("array elements changed by toJSON", () => {
+        const array = [
+            {
+                toJSON() {
+                    array[1] = "changed";
+                    array.length = 2;
+                    return 0;
+                },
+            },
+            1,
+            2,
+        ];
+        expect(JSON.stringify(array)).toBe('[0,"changed",null]');
+    });
+});
@@ -16,3 +16,109 @@ test("Inline cache invalidated by deleting property from unique shape", () => {
     expect(first).toBe(2);
     expect(second).toBeUndefined();
 });
+
+test("Inline cache remembers more than one shape", () => {
+    function ic(o) {
+        return o.x;
+    }
+
+    const objects = [{ x: 1 }, { a: 0, x: 2 }, { a: 0, b: 0, x: 3 }, { a: 0, b: 0, c: 0, x: 4 }, { y: 0, x: 5 }];
+    for (let i = 0; i < 3; ++i) {
+        expect(objects.map(ic)).toEqual([1, 2, 3, 4, 5]);
+    }
+});
+
+test("Inline cache for adding a property respects setters added to the prototype", () => {
+    function Thing() {}
+    function add(o) {
+        o.value = 1;
+    }
+
+    const first = new Thing();
+    add(first);
+    expect(Object.hasOwn(first, "value")).toBeTrue();
+
+    let setterCalls = 0;
+    Object.defineProperty(Thing.prototype, "value", {
+        set() {
+            ++setterCalls;
+        },
+        configurable: true,
+    });
+
+    const second = new Thing();
+    add(second);
+    expect(Object.hasOwn(second, "value")).toBeFalse();
+    expect(setterCalls).toBe(1);
+});
+
+test("Inline cache for adding a property respects read-only properties further up the prototype chain", () => {
+    const base = {};
+    const middle = Object.create(base);
+    function add(o) {
+        "use strict";
+        o.value = 1;
+    }
+
+    const first = Object.create(middle);
+    add(first);
+    expect(first.value).toBe(1);
+
+    Object.defineProperty(base, "value", { value: 0, writable: false });
+
+    const second = Object.create(middle);
+    expect(() => add(second)).toThrowWithMessage(TypeError, "Cannot set property 'value'");
+    expect(Object.hasOwn(second, "value")).toBeFalse();
+});
+
+test("Inline cache for adding a property respects non-extensible objects", () => {
+    function add(o) {
+        o.value = 1;
+    }
+
+    const first = {};
+    add(first);
+    expect(first.value).toBe(1);
+
+    const second = Object.preventExtensions({});
+    add(second);
+    expect(Object.hasOwn(second, "value")).toBeFalse();
+});
+
+test("Inline cache for adding a property doesn't skip the set trap of a proxy", () => {
+    function add(o) {
+        o.value = 1;
+    }
+
+    add(Object.create(Object.prototype));
+    add(Object.create(Object.prototype));
+
+    let trapCalls = 0;
+    const target = {};
+    const proxy = new Proxy(target, {
+        set(target, key, value) {
+            ++trapCalls;
+            target[key] = value * 2;
+            return true;
+        },
+    });
+    add(proxy);
+    expect(trapCalls).toBe(1);
+    expect(target.value).toBe(2);
+    expect(proxy.value).toBe(2);
+});
+
+test("Inline cache for adding a property doesn't add an own length property to an array", () => {
+    function truncate(o) {
+        o.length = 0;
+    }
+
+    truncate(Object.create(Array.prototype));
+    truncate(Object.create(Array.prototype));
+
+    const array = [1, 2, 3];
+    truncate(array);
+    expect(array).toHaveLength(0);
+    expect(array[0]).toBeUndefined();
+    expect(Object.getOwnPropertyNames(array)).toEqual(["length"]);
+});
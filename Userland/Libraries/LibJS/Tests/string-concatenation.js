@@ -28,3 +28,39 @@ test("adding strings with dangling surrogates", () => {
     expect("\ud834a" + "\udf06").toBe("\ud834a\udf06");
     expect("\ud834" + "a\udf06").toBe("\ud834a\udf06");
 });
+
+test("length of strings built by repeated concatenation", () => {
+    let s = "";
+    for (let i = 0; i < 100000; ++i) {
+        s += i % 2 ? "a" : "é";
+        if (i % 1000 === 0) expect(s.length).toBe(i + 1);
+    }
+    expect(s.length).toBe(100000);
+    expect(s[99999]).toBe("a");
+    expect(s[99998]).toBe("é");
+
+    let t = "";
+    for (let i = 0; i < 1000; ++i) t = "𝌆" + t + "b";
+    expect(t.length).toBe(3000);
+    expect(t.slice(-3)).toBe("bbb");
+    expect(t.codePointAt(0)).toBe(0x1d306);
+});
+
+test("joining surrogates across many pieces", () => {
+    let s = "x";
+    for (let i = 0; i < 100; ++i) s += "\ud834" + "";
+    s += "\udf06";
+    expect(s.length).toBe(102);
+    expect(s.codePointAt(100)).toBe(0x1d306);
+});
+
+test("short concatenations of strings from different sources", () => {
+    const high = String.fromCharCode(0xd834);
+    const low = String.fromCharCode(0xdf06);
+    expect(high + low).toBe("𝌆");
+    expect((high + low).length).toBe(2);
+    expect("a" + low).toBe("a\udf06");
+    expect("é".charAt(0) + "ü").toBe("éü");
+    expect(("ab" + "cd").length).toBe(4);
+    expect("ab" + "cd" === "abcd").toBeTrue();
+});
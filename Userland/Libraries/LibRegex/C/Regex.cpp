@@ -57,9 +57,9 @@ int regcomp(regex_t* reg, char const* pattern, int cflags)
 
     ByteString pattern_str(pattern);
     if (is_extended)
-        preg->re = make<Regex<PosixExtended>>(pattern_str, PosixOptions {} | (PosixFlags)cflags | PosixFlags::SkipTrimEmptyMatches);
+        preg->re = make<Regex<PosixExtended>>(RegexCache<PosixExtended>::the().compile(pattern_str, PosixOptions {} | (PosixFlags)cflags | PosixFlags::SkipTrimEmptyMatches));
     else
-        preg->re = make<Regex<PosixBasic>>(pattern_str, PosixOptions {} | (PosixFlags)cflags | PosixFlags::SkipTrimEmptyMatches);
+        preg->re = make<Regex<PosixBasic>>(RegexCache<PosixBasic>::the().compile(pattern_str, PosixOptions {} | (PosixFlags)cflags | PosixFlags::SkipTrimEmptyMatches));
 
     auto parser_result = preg->re->visit([](auto& re) { return re->parser_result; });
 
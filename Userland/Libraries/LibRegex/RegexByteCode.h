@@ -530,11 +530,12 @@ private:
             empend((ByteCodeValueType)view[i]);
     }
 
-    void ensure_opcodes_initialized();
+    static void ensure_opcodes_initialized();
     ALWAYS_INLINE OpCode& get_opcode_by_id(OpCodeId id) const;
-    static OwnPtr<OpCode> s_opcodes[(size_t)OpCodeId::Last + 1];
-    static bool s_opcodes_initialized;
-    static size_t s_next_checkpoint_serial_id;
+    // NOTE: These are per thread, as patterns may be compiled and matched on several threads at once.
+    static thread_local OwnPtr<OpCode> s_opcodes[(size_t)OpCodeId::Last + 1];
+    static thread_local bool s_opcodes_initialized;
+    static thread_local size_t s_next_checkpoint_serial_id;
 };
 
 #define ENUMERATE_EXECUTION_RESULTS                          \
@@ -854,6 +855,10 @@ ALWAYS_INLINE OpCode& ByteCode::get_opcode_by_id(OpCodeId id) const
 {
     VERIFY(id >= OpCodeId::First && id <= OpCodeId::Last);
 
+    // NOTE: Bytecode may be executed on another thread than the one that created it.
+    if (!s_opcodes_initialized) [[unlikely]]
+        ensure_opcodes_initialized();
+
     auto& opcode = s_opcodes[(u32)id];
     opcode->set_bytecode(*const_cast<ByteCode*>(this));
     return *opcode;
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NeverDestroyed.h>
+#include <LibRegex/RegexCache.h>
+
+namespace regex {
+
+struct CompiledPattern {
+    ByteString pattern;
+    regex::Parser::Result result;
+};
+
+// Cached patterns are handed out to any thread, and the reference counts of ByteStrings aren't atomic. So the cache and
+// every Regex it hands out get their own copy of each string. Named capture groups in the bytecode point into the
+// pattern, so they are made to point into its copy.
+static CompiledPattern isolated_copy(ByteString const& pattern, regex::Parser::Result const& result)
+{
+    CompiledPattern copy { pattern.isolated_copy(), result };
+
+    auto& optimization_data = copy.result.optimization_data;
+    if (optimization_data.pure_substring_search.has_value())
+        optimization_data.pure_substring_search = optimization_data.pure_substring_search->isolated_copy();
+    optimization_data.literal_prefix = optimization_data.literal_prefix.isolated_copy();
+    copy.result.error_token = {};
+
+    auto old_base = reinterpret_cast<FlatPtr>(pattern.characters());
+    auto new_base = reinterpret_cast<FlatPtr>(copy.pattern.characters());
+
+    auto& bytecode = copy.result.bytecode;
+    MatchState state;
+    while (state.instruction_position < bytecode.size()) {
+        auto& opcode = bytecode.get_opcode(state);
+        if (opcode.opcode_id() == OpCodeId::SaveRightNamedCaptureGroup) {
+            auto& name = bytecode[state.instruction_position + 1];
+            VERIFY(name >= old_base && name - old_base <= pattern.length());
+            name = name - old_base + new_base;
+        }
+        state.instruction_position += opcode.size();
+    }
+
+    return copy;
+}
+
+template<class Parser>
+RegexCache<Parser>& RegexCache<Parser>::the()
+{
+    static NeverDestroyed<RegexCache> s_the;
+    return *s_the;
+}
+
+template<class Parser>
+Regex<Parser> RegexCache<Parser>::compile(ByteString pattern, OptionsType options)
+{
+    return find_or_compile(move(pattern), options, [&](ByteString const& pattern) {
+        return Regex<Parser> { pattern, options };
+    });
+}
+
+template<class Parser>
+Regex<Parser> RegexCache<Parser>::compile(regex::Parser::Result const& parse_result, ByteString pattern, OptionsType options)
+{
+    return find_or_compile(move(pattern), options, [&](ByteString const& pattern) {
+        return Regex<Parser> { parse_result, pattern, options };
+    });
+}
+
+template<class Parser>
+template<typename CompileCallback>
+Regex<Parser> RegexCache<Parser>::find_or_compile(ByteString pattern, OptionsType options, CompileCallback compile)
+{
+    {
+        Threading::MutexLocker locker { m_lock };
+        if (auto it = m_entries.find(Key { pattern, options }); it != m_entries.end()) {
+            ++m_statistics.hits;
+
+            auto copy = isolated_copy(it->key.pattern, it->value.result);
+            Regex<Parser> regex { {}, move(copy.pattern), move(copy.result), it->value.matcher_options };
+
+            // Move the entry to the back, with the other recently used ones.
+            auto key = it->key;
+            auto entry = move(it->value);
+            m_entries.remove(it);
+            m_entries.set(move(key), move(entry));
+            return regex;
+        }
+        ++m_statistics.misses;
+    }
+
+    // Compiling may take a while, so other threads can keep using the cache in the meantime.
+    auto regex = compile(pattern);
+    if (regex.parser_result.error != Error::NoError || !regex.matcher)
+        return regex;
+
+    auto copy = isolated_copy(regex.pattern_value, regex.parser_result);
+
+    Threading::MutexLocker locker { m_lock };
+    if (m_capacity == 0)
+        return regex;
+
+    m_entries.set(Key { move(copy.pattern), options }, Entry { move(copy.result), regex.matcher->options() });
+    evict_entries_over_capacity();
+    return regex;
+}
+
+template<class Parser>
+void RegexCache<Parser>::evict_entries_over_capacity()
+{
+    while (m_entries.size() > m_capacity) {
+        m_entries.remove(m_entries.begin());
+        ++m_statistics.evictions;
+    }
+}
+
+template<class Parser>
+void RegexCache<Parser>::set_capacity(size_t capacity)
+{
+    Threading::MutexLocker locker { m_lock };
+    m_capacity = capacity;
+    evict_entries_over_capacity();
+}
+
+template<class Parser>
+void RegexCache<Parser>::clear()
+{
+    Threading::MutexLocker locker { m_lock };
+    m_entries.clear();
+    m_statistics = {};
+}
+
+template<class Parser>
+RegexCacheStatistics RegexCache<Parser>::statistics() const
+{
+    Threading::MutexLocker locker { m_lock };
+    auto statistics = m_statistics;
+    statistics.entries = m_entries.size();
+    statistics.capacity = m_capacity;
+    return statistics;
+}
+
+template class RegexCache<PosixBasicParser>;
+template class RegexCache<PosixExtendedParser>;
+template class RegexCache<ECMA262Parser>;
+
+}
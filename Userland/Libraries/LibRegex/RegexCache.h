@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "RegexMatcher.h"
+#include "RegexParser.h"
+
+#include <AK/ByteString.h>
+#include <AK/HashFunctions.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/Types.h>
+#include <LibThreading/Mutex.h>
+
+namespace regex {
+
+struct RegexCacheStatistics {
+    size_t hits { 0 };
+    size_t misses { 0 };
+    size_t evictions { 0 };
+    size_t entries { 0 };
+    size_t capacity { 0 };
+};
+
+// A process-wide cache of compiled patterns, keyed by the pattern and its options (and, as there's one cache per
+// parser, its syntax). Compiling a pattern that's already in the cache skips parsing and optimizing it again.
+//
+// The cache keeps its own copy of each compiled pattern, which is never changed, and every Regex handed out gets a deep
+// copy of that, which shares no strings with it. When the cache is full, the pattern that was least recently compiled
+// is evicted.
+//
+// NOTE: The names of ECMA-262 capture groups are fly strings, which are shared with the cached copy regardless. Using
+//       a cache for those from more than one thread requires DeprecatedFlyString::enable_sharing_between_threads().
+template<class Parser>
+class RegexCache {
+    AK_MAKE_NONCOPYABLE(RegexCache);
+    AK_MAKE_NONMOVABLE(RegexCache);
+
+public:
+    using OptionsType = typename ParserTraits<Parser>::OptionsType;
+
+    static constexpr size_t default_capacity = 128;
+
+    static RegexCache& the();
+
+    RegexCache() = default;
+
+    // Patterns that fail to compile aren't cached, so that their errors are reported every time.
+    Regex<Parser> compile(ByteString pattern, OptionsType options = {});
+    // If the pattern isn't in the cache yet, this compiles it from an earlier result of Regex::parse_pattern().
+    Regex<Parser> compile(regex::Parser::Result const& parse_result, ByteString pattern, OptionsType options = {});
+
+    void set_capacity(size_t);
+    // Forgets all compiled patterns, and starts counting from zero again.
+    void clear();
+
+    RegexCacheStatistics statistics() const;
+
+private:
+    template<typename CompileCallback>
+    Regex<Parser> find_or_compile(ByteString pattern, OptionsType options, CompileCallback);
+
+    void evict_entries_over_capacity();
+
+    struct Key {
+        // NOTE: The bytecode of the cached pattern points into this string, which only the cache itself uses.
+        ByteString pattern;
+        OptionsType options;
+    };
+
+    struct KeyTraits : public DefaultTraits<Key> {
+        static unsigned hash(Key const& key) { return pair_int_hash(key.pattern.hash(), u64_hash(to_underlying(key.options.value()))); }
+        static bool equals(Key const& a, Key const& b) { return a.options.value() == b.options.value() && a.pattern == b.pattern; }
+    };
+
+    struct Entry {
+        regex::Parser::Result result;
+        OptionsType matcher_options;
+    };
+
+    mutable Threading::Mutex m_lock;
+    // Ordered from least to most recently used.
+    OrderedHashMap<Key, Entry, KeyTraits> m_entries;
+    size_t m_capacity { default_capacity };
+    RegexCacheStatistics m_statistics;
+};
+
+}
+
+using regex::RegexCache;
+using regex::RegexCacheStatistics;
@@ -4,12 +4,15 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/BumpAllocator.h>
 #include <AK/ByteString.h>
 #include <AK/Debug.h>
+#include <AK/SIMDExtras.h>
 #include <AK/StringBuilder.h>
 #include <LibRegex/RegexMatcher.h>
 #include <LibRegex/RegexParser.h>
+#include <LibRegex/RegexPikeVM.h>
 
 #if REGEX_DEBUG
 #    include <LibRegex/RegexDebug.h>
@@ -21,6 +24,95 @@ namespace regex {
 static RegexDebug s_regex_dbg(stderr);
 #endif
 
+// Up to this many different bytes are looked for with SIMD compares, more than that with a lookup table.
+static constexpr size_t max_bytes_to_compare_at_once = 4;
+
+static Optional<size_t> find_first_of_bytes(ReadonlyBytes haystack, ReadonlySpan<u8> needles)
+{
+    size_t i = 0;
+
+    if (needles.size() <= max_bytes_to_compare_at_once) {
+        using AK::SIMD::u8x16;
+
+        Array<u8x16, max_bytes_to_compare_at_once> needle_vectors;
+        for (size_t j = 0; j < needles.size(); ++j)
+            needle_vectors[j] = AK::SIMD::expand_to<u8x16>(needles[j]);
+
+        for (; i + sizeof(u8x16) <= haystack.size(); i += sizeof(u8x16)) {
+            auto chunk = AK::SIMD::load_unaligned<u8x16>(haystack.offset_pointer(i));
+            auto matches = chunk == needle_vectors[0];
+            for (size_t j = 1; j < needles.size(); ++j)
+                matches |= chunk == needle_vectors[j];
+
+            u64 match_bits[2];
+            __builtin_memcpy(match_bits, &matches, sizeof(match_bits));
+            if ((match_bits[0] | match_bits[1]) == 0)
+                continue;
+
+            for (size_t j = 0;; ++j) {
+                if (matches[j])
+                    return i + j;
+            }
+        }
+
+        for (; i < haystack.size(); ++i) {
+            if (needles.contains_slow(haystack[i]))
+                return i;
+        }
+        return {};
+    }
+
+    Array<bool, 256> is_needle {};
+    for (auto needle : needles)
+        is_needle[needle] = true;
+
+    for (; i < haystack.size(); ++i) {
+        if (is_needle[haystack[i]])
+            return i;
+    }
+    return {};
+}
+
+// Returns the first position from the given one onwards where a match could start, going only by what every match
+// has to start with. This lets us skip over the parts of the input that can't match without running the bytecode.
+static Optional<size_t> find_possible_match_start(RegexStringView const& view, size_t position, ReadonlySpan<u8> starting_characters, StringView literal_prefix)
+{
+    if (view.is_string_view()) {
+        auto string = view.string_view();
+        if (literal_prefix.is_empty()) {
+            auto offset = find_first_of_bytes(string.bytes().slice(position), starting_characters);
+            if (!offset.has_value())
+                return {};
+            return position + *offset;
+        }
+
+        // Look for the first character of the prefix, then check whether the rest follows.
+        while (position + literal_prefix.length() <= string.length()) {
+            auto candidates = string.bytes().slice(position, string.length() - literal_prefix.length() + 1 - position);
+            auto offset = find_first_of_bytes(candidates, literal_prefix.bytes().trim(1));
+            if (!offset.has_value())
+                return {};
+            position += *offset;
+            if (string.substring_view(position, literal_prefix.length()) == literal_prefix)
+                return position;
+            ++position;
+        }
+        return {};
+    }
+
+    Array<bool, 128> is_starting_character {};
+    for (auto ch : starting_characters)
+        is_starting_character[ch] = true;
+
+    auto const& utf16_view = view.u16_view();
+    for (; position < utf16_view.length_in_code_units(); ++position) {
+        auto code_unit = utf16_view.code_unit_at(position);
+        if (is_ascii(code_unit) && is_starting_character[code_unit])
+            return position;
+    }
+    return {};
+}
+
 template<class Parser>
 regex::Parser::Result Regex<Parser>::parse_pattern(StringView pattern, typename ParserTraits<Parser>::OptionsType regex_options)
 {
@@ -54,6 +146,15 @@ Regex<Parser>::Regex(regex::Parser::Result parse_result, ByteString pattern, typ
         matcher = make<Matcher<Parser>>(this, regex_options | static_cast<decltype(regex_options.value())>(parse_result.options.value()));
 }
 
+template<class Parser>
+Regex<Parser>::Regex(Badge<RegexCache<Parser>>, ByteString pattern, regex::Parser::Result compiled_result, typename ParserTraits<Parser>::OptionsType matcher_options)
+    : pattern_value(move(pattern))
+    , parser_result(move(compiled_result))
+{
+    VERIFY(parser_result.error == regex::Error::NoError);
+    matcher = make<Matcher<Parser>>(this, matcher_options);
+}
+
 template<class Parser>
 Regex<Parser>::Regex(Regex&& regex)
     : pattern_value(move(regex.pattern_value))
@@ -185,6 +286,20 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
 
     auto single_match_only = input.regex_options.has_flag_set(AllFlags::SingleMatch);
 
+    auto backtracking_operations_limit = NumericLimits<size_t>::max();
+    if (m_pattern->parser_result.optimization_data.can_use_pike_vm) {
+        backtracking_operations_limit = c_backtracking_operations_base_limit;
+        for (auto const& view : views)
+            backtracking_operations_limit += view.length_in_code_units() * c_backtracking_operations_limit_per_code_unit;
+    }
+    bool use_pike_vm = false;
+
+    auto const& optimization_data = m_pattern->parser_result.optimization_data;
+    // NOTE: The prefilter assumes that characters are compared the way they were when the pattern was compiled.
+    bool can_skip_ahead = continue_search
+        && !optimization_data.starting_characters.is_empty()
+        && input.regex_options.has_flag_set(AllFlags::Insensitive) == m_pattern->parser_result.options.has_flag_set(AllFlags::Insensitive);
+
     for (auto const& view : views) {
         if (lines_to_skip != 0) {
             ++input.line;
@@ -214,7 +329,7 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             state.instruction_position = 0;
             state.repetition_marks.clear();
 
-            auto success = execute(input, state, temp_operations);
+            auto success = execute(input, state, temp_operations) == ExecuteResult::Matched;
             // This success is acceptable only if it doesn't read anything from the input (input length is 0).
             if (success && (state.string_position <= view_index)) {
                 operations = temp_operations;
@@ -245,6 +360,16 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             if (match_length_minimum && match_length_minimum > view_length - view_index)
                 break;
 
+            // Positions are only the same as code units (which is what the prefilter looks at) outside of unicode mode.
+            if (can_skip_ahead && !view.unicode() && (view.is_string_view() || view.is_u16_view())) {
+                auto possible_match_start = find_possible_match_start(view, view_index, optimization_data.starting_characters, optimization_data.literal_prefix);
+                if (!possible_match_start.has_value())
+                    break;
+                view_index = *possible_match_start;
+                if (match_length_minimum && match_length_minimum > view_length - view_index)
+                    break;
+            }
+
             input.column = match_count;
             input.match_index = match_count;
 
@@ -253,8 +378,31 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             state.instruction_position = 0;
             state.repetition_marks.clear();
 
-            auto success = execute(input, state, operations);
-            if (success) {
+            auto result = use_pike_vm ? ExecuteResult::ReachedOperationsLimit : execute(input, state, operations, backtracking_operations_limit);
+            if (result == ExecuteResult::ReachedOperationsLimit) {
+                // Start over from this position, leaving out whatever captures the backtracker got to.
+                use_pike_vm = true;
+                if (input.match_index < state.capture_group_matches.size())
+                    state.capture_group_matches.mutable_at(input.match_index).clear();
+                state.string_position = view_index;
+                state.string_position_in_code_units = view_index;
+
+                // Rather than trying one position after another, the Pike VM finds the leftmost match in one go.
+                auto last_start_position = view_index;
+                if (continue_search) {
+                    last_start_position = view_length - match_length_minimum;
+                    if (last_start_position == view_length && input.regex_options.has_flag_set(AllFlags::Multiline))
+                        --last_start_position;
+                }
+
+                auto match_start = PikeVM::search(m_pattern->parser_result.bytecode, input, state, last_start_position, operations);
+                if (!match_start.has_value())
+                    break;
+                view_index = *match_start;
+                result = ExecuteResult::Matched;
+            }
+
+            if (result == ExecuteResult::Matched) {
                 succeeded = true;
 
                 if (input.regex_options.has_flag_set(AllFlags::MatchNotEndOfLine) && state.string_position == input.view.length()) {
@@ -417,26 +565,26 @@ private:
 };
 
 template<class Parser>
-bool Matcher<Parser>::execute(MatchInput const& input, MatchState& state, size_t& operations) const
+typename Matcher<Parser>::ExecuteResult Matcher<Parser>::execute(MatchInput const& input, MatchState& state, size_t& operations, size_t operations_limit) const
 {
     if (m_pattern->parser_result.optimization_data.pure_substring_search.has_value() && input.view.is_string_view()) {
         // Yay, we can do a simple substring search!
         auto& needle = m_pattern->parser_result.optimization_data.pure_substring_search.value();
         if (needle.length() + state.string_position > input.view.length())
-            return false;
+            return ExecuteResult::DidNotMatch;
 
         auto haystack = input.view.string_view().substring_view(state.string_position);
         if (input.regex_options.has_flag_set(AllFlags::Insensitive)) {
             if (!haystack.substring_view(0, needle.length()).equals_ignoring_ascii_case(needle))
-                return false;
+                return ExecuteResult::DidNotMatch;
         } else {
             if (!haystack.starts_with(needle))
-                return false;
+                return ExecuteResult::DidNotMatch;
         }
 
         state.string_position += needle.length();
         state.string_position_in_code_units += needle.length();
-        return true;
+        return ExecuteResult::Matched;
     }
 
     BumpAllocatedLinkedList<MatchState> states_to_try_next;
@@ -448,7 +596,8 @@ bool Matcher<Parser>::execute(MatchInput const& input, MatchState& state, size_t
 
     for (;;) {
         auto& opcode = bytecode.get_opcode(state);
-        ++operations;
+        if (++operations > operations_limit)
+            return ExecuteResult::ReachedOperationsLimit;
 
 #if REGEX_DEBUG
         s_regex_dbg.print_opcode("VM", opcode, state, recursion_level, false);
@@ -516,16 +665,16 @@ bool Matcher<Parser>::execute(MatchInput const& input, MatchState& state, size_t
         case ExecutionResult::Continue:
             continue;
         case ExecutionResult::Succeeded:
-            return true;
+            return ExecuteResult::Matched;
         case ExecutionResult::Failed:
             if (!states_to_try_next.is_empty()) {
                 state = states_to_try_next.take_last();
                 continue;
             }
-            return false;
+            return ExecuteResult::DidNotMatch;
         case ExecutionResult::Failed_ExecuteLowPrioForks: {
             if (states_to_try_next.is_empty()) {
-                return false;
+                return ExecuteResult::DidNotMatch;
             }
             state = states_to_try_next.take_last();
 #if REGEX_DEBUG
@@ -14,6 +14,7 @@
 #include <AK/Forward.h>
 #include <AK/GenericLexer.h>
 #include <AK/HashMap.h>
+#include <AK/NumericLimits.h>
 #include <AK/Types.h>
 #include <AK/Utf32View.h>
 #include <AK/Vector.h>
@@ -36,6 +37,12 @@ struct Block {
 static constexpr size_t const c_max_recursion = 5000;
 static constexpr size_t const c_match_preallocation_count = 0;
 
+// Backtracking takes exponential time on patterns like (a|aa)*b. Once a single match() has executed more instructions
+// than this allows for, it goes on with the Pike VM instead (if the pattern doesn't need the backtracker), which takes
+// linear time.
+static constexpr size_t const c_backtracking_operations_base_limit = 100'000;
+static constexpr size_t const c_backtracking_operations_limit_per_code_unit = 100;
+
 struct RegexResult final {
     bool success { false };
     size_t count { 0 };
@@ -49,6 +56,9 @@ struct RegexResult final {
 template<class Parser>
 class Regex;
 
+template<class Parser>
+class RegexCache;
+
 template<class Parser>
 class Matcher final {
 
@@ -74,7 +84,12 @@ public:
     }
 
 private:
-    bool execute(MatchInput const& input, MatchState& state, size_t& operations) const;
+    enum class ExecuteResult {
+        Matched,
+        DidNotMatch,
+        ReachedOperationsLimit,
+    };
+    ExecuteResult execute(MatchInput const& input, MatchState& state, size_t& operations, size_t operations_limit = NumericLimits<size_t>::max()) const;
 
     Regex<Parser> const* m_pattern;
     typename ParserTraits<Parser>::OptionsType const m_regex_options;
@@ -92,6 +107,8 @@ public:
 
     explicit Regex(ByteString pattern, typename ParserTraits<Parser>::OptionsType regex_options = {});
     Regex(regex::Parser::Result parse_result, ByteString pattern, typename ParserTraits<Parser>::OptionsType regex_options = {});
+    // Makes a copy of a pattern that RegexCache has already compiled (and optimized).
+    Regex(Badge<RegexCache<Parser>>, ByteString pattern, regex::Parser::Result compiled_result, typename ParserTraits<Parser>::OptionsType matcher_options);
     ~Regex() = default;
     Regex(Regex&&);
     Regex& operator=(Regex&&);
@@ -238,6 +255,7 @@ private:
     void run_optimization_passes();
     void attempt_rewrite_loops_as_atomic_groups(BasicBlockList const&);
     bool attempt_rewrite_entire_match_as_substring_search(BasicBlockList const&);
+    void fill_search_prefilter();
 };
 
 // free standing functions for match, search and has_match
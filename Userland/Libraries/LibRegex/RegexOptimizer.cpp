@@ -13,6 +13,7 @@
 #include <AK/Trie.h>
 #include <LibRegex/Regex.h>
 #include <LibRegex/RegexBytecodeStreamOptimizer.h>
+#include <LibRegex/RegexPikeVM.h>
 #include <LibUnicode/CharacterTypes.h>
 #if REGEX_DEBUG
 #    include <AK/ScopeGuard.h>
@@ -29,14 +30,19 @@ void Regex<Parser>::run_optimization_passes()
     parser_result.bytecode.flatten();
 
     auto blocks = split_basic_blocks(parser_result.bytecode);
-    if (attempt_rewrite_entire_match_as_substring_search(blocks))
+    if (attempt_rewrite_entire_match_as_substring_search(blocks)) {
+        fill_search_prefilter();
         return;
+    }
 
     // Rewrite fork loops as atomic groups
     // e.g. a*b -> (ATOMIC a*)b
     attempt_rewrite_loops_as_atomic_groups(blocks);
 
     parser_result.bytecode.flatten();
+
+    fill_search_prefilter();
+    parser_result.optimization_data.can_use_pike_vm = PikeVM::can_execute(parser_result.bytecode);
 }
 
 template<typename Parser>
@@ -651,6 +657,233 @@ bool Regex<Parser>::attempt_rewrite_entire_match_as_substring_search(BasicBlockL
     return true;
 }
 
+struct CompareArgument {
+    CharacterCompareType type;
+    size_t values_offset; // Where the values of this argument start in the bytecode.
+};
+
+// Unlike OpCode_Compare::flat_compares(), this keeps strings in one piece.
+static Vector<CompareArgument, 4> compare_arguments(ByteCode const& bytecode, size_t instruction_position)
+{
+    Vector<CompareArgument, 4> arguments;
+    auto argument_count = bytecode.at(instruction_position + 1);
+    size_t offset = instruction_position + 3;
+
+    for (size_t i = 0; i < argument_count; ++i) {
+        auto type = static_cast<CharacterCompareType>(bytecode.at(offset++));
+        arguments.append({ type, offset });
+        switch (type) {
+        case CharacterCompareType::Char:
+        case CharacterCompareType::Reference:
+        case CharacterCompareType::CharClass:
+        case CharacterCompareType::CharRange:
+        case CharacterCompareType::Property:
+        case CharacterCompareType::GeneralCategory:
+        case CharacterCompareType::Script:
+        case CharacterCompareType::ScriptExtension:
+            offset += 1;
+            break;
+        case CharacterCompareType::String:
+        case CharacterCompareType::LookupTable:
+            offset += 1 + bytecode.at(offset);
+            break;
+        default:
+            break;
+        }
+    }
+    return arguments;
+}
+
+template<typename Parser>
+void Regex<Parser>::fill_search_prefilter()
+{
+    auto& bytecode = parser_result.bytecode;
+    auto& optimization_data = parser_result.optimization_data;
+
+    // Case-insensitive comparisons go through full case folding in unicode mode, which lets ASCII characters match
+    // non-ASCII ones (e.g. 'k' and U+212A KELVIN SIGN).
+    auto is_insensitive = parser_result.options.has_flag_set(AllFlags::Insensitive);
+    if (is_insensitive && parser_result.options.has_flag_set(AllFlags::Unicode))
+        return;
+
+    // Only a plain run of characters at the very start (give or take some assertions) can be a literal prefix.
+    if (!is_insensitive) {
+        StringBuilder prefix;
+        MatchState state;
+        auto add_to_prefix = [&](OpCode const& opcode) {
+            switch (opcode.opcode_id()) {
+            case OpCodeId::SaveLeftCaptureGroup:
+            case OpCodeId::SaveRightCaptureGroup:
+            case OpCodeId::SaveRightNamedCaptureGroup:
+            case OpCodeId::CheckBegin:
+            case OpCodeId::CheckBoundary:
+            case OpCodeId::Checkpoint:
+                return true;
+            case OpCodeId::Compare: {
+                auto arguments = compare_arguments(bytecode, state.instruction_position);
+                if (arguments.size() != 1)
+                    return false;
+                auto& argument = arguments.first();
+                if (argument.type == CharacterCompareType::Char) {
+                    auto ch = bytecode.at(argument.values_offset);
+                    if (!is_ascii(ch))
+                        return false;
+                    prefix.append(static_cast<char>(ch));
+                    return true;
+                }
+                if (argument.type == CharacterCompareType::String) {
+                    auto length = bytecode.at(argument.values_offset);
+                    for (size_t i = 0; i < length; ++i) {
+                        auto ch = bytecode.at(argument.values_offset + 1 + i);
+                        if (!is_ascii(ch))
+                            return false;
+                        prefix.append(static_cast<char>(ch));
+                    }
+                    return true;
+                }
+                return false;
+            }
+            default:
+                return false;
+            }
+        };
+        while (state.instruction_position < bytecode.size()) {
+            auto& opcode = bytecode.get_opcode(state);
+            if (!add_to_prefix(opcode))
+                break;
+            state.instruction_position += opcode.size();
+        }
+        if (prefix.length() > 1)
+            optimization_data.literal_prefix = prefix.to_byte_string();
+    }
+
+    // Follow every path from the start of the bytecode up to the first thing it consumes, and collect everything that
+    // could be consumed there. Anything we can't reason about (lookarounds, non-ASCII characters, character classes,
+    // paths that can match without consuming anything...) means a match could start anywhere.
+    Array<bool, 128> can_start_with {};
+    auto add_character_range = [&](u32 from, u32 to) {
+        if (!is_ascii(from) || !is_ascii(to))
+            return false;
+        auto is_in_range = [](u32 ch, u32 from, u32 to) { return ch >= from && ch <= to; };
+        for (u32 ch = 0; ch < can_start_with.size(); ++ch) {
+            if (is_in_range(ch, from, to)) {
+                can_start_with[ch] = true;
+                continue;
+            }
+            // The different kinds of compares don't all ignore case in quite the same way, so this errs on the side of
+            // letting through too much.
+            if (is_insensitive
+                && (is_in_range(to_ascii_lowercase(ch), from, to)
+                    || is_in_range(to_ascii_uppercase(ch), from, to)
+                    || is_in_range(to_ascii_lowercase(ch), to_ascii_lowercase(from), to_ascii_lowercase(to)))) {
+                can_start_with[ch] = true;
+            }
+        }
+        return true;
+    };
+    auto add_compare = [&](size_t instruction_position) {
+        auto arguments = compare_arguments(bytecode, instruction_position);
+        if (arguments.is_empty())
+            return false;
+        for (auto& argument : arguments) {
+            switch (argument.type) {
+            case CharacterCompareType::Char: {
+                auto ch = bytecode.at(argument.values_offset);
+                if (!add_character_range(ch, ch))
+                    return false;
+                break;
+            }
+            case CharacterCompareType::String: {
+                // Only a string that is all there is to this compare has to be matched in full.
+                if (arguments.size() != 1 || bytecode.at(argument.values_offset) == 0)
+                    return false;
+                auto ch = bytecode.at(argument.values_offset + 1);
+                if (!add_character_range(ch, ch))
+                    return false;
+                break;
+            }
+            case CharacterCompareType::CharRange: {
+                CharRange range { bytecode.at(argument.values_offset) };
+                if (!add_character_range(range.from, range.to))
+                    return false;
+                break;
+            }
+            case CharacterCompareType::LookupTable: {
+                auto count = bytecode.at(argument.values_offset);
+                for (size_t i = 0; i < count; ++i) {
+                    CharRange range { bytecode.at(argument.values_offset + 1 + i) };
+                    if (!add_character_range(range.from, range.to))
+                        return false;
+                }
+                break;
+            }
+            default:
+                return false;
+            }
+        }
+        return true;
+    };
+
+    Vector<size_t> positions_to_visit { 0 };
+    HashTable<size_t> visited_positions;
+    while (!positions_to_visit.is_empty()) {
+        MatchState state;
+        state.instruction_position = positions_to_visit.take_last();
+        if (state.instruction_position >= bytecode.size())
+            return;
+        if (visited_positions.set(state.instruction_position) != HashSetResult::InsertedNewEntry)
+            continue;
+
+        auto& opcode = bytecode.get_opcode(state);
+        auto next_position = state.instruction_position + opcode.size();
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare:
+            if (!add_compare(state.instruction_position))
+                return;
+            break;
+        case OpCodeId::Jump:
+            positions_to_visit.append(next_position + static_cast<OpCode_Jump const&>(opcode).offset());
+            break;
+        case OpCodeId::JumpNonEmpty:
+            positions_to_visit.append(next_position);
+            positions_to_visit.append(next_position + static_cast<OpCode_JumpNonEmpty const&>(opcode).offset());
+            break;
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkReplaceJump:
+            positions_to_visit.append(next_position);
+            positions_to_visit.append(next_position + static_cast<OpCode_ForkJump const&>(opcode).offset());
+            break;
+        case OpCodeId::ForkStay:
+        case OpCodeId::ForkReplaceStay:
+            positions_to_visit.append(next_position);
+            positions_to_visit.append(next_position + static_cast<OpCode_ForkStay const&>(opcode).offset());
+            break;
+        case OpCodeId::Repeat:
+            positions_to_visit.append(next_position);
+            positions_to_visit.append(state.instruction_position - static_cast<OpCode_Repeat const&>(opcode).offset());
+            break;
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::CheckBegin:
+        case OpCodeId::CheckEnd:
+        case OpCodeId::CheckBoundary:
+        case OpCodeId::ClearCaptureGroup:
+        case OpCodeId::ResetRepeat:
+        case OpCodeId::Checkpoint:
+            positions_to_visit.append(next_position);
+            break;
+        default:
+            return;
+        }
+    }
+
+    for (u8 ch = 0; ch < can_start_with.size(); ++ch) {
+        if (can_start_with[ch])
+            optimization_data.starting_characters.append(ch);
+    }
+}
+
 template<typename Parser>
 void Regex<Parser>::attempt_rewrite_loops_as_atomic_groups(BasicBlockList const& basic_blocks)
 {
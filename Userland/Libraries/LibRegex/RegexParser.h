@@ -58,6 +58,11 @@ public:
 
         struct {
             Optional<ByteString> pure_substring_search;
+            // Every match starts with one of these ASCII characters, or with this literal. These let Matcher skip
+            // ahead to where a match could start, rather than trying every position in turn.
+            Vector<u8> starting_characters;
+            ByteString literal_prefix;
+            bool can_use_pike_vm { false };
         } optimization_data {};
     };
 
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashFunctions.h>
+#include <AK/HashTable.h>
+#include <AK/IterationDecision.h>
+#include <AK/Vector.h>
+#include <LibRegex/RegexPikeVM.h>
+
+namespace regex {
+
+namespace {
+
+struct Thread {
+    MatchState state;
+    size_t start_position { 0 };
+};
+
+// Repeat instructions keep their count in the match state, so for patterns that have them, two threads at the same
+// instruction are only the same if they have also gone around their counted loops the same number of times.
+struct VisitedKey {
+    size_t instruction_position { 0 };
+    COWVector<u64> repetition_marks;
+};
+
+struct VisitedKeyTraits : public DefaultTraits<VisitedKey> {
+    static u64 mark_at(COWVector<u64> const& marks, size_t index)
+    {
+        // A mark that was never touched is the same as one that was reset.
+        return index < marks.size() ? marks.at(index) : 0;
+    }
+
+    static unsigned hash(VisitedKey const& key)
+    {
+        auto hash = u64_hash(key.instruction_position);
+        for (size_t i = 0; i < key.repetition_marks.size(); ++i) {
+            if (auto mark = key.repetition_marks.at(i); mark != 0)
+                hash = pair_int_hash(hash, pair_int_hash(i, u64_hash(mark)));
+        }
+        return hash;
+    }
+
+    static bool equals(VisitedKey const& a, VisitedKey const& b)
+    {
+        if (a.instruction_position != b.instruction_position)
+            return false;
+        auto mark_count = max(a.repetition_marks.size(), b.repetition_marks.size());
+        for (size_t i = 0; i < mark_count; ++i) {
+            if (mark_at(a.repetition_marks, i) != mark_at(b.repetition_marks, i))
+                return false;
+        }
+        return true;
+    }
+};
+
+template<typename Callback>
+void for_each_opcode(ByteCode const& bytecode, Callback callback)
+{
+    MatchState state;
+    auto bytecode_size = bytecode.size();
+    while (state.instruction_position < bytecode_size) {
+        auto& opcode = bytecode.get_opcode(state);
+        if (callback(opcode) == IterationDecision::Break)
+            return;
+        state.instruction_position += opcode.size();
+    }
+}
+
+class Search {
+public:
+    Search(ByteCode const& bytecode, MatchInput const& input, size_t& operations)
+        : m_bytecode(bytecode)
+        , m_input(input)
+        , m_operations(operations)
+    {
+        for_each_opcode(bytecode, [&](OpCode const& opcode) {
+            if (opcode.opcode_id() != OpCodeId::Repeat && opcode.opcode_id() != OpCodeId::ResetRepeat)
+                return IterationDecision::Continue;
+            m_uses_repetition_marks = true;
+            return IterationDecision::Break;
+        });
+
+        if (!m_uses_repetition_marks)
+            m_step_of_last_visit.resize(bytecode.size());
+    }
+
+    Optional<size_t> run(MatchState& state, size_t last_start_position)
+    {
+        auto position = state.string_position;
+        auto position_in_code_units = state.string_position_in_code_units;
+
+        // The threads for the current position, in the order the backtracker would have tried them.
+        Vector<Thread> threads;
+        Vector<Thread> next_threads;
+
+        for (;;) {
+            // A match that starts further to the left always wins, so new threads only keep being started until there
+            // is one. They come last, as the backtracker would only get to them once everything else has failed.
+            if (!m_match.has_value() && position <= last_start_position) {
+                Thread thread { state, position };
+                thread.state.string_position = position;
+                thread.state.string_position_in_code_units = position_in_code_units;
+                thread.state.instruction_position = 0;
+                thread.state.repetition_marks.clear();
+                threads.append(move(thread));
+            }
+
+            if (threads.is_empty())
+                break;
+
+            ++m_step;
+            m_visited.clear_with_capacity();
+
+            for (auto& thread : threads) {
+                if (thread.state.string_position != position) {
+                    // This thread consumed more than one unit of input at once, and waits here for the others to catch
+                    // up. It keeps its place among them, as that's what decides which match wins.
+                    next_threads.append(move(thread));
+                    continue;
+                }
+
+                // Whatever comes after a thread that found a match could only find a worse one.
+                if (run_thread(move(thread), position, next_threads))
+                    break;
+            }
+
+            threads.clear_with_capacity();
+            swap(threads, next_threads);
+
+            ++position;
+            if (m_input.view.unicode() && position_in_code_units < m_input.view.length_in_code_units())
+                position_in_code_units += m_input.view.length_of_code_point(m_input.view[position_in_code_units]);
+            else
+                ++position_in_code_units;
+        }
+
+        if (!m_match.has_value())
+            return {};
+
+        state = move(m_match->state);
+        return m_match->start_position;
+    }
+
+private:
+    // Returns false if another thread has already been at this instruction during this step.
+    bool visit(MatchState const& state)
+    {
+        if (m_uses_repetition_marks)
+            return m_visited.set({ state.instruction_position, state.repetition_marks }) == HashSetResult::InsertedNewEntry;
+
+        // Falling off the end of the bytecode is a match, and the first thread to get there wins anyway.
+        if (state.instruction_position >= m_step_of_last_visit.size())
+            return true;
+
+        auto& step_of_last_visit = m_step_of_last_visit[state.instruction_position];
+        if (step_of_last_visit == m_step)
+            return false;
+        step_of_last_visit = m_step;
+        return true;
+    }
+
+    // Follows a thread (and everything it forks into) until it consumes input, fails, or matches. Threads that consumed
+    // input are added to next_threads in the order the backtracker would have tried them. Returns whether there was a
+    // match, in which case any forks that would only have been tried after it are dropped.
+    bool run_thread(Thread thread, size_t position, Vector<Thread>& next_threads)
+    {
+        m_forks.clear_with_capacity();
+
+        for (;;) {
+            if (visit(thread.state)) {
+                auto& opcode = m_bytecode.get_opcode(thread.state);
+                ++m_operations;
+
+                auto result = opcode.execute(m_input, thread.state);
+                thread.state.instruction_position += opcode.size();
+
+                // NOTE: The backtracker uses this to drop forks that can't lead to a different match. Here, forks that
+                //       lead nowhere new are dropped anyway, so ForkReplace* act just like their plain counterparts.
+                m_input.fork_to_replace.clear();
+
+                switch (result) {
+                case ExecutionResult::Continue:
+                    if (thread.state.string_position == position)
+                        continue;
+                    next_threads.append(move(thread));
+                    break;
+                case ExecutionResult::Fork_PrioHigh: {
+                    auto fork = thread;
+                    thread.state.instruction_position = thread.state.fork_at_position;
+                    m_forks.append(move(fork));
+                    continue;
+                }
+                case ExecutionResult::Fork_PrioLow: {
+                    auto fork = thread;
+                    fork.state.instruction_position = fork.state.fork_at_position;
+                    m_forks.append(move(fork));
+                    continue;
+                }
+                case ExecutionResult::Succeeded:
+                    m_match = move(thread);
+                    return true;
+                case ExecutionResult::Failed:
+                case ExecutionResult::Failed_ExecuteLowPrioForks:
+                    break;
+                }
+            }
+
+            if (m_forks.is_empty())
+                return false;
+            thread = m_forks.take_last();
+        }
+    }
+
+    ByteCode const& m_bytecode;
+    MatchInput const& m_input;
+    size_t& m_operations;
+
+    bool m_uses_repetition_marks { false };
+    size_t m_step { 0 };
+    Vector<size_t> m_step_of_last_visit;
+    HashTable<VisitedKey, VisitedKeyTraits> m_visited;
+
+    Vector<Thread> m_forks;
+    Optional<Thread> m_match;
+};
+
+}
+
+bool PikeVM::can_execute(ByteCode const& bytecode)
+{
+    bool can_execute = true;
+    for_each_opcode(bytecode, [&](OpCode const& opcode) {
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Save:
+        case OpCodeId::Restore:
+        case OpCodeId::GoBack:
+        case OpCodeId::FailForks:
+            can_execute = false;
+            return IterationDecision::Break;
+        case OpCodeId::Compare:
+            for (auto const& compare : static_cast<OpCode_Compare const&>(opcode).flat_compares()) {
+                if (compare.type == CharacterCompareType::Reference) {
+                    can_execute = false;
+                    return IterationDecision::Break;
+                }
+            }
+            return IterationDecision::Continue;
+        default:
+            return IterationDecision::Continue;
+        }
+    });
+    return can_execute;
+}
+
+Optional<size_t> PikeVM::search(ByteCode const& bytecode, MatchInput const& input, MatchState& state, size_t last_start_position, size_t& operations)
+{
+    Search search { bytecode, input, operations };
+    return search.run(state, last_start_position);
+}
+
+}
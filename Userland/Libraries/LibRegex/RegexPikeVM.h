@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "RegexByteCode.h"
+#include "RegexMatch.h"
+
+#include <AK/Optional.h>
+#include <AK/Types.h>
+
+namespace regex {
+
+// Runs bytecode without backtracking: every way the pattern could go is followed at once, with all of them advancing
+// through the input in lockstep (a "Pike VM"). Whenever two of them end up at the same instruction at the same input
+// position, only the one that the backtracker would have tried first goes on, so the number of live threads is bounded
+// by the size of the bytecode, and matching takes time linear in the length of the input.
+//
+// This finds the same match the backtracker would find, but it's slower on patterns that don't need to backtrack much,
+// so Matcher only switches over to it once backtracking gets out of hand.
+class PikeVM {
+public:
+    // Backreferences and lookaround need the backtracker.
+    static bool can_execute(ByteCode const&);
+
+    // Looks for the leftmost match that starts somewhere between state.string_position and last_start_position, and
+    // returns where it starts. Like with Matcher::execute(), the state is left at the end of the match, with its capture
+    // groups filled in.
+    static Optional<size_t> search(ByteCode const&, MatchInput const&, MatchState&, size_t last_start_position, size_t& operations);
+};
+
+}
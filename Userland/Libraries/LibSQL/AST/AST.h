@@ -9,6 +9,7 @@
 #pragma once
 
 #include <AK/ByteString.h>
+#include <AK/NonnullOwnPtr.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
@@ -703,6 +704,7 @@ public:
     }
 
     NonnullRefPtr<Expression> const& expression() const { return m_expression; }
+    virtual ResultOr<Value> evaluate(ExecutionContext&) const override;
 
 private:
     NonnullRefPtr<Expression> m_expression;
@@ -1082,6 +1084,9 @@ public:
     RefPtr<LimitClause> const& limit_clause() const { return m_limit_clause; }
     ResultOr<ResultSet> execute(ExecutionContext&) const override;
 
+    // Builds the pipeline of operators which produces the rows of this statement.
+    ResultOr<NonnullOwnPtr<Operator>> create_operator(ExecutionContext&, Vector<ByteString>& column_names) const;
+
 private:
     RefPtr<CommonTableExpressionList> m_common_table_expression_list;
     bool m_select_all;
@@ -1107,4 +1112,18 @@ private:
     NonnullRefPtr<QualifiedTableName> m_qualified_table_name;
 };
 
+class Explain : public Statement {
+public:
+    explicit Explain(NonnullRefPtr<Select> select_statement)
+        : m_select_statement(move(select_statement))
+    {
+    }
+
+    NonnullRefPtr<Select> const& select_statement() const { return m_select_statement; }
+    ResultOr<ResultSet> execute(ExecutionContext&) const override;
+
+private:
+    NonnullRefPtr<Select> m_select_statement;
+};
+
 }
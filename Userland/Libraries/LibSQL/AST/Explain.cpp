@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/AST/AST.h>
+#include <LibSQL/AST/QueryPlan.h>
+#include <LibSQL/ResultSet.h>
+
+namespace SQL::AST {
+
+ResultOr<ResultSet> Explain::execute(ExecutionContext& context) const
+{
+    auto const& select = *m_select_statement;
+    auto plan = TRY(QueryPlan::create(context, select));
+
+    auto lines = plan.explain();
+    if (!select.ordering_term_list().is_empty())
+        lines.append(ByteString::formatted("SORT ({} TERMS)", select.ordering_term_list().size()));
+    if (select.limit_clause())
+        lines.append("LIMIT"sv);
+
+    auto descriptor = adopt_ref(*new TupleDescriptor);
+    descriptor->append({ "", "", "plan", SQLType::Text, Order::Ascending });
+
+    ResultSet result { SQLCommand::Explain, { "plan" } };
+    TRY(result.try_ensure_capacity(lines.size()));
+
+    for (auto& line : lines) {
+        Tuple tuple(descriptor);
+        tuple[0] = move(line);
+
+        result.insert_row(tuple, Tuple {});
+    }
+
+    return result;
+}
+
+}
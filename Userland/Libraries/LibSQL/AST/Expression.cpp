@@ -147,6 +147,16 @@ ResultOr<Value> UnaryOperatorExpression::evaluate(ExecutionContext& context) con
     }
 }
 
+ResultOr<Value> BetweenExpression::evaluate(ExecutionContext& context) const
+{
+    Value value = TRY(expression()->evaluate(context));
+    Value lower_bound = TRY(lhs()->evaluate(context));
+    Value upper_bound = TRY(rhs()->evaluate(context));
+
+    bool is_between = (value.compare(lower_bound) >= 0) && (value.compare(upper_bound) <= 0);
+    return Value(invert_expression() ? !is_between : is_between);
+}
+
 ResultOr<Value> ColumnNameExpression::evaluate(ExecutionContext& context) const
 {
     if (!context.current_row)
@@ -0,0 +1,792 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/AnyOf.h>
+#include <AK/Checked.h>
+#include <AK/HashFunctions.h>
+#include <AK/NumericLimits.h>
+#include <AK/QuickSort.h>
+#include <LibSQL/AST/Operators.h>
+#include <LibSQL/Database.h>
+#include <LibSQL/Meta.h>
+
+namespace SQL::AST {
+
+static bool evaluate_comparison(BinaryOperator op, Value const& lhs, Value const& rhs)
+{
+    auto result = lhs.compare(rhs);
+
+    switch (op) {
+    case BinaryOperator::Equals:
+        return result == 0;
+    case BinaryOperator::LessThan:
+        return result < 0;
+    case BinaryOperator::LessThanEquals:
+        return result <= 0;
+    case BinaryOperator::GreaterThan:
+        return result > 0;
+    case BinaryOperator::GreaterThanEquals:
+        return result >= 0;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+static ResultOr<bool> evaluate_predicates(ExecutionContext& context, Vector<NonnullRefPtr<Expression>> const& predicates)
+{
+    for (auto const& predicate : predicates) {
+        auto result = TRY(predicate->evaluate(context)).to_bool();
+        if (!result.has_value() || !result.value())
+            return false;
+    }
+
+    return true;
+}
+
+struct LimitAndOffset {
+    size_t limit { NumericLimits<size_t>::max() };
+    size_t offset { 0 };
+};
+
+static ResultOr<LimitAndOffset> evaluate_limit_and_offset(ExecutionContext& context, LimitClause const& limit_clause)
+{
+    LimitAndOffset result;
+
+    auto limit = TRY(limit_clause.limit_expression()->evaluate(context));
+    if (!limit.is_null()) {
+        auto limit_value_maybe = limit.to_int<size_t>();
+        if (!limit_value_maybe.has_value())
+            return Result { SQLCommand::Select, SQLErrorCode::SyntaxError, "LIMIT clause must evaluate to an integer value"sv };
+
+        result.limit = limit_value_maybe.value();
+    }
+
+    if (limit_clause.offset_expression() != nullptr) {
+        auto offset = TRY(limit_clause.offset_expression()->evaluate(context));
+        if (!offset.is_null()) {
+            auto offset_value_maybe = offset.to_int<size_t>();
+            if (!offset_value_maybe.has_value())
+                return Result { SQLCommand::Select, SQLErrorCode::SyntaxError, "OFFSET clause must evaluate to an integer value"sv };
+
+            result.offset = offset_value_maybe.value();
+        }
+    }
+
+    return result;
+}
+
+ResultOr<Optional<Tuple>> UnityOperator::next(ExecutionContext&)
+{
+    if (m_exhausted)
+        return Optional<Tuple> {};
+    m_exhausted = true;
+
+    auto descriptor = adopt_ref(*new TupleDescriptor);
+    descriptor->empend("__unity__"sv);
+
+    Tuple tuple(descriptor);
+    tuple[0] = Value { true };
+    return tuple;
+}
+
+ScanOperator::ScanOperator(TableAccess access)
+    : m_access(move(access))
+    , m_tuple(m_access.descriptor)
+{
+}
+
+ResultOr<void> ScanOperator::start(ExecutionContext& context)
+{
+    m_started = true;
+
+    TRY(m_range_values.try_ensure_capacity(m_access.range_predicates.size()));
+    for (auto const& predicate : m_access.range_predicates)
+        m_range_values.unchecked_append(TRY(predicate.value->evaluate(context)));
+
+    if (m_access.access_path == AccessPath::FullScan) {
+        m_next_block_index = m_access.table->block_index();
+        return {};
+    }
+
+    auto key_descriptor = adopt_ref(*new TupleDescriptor);
+    Vector<Value> key_values;
+
+    for (auto const& predicate : m_access.key_predicates) {
+        auto value = TRY(predicate.value->evaluate(context));
+
+        // NULL never compares equal to anything, so no row can satisfy this term.
+        if (value.is_null())
+            return {};
+
+        key_descriptor->append({ "", "", predicate.column_name, value.type(), Order::Ascending });
+        TRY(key_values.try_append(move(value)));
+    }
+
+    Key key(key_descriptor);
+    for (size_t i = 0; i < key_values.size(); ++i)
+        key[i] = move(key_values[i]);
+
+    // Key lookups are expected to match few rows, so they are read all at once. This keeps
+    // Database::match as the single place where a lookup may be answered using an index.
+    m_matched_rows = TRY(context.database->match(*m_access.table, key));
+    return {};
+}
+
+ResultOr<bool> ScanOperator::matches(ExecutionContext& context)
+{
+    for (size_t i = 0; i < m_access.range_predicates.size(); ++i) {
+        auto const& predicate = m_access.range_predicates[i];
+        auto const& column_value = m_tuple[predicate.column_index];
+
+        auto satisfied = predicate.column_is_lhs
+            ? evaluate_comparison(predicate.op, column_value, m_range_values[i])
+            : evaluate_comparison(predicate.op, m_range_values[i], column_value);
+        if (!satisfied)
+            return false;
+    }
+
+    context.current_row = &m_tuple;
+    return evaluate_predicates(context, m_access.filters);
+}
+
+ResultOr<Optional<Tuple>> ScanOperator::next(ExecutionContext& context)
+{
+    if (!m_started)
+        TRY(start(context));
+
+    // Rows read from the heap do not know which table their columns belong to, so transfer their
+    // values into a tuple which does. Table-qualified column names may then be resolved against it.
+    auto load_row = [&](Row const& row) {
+        for (size_t i = 0; i < row.size(); ++i)
+            m_tuple[i] = row[i];
+    };
+
+    if (m_access.access_path == AccessPath::KeyLookup) {
+        while (m_matched_row_index < m_matched_rows.size()) {
+            load_row(m_matched_rows[m_matched_row_index++]);
+            if (TRY(matches(context)))
+                return m_tuple;
+        }
+
+        return Optional<Tuple> {};
+    }
+
+    while (m_next_block_index != 0) {
+        auto row = context.database->read_row(*m_access.table, m_next_block_index);
+        m_next_block_index = row.next_block_index();
+
+        load_row(row);
+        if (TRY(matches(context)))
+            return m_tuple;
+    }
+
+    return Optional<Tuple> {};
+}
+
+NestedLoopJoinOperator::NestedLoopJoinOperator(NonnullOwnPtr<Operator> outer, TableAccess inner, NonnullRefPtr<TupleDescriptor> descriptor, Vector<NonnullRefPtr<Expression>> predicates)
+    : m_outer(move(outer))
+    , m_inner(move(inner))
+    , m_predicates(move(predicates))
+    , m_candidate(descriptor)
+{
+}
+
+ResultOr<Optional<Tuple>> NestedLoopJoinOperator::next(ExecutionContext& context)
+{
+    if (!m_inner_loaded) {
+        m_inner_loaded = true;
+
+        while (true) {
+            auto row = TRY(m_inner.next(context));
+            if (!row.has_value())
+                break;
+            TRY(m_inner_rows.try_append(row.release_value()));
+        }
+    }
+
+    if (m_inner_rows.is_empty())
+        return Optional<Tuple> {};
+
+    while (true) {
+        if (!m_has_outer_row || m_inner_index == m_inner_rows.size()) {
+            auto outer_row = TRY(m_outer->next(context));
+            if (!outer_row.has_value())
+                return Optional<Tuple> {};
+
+            m_outer_size = outer_row->size();
+            for (size_t i = 0; i < m_outer_size; ++i)
+                m_candidate[i] = (*outer_row)[i];
+
+            m_has_outer_row = true;
+            m_inner_index = 0;
+        }
+
+        while (m_inner_index < m_inner_rows.size()) {
+            auto const& inner_row = m_inner_rows[m_inner_index++];
+            for (size_t i = 0; i < inner_row.size(); ++i)
+                m_candidate[m_outer_size + i] = inner_row[i];
+
+            context.current_row = &m_candidate;
+            if (TRY(evaluate_predicates(context, m_predicates)))
+                return m_candidate;
+        }
+    }
+}
+
+static bool has_null_key(Tuple const& row, Vector<JoinKeyColumns> const& keys, size_t JoinKeyColumns::*index)
+{
+    return any_of(keys, [&](auto const& key) { return row[key.*index].is_null(); });
+}
+
+static u32 hash_key(Tuple const& row, Vector<JoinKeyColumns> const& keys, size_t JoinKeyColumns::*index)
+{
+    u32 hash = 0;
+    for (auto const& key : keys)
+        hash = pair_int_hash(hash, row[key.*index].hash());
+    return hash;
+}
+
+static int compare_keys(Tuple const& lhs, size_t JoinKeyColumns::*lhs_index, Tuple const& rhs, size_t JoinKeyColumns::*rhs_index, Vector<JoinKeyColumns> const& keys)
+{
+    for (auto const& key : keys) {
+        if (auto result = lhs[key.*lhs_index].compare(rhs[key.*rhs_index]); result != 0)
+            return result;
+    }
+    return 0;
+}
+
+// Reads all rows of an input, other than those with a NULL key. NULL never compares equal to anything, so
+// those rows cannot be joined.
+static ResultOr<void> read_joinable_rows(ExecutionContext& context, Operator& input, Vector<JoinKeyColumns> const& keys, size_t JoinKeyColumns::*index, Vector<Tuple>& rows)
+{
+    while (true) {
+        auto row = TRY(input.next(context));
+        if (!row.has_value())
+            return {};
+        if (!has_null_key(*row, keys, index))
+            TRY(rows.try_append(row.release_value()));
+    }
+}
+
+HashJoinOperator::HashJoinOperator(NonnullOwnPtr<Operator> outer, TableAccess inner, NonnullRefPtr<TupleDescriptor> descriptor, Vector<JoinKeyColumns> keys, Vector<NonnullRefPtr<Expression>> predicates)
+    : m_outer(move(outer))
+    , m_inner(move(inner))
+    , m_keys(move(keys))
+    , m_predicates(move(predicates))
+    , m_candidate(descriptor)
+{
+}
+
+ResultOr<void> HashJoinOperator::build(ExecutionContext& context)
+{
+    m_built = true;
+    TRY(read_joinable_rows(context, m_inner, m_keys, &JoinKeyColumns::inner_index, m_inner_rows));
+
+    TRY(m_next_in_bucket.try_resize(m_inner_rows.size()));
+    TRY(m_buckets.try_ensure_capacity(m_inner_rows.size()));
+
+    // Rows are prepended to their chain, so add them in reverse to have every chain list its rows in the
+    // order they were read.
+    for (size_t i = m_inner_rows.size(); i > 0; --i) {
+        auto hash = hash_key(m_inner_rows[i - 1], m_keys, &JoinKeyColumns::inner_index);
+        m_next_in_bucket[i - 1] = m_buckets.get(hash).value_or(0);
+        TRY(m_buckets.try_set(hash, i));
+    }
+
+    return {};
+}
+
+ResultOr<Optional<Tuple>> HashJoinOperator::next(ExecutionContext& context)
+{
+    if (!m_built)
+        TRY(build(context));
+
+    if (m_inner_rows.is_empty())
+        return Optional<Tuple> {};
+
+    while (true) {
+        while (m_next_match != 0) {
+            auto const& inner_row = m_inner_rows[m_next_match - 1];
+            m_next_match = m_next_in_bucket[m_next_match - 1];
+
+            // Different keys may hash equally.
+            if (compare_keys(m_candidate, &JoinKeyColumns::outer_index, inner_row, &JoinKeyColumns::inner_index, m_keys) != 0)
+                continue;
+
+            for (size_t i = 0; i < inner_row.size(); ++i)
+                m_candidate[m_outer_size + i] = inner_row[i];
+
+            context.current_row = &m_candidate;
+            if (TRY(evaluate_predicates(context, m_predicates)))
+                return m_candidate;
+        }
+
+        auto outer_row = TRY(m_outer->next(context));
+        if (!outer_row.has_value())
+            return Optional<Tuple> {};
+        if (has_null_key(*outer_row, m_keys, &JoinKeyColumns::outer_index))
+            continue;
+
+        m_outer_size = outer_row->size();
+        for (size_t i = 0; i < m_outer_size; ++i)
+            m_candidate[i] = (*outer_row)[i];
+
+        m_next_match = m_buckets.get(hash_key(m_candidate, m_keys, &JoinKeyColumns::outer_index)).value_or(0);
+    }
+}
+
+MergeJoinOperator::MergeJoinOperator(NonnullOwnPtr<Operator> outer, TableAccess inner, NonnullRefPtr<TupleDescriptor> descriptor, Vector<JoinKeyColumns> keys, Vector<NonnullRefPtr<Expression>> predicates)
+    : m_outer(move(outer))
+    , m_inner(move(inner))
+    , m_keys(move(keys))
+    , m_predicates(move(predicates))
+    , m_candidate(descriptor)
+{
+}
+
+ResultOr<void> MergeJoinOperator::sort(ExecutionContext& context)
+{
+    m_sorted = true;
+
+    TRY(read_joinable_rows(context, m_inner, m_keys, &JoinKeyColumns::inner_index, m_inner_rows));
+    if (m_inner_rows.is_empty())
+        return {};
+    TRY(read_joinable_rows(context, *m_outer, m_keys, &JoinKeyColumns::outer_index, m_outer_rows));
+
+    auto sort_rows = [&](Vector<Tuple> const& rows, Vector<size_t>& order, size_t JoinKeyColumns::*index) -> ResultOr<void> {
+        TRY(order.try_ensure_capacity(rows.size()));
+        for (size_t i = 0; i < rows.size(); ++i)
+            order.unchecked_append(i);
+
+        // Rows with equal keys are kept in the order they were read.
+        quick_sort(order, [&](size_t a, size_t b) {
+            auto result = compare_keys(rows[a], index, rows[b], index, m_keys);
+            if (result != 0)
+                return result < 0;
+            return a < b;
+        });
+
+        return {};
+    };
+
+    TRY(sort_rows(m_outer_rows, m_outer_order, &JoinKeyColumns::outer_index));
+    TRY(sort_rows(m_inner_rows, m_inner_order, &JoinKeyColumns::inner_index));
+    return {};
+}
+
+ResultOr<Optional<Tuple>> MergeJoinOperator::next(ExecutionContext& context)
+{
+    if (!m_sorted)
+        TRY(sort(context));
+
+    auto outer_row = [&]() -> Tuple const& { return m_outer_rows[m_outer_order[m_outer_index]]; };
+    auto inner_row = [&](size_t index) -> Tuple const& { return m_inner_rows[m_inner_order[index]]; };
+    auto compare_rows = [&](size_t inner_index) {
+        return compare_keys(outer_row(), &JoinKeyColumns::outer_index, inner_row(inner_index), &JoinKeyColumns::inner_index, m_keys);
+    };
+
+    while (true) {
+        if (m_in_group) {
+            if (m_group_index < m_group_end) {
+                auto const& outer = outer_row();
+                auto const& inner = inner_row(m_group_index++);
+
+                for (size_t i = 0; i < outer.size(); ++i)
+                    m_candidate[i] = outer[i];
+                for (size_t i = 0; i < inner.size(); ++i)
+                    m_candidate[outer.size() + i] = inner[i];
+
+                context.current_row = &m_candidate;
+                if (TRY(evaluate_predicates(context, m_predicates)))
+                    return m_candidate;
+                continue;
+            }
+
+            // The next outer row may have the same key, in which case it is joined with the same inner rows.
+            ++m_outer_index;
+            if (m_outer_index < m_outer_order.size() && compare_rows(m_group_start) == 0) {
+                m_group_index = m_group_start;
+                continue;
+            }
+
+            m_in_group = false;
+            m_inner_index = m_group_end;
+        }
+
+        if (m_outer_index == m_outer_order.size() || m_inner_index == m_inner_order.size())
+            return Optional<Tuple> {};
+
+        auto result = compare_rows(m_inner_index);
+        if (result < 0) {
+            ++m_outer_index;
+        } else if (result > 0) {
+            ++m_inner_index;
+        } else {
+            m_in_group = true;
+            m_group_start = m_inner_index;
+            m_group_end = m_inner_index + 1;
+            while (m_group_end < m_inner_order.size() && compare_rows(m_group_end) == 0)
+                ++m_group_end;
+            m_group_index = m_group_start;
+        }
+    }
+}
+
+FilterOperator::FilterOperator(NonnullOwnPtr<Operator> input, Vector<NonnullRefPtr<Expression>> predicates)
+    : m_input(move(input))
+    , m_predicates(move(predicates))
+{
+}
+
+ResultOr<Optional<Tuple>> FilterOperator::next(ExecutionContext& context)
+{
+    while (true) {
+        auto row = TRY(m_input->next(context));
+        if (!row.has_value())
+            return row;
+
+        context.current_row = &row.value();
+        if (TRY(evaluate_predicates(context, m_predicates)))
+            return row;
+    }
+}
+
+// Restores the order of a binary heap of indices after the element at `index` may have become smaller than its
+// parent. The heap keeps the element for which `is_before` holds against all others at its root.
+template<typename Callback>
+static void sift_up(Vector<size_t>& heap, size_t index, Callback is_before)
+{
+    while (index > 0) {
+        auto parent = (index - 1) / 2;
+        if (!is_before(heap[index], heap[parent]))
+            break;
+
+        swap(heap[index], heap[parent]);
+        index = parent;
+    }
+}
+
+// Restores the order of a binary heap of indices after the element at `index` may have become larger than its
+// children.
+template<typename Callback>
+static void sift_down(Vector<size_t>& heap, size_t index, Callback is_before)
+{
+    while (true) {
+        auto first = index;
+        auto left = index * 2 + 1;
+        auto right = left + 1;
+
+        if (left < heap.size() && is_before(heap[left], heap[first]))
+            first = left;
+        if (right < heap.size() && is_before(heap[right], heap[first]))
+            first = right;
+        if (first == index)
+            break;
+
+        swap(heap[index], heap[first]);
+        index = first;
+    }
+}
+
+// An estimate of the memory used by a tuple, to compare against the sort memory budget.
+static size_t estimated_size(Tuple const& tuple)
+{
+    auto size = sizeof(Tuple) + tuple.size() * sizeof(Value);
+    for (size_t i = 0; i < tuple.size(); ++i)
+        size += tuple[i].length();
+    return size;
+}
+
+SortOperator::SortOperator(NonnullOwnPtr<Operator> input, Vector<NonnullRefPtr<OrderingTerm>> ordering_terms, RefPtr<LimitClause const> limit_clause)
+    : m_input(move(input))
+    , m_ordering_terms(move(ordering_terms))
+    , m_limit_clause(move(limit_clause))
+{
+}
+
+// Rows with equal sort keys are produced in the order they were read.
+bool SortOperator::is_less_than(SortEntry const& a, SortEntry const& b)
+{
+    auto result = a.sort_key.compare(b.sort_key);
+    if (result != 0)
+        return result < 0;
+    return a.sequence < b.sequence;
+}
+
+ResultOr<void> SortOperator::sort(ExecutionContext& context)
+{
+    m_sorted = true;
+    m_memory_budget = context.database->sort_memory_budget();
+
+    if (m_limit_clause) {
+        auto limit_and_offset = TRY(evaluate_limit_and_offset(context, *m_limit_clause));
+
+        auto kept_entry_limit = Checked<size_t>::saturating_add(limit_and_offset.limit, limit_and_offset.offset);
+        if (kept_entry_limit == 0)
+            return {};
+        m_kept_entry_limit = kept_entry_limit;
+    }
+
+    m_sort_descriptor = adopt_ref(*new TupleDescriptor);
+    for (auto const& term : m_ordering_terms)
+        m_sort_descriptor->append(TupleElementDescriptor { .order = term->order() });
+
+    for (size_t sequence = 0;; ++sequence) {
+        auto row = TRY(m_input->next(context));
+        if (!row.has_value())
+            break;
+
+        context.current_row = &row.value();
+
+        Tuple sort_key(*m_sort_descriptor);
+        for (size_t i = 0; i < m_ordering_terms.size(); ++i)
+            sort_key[i] = TRY(m_ordering_terms[i]->expression()->evaluate(context));
+
+        if (!m_row_descriptor)
+            m_row_descriptor = row->descriptor();
+
+        TRY(add_entry(SortEntry { row.release_value(), move(sort_key), sequence }));
+        if (m_memory_used > m_memory_budget)
+            TRY(spill());
+    }
+
+    if (m_runs.is_empty()) {
+        sort_entries();
+        return {};
+    }
+
+    if (!m_entries.is_empty())
+        TRY(spill());
+
+    // Merging too many runs at once would need too many open files, so merge them in groups first. Each group
+    // holds consecutive runs, so that rows with equal sort keys remain in the order they were read.
+    while (m_runs.size() > MAX_MERGED_RUNS) {
+        Vector<NonnullOwnPtr<SortRun>> merged_runs;
+
+        for (size_t i = 0; i < m_runs.size(); i += MAX_MERGED_RUNS) {
+            Vector<NonnullOwnPtr<SortRun>> group;
+            for (size_t j = i; j < min(i + MAX_MERGED_RUNS, m_runs.size()); ++j)
+                TRY(group.try_append(move(m_runs[j])));
+
+            TRY(start_merge(move(group)));
+
+            auto merged_run = TRY(SortRun::create());
+            while (TRY(merge_next()))
+                TRY(merged_run->append(m_merged_entry.sort_key, m_merged_entry.row));
+            TRY(merged_run->finish());
+
+            TRY(merged_runs.try_append(move(merged_run)));
+        }
+
+        m_runs = move(merged_runs);
+    }
+
+    TRY(start_merge(move(m_runs)));
+    m_merging = true;
+    return {};
+}
+
+ResultOr<void> SortOperator::add_entry(SortEntry entry)
+{
+    auto is_after = [&](size_t a, size_t b) { return is_less_than(m_entries[b], m_entries[a]); };
+
+    // Once the heap holds as many entries as may be produced, a new entry either replaces the largest one, or
+    // could never be produced itself.
+    if (m_kept_entry_limit.has_value() && m_entries.size() == *m_kept_entry_limit) {
+        auto& largest_entry = m_entries[m_order.first()];
+        if (!is_less_than(entry, largest_entry))
+            return {};
+
+        m_memory_used -= estimated_size(largest_entry.row) + estimated_size(largest_entry.sort_key);
+        m_memory_used += estimated_size(entry.row) + estimated_size(entry.sort_key);
+        largest_entry = move(entry);
+
+        sift_down(m_order, 0, is_after);
+        return {};
+    }
+
+    m_memory_used += estimated_size(entry.row) + estimated_size(entry.sort_key);
+    TRY(m_entries.try_append(move(entry)));
+
+    if (m_kept_entry_limit.has_value()) {
+        TRY(m_order.try_append(m_entries.size() - 1));
+        sift_up(m_order, m_order.size() - 1, is_after);
+    }
+
+    return {};
+}
+
+void SortOperator::sort_entries()
+{
+    // Sort the indices of the entries rather than the entries themselves, which are much more costly to move.
+    m_order.clear_with_capacity();
+    m_order.ensure_capacity(m_entries.size());
+    for (size_t i = 0; i < m_entries.size(); ++i)
+        m_order.unchecked_append(i);
+
+    quick_sort(m_order, [&](size_t a, size_t b) { return is_less_than(m_entries[a], m_entries[b]); });
+    m_index = 0;
+}
+
+ResultOr<void> SortOperator::spill()
+{
+    sort_entries();
+
+    auto run = TRY(SortRun::create());
+    for (auto index : m_order)
+        TRY(run->append(m_entries[index].sort_key, m_entries[index].row));
+    TRY(run->finish());
+    TRY(m_runs.try_append(move(run)));
+
+    m_entries.clear();
+    m_order.clear();
+    m_memory_used = 0;
+    return {};
+}
+
+ResultOr<void> SortOperator::start_merge(Vector<NonnullOwnPtr<SortRun>> runs)
+{
+    m_merge_inputs.clear();
+    m_merge_heap.clear();
+    m_merged_entry = SortEntry { Tuple { *m_row_descriptor }, Tuple { *m_sort_descriptor }, 0 };
+
+    TRY(m_merge_inputs.try_ensure_capacity(runs.size()));
+    TRY(m_merge_heap.try_ensure_capacity(runs.size()));
+
+    // Every run holds rows read after those in the runs before it, so the index of the run stands in for the
+    // sequence in which the rows were read.
+    for (size_t i = 0; i < runs.size(); ++i) {
+        m_merge_inputs.unchecked_append(MergeInput { move(runs[i]), SortEntry { Tuple { *m_row_descriptor }, Tuple { *m_sort_descriptor }, i } });
+
+        auto& input = m_merge_inputs.last();
+        if (TRY(input.run->read(input.entry.sort_key, input.entry.row))) {
+            m_merge_heap.unchecked_append(i);
+            sift_up(m_merge_heap, m_merge_heap.size() - 1, [&](size_t a, size_t b) {
+                return is_less_than(m_merge_inputs[a].entry, m_merge_inputs[b].entry);
+            });
+        }
+    }
+
+    return {};
+}
+
+ResultOr<bool> SortOperator::merge_next()
+{
+    if (m_merge_heap.is_empty())
+        return false;
+
+    auto is_before = [&](size_t a, size_t b) {
+        return is_less_than(m_merge_inputs[a].entry, m_merge_inputs[b].entry);
+    };
+
+    auto& input = m_merge_inputs[m_merge_heap.first()];
+    m_merged_entry.row = input.entry.row;
+    m_merged_entry.sort_key = input.entry.sort_key;
+
+    if (!TRY(input.run->read(input.entry.sort_key, input.entry.row))) {
+        m_merge_heap.first() = m_merge_heap.last();
+        m_merge_heap.take_last();
+    }
+
+    sift_down(m_merge_heap, 0, is_before);
+    return true;
+}
+
+ResultOr<Optional<Tuple>> SortOperator::next(ExecutionContext& context)
+{
+    if (!m_sorted)
+        TRY(sort(context));
+
+    if (m_merging) {
+        if (!TRY(merge_next()))
+            return Optional<Tuple> {};
+        return m_merged_entry.row;
+    }
+
+    if (m_index == m_order.size())
+        return Optional<Tuple> {};
+    return move(m_entries[m_order[m_index++]].row);
+}
+
+ProjectOperator::ProjectOperator(NonnullOwnPtr<Operator> input, Vector<NonnullRefPtr<ResultColumn const>> columns)
+    : m_input(move(input))
+    , m_columns(move(columns))
+{
+}
+
+ResultOr<Optional<Tuple>> ProjectOperator::next(ExecutionContext& context)
+{
+    auto row = TRY(m_input->next(context));
+    if (!row.has_value())
+        return row;
+
+    context.current_row = &row.value();
+    m_tuple.clear();
+
+    for (auto const& column : m_columns) {
+        auto value = TRY(column->expression()->evaluate(context));
+        m_tuple.append(value);
+    }
+
+    return m_tuple;
+}
+
+LimitOperator::LimitOperator(NonnullOwnPtr<Operator> input, NonnullRefPtr<LimitClause const> limit_clause)
+    : m_input(move(input))
+    , m_limit_clause(move(limit_clause))
+{
+}
+
+ResultOr<void> LimitOperator::evaluate_limit_clause(ExecutionContext& context)
+{
+    m_evaluated = true;
+
+    auto limit_and_offset = TRY(evaluate_limit_and_offset(context, *m_limit_clause));
+    m_limit = limit_and_offset.limit;
+    m_offset = limit_and_offset.offset;
+    return {};
+}
+
+ResultOr<Optional<Tuple>> LimitOperator::next(ExecutionContext& context)
+{
+    if (!m_evaluated)
+        TRY(evaluate_limit_clause(context));
+
+    for (; m_offset > 0; --m_offset) {
+        if (!TRY(m_input->next(context)).has_value())
+            return Optional<Tuple> {};
+    }
+
+    if (m_produced == m_limit)
+        return Optional<Tuple> {};
+
+    auto row = TRY(m_input->next(context));
+    if (row.has_value())
+        ++m_produced;
+    return row;
+}
+
+ResultOr<NonnullOwnPtr<Cursor>> Cursor::create(NonnullRefPtr<Database> database, NonnullRefPtr<Select const> select, Vector<Value> placeholder_values)
+{
+    auto cursor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Cursor(move(database), move(select), move(placeholder_values))));
+    cursor->m_root = TRY(cursor->m_select->create_operator(cursor->m_context, cursor->m_column_names));
+    return cursor;
+}
+
+Cursor::Cursor(NonnullRefPtr<Database> database, NonnullRefPtr<Select const> select, Vector<Value> placeholder_values)
+    : m_select(move(select))
+    , m_placeholder_values(move(placeholder_values))
+    , m_context { move(database), m_select.ptr(), m_placeholder_values.span(), nullptr }
+{
+}
+
+ResultOr<Optional<Tuple>> Cursor::next()
+{
+    VERIFY(m_root);
+    return m_root->next(m_context);
+}
+
+}
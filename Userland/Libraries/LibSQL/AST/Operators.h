@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibSQL/AST/AST.h>
+#include <LibSQL/AST/QueryPlan.h>
+#include <LibSQL/Forward.h>
+#include <LibSQL/Key.h>
+#include <LibSQL/Result.h>
+#include <LibSQL/Row.h>
+#include <LibSQL/SortRun.h>
+#include <LibSQL/Tuple.h>
+
+namespace SQL::AST {
+
+/**
+ * Operators form a pull-based ("volcano") pipeline which produces the rows of a
+ * SELECT statement one at a time. Each call to next() asks the operator for its
+ * next row, which it computes by pulling as many rows from its input as needed.
+ * Only operators which cannot produce output before seeing all of their input
+ * (sorting and joining) hold on to more than one row.
+ */
+class Operator {
+public:
+    virtual ~Operator() = default;
+
+    // Returns the next row, or an empty Optional once all rows have been produced.
+    virtual ResultOr<Optional<Tuple>> next(ExecutionContext&) = 0;
+};
+
+// Produces the single, column-less row that a SELECT without a FROM clause is evaluated against.
+class UnityOperator final : public Operator {
+public:
+    virtual ResultOr<Optional<Tuple>> next(ExecutionContext&) override;
+
+private:
+    bool m_exhausted { false };
+};
+
+// Reads the rows of a single table, applying the terms of the WHERE clause that only reference that table.
+class ScanOperator final : public Operator {
+public:
+    explicit ScanOperator(TableAccess access);
+
+    virtual ResultOr<Optional<Tuple>> next(ExecutionContext&) override;
+
+private:
+    ResultOr<void> start(ExecutionContext&);
+    ResultOr<bool> matches(ExecutionContext&);
+
+    TableAccess m_access;
+    Tuple m_tuple;
+
+    bool m_started { false };
+    Vector<Value> m_range_values;
+
+    Block::Index m_next_block_index { 0 };
+    Vector<Row> m_matched_rows;
+    size_t m_matched_row_index { 0 };
+};
+
+// Joins each row of its input with every row of a table for which the join terms hold. The table is read
+// once, on the first call to next(), and held in memory for the remainder of the join.
+class NestedLoopJoinOperator final : public Operator {
+public:
+    NestedLoopJoinOperator(NonnullOwnPtr<Operator> outer, TableAccess inner, NonnullRefPtr<TupleDescriptor> descriptor, Vector<NonnullRefPtr<Expression>> predicates);
+
+    virtual ResultOr<Optional<Tuple>> next(ExecutionContext&) override;
+
+private:
+    NonnullOwnPtr<Operator> m_outer;
+    ScanOperator m_inner;
+    Vector<NonnullRefPtr<Expression>> m_predicates;
+
+    bool m_inner_loaded { false };
+    Vector<Tuple> m_inner_rows;
+    size_t m_inner_index { 0 };
+
+    bool m_has_outer_row { false };
+    size_t m_outer_size { 0 };
+    Tuple m_candidate;
+};
+
+// The positions of a pair of columns which must hold equal values for rows to be joined: one in the rows
+// produced by the outer input of a join, and one in the rows of the joined table.
+struct JoinKeyColumns {
+    size_t outer_index { 0 };
+    size_t inner_index { 0 };
+};
+
+// Joins each row of its input with the rows of a table whose key columns hold the same values. The table is
+// read on the first call to next() into a hash table on those columns, which every row of the input is looked
+// up in.
+class HashJoinOperator final : public Operator {
+public:
+    HashJoinOperator(NonnullOwnPtr<Operator> outer, TableAccess inner, NonnullRefPtr<TupleDescriptor> descriptor, Vector<JoinKeyColumns> keys, Vector<NonnullRefPtr<Expression>> predicates);
+
+    virtual ResultOr<Optional<Tuple>> next(ExecutionContext&) override;
+
+private:
+    ResultOr<void> build(ExecutionContext&);
+
+    NonnullOwnPtr<Operator> m_outer;
+    ScanOperator m_inner;
+    Vector<JoinKeyColumns> m_keys;
+    Vector<NonnullRefPtr<Expression>> m_predicates;
+
+    bool m_built { false };
+    Vector<Tuple> m_inner_rows;
+
+    // Rows with equal key hashes are chained together: m_buckets holds the first row of each chain, and
+    // m_next_in_bucket the row following each row. Rows are stored as their index plus one, so that zero
+    // marks the end of a chain.
+    HashMap<u32, size_t> m_buckets;
+    Vector<size_t> m_next_in_bucket;
+    size_t m_next_match { 0 };
+
+    size_t m_outer_size { 0 };
+    Tuple m_candidate;
+};
+
+// Joins its input with a table by sorting both on their key columns, and merging the sorted rows. Unlike
+// a hash join, this does not need to look up rows in a hash table, but it does need to read all of its
+// input before producing the first row.
+class MergeJoinOperator final : public Operator {
+public:
+    MergeJoinOperator(NonnullOwnPtr<Operator> outer, TableAccess inner, NonnullRefPtr<TupleDescriptor> descriptor, Vector<JoinKeyColumns> keys, Vector<NonnullRefPtr<Expression>> predicates);
+
+    virtual ResultOr<Optional<Tuple>> next(ExecutionContext&) override;
+
+private:
+    ResultOr<void> sort(ExecutionContext&);
+
+    NonnullOwnPtr<Operator> m_outer;
+    ScanOperator m_inner;
+    Vector<JoinKeyColumns> m_keys;
+    Vector<NonnullRefPtr<Expression>> m_predicates;
+
+    bool m_sorted { false };
+    Vector<Tuple> m_outer_rows;
+    Vector<Tuple> m_inner_rows;
+
+    // The rows are sorted by sorting their indices, which is cheaper than moving the rows themselves.
+    Vector<size_t> m_outer_order;
+    Vector<size_t> m_inner_order;
+    size_t m_outer_index { 0 };
+    size_t m_inner_index { 0 };
+
+    // The range of (sorted) inner rows whose keys equal that of the current outer row, while it is being joined.
+    bool m_in_group { false };
+    size_t m_group_start { 0 };
+    size_t m_group_end { 0 };
+    size_t m_group_index { 0 };
+
+    Tuple m_candidate;
+};
+
+class FilterOperator final : public Operator {
+public:
+    FilterOperator(NonnullOwnPtr<Operator> input, Vector<NonnullRefPtr<Expression>> predicates);
+
+    virtual ResultOr<Optional<Tuple>> next(ExecutionContext&) override;
+
+private:
+    NonnullOwnPtr<Operator> m_input;
+    Vector<NonnullRefPtr<Expression>> m_predicates;
+};
+
+// Sorts its input on the ordering terms of a SELECT statement. Rows are sorted in memory until they exceed the
+// database's sort memory budget, at which point the sorted rows are written to a SortRun. The runs are merged
+// as the rows are produced. If the statement has a LIMIT clause, only as many rows as may be produced are kept
+// in memory, in a heap which discards the largest row whenever a smaller one is read.
+class SortOperator final : public Operator {
+public:
+    // The largest number of runs which are merged at once. Any more are first merged into fewer, larger runs.
+    static constexpr size_t MAX_MERGED_RUNS = 64;
+
+    SortOperator(NonnullOwnPtr<Operator> input, Vector<NonnullRefPtr<OrderingTerm>> ordering_terms, RefPtr<LimitClause const> limit_clause);
+
+    virtual ResultOr<Optional<Tuple>> next(ExecutionContext&) override;
+
+private:
+    struct SortEntry {
+        Tuple row;
+        Tuple sort_key;
+        size_t sequence { 0 };
+    };
+
+    struct MergeInput {
+        NonnullOwnPtr<SortRun> run;
+        SortEntry entry;
+    };
+
+    static bool is_less_than(SortEntry const&, SortEntry const&);
+
+    ResultOr<void> sort(ExecutionContext&);
+    ResultOr<void> add_entry(SortEntry);
+    void sort_entries();
+    ResultOr<void> spill();
+
+    ResultOr<void> start_merge(Vector<NonnullOwnPtr<SortRun>>);
+    ResultOr<bool> merge_next();
+
+    NonnullOwnPtr<Operator> m_input;
+    Vector<NonnullRefPtr<OrderingTerm>> m_ordering_terms;
+    RefPtr<LimitClause const> m_limit_clause;
+
+    bool m_sorted { false };
+    RefPtr<TupleDescriptor> m_row_descriptor;
+    RefPtr<TupleDescriptor> m_sort_descriptor;
+
+    Vector<SortEntry> m_entries;
+    size_t m_memory_used { 0 };
+    size_t m_memory_budget { 0 };
+
+    // With a LIMIT clause, m_order is a heap of the entries with the largest entry on top until they are sorted.
+    Optional<size_t> m_kept_entry_limit;
+    Vector<size_t> m_order;
+    size_t m_index { 0 };
+
+    Vector<NonnullOwnPtr<SortRun>> m_runs;
+    Vector<MergeInput> m_merge_inputs;
+    Vector<size_t> m_merge_heap;
+    bool m_merging { false };
+    SortEntry m_merged_entry;
+};
+
+class ProjectOperator final : public Operator {
+public:
+    ProjectOperator(NonnullOwnPtr<Operator> input, Vector<NonnullRefPtr<ResultColumn const>> columns);
+
+    virtual ResultOr<Optional<Tuple>> next(ExecutionContext&) override;
+
+private:
+    NonnullOwnPtr<Operator> m_input;
+    Vector<NonnullRefPtr<ResultColumn const>> m_columns;
+    Tuple m_tuple;
+};
+
+// Skips the first `offset` rows of its input and stops pulling from it once `limit` rows have been produced.
+class LimitOperator final : public Operator {
+public:
+    LimitOperator(NonnullOwnPtr<Operator> input, NonnullRefPtr<LimitClause const> limit_clause);
+
+    virtual ResultOr<Optional<Tuple>> next(ExecutionContext&) override;
+
+private:
+    ResultOr<void> evaluate_limit_clause(ExecutionContext&);
+
+    NonnullOwnPtr<Operator> m_input;
+    NonnullRefPtr<LimitClause const> m_limit_clause;
+
+    bool m_evaluated { false };
+    size_t m_offset { 0 };
+    size_t m_limit { 0 };
+    size_t m_produced { 0 };
+};
+
+// Owns everything needed to pull the rows of a SELECT statement incrementally, outside of a call to
+// Statement::execute.
+class Cursor {
+    AK_MAKE_NONCOPYABLE(Cursor);
+    AK_MAKE_NONMOVABLE(Cursor);
+
+public:
+    static ResultOr<NonnullOwnPtr<Cursor>> create(NonnullRefPtr<Database>, NonnullRefPtr<Select const>, Vector<Value> placeholder_values);
+
+    Vector<ByteString> const& column_names() const { return m_column_names; }
+    ResultOr<Optional<Tuple>> next();
+
+private:
+    Cursor(NonnullRefPtr<Database>, NonnullRefPtr<Select const>, Vector<Value> placeholder_values);
+
+    NonnullRefPtr<Select const> m_select;
+    Vector<Value> m_placeholder_values;
+    ExecutionContext m_context;
+
+    Vector<ByteString> m_column_names;
+    OwnPtr<Operator> m_root;
+};
+
+}
@@ -0,0 +1,482 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/AnyOf.h>
+#include <AK/InsertionSort.h>
+#include <AK/StringBuilder.h>
+#include <AK/TypeCasts.h>
+#include <LibSQL/AST/Operators.h>
+#include <LibSQL/AST/QueryPlan.h>
+#include <LibSQL/Database.h>
+#include <LibSQL/Key.h>
+#include <LibSQL/Row.h>
+
+namespace SQL::AST {
+
+static void split_conjunction(NonnullRefPtr<Expression> const& expression, Vector<NonnullRefPtr<Expression>>& terms)
+{
+    if (is<BinaryOperatorExpression>(*expression)) {
+        auto const& binary_expression = static_cast<BinaryOperatorExpression const&>(*expression);
+
+        if (binary_expression.type() == BinaryOperator::And) {
+            split_conjunction(binary_expression.lhs(), terms);
+            split_conjunction(binary_expression.rhs(), terms);
+            return;
+        }
+    }
+
+    terms.append(expression);
+}
+
+// Collects the column references of an expression. Returns false if the expression contains a node
+// the planner cannot look into (e.g. a sub-select), in which case it must not be pushed down.
+static bool collect_column_references(Expression const& expression, Vector<ColumnNameExpression const*>& columns)
+{
+    if (is<ColumnNameExpression>(expression)) {
+        columns.append(static_cast<ColumnNameExpression const*>(&expression));
+        return true;
+    }
+
+    if (is<NumericLiteral>(expression) || is<StringLiteral>(expression) || is<BlobLiteral>(expression)
+        || is<BooleanLiteral>(expression) || is<NullLiteral>(expression) || is<Placeholder>(expression))
+        return true;
+
+    if (is<BetweenExpression>(expression)) {
+        auto const& between = static_cast<BetweenExpression const&>(expression);
+        return collect_column_references(*between.expression(), columns)
+            && collect_column_references(*between.lhs(), columns)
+            && collect_column_references(*between.rhs(), columns);
+    }
+
+    if (is<MatchExpression>(expression)) {
+        auto const& match = static_cast<MatchExpression const&>(expression);
+        if (match.escape() && !collect_column_references(*match.escape(), columns))
+            return false;
+        return collect_column_references(*match.lhs(), columns) && collect_column_references(*match.rhs(), columns);
+    }
+
+    if (is<BinaryOperatorExpression>(expression)) {
+        auto const& binary = static_cast<BinaryOperatorExpression const&>(expression);
+        return collect_column_references(*binary.lhs(), columns) && collect_column_references(*binary.rhs(), columns);
+    }
+
+    if (is<UnaryOperatorExpression>(expression))
+        return collect_column_references(*static_cast<UnaryOperatorExpression const&>(expression).expression(), columns);
+
+    if (is<ChainedExpression>(expression)) {
+        for (auto const& element : static_cast<ChainedExpression const&>(expression).expressions()) {
+            if (!collect_column_references(*element, columns))
+                return false;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+static bool is_constant_expression(Expression const& expression)
+{
+    Vector<ColumnNameExpression const*> columns;
+    return collect_column_references(expression, columns) && columns.is_empty();
+}
+
+static Optional<size_t> column_index_in_table(TableDef const& table, ByteString const& column_name)
+{
+    auto const& columns = table.columns();
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (columns[i]->name() == column_name)
+            return i;
+    }
+    return {};
+}
+
+// Mirrors how ColumnNameExpression::evaluate resolves a column against the joined row: an unambiguous
+// match on the (optionally table-qualified) column name. Returns an empty Optional if the column does
+// not resolve to exactly one table; such terms are left for evaluation against the fully joined row.
+static Optional<size_t> resolve_table(Vector<TableAccess> const& tables, ColumnNameExpression const& column)
+{
+    Optional<size_t> result;
+
+    for (size_t i = 0; i < tables.size(); ++i) {
+        auto const& table = *tables[i].table;
+
+        if (!column.table_name().is_empty() && table.name() != column.table_name())
+            continue;
+        if (!column_index_in_table(table, column.column_name()).has_value())
+            continue;
+
+        if (result.has_value())
+            return {};
+        result = i;
+    }
+
+    return result;
+}
+
+static bool is_comparison(BinaryOperator op)
+{
+    switch (op) {
+    case BinaryOperator::Equals:
+    case BinaryOperator::LessThan:
+    case BinaryOperator::LessThanEquals:
+    case BinaryOperator::GreaterThan:
+    case BinaryOperator::GreaterThanEquals:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static Vector<SargablePredicate> sargable_predicates(TableDef const& table, Expression const& term)
+{
+    auto as_column = [&](Expression const& expression) -> Optional<size_t> {
+        if (!is<ColumnNameExpression>(expression))
+            return {};
+        return column_index_in_table(table, static_cast<ColumnNameExpression const&>(expression).column_name());
+    };
+
+    auto make_predicate = [&](size_t column_index, BinaryOperator op, bool column_is_lhs, NonnullRefPtr<Expression> const& value) {
+        return SargablePredicate { column_index, table.columns()[column_index]->name(), op, column_is_lhs, value };
+    };
+
+    if (is<BinaryOperatorExpression>(term)) {
+        auto const& binary = static_cast<BinaryOperatorExpression const&>(term);
+        if (!is_comparison(binary.type()))
+            return {};
+
+        if (auto column_index = as_column(*binary.lhs()); column_index.has_value() && is_constant_expression(*binary.rhs()))
+            return { make_predicate(*column_index, binary.type(), true, binary.rhs()) };
+        if (auto column_index = as_column(*binary.rhs()); column_index.has_value() && is_constant_expression(*binary.lhs()))
+            return { make_predicate(*column_index, binary.type(), false, binary.lhs()) };
+        return {};
+    }
+
+    if (is<BetweenExpression>(term)) {
+        auto const& between = static_cast<BetweenExpression const&>(term);
+        if (between.invert_expression() || !is_constant_expression(*between.lhs()) || !is_constant_expression(*between.rhs()))
+            return {};
+
+        if (auto column_index = as_column(*between.expression()); column_index.has_value()) {
+            return {
+                make_predicate(*column_index, BinaryOperator::GreaterThanEquals, true, between.lhs()),
+                make_predicate(*column_index, BinaryOperator::LessThanEquals, true, between.rhs()),
+            };
+        }
+    }
+
+    return {};
+}
+
+static Optional<EquiJoinKey> equi_join_key(Vector<TableAccess> const& tables, size_t inner_table_index, Expression const& term)
+{
+    if (!is<BinaryOperatorExpression>(term))
+        return {};
+
+    auto const& binary = static_cast<BinaryOperatorExpression const&>(term);
+    if (binary.type() != BinaryOperator::Equals || !is<ColumnNameExpression>(*binary.lhs()) || !is<ColumnNameExpression>(*binary.rhs()))
+        return {};
+
+    auto const& lhs = static_cast<ColumnNameExpression const&>(*binary.lhs());
+    auto const& rhs = static_cast<ColumnNameExpression const&>(*binary.rhs());
+
+    // The term references two tables, so both columns were resolved to a table when it was classified.
+    auto lhs_table_index = resolve_table(tables, lhs).release_value();
+    auto rhs_table_index = resolve_table(tables, rhs).release_value();
+
+    auto const& outer_column = lhs_table_index == inner_table_index ? rhs : lhs;
+    auto const& inner_column = lhs_table_index == inner_table_index ? lhs : rhs;
+    auto outer_table_index = lhs_table_index == inner_table_index ? rhs_table_index : lhs_table_index;
+
+    auto const& outer_table = *tables[outer_table_index].table;
+    auto const& inner_table = *tables[inner_table_index].table;
+
+    auto outer_column_index = column_index_in_table(outer_table, outer_column.column_name()).release_value();
+    auto inner_column_index = column_index_in_table(inner_table, inner_column.column_name()).release_value();
+
+    if (outer_table.columns()[outer_column_index]->type() != inner_table.columns()[inner_column_index]->type())
+        return {};
+
+    return EquiJoinKey { outer_table_index, outer_column_index, inner_column_index };
+}
+
+ResultOr<QueryPlan> QueryPlan::create(ExecutionContext& context, Select const& select)
+{
+    QueryPlan plan;
+
+    for (auto const& table_descriptor : select.table_or_subquery_list()) {
+        if (!table_descriptor->is_table())
+            return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
+
+        auto table_def = TRY(context.database->get_table(table_descriptor->schema_name(), table_descriptor->table_name()));
+        if (table_def->num_columns() == 0)
+            continue;
+
+        auto descriptor = table_def->to_tuple_descriptor();
+        TRY(plan.m_tables.try_append(TableAccess { move(table_def), move(descriptor) }));
+    }
+
+    if (plan.m_tables.size() > 1) {
+        for (auto& access : plan.m_tables)
+            access.row_count = TRY(context.database->row_count(*access.table));
+    }
+
+    struct JoinPredicate {
+        NonnullRefPtr<Expression> expression;
+        Vector<size_t> tables;
+    };
+    Vector<JoinPredicate> join_predicates;
+
+    Vector<NonnullRefPtr<Expression>> terms;
+    if (select.where_clause())
+        split_conjunction(NonnullRefPtr<Expression> { *select.where_clause() }, terms);
+
+    for (auto const& term : terms) {
+        Vector<ColumnNameExpression const*> columns;
+        if (!collect_column_references(*term, columns) || columns.is_empty()) {
+            TRY(plan.m_residual_predicates.try_append(term));
+            continue;
+        }
+
+        Vector<size_t> referenced_tables;
+        bool resolved = true;
+
+        for (auto const* column : columns) {
+            auto table_index = resolve_table(plan.m_tables, *column);
+            if (!table_index.has_value()) {
+                resolved = false;
+                break;
+            }
+            if (!referenced_tables.contains_slow(*table_index))
+                TRY(referenced_tables.try_append(*table_index));
+        }
+
+        if (!resolved) {
+            TRY(plan.m_residual_predicates.try_append(term));
+            continue;
+        }
+
+        if (referenced_tables.size() > 1) {
+            TRY(join_predicates.try_append(JoinPredicate { term, move(referenced_tables) }));
+            continue;
+        }
+
+        auto& access = plan.m_tables[referenced_tables.first()];
+        auto predicates = sargable_predicates(*access.table, *term);
+
+        if (predicates.is_empty()) {
+            TRY(access.filters.try_append(term));
+            continue;
+        }
+
+        for (auto& predicate : predicates) {
+            // Rows are matched against a key by comparing the row's value to the key's value, so only
+            // `column = value` terms can be answered by a key lookup without changing their meaning.
+            if (predicate.op == BinaryOperator::Equals && predicate.column_is_lhs)
+                TRY(access.key_predicates.try_append(move(predicate)));
+            else
+                TRY(access.range_predicates.try_append(move(predicate)));
+        }
+    }
+
+    for (auto& access : plan.m_tables) {
+        if (!access.key_predicates.is_empty())
+            access.access_path = AccessPath::KeyLookup;
+    }
+
+    TRY(plan.m_join_order.try_ensure_capacity(plan.m_tables.size()));
+    for (size_t i = 0; i < plan.m_tables.size(); ++i)
+        plan.m_join_order.unchecked_append(JoinStep { i, {} });
+
+    // Join the tables which are expected to produce the fewest rows first, so that the intermediate
+    // results stay small. Without statistics, a key lookup is assumed to be more selective than a
+    // range, which in turn is assumed to be more selective than a filtered or a full scan. Of tables
+    // which rank equally, the larger ones are read first: every table after the first is held in
+    // memory while it is joined, so the smaller tables are the cheaper ones to hold. The sort is
+    // stable, so tables of equal rank and size are joined in the order they appear in the FROM clause.
+    auto rank = [&](JoinStep const& step) {
+        auto const& access = plan.m_tables[step.table_index];
+        if (access.access_path == AccessPath::KeyLookup)
+            return 0;
+        if (!access.range_predicates.is_empty())
+            return 1;
+        if (!access.filters.is_empty())
+            return 2;
+        return 3;
+    };
+    insertion_sort(plan.m_join_order, [&](auto const& a, auto const& b) {
+        if (auto rank_a = rank(a), rank_b = rank(b); rank_a != rank_b)
+            return rank_a < rank_b;
+        return plan.m_tables[a.table_index].row_count > plan.m_tables[b.table_index].row_count;
+    });
+
+    for (auto& join_predicate : join_predicates) {
+        size_t last_step = 0;
+
+        for (size_t step = 0; step < plan.m_join_order.size(); ++step) {
+            if (join_predicate.tables.contains_slow(plan.m_join_order[step].table_index))
+                last_step = step;
+        }
+
+        auto& join_step = plan.m_join_order[last_step];
+
+        if (auto key = equi_join_key(plan.m_tables, join_step.table_index, *join_predicate.expression); key.has_value())
+            TRY(join_step.keys.try_append(key.release_value()));
+        else
+            TRY(join_step.predicates.try_append(move(join_predicate.expression)));
+    }
+
+    for (auto& join_step : plan.m_join_order) {
+        if (join_step.keys.is_empty())
+            continue;
+
+        // Floating point values are compared with a tolerance, so equal values need not hash equally.
+        auto const& inner = plan.m_tables[join_step.table_index];
+        auto has_float_key = any_of(join_step.keys, [&](auto const& key) {
+            return inner.table->columns()[key.inner_column_index]->type() == SQLType::Float;
+        });
+
+        if (has_float_key || inner.row_count > MAX_HASH_JOIN_ROWS)
+            join_step.algorithm = JoinAlgorithm::Merge;
+        else
+            join_step.algorithm = JoinAlgorithm::Hash;
+    }
+
+    return plan;
+}
+
+ResultOr<NonnullOwnPtr<Operator>> QueryPlan::create_operator() const
+{
+    if (m_join_order.is_empty()) {
+        if (m_residual_predicates.is_empty())
+            return TRY(try_make<UnityOperator>());
+        return TRY(try_make<FilterOperator>(TRY(try_make<UnityOperator>()), m_residual_predicates));
+    }
+
+    auto const& first_step = m_join_order.first();
+    auto descriptor = m_tables[first_step.table_index].descriptor;
+
+    NonnullOwnPtr<Operator> root = TRY(try_make<ScanOperator>(m_tables[first_step.table_index]));
+    if (!first_step.predicates.is_empty())
+        root = TRY(try_make<FilterOperator>(move(root), first_step.predicates));
+
+    // The position of each table's first column in the joined rows.
+    Vector<size_t> table_offsets;
+    TRY(table_offsets.try_resize(m_tables.size()));
+
+    for (size_t step = 1; step < m_join_order.size(); ++step) {
+        auto const& join_step = m_join_order[step];
+        auto const& access = m_tables[join_step.table_index];
+
+        table_offsets[join_step.table_index] = descriptor->size();
+
+        auto joined_descriptor = adopt_ref(*new TupleDescriptor);
+        joined_descriptor->extend(*descriptor);
+        joined_descriptor->extend(*access.descriptor);
+
+        Vector<JoinKeyColumns> keys;
+        TRY(keys.try_ensure_capacity(join_step.keys.size()));
+        for (auto const& key : join_step.keys)
+            keys.unchecked_append({ table_offsets[key.outer_table_index] + key.outer_column_index, key.inner_column_index });
+
+        switch (join_step.algorithm) {
+        case JoinAlgorithm::NestedLoop:
+            root = TRY(try_make<NestedLoopJoinOperator>(move(root), access, joined_descriptor, join_step.predicates));
+            break;
+        case JoinAlgorithm::Hash:
+            root = TRY(try_make<HashJoinOperator>(move(root), access, joined_descriptor, move(keys), join_step.predicates));
+            break;
+        case JoinAlgorithm::Merge:
+            root = TRY(try_make<MergeJoinOperator>(move(root), access, joined_descriptor, move(keys), join_step.predicates));
+            break;
+        }
+
+        descriptor = move(joined_descriptor);
+    }
+
+    if (!m_residual_predicates.is_empty())
+        root = TRY(try_make<FilterOperator>(move(root), m_residual_predicates));
+
+    return root;
+}
+
+static StringView join_algorithm_name(JoinAlgorithm algorithm)
+{
+    switch (algorithm) {
+    case JoinAlgorithm::NestedLoop:
+        return "NESTED LOOP"sv;
+    case JoinAlgorithm::Hash:
+        return "HASH"sv;
+    case JoinAlgorithm::Merge:
+        return "MERGE"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Vector<ByteString> QueryPlan::explain() const
+{
+    Vector<ByteString> lines;
+
+    auto append_sargable_predicates = [](StringBuilder& builder, Vector<SargablePredicate> const& predicates) {
+        builder.append('(');
+        for (size_t i = 0; i < predicates.size(); ++i) {
+            if (i > 0)
+                builder.append(" AND "sv);
+            builder.appendff("{}{}?", predicates[i].column_name, BinaryOperator_name(predicates[i].op));
+        }
+        builder.append(')');
+    };
+
+    for (size_t step = 0; step < m_join_order.size(); ++step) {
+        auto const& join_step = m_join_order[step];
+        auto const& access = m_tables[join_step.table_index];
+
+        StringBuilder builder;
+        if (step > 0)
+            builder.appendff("{} JOIN ", join_algorithm_name(join_step.algorithm));
+
+        if (access.access_path == AccessPath::KeyLookup) {
+            builder.appendff("SEARCH {}.{} USING KEY ", access.table->parent()->name(), access.table->name());
+            append_sargable_predicates(builder, access.key_predicates);
+        } else {
+            builder.appendff("SCAN {}.{}", access.table->parent()->name(), access.table->name());
+        }
+
+        if (!access.range_predicates.is_empty()) {
+            builder.append(" RANGE "sv);
+            append_sargable_predicates(builder, access.range_predicates);
+        }
+        if (!access.filters.is_empty())
+            builder.appendff(" FILTER ({} TERMS)", access.filters.size());
+        if (!join_step.keys.is_empty()) {
+            builder.append(" ON ("sv);
+            for (size_t i = 0; i < join_step.keys.size(); ++i) {
+                auto const& key = join_step.keys[i];
+                auto const& outer_table = *m_tables[key.outer_table_index].table;
+
+                if (i > 0)
+                    builder.append(" AND "sv);
+                builder.appendff("{}.{}={}.{}",
+                    outer_table.name(), outer_table.columns()[key.outer_column_index]->name(),
+                    access.table->name(), access.table->columns()[key.inner_column_index]->name());
+            }
+            builder.append(')');
+
+            if (!join_step.predicates.is_empty())
+                builder.appendff(" AND ({} TERMS)", join_step.predicates.size());
+        } else if (!join_step.predicates.is_empty()) {
+            builder.appendff(" ON ({} TERMS)", join_step.predicates.size());
+        }
+
+        lines.append(builder.to_byte_string());
+    }
+
+    if (!m_residual_predicates.is_empty())
+        lines.append(ByteString::formatted("FILTER ({} TERMS)", m_residual_predicates.size()));
+
+    return lines;
+}
+
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteString.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Vector.h>
+#include <LibSQL/AST/AST.h>
+#include <LibSQL/Forward.h>
+#include <LibSQL/Meta.h>
+#include <LibSQL/Result.h>
+#include <LibSQL/Tuple.h>
+
+namespace SQL::AST {
+
+enum class AccessPath {
+    FullScan,
+    KeyLookup,
+};
+
+// A predicate of the form `column <op> value` or `value <op> column`, where value does not depend
+// on the row being examined. These can be answered without evaluating an expression tree per row.
+struct SargablePredicate {
+    size_t column_index { 0 };
+    ByteString column_name;
+    BinaryOperator op { BinaryOperator::Equals };
+    bool column_is_lhs { true };
+    NonnullRefPtr<Expression> value;
+};
+
+struct TableAccess {
+    NonnullRefPtr<TableDef> table;
+    NonnullRefPtr<TupleDescriptor> descriptor;
+    AccessPath access_path { AccessPath::FullScan };
+
+    // Only counted when the table is joined with another one.
+    size_t row_count { 0 };
+
+    Vector<SargablePredicate> key_predicates;
+    Vector<SargablePredicate> range_predicates;
+    Vector<NonnullRefPtr<Expression>> filters;
+};
+
+enum class JoinAlgorithm {
+    NestedLoop,
+    Hash,
+    Merge,
+};
+
+// A join term of the form `outer.column = inner.column`, where the inner column belongs to the table being
+// joined, the outer column to a table joined before it, and both columns are of the same type.
+struct EquiJoinKey {
+    size_t outer_table_index { 0 };
+    size_t outer_column_index { 0 };
+    size_t inner_column_index { 0 };
+};
+
+struct JoinStep {
+    size_t table_index { 0 };
+    JoinAlgorithm algorithm { JoinAlgorithm::NestedLoop };
+
+    Vector<EquiJoinKey> keys;
+
+    // Predicates which reference this table and one or more tables joined before it, other than the keys.
+    Vector<NonnullRefPtr<Expression>> predicates;
+};
+
+/**
+ * A QueryPlan describes how the FROM and WHERE clauses of a SELECT statement are
+ * evaluated. The WHERE clause is split into its AND-ed terms, each of which is
+ * pushed down to the earliest point it can be evaluated at: terms referencing a
+ * single table filter that table while it is being read, and terms referencing
+ * several tables are evaluated as soon as the last of those tables is joined.
+ * Tables with the most selective access paths are joined first.
+ *
+ * create_operator() turns the plan into a pipeline of Operators which read the
+ * first table in the join order incrementally, and join every further table to
+ * it in turn. Tables which are joined on equal columns are joined by hashing the
+ * joined table, or by sorting and merging both sides if it is too large to hash.
+ * Any other join compares every pair of rows.
+ */
+class QueryPlan {
+public:
+    // The largest table which is joined by building a hash table over its rows.
+    static constexpr size_t MAX_HASH_JOIN_ROWS = 1 << 17;
+
+    static ResultOr<QueryPlan> create(ExecutionContext&, Select const&);
+
+    ResultOr<NonnullOwnPtr<Operator>> create_operator() const;
+    Vector<ByteString> explain() const;
+
+    Vector<TableAccess> const& tables() const { return m_tables; }
+    Vector<JoinStep> const& join_order() const { return m_join_order; }
+
+private:
+    QueryPlan() = default;
+
+    Vector<TableAccess> m_tables;
+    Vector<JoinStep> m_join_order;
+    Vector<NonnullRefPtr<Expression>> m_residual_predicates;
+};
+
+}
@@ -4,8 +4,9 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <AK/NumericLimits.h>
 #include <LibSQL/AST/AST.h>
+#include <LibSQL/AST/Operators.h>
+#include <LibSQL/AST/QueryPlan.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Meta.h>
 #include <LibSQL/Row.h>
@@ -37,10 +38,9 @@ static ByteString result_column_name(ResultColumn const& column, size_t column_i
     return fallback_column_name();
 }
 
-ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
+ResultOr<NonnullOwnPtr<Operator>> Select::create_operator(ExecutionContext& context, Vector<ByteString>& column_names) const
 {
     Vector<NonnullRefPtr<ResultColumn const>> columns;
-    Vector<ByteString> column_names;
 
     auto const& result_column_list = this->result_column_list();
     VERIFY(!result_column_list.is_empty());
@@ -83,98 +83,33 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
         }
     }
 
-    ResultSet result { SQLCommand::Select, move(column_names) };
-
-    auto descriptor = adopt_ref(*new TupleDescriptor);
-    Tuple tuple(descriptor);
-    Vector<Tuple> rows;
-    descriptor->empend("__unity__"sv);
-    tuple.append(Value { true });
-    rows.append(tuple);
-
-    for (auto& table_descriptor : table_or_subquery_list()) {
-        if (!table_descriptor->is_table())
-            return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
-
-        auto table_def = TRY(context.database->get_table(table_descriptor->schema_name(), table_descriptor->table_name()));
-        if (table_def->num_columns() == 0)
-            continue;
-
-        auto old_descriptor_size = descriptor->size();
-        descriptor->extend(table_def->to_tuple_descriptor());
+    auto plan = TRY(QueryPlan::create(context, *this));
+    auto root = TRY(plan.create_operator());
 
-        while (!rows.is_empty() && (rows.first().size() == old_descriptor_size)) {
-            auto cartesian_row = rows.take_first();
-            auto table_rows = TRY(context.database->select_all(*table_def));
+    if (!m_ordering_term_list.is_empty())
+        root = TRY(try_make<SortOperator>(move(root), m_ordering_term_list, m_limit_clause));
 
-            for (auto& table_row : table_rows) {
-                auto new_row = cartesian_row;
-                new_row.extend(table_row);
-                rows.append(new_row);
-            }
-        }
-    }
+    root = TRY(try_make<ProjectOperator>(move(root), move(columns)));
 
-    bool has_ordering { false };
-    auto sort_descriptor = adopt_ref(*new TupleDescriptor);
-    for (auto& term : m_ordering_term_list) {
-        sort_descriptor->append(TupleElementDescriptor { .order = term->order() });
-        has_ordering = true;
-    }
-    Tuple sort_key(sort_descriptor);
-
-    for (auto& row : rows) {
-        context.current_row = &row;
-
-        if (where_clause()) {
-            auto where_result = TRY(where_clause()->evaluate(context)).to_bool();
-            if (!where_result.has_value() || !where_result.value())
-                continue;
-        }
+    if (m_limit_clause != nullptr)
+        root = TRY(try_make<LimitOperator>(move(root), *m_limit_clause));
 
-        tuple.clear();
-
-        for (auto& col : columns) {
-            auto value = TRY(col->expression()->evaluate(context));
-            tuple.append(value);
-        }
-
-        if (has_ordering) {
-            sort_key.clear();
-            for (auto& term : m_ordering_term_list) {
-                auto value = TRY(term->expression()->evaluate(context));
-                sort_key.append(value);
-            }
-        }
-
-        result.insert_row(tuple, sort_key);
-    }
-
-    if (m_limit_clause != nullptr) {
-        size_t limit_value = NumericLimits<size_t>::max();
-        size_t offset_value = 0;
-
-        auto limit = TRY(m_limit_clause->limit_expression()->evaluate(context));
-        if (!limit.is_null()) {
-            auto limit_value_maybe = limit.to_int<size_t>();
-            if (!limit_value_maybe.has_value())
-                return Result { SQLCommand::Select, SQLErrorCode::SyntaxError, "LIMIT clause must evaluate to an integer value"sv };
+    return root;
+}
 
-            limit_value = limit_value_maybe.value();
-        }
+ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
+{
+    Vector<ByteString> column_names;
+    auto root = TRY(create_operator(context, column_names));
 
-        if (m_limit_clause->offset_expression() != nullptr) {
-            auto offset = TRY(m_limit_clause->offset_expression()->evaluate(context));
-            if (!offset.is_null()) {
-                auto offset_value_maybe = offset.to_int<size_t>();
-                if (!offset_value_maybe.has_value())
-                    return Result { SQLCommand::Select, SQLErrorCode::SyntaxError, "OFFSET clause must evaluate to an integer value"sv };
+    ResultSet result { SQLCommand::Select, move(column_names) };
 
-                offset_value = offset_value_maybe.value();
-            }
-        }
+    while (true) {
+        auto row = TRY(root->next(context));
+        if (!row.has_value())
+            break;
 
-        result.limit(offset_value, limit_value);
+        TRY(result.try_append(ResultRow { row.release_value(), Tuple {} }));
     }
 
     return result;
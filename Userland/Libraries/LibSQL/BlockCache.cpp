@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibIPC/Decoder.h>
+#include <LibIPC/Encoder.h>
+#include <LibSQL/BlockCache.h>
+
+namespace SQL {
+
+BlockCache::BlockCache(size_t capacity)
+    : m_capacity(capacity)
+{
+}
+
+BlockCache::~BlockCache()
+{
+    clear();
+}
+
+void BlockCache::set_capacity(size_t capacity)
+{
+    m_capacity = capacity;
+    evict_until_size(capacity);
+}
+
+Optional<ReadonlyBytes> BlockCache::get(Block::Index index)
+{
+    auto entry = m_entries.get(index);
+    if (!entry.has_value()) {
+        ++m_statistics.misses;
+        return {};
+    }
+
+    ++m_statistics.hits;
+    m_recently_used.remove(**entry);
+    m_recently_used.append(**entry);
+    return (*entry)->data.bytes();
+}
+
+ErrorOr<void> BlockCache::put(Block::Index index, ReadonlyBytes data)
+{
+    if (m_capacity == 0)
+        return {};
+
+    if (auto entry = m_entries.get(index); entry.has_value()) {
+        VERIFY((*entry)->data.size() == data.size());
+        (*entry)->data.overwrite(0, data.data(), data.size());
+        m_recently_used.remove(**entry);
+        m_recently_used.append(**entry);
+        return {};
+    }
+
+    evict_until_size(m_capacity - 1);
+
+    auto entry = TRY(try_make<Entry>());
+    entry->index = index;
+    entry->data = TRY(ByteBuffer::copy(data));
+
+    m_recently_used.append(*entry);
+    TRY(m_entries.try_set(index, move(entry)));
+    return {};
+}
+
+ErrorOr<void> BlockCache::update_if_cached(Block::Index index, ReadonlyBytes data)
+{
+    auto entry = m_entries.get(index);
+    if (!entry.has_value())
+        return {};
+
+    VERIFY((*entry)->data.size() == data.size());
+    (*entry)->data.overwrite(0, data.data(), data.size());
+    return {};
+}
+
+void BlockCache::remove(Block::Index index)
+{
+    auto entry = m_entries.get(index);
+    if (!entry.has_value())
+        return;
+
+    m_recently_used.remove(**entry);
+    m_entries.remove(index);
+}
+
+void BlockCache::clear()
+{
+    m_recently_used.clear();
+    m_entries.clear();
+}
+
+void BlockCache::evict_until_size(size_t size)
+{
+    while (m_entries.size() > size) {
+        auto* entry = m_recently_used.take_first();
+        VERIFY(entry);
+
+        ++m_statistics.evictions;
+        m_entries.remove(entry->index);
+    }
+}
+
+BlockCacheStatistics BlockCache::statistics() const
+{
+    auto statistics = m_statistics;
+    statistics.cached_blocks = m_entries.size();
+    statistics.capacity = m_capacity;
+    return statistics;
+}
+
+}
+
+template<>
+ErrorOr<void> IPC::encode(Encoder& encoder, SQL::BlockCacheStatistics const& statistics)
+{
+    TRY(encoder.encode(statistics.hits));
+    TRY(encoder.encode(statistics.misses));
+    TRY(encoder.encode(statistics.read_ahead_blocks));
+    TRY(encoder.encode(statistics.evictions));
+    TRY(encoder.encode(statistics.cached_blocks));
+    return encoder.encode(statistics.capacity);
+}
+
+template<>
+ErrorOr<SQL::BlockCacheStatistics> IPC::decode(Decoder& decoder)
+{
+    SQL::BlockCacheStatistics statistics;
+    statistics.hits = TRY(decoder.decode<u64>());
+    statistics.misses = TRY(decoder.decode<u64>());
+    statistics.read_ahead_blocks = TRY(decoder.decode<u64>());
+    statistics.evictions = TRY(decoder.decode<u64>());
+    statistics.cached_blocks = TRY(decoder.decode<u64>());
+    statistics.capacity = TRY(decoder.decode<u64>());
+    return statistics;
+}
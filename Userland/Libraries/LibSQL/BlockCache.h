@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <LibIPC/Forward.h>
+#include <LibSQL/Heap.h>
+
+namespace SQL {
+
+struct BlockCacheStatistics {
+    u64 hits { 0 };
+    u64 misses { 0 };
+    u64 read_ahead_blocks { 0 };
+    u64 evictions { 0 };
+    u64 cached_blocks { 0 };
+    u64 capacity { 0 };
+};
+
+/**
+ * A BlockCache holds the contents of up to `capacity` recently read blocks of a
+ * Heap, so that reading them again does not need to go to the disk. When full,
+ * the least recently used block is evicted to make room for a new one.
+ *
+ * The cache only holds blocks as they are committed; the Heap keeps blocks that
+ * are not yet committed to itself, and updates the cache when they are.
+ */
+class BlockCache {
+    AK_MAKE_NONCOPYABLE(BlockCache);
+    AK_MAKE_NONMOVABLE(BlockCache);
+
+public:
+    explicit BlockCache(size_t capacity);
+    ~BlockCache();
+
+    size_t capacity() const { return m_capacity; }
+    void set_capacity(size_t);
+
+    size_t size() const { return m_entries.size(); }
+    bool contains(Block::Index index) const { return m_entries.contains(index); }
+
+    // Looks up a block, marking it as the most recently used one. The returned bytes are valid until the
+    // cache is next modified.
+    Optional<ReadonlyBytes> get(Block::Index);
+
+    ErrorOr<void> put(Block::Index, ReadonlyBytes);
+    ErrorOr<void> update_if_cached(Block::Index, ReadonlyBytes);
+    void remove(Block::Index);
+    void clear();
+
+    void did_read_ahead(size_t block_count) { m_statistics.read_ahead_blocks += block_count; }
+    BlockCacheStatistics statistics() const;
+
+private:
+    struct Entry {
+        Block::Index index { 0 };
+        ByteBuffer data;
+        IntrusiveListNode<Entry> list_node;
+
+        using List = IntrusiveList<&Entry::list_node>;
+    };
+
+    void evict_until_size(size_t);
+
+    size_t m_capacity { 0 };
+    HashMap<Block::Index, NonnullOwnPtr<Entry>> m_entries;
+
+    // Ordered from the least to the most recently used entry.
+    Entry::List m_recently_used;
+
+    BlockCacheStatistics m_statistics;
+};
+
+}
+
+namespace IPC {
+
+template<>
+ErrorOr<void> encode(Encoder&, SQL::BlockCacheStatistics const&);
+
+template<>
+ErrorOr<SQL::BlockCacheStatistics> decode(Decoder&);
+
+}
@@ -7,6 +7,7 @@
 
 #include <AK/ByteString.h>
 #include <LibSQL/BTree.h>
+#include <LibSQL/BlockCache.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Heap.h>
 #include <LibSQL/Meta.h>
@@ -83,7 +84,22 @@ Database::~Database() = default;
 ErrorOr<void> Database::commit()
 {
     VERIFY(is_open());
-    TRY(m_heap->flush());
+    TRY(m_heap->commit());
+
+    if (!m_defers_sync)
+        TRY(m_heap->sync());
+    return {};
+}
+
+BlockCacheStatistics Database::block_cache_statistics() const
+{
+    return m_heap->block_cache_statistics();
+}
+
+ErrorOr<void> Database::sync()
+{
+    VERIFY(is_open());
+    TRY(m_heap->sync());
     return {};
 }
 
@@ -165,6 +181,8 @@ ResultOr<NonnullRefPtr<TableDef>> Database::get_table(ByteString const& schema,
     auto schema_def = TRY(get_schema(schema));
     auto table_def = TRY(TableDef::create(schema_def, name));
     table_def->set_block_index((*table_iterator).block_index());
+    if (table_def->block_index() == 0)
+        table_def->set_row_count(0);
     m_table_cache.set(key.hash(), table_def);
 
     auto table_hash = table_def->hash();
@@ -175,6 +193,12 @@ ResultOr<NonnullRefPtr<TableDef>> Database::get_table(ByteString const& schema,
     return table_def;
 }
 
+Row Database::read_row(TableDef& table, Block::Index block_index)
+{
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
+    return m_serializer.deserialize_block<Row>(block_index, table, block_index);
+}
+
 ErrorOr<Vector<Row>> Database::select_all(TableDef& table)
 {
     VERIFY(m_table_cache.get(table.key().hash()).has_value());
@@ -193,13 +217,27 @@ ErrorOr<Vector<Row>> Database::match(TableDef& table, Key const& key)
     // use the index instead of scanning the table.
     for (auto block_index = table.block_index(); block_index;) {
         auto row = m_serializer.deserialize_block<Row>(block_index, table, block_index);
-        if (row.match(key))
-            ret.append(row);
-        block_index = ret.last().next_block_index();
+        block_index = row.next_block_index();
+        if (row.match(key) == 0)
+            ret.append(move(row));
     }
     return ret;
 }
 
+ErrorOr<size_t> Database::row_count(TableDef& table)
+{
+    VERIFY(m_table_cache.get(table.key().hash()).has_value());
+    if (auto row_count = table.row_count(); row_count.has_value())
+        return row_count.value();
+
+    size_t row_count = 0;
+    for (auto block_index = table.block_index(); block_index; ++row_count)
+        block_index = m_serializer.deserialize_block<Row>(block_index, table, block_index).next_block_index();
+
+    table.set_row_count(row_count);
+    return row_count;
+}
+
 ErrorOr<void> Database::insert(Row& row)
 {
     VERIFY(m_table_cache.get(row.table().key().hash()).has_value());
@@ -215,6 +253,7 @@ ErrorOr<void> Database::insert(Row& row)
     table_key.set_block_index(row.block_index());
     VERIFY(m_tables->update_key_pointer(table_key));
     row.table().set_block_index(row.block_index());
+    row.table().did_insert_row();
     return {};
 }
 
@@ -224,6 +263,7 @@ ErrorOr<void> Database::remove(Row& row)
     VERIFY(m_table_cache.get(table.key().hash()).has_value());
 
     TRY(m_heap->free_storage(row.block_index()));
+    table.did_remove_row();
 
     if (table.block_index() == row.block_index()) {
         auto table_key = table.key();
@@ -31,7 +31,20 @@ public:
     ResultOr<void> open();
     bool is_open() const { return m_open; }
     ErrorOr<void> commit();
+    ErrorOr<void> sync();
     ErrorOr<size_t> file_size_in_bytes() const { return m_heap->file_size_in_bytes(); }
+    BlockCacheStatistics block_cache_statistics() const;
+
+    // When syncs are deferred, commit() does not wait for the committed changes to reach the disk. They only
+    // become durable on the next call to sync(), which allows many commits to share a single sync.
+    bool defers_sync() const { return m_defers_sync; }
+    void set_defers_sync(bool defers_sync) { m_defers_sync = defers_sync; }
+
+    // The number of bytes of rows a query may hold in memory while sorting them. Once exceeded, the sorted
+    // rows are written to temporary files, and merged from there.
+    static constexpr size_t DEFAULT_SORT_MEMORY_BUDGET = 16 * MiB;
+    size_t sort_memory_budget() const { return m_sort_memory_budget; }
+    void set_sort_memory_budget(size_t sort_memory_budget) { m_sort_memory_budget = sort_memory_budget; }
 
     ResultOr<void> add_schema(SchemaDef const&);
     static Key get_schema_key(ByteString const&);
@@ -41,8 +54,10 @@ public:
     static Key get_table_key(ByteString const&, ByteString const&);
     ResultOr<NonnullRefPtr<TableDef>> get_table(ByteString const&, ByteString const&);
 
+    Row read_row(TableDef&, Block::Index);
     ErrorOr<Vector<Row>> select_all(TableDef&);
     ErrorOr<Vector<Row>> match(TableDef&, Key const&);
+    ErrorOr<size_t> row_count(TableDef&);
     ErrorOr<void> insert(Row&);
     ErrorOr<void> remove(Row&);
     ErrorOr<void> update(Row&);
@@ -51,6 +66,8 @@ private:
     explicit Database(NonnullRefPtr<Heap>);
 
     bool m_open { false };
+    bool m_defers_sync { false };
+    size_t m_sort_memory_budget { DEFAULT_SORT_MEMORY_BUDGET };
     NonnullRefPtr<Heap> m_heap;
     Serializer m_serializer;
     RefPtr<BTree> m_schemas;
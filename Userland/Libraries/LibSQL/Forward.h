@@ -7,6 +7,8 @@
 #pragma once
 
 namespace SQL {
+class BlockCache;
+struct BlockCacheStatistics;
 class BTree;
 class BTreeIterator;
 class ColumnDef;
@@ -23,12 +25,14 @@ class ResultSet;
 class Row;
 class SchemaDef;
 class Serializer;
+class SortRun;
 class TableDef;
 class TreeNode;
 class Tuple;
 class TupleDescriptor;
 struct TupleElementDescriptor;
 class Value;
+class WriteAheadLog;
 }
 
 namespace SQL::AST {
@@ -53,6 +57,7 @@ class DropTable;
 class ErrorExpression;
 class ErrorStatement;
 class ExistsExpression;
+class Explain;
 class Expression;
 class GroupByClause;
 class InChainedExpression;
@@ -70,6 +75,7 @@ class NestedExpression;
 class NullExpression;
 class NullLiteral;
 class NumericLiteral;
+class Operator;
 class OrderingTerm;
 class Parser;
 class QualifiedTableName;
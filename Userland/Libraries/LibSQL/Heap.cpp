@@ -9,7 +9,9 @@
 #include <AK/Format.h>
 #include <AK/QuickSort.h>
 #include <LibCore/System.h>
+#include <LibSQL/BlockCache.h>
 #include <LibSQL/Heap.h>
+#include <LibSQL/WriteAheadLog.h>
 #include <sys/stat.h>
 
 namespace SQL {
@@ -26,10 +28,17 @@ Heap::Heap(ByteString file_name)
 
 Heap::~Heap()
 {
-    if (m_file && !m_write_ahead_log.is_empty()) {
-        if (auto maybe_error = flush(); maybe_error.is_error())
-            warnln("~Heap({}): {}", name(), maybe_error.error());
-    }
+    if (!m_file)
+        return;
+
+    // Leave everything in the Heap file on a clean shutdown, so the log is no longer needed.
+    auto maybe_error = [&]() -> ErrorOr<void> {
+        TRY(flush());
+        TRY(checkpoint());
+        return m_write_ahead_log->remove();
+    }();
+    if (maybe_error.is_error())
+        warnln("~Heap({}): {}", name(), maybe_error.error());
 }
 
 ErrorOr<void> Heap::open()
@@ -50,27 +59,58 @@ ErrorOr<void> Heap::open()
         file_size = stat_buffer.st_size;
     }
 
-    if (file_size > 0) {
-        m_next_block = file_size / Block::SIZE;
-        m_highest_block_written = m_next_block - 1;
-    }
+    m_block_cache = TRY(try_make<BlockCache>(m_block_cache_capacity));
 
     auto file = TRY(Core::File::open(name(), Core::File::OpenMode::ReadWrite));
+    m_file_descriptor = file->fd();
     m_file = TRY(Core::InputBufferedFile::create(move(file)));
 
+    auto close_files = [&]() {
+        m_file = nullptr;
+        m_file_descriptor = -1;
+        m_write_ahead_log = nullptr;
+        m_block_cache = nullptr;
+    };
+
+    auto write_ahead_log_or_error = WriteAheadLog::open(ByteString::formatted("{}-wal", name()));
+    if (write_ahead_log_or_error.is_error()) {
+        close_files();
+        return write_ahead_log_or_error.release_error();
+    }
+    m_write_ahead_log = write_ahead_log_or_error.release_value();
+
     if (file_size > 0) {
+        // Replay the transactions that were committed to the log, but not yet copied into the Heap file.
+        if (!m_write_ahead_log->is_empty()) {
+            if (auto error_maybe = checkpoint(); error_maybe.is_error()) {
+                close_files();
+                return error_maybe.release_error();
+            }
+            file_size = max(file_size, TRY(m_file->seek(0, SeekMode::FromEndPosition)));
+        }
+
+        m_next_block = file_size / Block::SIZE;
+        m_highest_block_written = m_next_block - 1;
+
         if (auto error_maybe = read_zero_block(); error_maybe.is_error()) {
-            m_file = nullptr;
+            close_files();
             return error_maybe.release_error();
         }
     } else {
+        // A log without a Heap file to go with it belongs to a database that no longer exists.
+        TRY(m_write_ahead_log->reset());
+
+        // Write the zero block through to the Heap file, so a Heap file exists for any transaction in the log.
         TRY(initialize_zero_block());
+        TRY(flush());
+        TRY(checkpoint());
     }
 
     // FIXME: We should more gracefully handle version incompatibilities. For now, we drop the database.
     if (m_version != VERSION) {
         dbgln_if(SQL_DEBUG, "Heap file {} opened has incompatible version {}. Deleting for version {}.", name(), m_version, VERSION);
-        m_file = nullptr;
+        TRY(m_write_ahead_log->remove());
+        close_files();
 
         TRY(Core::System::unlink(name()));
         return open();
@@ -92,12 +132,29 @@ ErrorOr<void> Heap::open()
 ErrorOr<size_t> Heap::file_size_in_bytes() const
 {
     TRY(m_file->seek(0, SeekMode::FromEndPosition));
-    return TRY(m_file->tell());
+    auto file_size = TRY(m_file->tell());
+
+    // Blocks committed to the log, but not yet checkpointed, may extend the Heap file beyond its current size.
+    return max(file_size, (static_cast<size_t>(m_highest_block_written) + 1) * Block::SIZE);
+}
+
+void Heap::set_block_cache_capacity(size_t capacity)
+{
+    m_block_cache_capacity = capacity;
+    if (m_block_cache)
+        m_block_cache->set_capacity(capacity);
+}
+
+BlockCacheStatistics Heap::block_cache_statistics() const
+{
+    if (!m_block_cache)
+        return { .capacity = m_block_cache_capacity };
+    return m_block_cache->statistics();
 }
 
 bool Heap::has_block(Block::Index index) const
 {
-    return (index <= m_highest_block_written || m_write_ahead_log.contains(index))
+    return (index <= m_highest_block_written || m_pending_blocks.contains(index))
         && !m_free_block_indices.contains_slow(index);
 }
 
@@ -177,13 +234,62 @@ ErrorOr<ByteBuffer> Heap::read_raw_block(Block::Index index)
     VERIFY(m_file);
     VERIFY(index < m_next_block);
 
-    if (auto wal_entry = m_write_ahead_log.get(index); wal_entry.has_value())
-        return wal_entry.value();
+    if (auto pending_block = m_pending_blocks.get(index); pending_block.has_value())
+        return pending_block.value();
+
+    if (auto cached_block = m_block_cache->get(index); cached_block.has_value())
+        return ByteBuffer::copy(*cached_block);
+
+    if (auto logged_block = TRY(m_write_ahead_log->read_block(index)); logged_block.has_value()) {
+        TRY(m_block_cache->put(index, *logged_block));
+        return logged_block.release_value();
+    }
+
+    return read_raw_blocks_from_file(index);
+}
+
+ErrorOr<ByteBuffer> Heap::read_raw_blocks_from_file(Block::Index index)
+{
+    // Table scans mostly visit rows in the order their blocks were allocated in. If a block directly follows the
+    // last one read from the file, assume such a scan and read the blocks after it along with it.
+    size_t block_count = 1;
+    if (index == m_last_block_read_from_file + 1) {
+        auto max_block_count = min(READ_AHEAD_BLOCKS, m_block_cache->capacity());
+        while (block_count < max_block_count && index + block_count <= m_highest_block_written)
+            ++block_count;
+    }
 
     TRY(m_file->seek(index * Block::SIZE, SeekMode::SetPosition));
-    auto buffer = TRY(ByteBuffer::create_uninitialized(Block::SIZE));
-    TRY(m_file->read_until_filled(buffer));
-    return buffer;
+    auto buffer = TRY(ByteBuffer::create_uninitialized(block_count * Block::SIZE));
+
+    // Blocks at the end of the Heap may only exist in the log, so the file can end before all blocks were read.
+    size_t bytes_read = 0;
+    while (bytes_read < buffer.size()) {
+        auto bytes = TRY(m_file->read_some(buffer.bytes().slice(bytes_read)));
+        if (bytes.is_empty())
+            break;
+        bytes_read += bytes.size();
+    }
+    if (bytes_read < Block::SIZE)
+        return Error::from_string_literal("Heap::read_raw_block(): Block is beyond the end of the file");
+
+    block_count = bytes_read / Block::SIZE;
+    m_last_block_read_from_file = index + block_count - 1;
+
+    for (size_t i = 1; i < block_count; ++i) {
+        auto read_ahead_index = static_cast<Block::Index>(index + i);
+
+        // The file holds an outdated version of blocks that have since been written to.
+        if (m_pending_blocks.contains(read_ahead_index) || m_write_ahead_log->contains(read_ahead_index) || m_block_cache->contains(read_ahead_index))
+            continue;
+
+        TRY(m_block_cache->put(read_ahead_index, buffer.bytes().slice(i * Block::SIZE, Block::SIZE)));
+        m_block_cache->did_read_ahead(1);
+    }
+
+    auto block = TRY(buffer.slice(0, Block::SIZE));
+    TRY(m_block_cache->put(index, block));
+    return block;
 }
 
 ErrorOr<Block> Heap::read_block(Block::Index index)
@@ -214,13 +320,13 @@ ErrorOr<void> Heap::write_raw_block(Block::Index index, ReadonlyBytes data)
     return {};
 }
 
-ErrorOr<void> Heap::write_raw_block_to_wal(Block::Index index, ByteBuffer&& data)
+ErrorOr<void> Heap::write_raw_block_to_pending(Block::Index index, ByteBuffer&& data)
 {
     dbgln_if(SQL_DEBUG, "{}({})", __FUNCTION__, index);
     VERIFY(index < m_next_block);
     VERIFY(data.size() == Block::SIZE);
 
-    TRY(m_write_ahead_log.try_set(index, move(data)));
+    TRY(m_pending_blocks.try_set(index, move(data)));
 
     return {};
 }
@@ -242,7 +348,7 @@ ErrorOr<void> Heap::write_block(Block const& block)
 
     block.data().bytes().copy_to(heap_data.bytes().slice(Block::HEADER_SIZE));
 
-    return write_raw_block_to_wal(block.index(), move(heap_data));
+    return write_raw_block_to_pending(block.index(), move(heap_data));
 }
 
 ErrorOr<void> Heap::free_storage(Block::Index index)
@@ -268,23 +374,69 @@ ErrorOr<void> Heap::free_block(Block const& block)
 
     // Zero out freed blocks to facilitate a free block scan upon opening the database later
     auto zeroed_data = TRY(ByteBuffer::create_zeroed(Block::SIZE));
-    TRY(write_raw_block_to_wal(index, move(zeroed_data)));
+    TRY(write_raw_block_to_pending(index, move(zeroed_data)));
 
     return m_free_block_indices.try_append(index);
 }
 
-ErrorOr<void> Heap::flush()
+ErrorOr<void> Heap::commit()
 {
     VERIFY(m_file);
-    auto indices = m_write_ahead_log.keys();
+    if (m_pending_blocks.is_empty())
+        return {};
+
+    auto indices = m_pending_blocks.keys();
     quick_sort(indices);
-    for (auto index : indices) {
-        dbgln_if(SQL_DEBUG, "Flushing block {}", index);
-        auto& data = m_write_ahead_log.get(index).value();
-        TRY(write_raw_block(index, data));
+    TRY(m_write_ahead_log->append_transaction(indices, m_pending_blocks));
+
+    for (auto index : indices)
+        TRY(m_block_cache->update_if_cached(index, m_pending_blocks.get(index).value()));
+
+    if (indices.last() > m_highest_block_written)
+        m_highest_block_written = indices.last();
+
+    m_pending_blocks.clear();
+    dbgln_if(SQL_DEBUG, "Committed {} blocks; new number of blocks = {}", indices.size(), m_highest_block_written);
+    return {};
+}
+
+ErrorOr<void> Heap::sync()
+{
+    VERIFY(m_file);
+    TRY(m_write_ahead_log->sync());
+
+    if (m_write_ahead_log->frame_count() >= CHECKPOINT_THRESHOLD)
+        TRY(checkpoint());
+    return {};
+}
+
+ErrorOr<void> Heap::flush()
+{
+    TRY(commit());
+    return sync();
+}
+
+ErrorOr<void> Heap::checkpoint()
+{
+    VERIFY(m_file);
+    if (m_write_ahead_log->is_empty())
+        return {};
+
+    // Only blocks of synced transactions may be copied into the Heap file.
+    TRY(m_write_ahead_log->sync());
+
+    for (auto index : m_write_ahead_log->block_indices()) {
+        dbgln_if(SQL_DEBUG, "Checkpointing block {}", index);
+        auto data = TRY(m_write_ahead_log->read_block(index));
+        TRY(write_raw_block(index, data.value()));
     }
-    m_write_ahead_log.clear();
-    dbgln_if(SQL_DEBUG, "WAL flushed; new number of blocks = {}", m_highest_block_written);
+
+    // The log may only be reset once its blocks are known to have reached the Heap file. Should we crash
+    // before that, the same blocks are copied again when the Heap is next opened.
+    TRY(Core::System::fsync(m_file_descriptor));
+    TRY(m_write_ahead_log->reset());
+
+    dbgln_if(SQL_DEBUG, "Checkpoint of {} complete; number of blocks = {}", name(), m_highest_block_written);
     return {};
 }
 
@@ -348,7 +500,7 @@ ErrorOr<void> Heap::update_zero_block()
     buffer_bytes.overwrite(TABLE_COLUMNS_ROOT_OFFSET, &m_table_columns_root, sizeof(u32));
     buffer_bytes.overwrite(USER_VALUES_OFFSET, m_user_values.data(), m_user_values.size() * sizeof(u32));
 
-    return write_raw_block_to_wal(0, move(buffer));
+    return write_raw_block_to_pending(0, move(buffer));
 }
 
 ErrorOr<void> Heap::initialize_zero_block()
@@ -14,6 +14,7 @@
 #include <AK/RefCounted.h>
 #include <AK/Vector.h>
 #include <LibCore/File.h>
+#include <LibSQL/Forward.h>
 
 namespace SQL {
 
@@ -63,10 +64,24 @@ private:
  *
  * A Heap can be thought of the backing storage of a single database. It's
  * assumed that a single SQL database is backed by a single Heap.
+ *
+ * Blocks written to the Heap are held in memory until they are committed, at
+ * which point they are appended to the Heap's WriteAheadLog as one transaction.
+ * Committing does not wait for the log to reach the disk; sync() does, and lets
+ * any number of commits share a single fsync. flush() commits and syncs. Once
+ * the log grows past CHECKPOINT_THRESHOLD frames, its blocks are copied back
+ * into the Heap file and the log is reset.
+ *
+ * Committed blocks that are read are kept in a BlockCache, which holds up to
+ * block_cache_capacity() blocks. Reading a block from the Heap file directly
+ * after the block before it reads up to READ_AHEAD_BLOCKS blocks at once.
  */
 class Heap : public RefCounted<Heap> {
 public:
     static constexpr u32 VERSION = 5;
+    static constexpr size_t CHECKPOINT_THRESHOLD = 1000;
+    static constexpr size_t READ_AHEAD_BLOCKS = 16;
+    static constexpr size_t DEFAULT_BLOCK_CACHE_CAPACITY = 1024;
 
     static ErrorOr<NonnullRefPtr<Heap>> create(ByteString);
     virtual ~Heap();
@@ -76,6 +91,10 @@ public:
     ErrorOr<void> open();
     ErrorOr<size_t> file_size_in_bytes() const;
 
+    size_t block_cache_capacity() const { return m_block_cache_capacity; }
+    void set_block_cache_capacity(size_t);
+    BlockCacheStatistics block_cache_statistics() const;
+
     [[nodiscard]] bool has_block(Block::Index) const;
     [[nodiscard]] Block::Index request_new_block_index();
 
@@ -119,14 +138,18 @@ public:
     ErrorOr<void> write_storage(Block::Index, ReadonlyBytes);
     ErrorOr<void> free_storage(Block::Index);
 
+    ErrorOr<void> commit();
+    ErrorOr<void> sync();
     ErrorOr<void> flush();
+    ErrorOr<void> checkpoint();
 
 private:
     explicit Heap(ByteString);
 
     ErrorOr<ByteBuffer> read_raw_block(Block::Index);
+    ErrorOr<ByteBuffer> read_raw_blocks_from_file(Block::Index);
     ErrorOr<void> write_raw_block(Block::Index, ReadonlyBytes);
-    ErrorOr<void> write_raw_block_to_wal(Block::Index, ByteBuffer&&);
+    ErrorOr<void> write_raw_block_to_pending(Block::Index, ByteBuffer&&);
 
     ErrorOr<Block> read_block(Block::Index);
     ErrorOr<void> write_block(Block const&);
@@ -139,6 +162,11 @@ private:
     ByteString m_name;
 
     OwnPtr<Core::InputBufferedFile> m_file;
+    int m_file_descriptor { -1 };
+    OwnPtr<WriteAheadLog> m_write_ahead_log;
+    OwnPtr<BlockCache> m_block_cache;
+    size_t m_block_cache_capacity { DEFAULT_BLOCK_CACHE_CAPACITY };
+    Block::Index m_last_block_read_from_file { 0 };
     Block::Index m_highest_block_written { 0 };
     Block::Index m_next_block { 1 };
     Block::Index m_schemas_root { 0 };
@@ -146,7 +174,7 @@ private:
     Block::Index m_table_columns_root { 0 };
     u32 m_version { VERSION };
     Array<u32, 16> m_user_values { 0 };
-    HashMap<Block::Index, ByteBuffer> m_write_ahead_log;
+    HashMap<Block::Index, ByteBuffer> m_pending_blocks;
     Vector<Block::Index> m_free_block_indices;
 };
 
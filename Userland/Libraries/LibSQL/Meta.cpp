@@ -214,6 +214,20 @@ void TableDef::append_column(Key const& column)
     append_column(column["column_name"].to_byte_string(), static_cast<SQLType>(*column_type));
 }
 
+void TableDef::did_insert_row()
+{
+    if (m_row_count.has_value())
+        ++m_row_count.value();
+}
+
+void TableDef::did_remove_row()
+{
+    if (m_row_count.has_value()) {
+        VERIFY(m_row_count.value() > 0);
+        --m_row_count.value();
+    }
+}
+
 Key TableDef::make_key(SchemaDef const& schema_def)
 {
     return TableDef::make_key(schema_def.key());
@@ -8,6 +8,7 @@
 
 #include <AK/ByteString.h>
 #include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
 #include <AK/RefCounted.h>
 #include <AK/Result.h>
 #include <AK/Vector.h>
@@ -141,6 +142,13 @@ public:
     Vector<NonnullRefPtr<IndexDef>> const& indexes() const { return m_indexes; }
     [[nodiscard]] NonnullRefPtr<TupleDescriptor> to_tuple_descriptor() const;
 
+    // The number of rows in the table is not stored in the database. It is counted the first time it is
+    // needed, and kept up to date as rows are inserted and removed from then on.
+    Optional<size_t> row_count() const { return m_row_count; }
+    void set_row_count(size_t row_count) { m_row_count = row_count; }
+    void did_insert_row();
+    void did_remove_row();
+
     static NonnullRefPtr<IndexDef> index_def();
     static Key make_key(SchemaDef const& schema_def);
     static Key make_key(Key const& schema_key);
@@ -150,6 +158,7 @@ private:
 
     Vector<NonnullRefPtr<ColumnDef>> m_columns;
     Vector<NonnullRefPtr<IndexDef>> m_indexes;
+    Optional<size_t> m_row_count;
 };
 
 }
@@ -19,6 +19,7 @@ namespace SQL {
     S(Create)                     \
     S(Delete)                     \
     S(Describe)                   \
+    S(Explain)                    \
     S(Insert)                     \
     S(Select)                     \
     S(Update)
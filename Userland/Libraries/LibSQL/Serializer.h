@@ -112,6 +112,15 @@ public:
     }
 
     [[nodiscard]] size_t offset() const { return m_current_offset; }
+
+    // Gives access to the buffer, for serializing to and deserializing from something other than the Heap.
+    [[nodiscard]] ByteBuffer const& buffer() const { return m_buffer; }
+    void set_buffer(ByteBuffer buffer)
+    {
+        m_buffer = move(buffer);
+        m_current_offset = 0;
+    }
+
     u32 request_new_block_index()
     {
         return m_heap->request_new_block_index();
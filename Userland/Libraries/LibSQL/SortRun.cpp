@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/SortRun.h>
+#include <LibSQL/Tuple.h>
+
+namespace SQL {
+
+static constexpr size_t WRITE_BUFFER_SIZE = 64 * KiB;
+
+ErrorOr<NonnullOwnPtr<SortRun>> SortRun::create()
+{
+    auto temp_file = TRY(FileSystem::TempFile::create_temp_file());
+    auto file = TRY(Core::File::open(temp_file->path(), Core::File::OpenMode::Write | Core::File::OpenMode::Truncate));
+    return adopt_nonnull_own_or_enomem(new (nothrow) SortRun(move(temp_file), move(file)));
+}
+
+SortRun::SortRun(NonnullOwnPtr<FileSystem::TempFile> temp_file, NonnullOwnPtr<Core::File> file)
+    : m_temp_file(move(temp_file))
+    , m_writer(move(file))
+{
+}
+
+SortRun::~SortRun() = default;
+
+ErrorOr<void> SortRun::append(Tuple const& sort_key, Tuple const& row)
+{
+    VERIFY(m_writer);
+
+    m_serializer.reset();
+    for (size_t i = 0; i < sort_key.size(); ++i)
+        m_serializer.serialize<Value>(sort_key[i]);
+    for (size_t i = 0; i < row.size(); ++i)
+        m_serializer.serialize<Value>(row[i]);
+
+    auto length = static_cast<u32>(m_serializer.buffer().size());
+    TRY(m_write_buffer.try_append(&length, sizeof(length)));
+    TRY(m_write_buffer.try_append(m_serializer.buffer().bytes()));
+    ++m_size;
+
+    if (m_write_buffer.size() >= WRITE_BUFFER_SIZE)
+        TRY(flush());
+    return {};
+}
+
+ErrorOr<void> SortRun::flush()
+{
+    TRY(m_writer->write_until_depleted(m_write_buffer));
+    m_write_buffer.clear();
+    return {};
+}
+
+ErrorOr<void> SortRun::finish()
+{
+    TRY(flush());
+    m_writer = nullptr;
+
+    auto file = TRY(Core::File::open(m_temp_file->path(), Core::File::OpenMode::Read));
+    m_reader = TRY(Core::InputBufferedFile::create(move(file)));
+    return {};
+}
+
+ErrorOr<bool> SortRun::read(Tuple& sort_key, Tuple& row)
+{
+    VERIFY(m_reader);
+    if (m_read == m_size)
+        return false;
+
+    u32 length = 0;
+    TRY(m_reader->read_until_filled({ &length, sizeof(length) }));
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(length));
+    TRY(m_reader->read_until_filled(buffer));
+    m_serializer.set_buffer(move(buffer));
+
+    for (size_t i = 0; i < sort_key.size(); ++i)
+        sort_key[i] = m_serializer.deserialize<Value>();
+    for (size_t i = 0; i < row.size(); ++i)
+        row[i] = m_serializer.deserialize<Value>();
+
+    ++m_read;
+    return true;
+}
+
+}
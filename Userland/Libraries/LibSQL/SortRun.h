@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/OwnPtr.h>
+#include <LibCore/File.h>
+#include <LibFileSystem/TempFile.h>
+#include <LibSQL/Forward.h>
+#include <LibSQL/Serializer.h>
+
+namespace SQL {
+
+/**
+ * A SortRun is a temporary file holding a sequence of sorted entries, written
+ * by an external sort once the entries it holds in memory exceed its budget.
+ * Every entry is a sort key and a row. Only their values are written to the
+ * file; the reader provides the descriptors of both tuples.
+ *
+ * A run is first appended to, and then read back in the same order once it
+ * is finished. The file is removed when the run is destroyed.
+ */
+class SortRun {
+    AK_MAKE_NONCOPYABLE(SortRun);
+    AK_MAKE_NONMOVABLE(SortRun);
+
+public:
+    static ErrorOr<NonnullOwnPtr<SortRun>> create();
+    ~SortRun();
+
+    size_t size() const { return m_size; }
+
+    ErrorOr<void> append(Tuple const& sort_key, Tuple const& row);
+    ErrorOr<void> finish();
+
+    // Reads the next entry into tuples with the same descriptors as those which were appended. Returns false
+    // once all entries have been read.
+    ErrorOr<bool> read(Tuple& sort_key, Tuple& row);
+
+private:
+    SortRun(NonnullOwnPtr<FileSystem::TempFile>, NonnullOwnPtr<Core::File>);
+
+    ErrorOr<void> flush();
+
+    NonnullOwnPtr<FileSystem::TempFile> m_temp_file;
+    OwnPtr<Core::File> m_writer;
+    OwnPtr<Core::InputBufferedFile> m_reader;
+
+    Serializer m_serializer;
+    ByteBuffer m_write_buffer;
+    size_t m_size { 0 };
+    size_t m_read { 0 };
+};
+
+}
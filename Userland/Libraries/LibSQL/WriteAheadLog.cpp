@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Format.h>
+#include <AK/QuickSort.h>
+#include <AK/Random.h>
+#include <LibCore/System.h>
+#include <LibCrypto/Checksum/CRC32.h>
+#include <LibSQL/WriteAheadLog.h>
+
+namespace SQL {
+
+constexpr static auto FILE_ID = "SerenityWAL "sv;
+constexpr static auto VERSION_OFFSET = FILE_ID.length();
+constexpr static auto SALT_OFFSET = VERSION_OFFSET + sizeof(u32);
+constexpr static auto HEADER_CHECKSUM_OFFSET = SALT_OFFSET + sizeof(u32);
+constexpr static auto HEADER_SIZE = HEADER_CHECKSUM_OFFSET + sizeof(u32);
+
+constexpr static size_t FRAME_BLOCK_INDEX_OFFSET = 0;
+constexpr static auto FRAME_COMMIT_SIZE_OFFSET = FRAME_BLOCK_INDEX_OFFSET + sizeof(Block::Index);
+constexpr static auto FRAME_SALT_OFFSET = FRAME_COMMIT_SIZE_OFFSET + sizeof(u32);
+constexpr static auto FRAME_CHECKSUM_OFFSET = FRAME_SALT_OFFSET + sizeof(u32);
+constexpr static auto FRAME_HEADER_SIZE = FRAME_CHECKSUM_OFFSET + sizeof(u32);
+constexpr static auto FRAME_SIZE = FRAME_HEADER_SIZE + Block::SIZE;
+
+static u32 read_u32(ReadonlyBytes bytes, size_t offset)
+{
+    u32 value;
+    memcpy(&value, bytes.offset(offset), sizeof(u32));
+    return value;
+}
+
+static void write_u32(Bytes bytes, size_t offset, u32 value)
+{
+    bytes.overwrite(offset, &value, sizeof(u32));
+}
+
+static u32 header_checksum(ReadonlyBytes header)
+{
+    return Crypto::Checksum::CRC32 { header.slice(0, HEADER_CHECKSUM_OFFSET) }.digest();
+}
+
+// The checksum covers everything in the frame except for the checksum itself.
+static u32 frame_checksum(ReadonlyBytes frame)
+{
+    Crypto::Checksum::CRC32 crc32;
+    crc32.update(frame.slice(0, FRAME_CHECKSUM_OFFSET));
+    crc32.update(frame.slice(FRAME_HEADER_SIZE));
+    return crc32.digest();
+}
+
+ErrorOr<NonnullOwnPtr<WriteAheadLog>> WriteAheadLog::open(ByteString file_name)
+{
+    auto file = TRY(Core::File::open(file_name, Core::File::OpenMode::ReadWrite));
+    auto log = TRY(adopt_nonnull_own_or_enomem(new (nothrow) WriteAheadLog(move(file_name), move(file))));
+    TRY(log->recover());
+    return log;
+}
+
+WriteAheadLog::WriteAheadLog(ByteString file_name, NonnullOwnPtr<Core::File> file)
+    : m_name(move(file_name))
+    , m_file(move(file))
+{
+}
+
+Vector<Block::Index> WriteAheadLog::block_indices() const
+{
+    auto indices = m_frame_offsets.keys();
+    quick_sort(indices);
+    return indices;
+}
+
+ErrorOr<void> WriteAheadLog::recover()
+{
+    auto file_size = TRY(m_file->seek(0, SeekMode::FromEndPosition));
+    if (file_size < HEADER_SIZE)
+        return reset();
+
+    TRY(m_file->seek(0, SeekMode::SetPosition));
+    auto header = TRY(ByteBuffer::create_uninitialized(HEADER_SIZE));
+    TRY(m_file->read_until_filled(header));
+
+    if (StringView { header.bytes().slice(0, FILE_ID.length()) } != FILE_ID
+        || read_u32(header, VERSION_OFFSET) != VERSION
+        || read_u32(header, HEADER_CHECKSUM_OFFSET) != header_checksum(header)) {
+        dbgln_if(SQL_DEBUG, "Write-ahead log {} has an invalid header; discarding it", name());
+        return reset();
+    }
+
+    m_salt = read_u32(header, SALT_OFFSET);
+    m_end_offset = HEADER_SIZE;
+
+    HashMap<Block::Index, u64> transaction_frame_offsets;
+    size_t transaction_frame_count = 0;
+    auto frame = TRY(ByteBuffer::create_uninitialized(FRAME_SIZE));
+
+    for (u64 offset = HEADER_SIZE; offset + FRAME_SIZE <= file_size; offset += FRAME_SIZE) {
+        TRY(m_file->seek(offset, SeekMode::SetPosition));
+        TRY(m_file->read_until_filled(frame));
+
+        // Frames left behind by an earlier generation of the log carry a different salt.
+        if (read_u32(frame, FRAME_SALT_OFFSET) != m_salt || read_u32(frame, FRAME_CHECKSUM_OFFSET) != frame_checksum(frame))
+            break;
+
+        TRY(transaction_frame_offsets.try_set(read_u32(frame, FRAME_BLOCK_INDEX_OFFSET), offset));
+        ++transaction_frame_count;
+
+        auto commit_size = read_u32(frame, FRAME_COMMIT_SIZE_OFFSET);
+        if (commit_size == 0)
+            continue;
+        if (commit_size != transaction_frame_count)
+            break;
+
+        for (auto const& frame_offset : transaction_frame_offsets)
+            TRY(m_frame_offsets.try_set(frame_offset.key, frame_offset.value));
+        m_frame_count += transaction_frame_count;
+        m_end_offset = offset + FRAME_SIZE;
+
+        transaction_frame_offsets.clear();
+        transaction_frame_count = 0;
+    }
+
+    dbgln_if(SQL_DEBUG, "Write-ahead log {} recovered; number of frames = {}; number of blocks = {}", name(), m_frame_count, m_frame_offsets.size());
+
+    // Drop everything after the last committed transaction, so that new frames are appended directly after it.
+    if (m_end_offset < file_size) {
+        TRY(m_file->truncate(m_end_offset));
+        TRY(Core::System::fsync(m_file->fd()));
+    }
+
+    return {};
+}
+
+ErrorOr<Optional<ByteBuffer>> WriteAheadLog::read_block(Block::Index index)
+{
+    auto offset = m_frame_offsets.get(index);
+    if (!offset.has_value())
+        return Optional<ByteBuffer> {};
+
+    TRY(m_file->seek(offset.value() + FRAME_HEADER_SIZE, SeekMode::SetPosition));
+    auto buffer = TRY(ByteBuffer::create_uninitialized(Block::SIZE));
+    TRY(m_file->read_until_filled(buffer));
+    return buffer;
+}
+
+ErrorOr<void> WriteAheadLog::append_transaction(Vector<Block::Index> const& indices, HashMap<Block::Index, ByteBuffer> const& blocks)
+{
+    dbgln_if(SQL_DEBUG, "{}({} blocks)", __FUNCTION__, indices.size());
+    VERIFY(!indices.is_empty());
+
+    // All frames of a transaction are written at once; the last one marks the transaction as committed.
+    auto buffer = TRY(ByteBuffer::create_zeroed(indices.size() * FRAME_SIZE));
+    for (size_t i = 0; i < indices.size(); ++i) {
+        auto const& data = blocks.get(indices[i]).value();
+        VERIFY(data.size() == Block::SIZE);
+
+        auto frame = buffer.bytes().slice(i * FRAME_SIZE, FRAME_SIZE);
+        write_u32(frame, FRAME_BLOCK_INDEX_OFFSET, indices[i]);
+        write_u32(frame, FRAME_COMMIT_SIZE_OFFSET, i == indices.size() - 1 ? static_cast<u32>(indices.size()) : 0);
+        write_u32(frame, FRAME_SALT_OFFSET, m_salt);
+        data.bytes().copy_to(frame.slice(FRAME_HEADER_SIZE));
+        write_u32(frame, FRAME_CHECKSUM_OFFSET, frame_checksum(frame));
+    }
+
+    TRY(m_file->seek(m_end_offset, SeekMode::SetPosition));
+    TRY(m_file->write_until_depleted(buffer));
+
+    for (size_t i = 0; i < indices.size(); ++i)
+        TRY(m_frame_offsets.try_set(indices[i], m_end_offset + i * FRAME_SIZE));
+
+    m_end_offset += buffer.size();
+    m_frame_count += indices.size();
+    m_needs_sync = true;
+    return {};
+}
+
+ErrorOr<void> WriteAheadLog::sync()
+{
+    if (!m_needs_sync)
+        return {};
+
+    dbgln_if(SQL_DEBUG, "Syncing write-ahead log {}", name());
+    TRY(Core::System::fsync(m_file->fd()));
+    m_needs_sync = false;
+    return {};
+}
+
+ErrorOr<void> WriteAheadLog::reset()
+{
+    auto previous_salt = m_salt;
+    do {
+        m_salt = get_random<u32>();
+    } while (m_salt == previous_salt);
+
+    auto header = TRY(ByteBuffer::create_zeroed(HEADER_SIZE));
+    header.overwrite(0, FILE_ID.characters_without_null_termination(), FILE_ID.length());
+    write_u32(header, VERSION_OFFSET, VERSION);
+    write_u32(header, SALT_OFFSET, m_salt);
+    write_u32(header, HEADER_CHECKSUM_OFFSET, header_checksum(header));
+
+    TRY(m_file->truncate(0));
+    TRY(m_file->seek(0, SeekMode::SetPosition));
+    TRY(m_file->write_until_depleted(header));
+    TRY(Core::System::fsync(m_file->fd()));
+
+    m_end_offset = HEADER_SIZE;
+    m_frame_count = 0;
+    m_needs_sync = false;
+    m_frame_offsets.clear();
+    return {};
+}
+
+ErrorOr<void> WriteAheadLog::remove()
+{
+    return Core::System::unlink(m_name);
+}
+
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/ByteString.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibCore/File.h>
+#include <LibSQL/Heap.h>
+
+namespace SQL {
+
+/**
+ * The WriteAheadLog is an append-only file, stored next to the Heap file, which
+ * committed blocks are written to before they are copied into the Heap file. A
+ * transaction is durable as soon as its frames have been synced to the log. A
+ * checkpoint later copies the latest version of every logged block into the Heap
+ * file, after which the log is reset.
+ *
+ * Every frame holds a single block, and carries the index of that block, the salt
+ * of the log generation it was written in, and a CRC32 checksum over its header
+ * and contents. The last frame of a transaction records the number of frames in
+ * that transaction, marking it as committed. When the log is opened, frames are
+ * read up to the first one that is torn, stale, or fails its checksum; only those
+ * transactions whose commit frame was read are recovered.
+ */
+class WriteAheadLog {
+    AK_MAKE_NONCOPYABLE(WriteAheadLog);
+    AK_MAKE_NONMOVABLE(WriteAheadLog);
+
+public:
+    static constexpr u32 VERSION = 1;
+
+    static ErrorOr<NonnullOwnPtr<WriteAheadLog>> open(ByteString file_name);
+
+    ByteString const& name() const { return m_name; }
+
+    bool is_empty() const { return m_frame_offsets.is_empty(); }
+    size_t frame_count() const { return m_frame_count; }
+    bool needs_sync() const { return m_needs_sync; }
+
+    bool contains(Block::Index index) const { return m_frame_offsets.contains(index); }
+    Vector<Block::Index> block_indices() const;
+
+    ErrorOr<Optional<ByteBuffer>> read_block(Block::Index);
+    ErrorOr<void> append_transaction(Vector<Block::Index> const& indices, HashMap<Block::Index, ByteBuffer> const& blocks);
+    ErrorOr<void> sync();
+
+    // Discards all frames and starts a new generation of the log.
+    ErrorOr<void> reset();
+    ErrorOr<void> remove();
+
+private:
+    WriteAheadLog(ByteString file_name, NonnullOwnPtr<Core::File>);
+
+    ErrorOr<void> recover();
+
+    ByteString m_name;
+    NonnullOwnPtr<Core::File> m_file;
+
+    u32 m_salt { 0 };
+    u64 m_end_offset { 0 };
+    size_t m_frame_count { 0 };
+    bool m_needs_sync { false };
+    HashMap<Block::Index, u64> m_frame_offsets;
+};
+
+}
@@ -9,11 +9,34 @@
 #include <LibWasm/AbstractMachine/BytecodeInterpreter.h>
 #include <LibWasm/AbstractMachine/Configuration.h>
 #include <LibWasm/AbstractMachine/Interpreter.h>
+#include <LibWasm/AbstractMachine/LoweredFunction.h>
 #include <LibWasm/AbstractMachine/Validator.h>
+#include <LibWasm/JIT/Compiler.h>
 #include <LibWasm/Types.h>
 
 namespace Wasm {
 
+WasmFunction::WasmFunction(WasmFunction&&) = default;
+WasmFunction::~WasmFunction() = default;
+
+JIT::NativeExecutable const* WasmFunction::native_executable(Store& store)
+{
+    if (!m_did_try_to_compile) {
+        m_did_try_to_compile = true;
+        m_native_executable = JIT::Compiler::compile(*this, store);
+    }
+    return m_native_executable.ptr();
+}
+
+LoweredFunction const* WasmFunction::lowered_function(Store& store)
+{
+    if (!m_did_try_to_lower) {
+        m_did_try_to_lower = true;
+        m_lowered_function = LoweredFunction::lower(*this, store);
+    }
+    return m_lowered_function.ptr();
+}
+
 Optional<FunctionAddress> Store::allocate(ModuleInstance& instance, Module const& module, CodeSection::Code const& code, TypeIndex type_index)
 {
     FunctionAddress address { m_functions.size() };
@@ -44,7 +67,7 @@ Optional<TableAddress> Store::allocate(TableType const& type)
 Optional<MemoryAddress> Store::allocate(MemoryType const& type)
 {
     MemoryAddress address { m_memories.size() };
-    auto instance = MemoryInstance::create(type);
+    auto instance = MemoryInstance::create(type, m_use_guard_pages);
     if (instance.is_error())
         return {};
 
@@ -365,7 +388,7 @@ InstantiationResult AbstractMachine::instantiate(Module const& module, Vector<Ex
                     };
                 }
                 if (!data.init.is_empty())
-                    instance->data().overwrite(offset, data.init.data(), data.init.size());
+                    instance->bytes().overwrite(offset, data.init.data(), data.init.size());
                 return {};
             },
             [&](DataSection::Data::Passive const& passive) -> Optional<InstantiationError> {
@@ -13,6 +13,7 @@
 #include <AK/Result.h>
 #include <AK/StackInfo.h>
 #include <AK/UFixedBigInt.h>
+#include <LibWasm/AbstractMachine/GuardedMemory.h>
 #include <LibWasm/Types.h>
 
 // NOTE: Special case for Wasm::Result.
@@ -21,8 +22,14 @@
 namespace Wasm {
 
 class Configuration;
+class LoweredFunction;
+class Store;
 struct Interpreter;
 
+namespace JIT {
+class NativeExecutable;
+}
+
 struct InstantiationError {
     ByteString error { "Unknown error" };
 };
@@ -332,16 +339,29 @@ public:
     {
     }
 
+    WasmFunction(WasmFunction&&);
+    ~WasmFunction();
+
     auto& type() const { return m_type; }
     auto& module() const { return m_module_instance; }
     auto& code() const { return m_code; }
     RefPtr<Module const> module_ref() const { return m_module.strong_ref(); }
 
+    // Compiles the function to native code the first time it is called, returns nullptr if it can't be compiled.
+    JIT::NativeExecutable const* native_executable(Store&);
+
+    // Lowers the function to the interpreter's register-based form the first time it is needed, returns nullptr if it can't be lowered.
+    LoweredFunction const* lowered_function(Store&);
+
 private:
     FunctionType m_type;
     WeakPtr<Module const> m_module;
     ModuleInstance const& m_module_instance;
     CodeSection::Code const& m_code;
+    OwnPtr<JIT::NativeExecutable> m_native_executable;
+    bool m_did_try_to_compile { false };
+    OwnPtr<LoweredFunction> m_lowered_function;
+    bool m_did_try_to_lower { false };
 };
 
 class HostFunction {
@@ -404,10 +424,21 @@ private:
 
 class MemoryInstance {
 public:
-    static ErrorOr<MemoryInstance> create(MemoryType const& type)
+    enum class UseGuardPages {
+        No,
+        Yes,
+    };
+
+    static ErrorOr<MemoryInstance> create(MemoryType const& type, UseGuardPages use_guard_pages = UseGuardPages::No)
     {
         MemoryInstance instance { type };
 
+        // Running out of address space or reservations isn't fatal, such memories are just bounds checked as usual.
+        if (use_guard_pages == UseGuardPages::Yes && GuardedMemory::is_supported()) {
+            if (auto guarded_memory = GuardedMemory::create(); !guarded_memory.is_error())
+                instance.m_guarded_memory = guarded_memory.release_value();
+        }
+
         if (!instance.grow(type.limits().min() * Constants::page_size, GrowType::No))
             return Error::from_string_literal("Failed to grow to requested size");
 
@@ -416,8 +447,16 @@ public:
 
     auto& type() const { return m_type; }
     auto size() const { return m_size; }
-    auto& data() const { return m_data; }
-    auto& data() { return m_data; }
+
+    // Accesses to guarded memories don't have to be bounds checked, see GuardedMemory.
+    bool is_guarded() const { return m_guarded_memory; }
+
+    Bytes bytes() { return m_guarded_memory ? m_guarded_memory->bytes() : m_data.bytes(); }
+    ReadonlyBytes bytes() const { return m_guarded_memory ? m_guarded_memory->bytes() : m_data.bytes(); }
+
+    // The ByteBuffer backing this memory, or null for guarded memories, which don't have one. Use bytes() to access the
+    // contents of any memory.
+    ByteBuffer* byte_buffer() { return m_guarded_memory ? nullptr : &m_data; }
 
     enum class InhibitGrowCallback {
         No,
@@ -433,7 +472,7 @@ public:
     {
         if (size_to_grow == 0)
             return true;
-        u64 new_size = m_data.size() + size_to_grow;
+        u64 new_size = m_size + size_to_grow;
         // Can't grow past 2^16 pages.
         if (new_size >= Constants::page_size * 65536)
             return false;
@@ -441,12 +480,19 @@ public:
             if (max.value() * Constants::page_size < new_size)
                 return false;
         }
-        auto previous_size = m_size;
-        if (m_data.try_resize(new_size).is_error())
-            return false;
-        m_size = new_size;
-        // The spec requires that we zero out everything on grow
-        __builtin_memset(m_data.offset_pointer(previous_size), 0, size_to_grow);
+        if (m_guarded_memory) {
+            // Guarded memories grow in place, and the newly accessible pages have never been touched, so they're already zero.
+            if (m_guarded_memory->grow_to(new_size).is_error())
+                return false;
+            m_size = new_size;
+        } else {
+            auto previous_size = m_size;
+            if (m_data.try_resize(new_size).is_error())
+                return false;
+            m_size = new_size;
+            // The spec requires that we zero out everything on grow
+            __builtin_memset(m_data.offset_pointer(previous_size), 0, size_to_grow);
+        }
 
         // NOTE: This exists because wasm-js-api wants to execute code after a successful grow,
         //       See [this issue](https://github.com/WebAssembly/spec/issues/1635) for more details.
@@ -475,6 +521,7 @@ private:
     MemoryType m_type;
     size_t m_size { 0 };
     ByteBuffer m_data;
+    OwnPtr<GuardedMemory> m_guarded_memory;
 };
 
 class GlobalInstance {
@@ -553,6 +600,8 @@ public:
     DataInstance* get(DataAddress);
     ElementInstance* get(ElementAddress);
 
+    void set_use_guard_pages(MemoryInstance::UseGuardPages use_guard_pages) { m_use_guard_pages = use_guard_pages; }
+
 private:
     Vector<FunctionInstance> m_functions;
     Vector<TableInstance> m_tables;
@@ -560,6 +609,7 @@ private:
     Vector<GlobalInstance> m_globals;
     Vector<ElementInstance> m_elements;
     Vector<DataInstance> m_datas;
+    MemoryInstance::UseGuardPages m_use_guard_pages { MemoryInstance::UseGuardPages::No };
 };
 
 class Label {
@@ -583,11 +633,12 @@ private:
 
 class Frame {
 public:
-    explicit Frame(ModuleInstance const& module, Vector<Value> locals, Expression const& expression, size_t arity)
+    explicit Frame(ModuleInstance const& module, Vector<Value> locals, Expression const& expression, size_t arity, Optional<FunctionAddress> function = {})
         : m_module(module)
         , m_locals(move(locals))
         , m_expression(expression)
         , m_arity(arity)
+        , m_function(function)
     {
     }
 
@@ -598,6 +649,8 @@ public:
     auto arity() const { return m_arity; }
     auto label_index() const { return m_label_index; }
     auto& label_index() { return m_label_index; }
+    // The function whose body is being executed, if any.
+    auto function() const { return m_function; }
 
 private:
     ModuleInstance const& m_module;
@@ -605,6 +658,7 @@ private:
     Expression const& m_expression;
     size_t m_arity { 0 };
     size_t m_label_index { 0 };
+    Optional<FunctionAddress> m_function;
 };
 
 using InstantiationResult = AK::ErrorOr<NonnullOwnPtr<ModuleInstance>, InstantiationError>;
@@ -624,6 +678,7 @@ public:
     auto& store() { return m_store; }
 
     void enable_instruction_count_limit() { m_should_limit_instruction_count = true; }
+    void enable_guarded_memories() { m_store.set_use_guard_pages(MemoryInstance::UseGuardPages::Yes); }
 
 private:
     Optional<InstantiationError> allocate_all_initial_phase(Module const&, ModuleInstance&, Vector<ExternValue>&, Vector<Value>& global_values, Vector<FunctionAddress>& own_functions);
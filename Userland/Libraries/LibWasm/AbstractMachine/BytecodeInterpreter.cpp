@@ -33,6 +33,13 @@ namespace Wasm {
 void BytecodeInterpreter::interpret(Configuration& configuration)
 {
     m_trap = Empty {};
+    if (configuration.ip() == 0) {
+        if (m_jit_enabled && try_run_native_code(configuration))
+            return;
+        if (m_lowering_enabled && try_run_lowered_function(configuration))
+            return;
+    }
+
     auto& instructions = configuration.frame().expression().instructions();
     auto max_ip_value = InstructionPointer { instructions.size() };
     auto& current_ip_value = configuration.ip();
@@ -56,6 +63,295 @@ void BytecodeInterpreter::interpret(Configuration& configuration)
     }
 }
 
+WasmFunction* BytecodeInterpreter::current_wasm_function(Configuration& configuration)
+{
+    auto function_address = configuration.frame().function();
+    if (!function_address.has_value())
+        return nullptr;
+    return configuration.store().get(*function_address)->get_pointer<WasmFunction>();
+}
+
+bool BytecodeInterpreter::try_run_native_code(Configuration& configuration)
+{
+    auto* function = current_wasm_function(configuration);
+    if (!function)
+        return false;
+    auto const* executable = function->native_executable(configuration.store());
+    if (!executable)
+        return false;
+
+    // The value stack of the function directly follows its locals.
+    auto& frame = configuration.frame();
+    frame.locals().resize(executable->local_count() + executable->max_stack_height());
+
+    JIT::NativeCallContext context;
+    context.interpreter = this;
+    context.configuration = &configuration;
+    if (!frame.module().memories().is_empty())
+        context.memory_address = frame.module().memories().first();
+    context.update_memory();
+    if (configuration.should_limit_instruction_count())
+        context.remaining_loop_iterations = Constants::max_allowed_executed_instructions_per_call;
+
+    auto trap_code = executable->run(frame.locals().data(), context);
+    if (trap_code != JIT::TrapCode::None) {
+        // Traps raised by the interpreter on behalf of native code have already been recorded.
+        if (trap_code != JIT::TrapCode::Interpreter)
+            m_trap = Trap { JIT::trap_code_reason(trap_code) };
+        return true;
+    }
+
+    // Calls made by native code may have moved the frame.
+    auto& locals = configuration.frame().locals();
+    auto arity = configuration.frame().arity();
+    configuration.value_stack().ensure_capacity(configuration.value_stack().size() + arity);
+    for (size_t i = 0; i < arity; ++i)
+        configuration.value_stack().unchecked_append(locals[executable->local_count() + i]);
+    return true;
+}
+
+bool BytecodeInterpreter::try_run_lowered_function(Configuration& configuration)
+{
+    auto* function = current_wasm_function(configuration);
+    if (!function)
+        return false;
+    auto const* lowered_function = function->lowered_function(configuration.store());
+    if (!lowered_function)
+        return false;
+
+    auto& frame = configuration.frame();
+    frame.locals().resize(lowered_function->slot_count());
+    lowered_function->initialize_constants(frame.locals().span());
+
+    run_lowered_function(configuration, *lowered_function);
+    if (did_trap())
+        return true;
+
+    auto& locals = configuration.frame().locals();
+    auto arity = configuration.frame().arity();
+    configuration.value_stack().ensure_capacity(configuration.value_stack().size() + arity);
+    for (size_t i = 0; i < arity; ++i)
+        configuration.value_stack().unchecked_append(locals[lowered_function->stack_base() + i]);
+    return true;
+}
+
+template<typename T>
+ALWAYS_INLINE static T read_little_endian(u8 const* data)
+{
+    if constexpr (IsFloatingPoint<T>) {
+        return bit_cast<T>(read_little_endian<Conditional<sizeof(T) == sizeof(u32), u32, u64>>(data));
+    } else {
+        T value;
+        memcpy(&value, data, sizeof(T));
+        return AK::convert_between_host_and_little_endian(value);
+    }
+}
+
+template<typename T>
+ALWAYS_INLINE static void write_little_endian(u8* data, T value)
+{
+    if constexpr (IsFloatingPoint<T>) {
+        write_little_endian(data, bit_cast<Conditional<sizeof(T) == sizeof(u32), u32, u64>>(value));
+    } else {
+        auto raw_value = AK::convert_between_host_and_little_endian(value);
+        memcpy(data, &raw_value, sizeof(T));
+    }
+}
+
+template<typename PopType, typename PushType, typename Operator>
+ALWAYS_INLINE bool BytecodeInterpreter::lowered_unary_operation(Value* slots, LoweredInstruction const& instruction)
+{
+    auto call_result = Operator {}(slots[instruction.lhs].to<PopType>());
+    PushType result;
+    if constexpr (IsSpecializationOf<decltype(call_result), AK::ErrorOr>) {
+        if (call_result.is_error()) {
+            trap_if_not(false, call_result.error());
+            return false;
+        }
+        result = call_result.release_value();
+    } else {
+        result = call_result;
+    }
+    slots[instruction.result] = Value(result);
+    return true;
+}
+
+template<typename PopType, typename PushType, typename Operator>
+ALWAYS_INLINE bool BytecodeInterpreter::lowered_binary_operation(Value* slots, LoweredInstruction const& instruction)
+{
+    auto call_result = Operator {}(slots[instruction.lhs].to<PopType>(), slots[instruction.rhs].to<PopType>());
+    PushType result;
+    if constexpr (IsSpecializationOf<decltype(call_result), AK::ErrorOr>) {
+        if (call_result.is_error()) {
+            trap_if_not(false, call_result.error());
+            return false;
+        }
+        result = call_result.release_value();
+    } else {
+        result = call_result;
+    }
+    slots[instruction.result] = Value(result);
+    return true;
+}
+
+template<typename ReadType, typename PushType, bool IsGuarded>
+ALWAYS_INLINE bool BytecodeInterpreter::lowered_load(Configuration& configuration, Value* slots, LoweredInstruction const& instruction)
+{
+    auto* memory = configuration.store().get(MemoryAddress { instruction.rhs });
+    u64 address = static_cast<u64>(slots[instruction.lhs].to<u32>()) + instruction.argument;
+    if (!IsGuarded && address + sizeof(ReadType) > memory->size()) {
+        m_trap = Trap { "Memory access out of bounds" };
+        dbgln_if(WASM_TRACE_DEBUG, "LibWasm: Memory access out of bounds (expected {} to be less than or equal to {})", address + sizeof(ReadType), memory->size());
+        return false;
+    }
+    slots[instruction.result] = Value(static_cast<PushType>(read_little_endian<ReadType>(memory->bytes().data() + address)));
+    return true;
+}
+
+template<typename PopType, typename StoreType, bool IsGuarded>
+ALWAYS_INLINE bool BytecodeInterpreter::lowered_store(Configuration& configuration, Value* slots, LoweredInstruction const& instruction)
+{
+    auto* memory = configuration.store().get(MemoryAddress { instruction.result });
+    u64 address = static_cast<u64>(slots[instruction.lhs].to<u32>()) + instruction.argument;
+    if (!IsGuarded && address + sizeof(StoreType) > memory->size()) {
+        m_trap = Trap { "Memory access out of bounds" };
+        dbgln_if(WASM_TRACE_DEBUG, "LibWasm: Memory access out of bounds (expected {} to be less than or equal to {})", address + sizeof(StoreType), memory->size());
+        return false;
+    }
+    write_little_endian(memory->bytes().data() + address, static_cast<StoreType>(slots[instruction.rhs].to<PopType>()));
+    return true;
+}
+
+void BytecodeInterpreter::run_lowered_function(Configuration& configuration, LoweredFunction const& function)
+{
+    if (!function.accesses_guarded_memory()) {
+        execute_lowered_instructions(configuration, function);
+        return;
+    }
+
+    // Guarded loads and stores fault instead of being checked, see GuardedMemory.
+    if (!GuardedMemory::run_catching_faults([&] { execute_lowered_instructions(configuration, function); }))
+        m_trap = Trap { "Memory access out of bounds" };
+}
+
+void BytecodeInterpreter::execute_lowered_instructions(Configuration& configuration, LoweredFunction const& function)
+{
+    auto const& instructions = function.instructions();
+    auto* slots = configuration.frame().locals().data();
+
+    // Every backward jump is a loop iteration, and limiting those is enough to stop any infinite loop.
+    u64 remaining_loop_iterations = NumericLimits<u64>::max();
+    if (configuration.should_limit_instruction_count())
+        remaining_loop_iterations = Constants::max_allowed_executed_instructions_per_call;
+
+    size_t ip = 0;
+    auto jump_to = [&](size_t target) {
+        if (target <= ip && --remaining_loop_iterations == 0) [[unlikely]] {
+            m_trap = Trap { "Exceeded maximum allowed number of instructions" };
+            return false;
+        }
+        ip = target;
+        return true;
+    };
+
+    while (ip < instructions.size()) {
+        auto const& instruction = instructions[ip];
+        switch (instruction.opcode) {
+        case LoweredOpCode::unreachable:
+            m_trap = Trap { "Unreachable" };
+            return;
+        case LoweredOpCode::move:
+            slots[instruction.result] = slots[instruction.lhs];
+            break;
+        case LoweredOpCode::select:
+            slots[instruction.result] = slots[instruction.argument].to<i32>() != 0 ? slots[instruction.lhs] : slots[instruction.rhs];
+            break;
+        case LoweredOpCode::jump:
+            if (!jump_to(instruction.argument))
+                return;
+            continue;
+        case LoweredOpCode::jump_if_zero:
+            if (slots[instruction.lhs].to<i32>() != 0)
+                break;
+            if (!jump_to(instruction.argument))
+                return;
+            continue;
+        case LoweredOpCode::jump_if_not_zero:
+            if (slots[instruction.lhs].to<i32>() == 0)
+                break;
+            if (!jump_to(instruction.argument))
+                return;
+            continue;
+        case LoweredOpCode::branch_table: {
+            auto index = min(slots[instruction.lhs].to<u32>(), instruction.rhs);
+            if (!jump_to(function.branch_table(instruction.argument)[index]))
+                return;
+            continue;
+        }
+        // NOTE: Anything that leaves the lowered code runs without faults being caught, see GuardedMemory.
+        case LoweredOpCode::call:
+            GuardedMemory::run_without_catching_faults([&] {
+                call_address(configuration, FunctionAddress { instruction.argument }, slots + instruction.lhs);
+            });
+            if (did_trap())
+                return;
+            slots = configuration.frame().locals().data();
+            break;
+        case LoweredOpCode::call_indirect:
+            GuardedMemory::run_without_catching_faults([&] {
+                call_table_element(configuration, TableAddress { instruction.result }, *bit_cast<FunctionType const*>(static_cast<FlatPtr>(instruction.argument)), slots + instruction.lhs);
+            });
+            if (did_trap())
+                return;
+            slots = configuration.frame().locals().data();
+            break;
+        case LoweredOpCode::interpret:
+            GuardedMemory::run_without_catching_faults([&] {
+                interpret_instruction_on_slots(configuration, *bit_cast<Instruction const*>(static_cast<FlatPtr>(instruction.argument)), slots + instruction.lhs, instruction.rhs, instruction.result);
+            });
+            if (did_trap())
+                return;
+            slots = configuration.frame().locals().data();
+            break;
+#define __ENUMERATE_LOWERED_OPERATION(name, PopType, PushType, Operator)                       \
+    case LoweredOpCode::name:                                                                    \
+        if (!lowered_unary_operation<PopType, PushType, Operator>(slots, instruction)) [[unlikely]] \
+            return;                                                                              \
+        break;
+            ENUMERATE_LOWERED_UNARY_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+#undef __ENUMERATE_LOWERED_OPERATION
+#define __ENUMERATE_LOWERED_OPERATION(name, PopType, PushType, Operator)                        \
+    case LoweredOpCode::name:                                                                     \
+        if (!lowered_binary_operation<PopType, PushType, Operator>(slots, instruction)) [[unlikely]] \
+            return;                                                                               \
+        break;
+            ENUMERATE_LOWERED_BINARY_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+#undef __ENUMERATE_LOWERED_OPERATION
+#define __ENUMERATE_LOWERED_OPERATION(name, ReadType, PushType)                                          \
+    case LoweredOpCode::name:                                                                            \
+        if (!lowered_load<ReadType, PushType, false>(configuration, slots, instruction)) [[unlikely]]    \
+            return;                                                                                      \
+        break;                                                                                           \
+    case LoweredOpCode::guarded_##name:                                                                  \
+        lowered_load<ReadType, PushType, true>(configuration, slots, instruction);                       \
+        break;
+            ENUMERATE_LOWERED_LOAD_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+#undef __ENUMERATE_LOWERED_OPERATION
+#define __ENUMERATE_LOWERED_OPERATION(name, PopType, StoreType)                                         \
+    case LoweredOpCode::name:                                                                           \
+        if (!lowered_store<PopType, StoreType, false>(configuration, slots, instruction)) [[unlikely]]  \
+            return;                                                                                     \
+        break;                                                                                          \
+    case LoweredOpCode::guarded_##name:                                                                 \
+        lowered_store<PopType, StoreType, true>(configuration, slots, instruction);                     \
+        break;
+            ENUMERATE_LOWERED_STORE_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+#undef __ENUMERATE_LOWERED_OPERATION
+        }
+        ++ip;
+    }
+}
+
 void BytecodeInterpreter::branch_to_label(Configuration& configuration, LabelIndex index)
 {
     dbgln_if(WASM_TRACE_DEBUG, "Branch to label with index {}...", index.value());
@@ -83,7 +379,7 @@ void BytecodeInterpreter::load_and_push(Configuration& configuration, Instructio
         return;
     }
     dbgln_if(WASM_TRACE_DEBUG, "load({} : {}) -> stack", instance_address, sizeof(ReadType));
-    auto slice = memory->data().bytes().slice(instance_address, sizeof(ReadType));
+    auto slice = memory->bytes().slice(instance_address, sizeof(ReadType));
     entry = Value(static_cast<PushType>(read_value<ReadType>(slice)));
 }
 
@@ -108,7 +404,7 @@ void BytecodeInterpreter::load_and_push_mxn(Configuration& configuration, Instru
         return;
     }
     dbgln_if(WASM_TRACE_DEBUG, "vec-load({} : {}) -> stack", instance_address, M * N / 8);
-    auto slice = memory->data().bytes().slice(instance_address, M * N / 8);
+    auto slice = memory->bytes().slice(instance_address, M * N / 8);
     using V64 = NativeVectorType<M, N, SetSign>;
     using V128 = NativeVectorType<M * 2, N, SetSign>;
 
@@ -134,7 +430,7 @@ void BytecodeInterpreter::load_and_push_lane_n(Configuration& configuration, Ins
         m_trap = Trap { "Memory access out of bounds" };
         return;
     }
-    auto slice = memory->data().bytes().slice(instance_address, N / 8);
+    auto slice = memory->bytes().slice(instance_address, N / 8);
     auto dst = bit_cast<u8*>(&vector) + memarg_and_lane.lane * N / 8;
     memcpy(dst, slice.data(), N / 8);
     configuration.value_stack().append(Value(vector));
@@ -152,7 +448,7 @@ void BytecodeInterpreter::load_and_push_zero_n(Configuration& configuration, Ins
         m_trap = Trap { "Memory access out of bounds" };
         return;
     }
-    auto slice = memory->data().bytes().slice(instance_address, N / 8);
+    auto slice = memory->bytes().slice(instance_address, N / 8);
     u128 vector = 0;
     memcpy(&vector, slice.data(), N / 8);
     configuration.value_stack().append(Value(vector));
@@ -173,7 +469,7 @@ void BytecodeInterpreter::load_and_push_m_splat(Configuration& configuration, In
         return;
     }
     dbgln_if(WASM_TRACE_DEBUG, "vec-splat({} : {}) -> stack", instance_address, M / 8);
-    auto slice = memory->data().bytes().slice(instance_address, M / 8);
+    auto slice = memory->bytes().slice(instance_address, M / 8);
     auto value = read_value<NativeIntegralType<M>>(slice);
     set_top_m_splat<M, NativeIntegralType>(configuration, value);
 }
@@ -261,6 +557,71 @@ void BytecodeInterpreter::call_address(Configuration& configuration, FunctionAdd
         configuration.value_stack().unchecked_append(entry);
 }
 
+void BytecodeInterpreter::call_address(Configuration& configuration, FunctionAddress address, Value* arguments)
+{
+    TRAP_IF_NOT(m_stack_info.size_free() >= Constants::minimum_stack_space_to_keep_free);
+
+    auto instance = configuration.store().get(address);
+    FunctionType const* type { nullptr };
+    instance->visit([&](auto const& function) { type = &function.type(); });
+    Vector<Value> args;
+    args.ensure_capacity(type->parameters().size());
+    for (size_t i = 0; i < type->parameters().size(); ++i)
+        args.unchecked_append(arguments[i]);
+
+    Result result { Trap { ""sv } };
+    if (instance->has<WasmFunction>()) {
+        CallFrameHandle handle { *this, configuration };
+        result = configuration.call(*this, address, move(args));
+    } else {
+        result = configuration.call(*this, address, move(args));
+    }
+
+    if (result.is_trap()) {
+        m_trap = move(result.trap());
+        return;
+    }
+
+    if (result.is_completion()) {
+        m_trap = move(result.completion());
+        return;
+    }
+
+    // The results are returned in reverse order, see Configuration::execute().
+    auto& values = result.values();
+    for (size_t i = 0; i < values.size(); ++i)
+        arguments[i] = values[values.size() - i - 1];
+}
+
+void BytecodeInterpreter::call_table_element(Configuration& configuration, TableAddress table_address, FunctionType const& expected_type, Value* arguments)
+{
+    auto* table_instance = configuration.store().get(table_address);
+    auto index = arguments[expected_type.parameters().size()].to<i32>();
+    if (index < 0 || static_cast<size_t>(index) >= table_instance->elements().size()) {
+        m_trap = Trap { "Indirect call out of the bounds of the table" };
+        return;
+    }
+
+    auto const& element = table_instance->elements()[index];
+    if (!element.ref().has<Reference::Func>()) {
+        m_trap = Trap { "Indirect call to a null reference" };
+        return;
+    }
+
+    auto address = element.ref().get<Reference::Func>().address;
+    FunctionType const* type { nullptr };
+    configuration.store().get(address)->visit([&](auto const& function) { type = &function.type(); });
+
+    // The caller relies on the number of results, so unlike call_indirect in the interpreter, this has to check the callee's type.
+    if (type->parameters() != expected_type.parameters() || type->results() != expected_type.results()) {
+        m_trap = Trap { "Indirect call to a function of a different type" };
+        return;
+    }
+
+    dbgln_if(WASM_TRACE_DEBUG, "call_indirect({} -> {})", index, address.value());
+    call_address(configuration, address, arguments);
+}
+
 template<typename PopTypeLHS, typename PushType, typename Operator, typename PopTypeRHS, typename... Args>
 void BytecodeInterpreter::binary_numeric_operation(Configuration& configuration, Args&&... args)
 {
@@ -366,7 +727,7 @@ void BytecodeInterpreter::store_to_memory(Configuration& configuration, Instruct
         return;
     }
     dbgln_if(WASM_TRACE_DEBUG, "temporary({}b) -> store({})", data.size(), instance_address);
-    data.copy_to(memory->data().bytes().slice(instance_address, data.size()));
+    data.copy_to(memory->bytes().slice(instance_address, data.size()));
 }
 
 template<typename T>
@@ -652,7 +1013,7 @@ ALWAYS_INLINE void BytecodeInterpreter::interpret_instruction(Configuration& con
         u8 value = static_cast<u8>(configuration.value_stack().take_last().to<u32>());
         auto destination_offset = configuration.value_stack().take_last().to<u32>();
 
-        TRAP_IF_NOT(static_cast<size_t>(destination_offset + count) <= instance->data().size());
+        TRAP_IF_NOT(static_cast<size_t>(destination_offset + count) <= instance->size());
 
         if (count == 0)
             return;
@@ -678,8 +1039,8 @@ ALWAYS_INLINE void BytecodeInterpreter::interpret_instruction(Configuration& con
         source_position.saturating_add(count);
         Checked<size_t> destination_position = destination_offset;
         destination_position.saturating_add(count);
-        TRAP_IF_NOT(source_position <= source_instance->data().size());
-        TRAP_IF_NOT(destination_position <= destination_instance->data().size());
+        TRAP_IF_NOT(source_position <= source_instance->size());
+        TRAP_IF_NOT(destination_position <= destination_instance->size());
 
         if (count == 0)
             return;
@@ -687,12 +1048,12 @@ ALWAYS_INLINE void BytecodeInterpreter::interpret_instruction(Configuration& con
         Instruction::MemoryArgument memarg { 0, 0, args.dst_index };
         if (destination_offset <= source_offset) {
             for (auto i = 0; i < count; ++i) {
-                auto value = source_instance->data()[source_offset + i];
+                auto value = source_instance->bytes()[source_offset + i];
                 store_to_memory(configuration, memarg, { &value, sizeof(value) }, destination_offset + i);
             }
         } else {
             for (auto i = count - 1; i >= 0; --i) {
-                auto value = source_instance->data()[source_offset + i];
+                auto value = source_instance->bytes()[source_offset + i];
                 store_to_memory(configuration, memarg, { &value, sizeof(value) }, destination_offset + i);
             }
         }
@@ -715,7 +1076,7 @@ ALWAYS_INLINE void BytecodeInterpreter::interpret_instruction(Configuration& con
         Checked<size_t> destination_position = destination_offset;
         destination_position.saturating_add(count);
         TRAP_IF_NOT(source_position <= data.data().size());
-        TRAP_IF_NOT(destination_position <= memory->data().size());
+        TRAP_IF_NOT(destination_position <= memory->size());
 
         if (count == 0)
             return;
@@ -1654,6 +2015,21 @@ ALWAYS_INLINE void BytecodeInterpreter::interpret_instruction(Configuration& con
     }
 }
 
+void BytecodeInterpreter::interpret_instruction_on_slots(Configuration& configuration, Instruction const& instruction, Value* operands, size_t pop_count, size_t push_count)
+{
+    auto& value_stack = configuration.value_stack();
+    for (size_t i = 0; i < pop_count; ++i)
+        value_stack.append(operands[i]);
+
+    auto ip = configuration.ip();
+    interpret_instruction(configuration, ip, instruction);
+    if (did_trap())
+        return;
+
+    for (size_t i = push_count; i > 0; --i)
+        operands[i - 1] = value_stack.take_last();
+}
+
 void DebuggerBytecodeInterpreter::interpret_instruction(Configuration& configuration, InstructionPointer& ip, Instruction const& instruction)
 {
     if (pre_interpret_hook) {
@@ -9,6 +9,8 @@
 #include <AK/StackInfo.h>
 #include <LibWasm/AbstractMachine/Configuration.h>
 #include <LibWasm/AbstractMachine/Interpreter.h>
+#include <LibWasm/AbstractMachine/LoweredFunction.h>
+#include <LibWasm/JIT/Compiler.h>
 
 namespace Wasm {
 
@@ -31,6 +33,11 @@ struct BytecodeInterpreter : public Interpreter {
     }
     virtual void clear_trap() final { m_trap = Empty {}; }
 
+    bool is_jit_enabled() const { return m_jit_enabled; }
+    void set_jit_enabled(bool enabled) { m_jit_enabled = enabled; }
+    bool is_lowering_enabled() const { return m_lowering_enabled; }
+    void set_lowering_enabled(bool enabled) { m_lowering_enabled = enabled; }
+
     struct CallFrameHandle {
         explicit CallFrameHandle(BytecodeInterpreter& interpreter, Configuration& configuration)
             : m_configuration_handle(configuration)
@@ -45,7 +52,17 @@ struct BytecodeInterpreter : public Interpreter {
     };
 
 protected:
+    friend struct JIT::Runtime;
+
     void interpret_instruction(Configuration&, InstructionPointer&, Instruction const&);
+    // Interprets a single instruction which neither branches nor calls, taking its operands from and writing its
+    // results to the given slots.
+    void interpret_instruction_on_slots(Configuration&, Instruction const&, Value* operands, size_t pop_count, size_t push_count);
+    WasmFunction* current_wasm_function(Configuration&);
+    bool try_run_native_code(Configuration&);
+    bool try_run_lowered_function(Configuration&);
+    void run_lowered_function(Configuration&, LoweredFunction const&);
+    void execute_lowered_instructions(Configuration&, LoweredFunction const&);
     void branch_to_label(Configuration&, LabelIndex);
     template<typename ReadT, typename PushT>
     void load_and_push(Configuration&, Instruction const&);
@@ -69,6 +86,9 @@ protected:
     VectorType pop_vector(Configuration&);
     void store_to_memory(Configuration&, Instruction::MemoryArgument const&, ReadonlyBytes data, u32 base);
     void call_address(Configuration&, FunctionAddress);
+    // Like call_address(), but takes the arguments from, and writes the results back to, the given slots.
+    void call_address(Configuration&, FunctionAddress, Value* arguments);
+    void call_table_element(Configuration&, TableAddress, FunctionType const& expected_type, Value* arguments);
 
     template<typename PopTypeLHS, typename PushType, typename Operator, typename PopTypeRHS = PopTypeLHS, typename... Args>
     void binary_numeric_operation(Configuration&, Args&&...);
@@ -79,6 +99,15 @@ protected:
     template<typename T>
     T read_value(ReadonlyBytes data);
 
+    template<typename PopType, typename PushType, typename Operator>
+    bool lowered_unary_operation(Value* slots, LoweredInstruction const&);
+    template<typename PopType, typename PushType, typename Operator>
+    bool lowered_binary_operation(Value* slots, LoweredInstruction const&);
+    template<typename ReadType, typename PushType, bool IsGuarded>
+    bool lowered_load(Configuration&, Value* slots, LoweredInstruction const&);
+    template<typename PopType, typename StoreType, bool IsGuarded>
+    bool lowered_store(Configuration&, Value* slots, LoweredInstruction const&);
+
     ALWAYS_INLINE bool trap_if_not(bool value, StringView reason)
     {
         if (!value)
@@ -88,6 +117,8 @@ protected:
 
     Variant<Trap, JS::Completion, Empty> m_trap;
     StackInfo const& m_stack_info;
+    bool m_jit_enabled { JIT::Compiler::is_enabled_by_default() };
+    bool m_lowering_enabled { true };
 };
 
 struct DebuggerBytecodeInterpreter : public BytecodeInterpreter {
@@ -36,6 +36,7 @@ Result Configuration::call(Interpreter& interpreter, FunctionAddress address, Ve
             move(locals),
             wasm_function->code().func().body(),
             wasm_function->type().results().size(),
+            address,
         });
         m_ip = 0;
         return execute(interpreter);
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/Platform.h>
+#include <LibCore/System.h>
+#include <LibWasm/AbstractMachine/GuardedMemory.h>
+#include <signal.h>
+#include <sys/mman.h>
+
+namespace Wasm {
+
+// The signal handler has to find out whether a fault is in a guard region without taking locks, so the live
+// reservations are kept in a fixed number of slots. Memories that don't get one are bounds checked instead.
+static constexpr size_t max_reservation_count = 128;
+static Atomic<FlatPtr> s_reservations[max_reservation_count];
+
+thread_local GuardedMemory::FaultScope* GuardedMemory::s_current_fault_scope { nullptr };
+
+static struct sigaction s_previous_segv_action;
+static struct sigaction s_previous_bus_action;
+
+static bool is_in_guard_region(FlatPtr address)
+{
+    for (auto& reservation : s_reservations) {
+        auto base = reservation.load(AK::MemoryOrder::memory_order_acquire);
+        if (base != 0 && address >= base && address - base < GuardedMemory::reservation_size)
+            return true;
+    }
+    return false;
+}
+
+void handle_fault(int signal, siginfo_t* info, void* context)
+{
+    auto* scope = GuardedMemory::s_current_fault_scope;
+    if (scope && is_in_guard_region(bit_cast<FlatPtr>(info->si_addr)))
+        siglongjmp(scope->jump_buffer, 1);
+
+    // Not ours, let whoever was there before deal with it. Returning with the default action in place re-raises the fault.
+    auto const& previous_action = signal == SIGBUS ? s_previous_bus_action : s_previous_segv_action;
+    if (previous_action.sa_flags & SA_SIGINFO) {
+        previous_action.sa_sigaction(signal, info, context);
+        return;
+    }
+    if (previous_action.sa_handler == SIG_DFL || previous_action.sa_handler == SIG_IGN) {
+        ::signal(signal, SIG_DFL);
+        return;
+    }
+    previous_action.sa_handler(signal);
+}
+
+static ErrorOr<void> install_fault_handler()
+{
+    struct sigaction action {};
+    action.sa_sigaction = handle_fault;
+    // The handler jumps out instead of returning, so it must not leave the signal blocked.
+    action.sa_flags = SA_SIGINFO | SA_NODEFER | SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+    TRY(Core::System::sigaction(SIGSEGV, &action, &s_previous_segv_action));
+    TRY(Core::System::sigaction(SIGBUS, &action, &s_previous_bus_action));
+    return {};
+}
+
+bool GuardedMemory::is_supported()
+{
+#ifdef AK_ARCH_64_BIT
+    return true;
+#else
+    return false;
+#endif
+}
+
+ErrorOr<NonnullOwnPtr<GuardedMemory>> GuardedMemory::create()
+{
+    if (!is_supported())
+        return Error::from_string_literal("Guarded memories need a 64-bit address space");
+
+    static bool const did_install_fault_handler = !install_fault_handler().is_error();
+    if (!did_install_fault_handler)
+        return Error::from_string_literal("Failed to install the fault handler");
+
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_NORESERVE
+    flags |= MAP_NORESERVE;
+#endif
+    auto* base = static_cast<u8*>(TRY(Core::System::mmap(nullptr, reservation_size, PROT_NONE, flags, -1, 0, 0, "Wasm guarded memory"sv)));
+
+    for (size_t slot = 0; slot < max_reservation_count; ++slot) {
+        FlatPtr expected = 0;
+        if (s_reservations[slot].compare_exchange_strong(expected, bit_cast<FlatPtr>(base), AK::MemoryOrder::memory_order_acq_rel))
+            return adopt_nonnull_own_or_enomem(new (nothrow) GuardedMemory(base, slot));
+    }
+
+    MUST(Core::System::munmap(base, reservation_size));
+    return Error::from_string_literal("Too many guarded memories");
+}
+
+GuardedMemory::~GuardedMemory()
+{
+    s_reservations[m_slot].store(0, AK::MemoryOrder::memory_order_release);
+    MUST(Core::System::munmap(m_base, reservation_size));
+}
+
+ErrorOr<void> GuardedMemory::grow_to(size_t new_size)
+{
+    VERIFY(new_size >= m_size);
+    if (new_size > NumericLimits<u32>::max() + 1ull)
+        return Error::from_errno(ENOMEM);
+    if (new_size == m_size)
+        return {};
+
+    // Memories grow in whole Wasm pages, which are also whole host pages.
+    if (::mprotect(m_base + m_size, new_size - m_size, PROT_READ | PROT_WRITE) < 0)
+        return Error::from_syscall("mprotect"sv, -errno);
+    m_size = new_size;
+    return {};
+}
+
+GuardedMemory::FaultScope::FaultScope()
+    : previous(s_current_fault_scope)
+{
+    s_current_fault_scope = this;
+}
+
+GuardedMemory::FaultScope::~FaultScope()
+{
+    s_current_fault_scope = previous;
+}
+
+}
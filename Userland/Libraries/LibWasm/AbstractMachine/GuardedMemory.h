@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Platform.h>
+#include <AK/Span.h>
+#include <AK/TemporaryChange.h>
+#include <AK/Types.h>
+#include <setjmp.h>
+#include <signal.h>
+
+namespace Wasm {
+
+// The backing store of a 32-bit linear memory that doesn't need to be bounds checked.
+//
+// Every address a load or store can compute is a 32-bit index plus a 32-bit offset, so reserving 8GiB of address
+// space up front makes every access land inside of the reservation. Only the first size() bytes are accessible,
+// the rest is an inaccessible guard region, which turns out of bounds accesses into faults. Growing the memory
+// just makes more of the reservation accessible, so its contents never move.
+//
+// Faults are only turned into traps inside of run_catching_faults(), which only lowered and native code run in.
+class GuardedMemory {
+    AK_MAKE_NONCOPYABLE(GuardedMemory);
+    AK_MAKE_NONMOVABLE(GuardedMemory);
+
+public:
+    static constexpr u64 reservation_size = 2 * (static_cast<u64>(NumericLimits<u32>::max()) + 1) + 64 * KiB;
+
+    static bool is_supported();
+    static ErrorOr<NonnullOwnPtr<GuardedMemory>> create();
+    ~GuardedMemory();
+
+    u8* data() const { return m_base; }
+    size_t size() const { return m_size; }
+    Bytes bytes() const { return { m_base, m_size }; }
+
+    // Newly accessible bytes are zero, as the spec requires.
+    ErrorOr<void> grow_to(size_t new_size);
+
+    // Runs the callback, turning faults in the guard regions of all guarded memories into a return value of false.
+    // Faults skip all frames between here and the faulting access, so the code that accesses memory must not hold
+    // anything that needs to be destroyed at that point.
+    template<typename Callback>
+    NEVER_INLINE static bool run_catching_faults(Callback&& callback)
+    {
+        FaultScope scope;
+        if (sigsetjmp(scope.jump_buffer, 0) != 0)
+            return false;
+        callback();
+        return true;
+    }
+
+    // Runs the callback with faults not being caught, even inside of run_catching_faults(). Anything called from code
+    // that runs there (other functions, host functions, or the generic interpreter) has to go through this, as it may
+    // hold things that a fault must not skip over. A nested run_catching_faults() catches faults again.
+    template<typename Callback>
+    static void run_without_catching_faults(Callback&& callback)
+    {
+        TemporaryChange change { s_current_fault_scope, static_cast<FaultScope*>(nullptr) };
+        callback();
+    }
+
+private:
+    struct FaultScope {
+        AK_MAKE_NONCOPYABLE(FaultScope);
+        AK_MAKE_NONMOVABLE(FaultScope);
+
+    public:
+        FaultScope();
+        ~FaultScope();
+
+        sigjmp_buf jump_buffer;
+        FaultScope* previous { nullptr };
+    };
+
+    friend void handle_fault(int, siginfo_t*, void*);
+
+    static thread_local FaultScope* s_current_fault_scope;
+
+    GuardedMemory(u8* base, size_t slot)
+        : m_base(base)
+        , m_slot(slot)
+    {
+    }
+
+    u8* m_base { nullptr };
+    size_t m_size { 0 };
+    size_t m_slot { 0 };
+};
+
+}
@@ -0,0 +1,749 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/HashMap.h>
+#include <LibWasm/AbstractMachine/LoweredFunction.h>
+#include <LibWasm/Opcode.h>
+#include <LibWasm/Printer/Printer.h>
+
+namespace Wasm {
+
+StringView lowered_opcode_name(LoweredOpCode opcode)
+{
+    switch (opcode) {
+    case LoweredOpCode::unreachable:
+        return "unreachable"sv;
+    case LoweredOpCode::move:
+        return "move"sv;
+    case LoweredOpCode::select:
+        return "select"sv;
+    case LoweredOpCode::jump:
+        return "jump"sv;
+    case LoweredOpCode::jump_if_zero:
+        return "jump_if_zero"sv;
+    case LoweredOpCode::jump_if_not_zero:
+        return "jump_if_not_zero"sv;
+    case LoweredOpCode::branch_table:
+        return "branch_table"sv;
+    case LoweredOpCode::call:
+        return "call"sv;
+    case LoweredOpCode::call_indirect:
+        return "call_indirect"sv;
+    case LoweredOpCode::interpret:
+        return "interpret"sv;
+#define __ENUMERATE_LOWERED_OPERATION(name, ...) \
+    case LoweredOpCode::name:                    \
+        return #name##sv;
+        ENUMERATE_LOWERED_UNARY_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+        ENUMERATE_LOWERED_BINARY_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+        ENUMERATE_LOWERED_LOAD_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+        ENUMERATE_LOWERED_STORE_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+#undef __ENUMERATE_LOWERED_OPERATION
+#define __ENUMERATE_LOWERED_OPERATION(name, ...) \
+    case LoweredOpCode::guarded_##name:          \
+        return "guarded_" #name##sv;
+        ENUMERATE_LOWERED_LOAD_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+        ENUMERATE_LOWERED_STORE_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+#undef __ENUMERATE_LOWERED_OPERATION
+    }
+    VERIFY_NOT_REACHED();
+}
+
+void LoweredFunction::initialize_constants(Span<Value> slots) const
+{
+    for (size_t i = 0; i < m_constants.size(); ++i)
+        slots[m_local_count + i] = m_constants[i];
+}
+
+// Keeps all slot and instruction indices well within the range of the u32 operands of LoweredInstructions.
+static constexpr size_t max_slot_count = 1 << 24;
+static constexpr size_t max_instruction_count = 1 << 28;
+
+static bool has_single_result(LoweredOpCode opcode)
+{
+    switch (opcode) {
+    case LoweredOpCode::move:
+    case LoweredOpCode::select:
+#define __ENUMERATE_LOWERED_OPERATION(name, ...) case LoweredOpCode::name:
+        ENUMERATE_LOWERED_UNARY_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+        ENUMERATE_LOWERED_BINARY_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+        ENUMERATE_LOWERED_LOAD_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+#undef __ENUMERATE_LOWERED_OPERATION
+#define __ENUMERATE_LOWERED_OPERATION(name, ...) case LoweredOpCode::guarded_##name:
+        ENUMERATE_LOWERED_LOAD_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+#undef __ENUMERATE_LOWERED_OPERATION
+        return true;
+    default:
+        return false;
+    }
+}
+
+class FunctionLowerer {
+public:
+    FunctionLowerer(WasmFunction const& function, Store& store)
+        : m_function(function)
+        , m_store(store)
+    {
+    }
+
+    OwnPtr<LoweredFunction> lower();
+
+private:
+    struct ControlFrame {
+        enum class Kind {
+            Function,
+            Block,
+            Loop,
+            If,
+        };
+
+        Kind kind { Kind::Block };
+
+        // The stack height at which the frame's parameters start.
+        size_t height { 0 };
+        size_t parameter_count { 0 };
+        size_t result_count { 0 };
+
+        // Where branches to a loop go.
+        size_t loop_start { 0 };
+        // The jumps to the end of the frame, whose target isn't known until it is reached.
+        Vector<size_t> pending_jumps;
+        // The jump to the else branch of an if, or to its end if it has none.
+        Optional<size_t> else_jump;
+
+        size_t branch_arity() const { return kind == Kind::Loop ? parameter_count : result_count; }
+    };
+
+    bool collect_constants();
+    bool lower_instruction(Instruction const&);
+    bool lower_block(Instruction const&, ControlFrame::Kind);
+    void lower_else();
+    void lower_end();
+    void lower_branch(ControlFrame&);
+    void lower_conditional_branch(ControlFrame&);
+    bool lower_table_branch(Instruction::TableBranchArgs const&);
+    bool lower_call(FunctionAddress);
+    bool lower_indirect_call(Instruction::IndirectCallArgs const&);
+    void lower_interpreted(Instruction const&, size_t pop_count, size_t push_count);
+    void lower_select();
+    void lower_local_set(LocalIndex);
+    void lower_unary_operation(LoweredOpCode);
+    void lower_binary_operation(LoweredOpCode);
+    bool lower_load(LoweredOpCode, LoweredOpCode guarded_opcode, Instruction::MemoryArgument const&);
+    bool lower_store(LoweredOpCode, LoweredOpCode guarded_opcode, Instruction::MemoryArgument const&);
+
+    size_t emit(LoweredInstruction);
+    void emit_jump(ControlFrame&, LoweredOpCode, u32 condition = 0);
+    void link_jumps_to_here(Vector<size_t> const&);
+
+    u32 fold_operand(u32 slot);
+    u32 fold_condition(u32 slot, bool& is_negated);
+
+    u32 local(size_t index) const { return index; }
+    u32 stack_slot(size_t height) const { return m_stack_base + height; }
+    void push(size_t count = 1);
+    void pop(size_t count = 1);
+    bool load_block_type(BlockType const&, size_t& parameter_count, size_t& result_count) const;
+    Optional<u32> memory_address(MemoryIndex) const;
+    ControlFrame& frame_for_label(LabelIndex index) { return m_control_stack[m_control_stack.size() - index.value() - 1]; }
+
+    WasmFunction const& m_function;
+    Store& m_store;
+
+    Vector<LoweredInstruction> m_instructions;
+    Vector<Vector<u32>> m_branch_tables;
+    Vector<Value> m_constants;
+    HashMap<u64, u32> m_constant_slots;
+
+    size_t m_local_count { 0 };
+    size_t m_stack_base { 0 };
+    size_t m_stack_height { 0 };
+    size_t m_max_stack_height { 0 };
+    Vector<ControlFrame> m_control_stack;
+
+    // Branches may only target instructions at or after this index, so anything before it must be left alone
+    // when fusing instructions.
+    size_t m_fusion_barrier { 0 };
+
+    // Instructions after an unconditional branch are never executed, and are skipped up to the end of their frame.
+    bool m_is_unreachable { false };
+    size_t m_unreachable_depth { 0 };
+
+    bool m_accesses_guarded_memory { false };
+};
+
+OwnPtr<LoweredFunction> LoweredFunction::lower(WasmFunction const& function, Store& store)
+{
+    return FunctionLowerer { function, store }.lower();
+}
+
+OwnPtr<LoweredFunction> FunctionLowerer::lower()
+{
+    auto& type = m_function.type();
+    m_local_count = type.parameters().size();
+    for (auto& local : m_function.code().func().locals()) {
+        m_local_count += local.n();
+        if (m_local_count > max_slot_count)
+            return nullptr;
+    }
+
+    if (!collect_constants())
+        return nullptr;
+    m_stack_base = m_local_count + m_constants.size();
+
+    m_control_stack.append(ControlFrame {
+        .kind = ControlFrame::Kind::Function,
+        .height = 0,
+        .parameter_count = 0,
+        .result_count = type.results().size(),
+    });
+
+    for (auto& instruction : m_function.code().func().body().instructions()) {
+        if (!lower_instruction(instruction)) {
+            dbgln_if(WASM_TRACE_DEBUG, "Unable to lower {}, interpreting the function directly", instruction_name(instruction.opcode()));
+            return nullptr;
+        }
+    }
+
+    // The final end of the function body is implicit.
+    VERIFY(m_control_stack.size() == 1);
+    link_jumps_to_here(m_control_stack.first().pending_jumps);
+
+    return make<LoweredFunction>(move(m_instructions), move(m_branch_tables), move(m_constants), m_local_count, m_max_stack_height, m_accesses_guarded_memory);
+}
+
+// Gives every distinct constant in the function a slot of its own, which instructions can read directly.
+bool FunctionLowerer::collect_constants()
+{
+    for (auto& instruction : m_function.code().func().body().instructions()) {
+        Value value;
+        switch (instruction.opcode().value()) {
+        case Instructions::i32_const.value():
+            value = Value(instruction.arguments().get<i32>());
+            break;
+        case Instructions::i64_const.value():
+            value = Value(instruction.arguments().get<i64>());
+            break;
+        case Instructions::f32_const.value():
+            value = Value(instruction.arguments().get<float>());
+            break;
+        case Instructions::f64_const.value():
+            value = Value(instruction.arguments().get<double>());
+            break;
+        default:
+            continue;
+        }
+
+        // Scalar constants only ever use the lower half of their Value.
+        auto key = value.value().low();
+        if (m_constant_slots.contains(key))
+            continue;
+        if (m_local_count + m_constants.size() >= max_slot_count)
+            return false;
+        m_constant_slots.set(key, m_local_count + m_constants.size());
+        m_constants.append(value);
+    }
+    return true;
+}
+
+bool FunctionLowerer::lower_instruction(Instruction const& instruction)
+{
+    auto opcode = instruction.opcode();
+
+    if (m_is_unreachable) {
+        switch (opcode.value()) {
+        case Instructions::block.value():
+        case Instructions::loop.value():
+        case Instructions::if_.value():
+            ++m_unreachable_depth;
+            return true;
+        case Instructions::structured_else.value():
+            if (m_unreachable_depth == 0)
+                lower_else();
+            return true;
+        case Instructions::structured_end.value():
+            if (m_unreachable_depth == 0)
+                lower_end();
+            else
+                --m_unreachable_depth;
+            return true;
+        default:
+            return true;
+        }
+    }
+
+    if (m_stack_base + m_stack_height > max_slot_count || m_instructions.size() > max_instruction_count)
+        return false;
+
+    switch (opcode.value()) {
+    case Instructions::unreachable.value():
+        emit({ .opcode = LoweredOpCode::unreachable });
+        m_is_unreachable = true;
+        return true;
+    case Instructions::nop.value():
+        return true;
+    case Instructions::block.value():
+        return lower_block(instruction, ControlFrame::Kind::Block);
+    case Instructions::loop.value():
+        return lower_block(instruction, ControlFrame::Kind::Loop);
+    case Instructions::if_.value():
+        return lower_block(instruction, ControlFrame::Kind::If);
+    case Instructions::structured_else.value():
+        lower_else();
+        return true;
+    case Instructions::structured_end.value():
+        lower_end();
+        return true;
+    case Instructions::br.value():
+        lower_branch(frame_for_label(instruction.arguments().get<LabelIndex>()));
+        m_is_unreachable = true;
+        return true;
+    case Instructions::br_if.value():
+        lower_conditional_branch(frame_for_label(instruction.arguments().get<LabelIndex>()));
+        return true;
+    case Instructions::br_table.value():
+        return lower_table_branch(instruction.arguments().get<Instruction::TableBranchArgs>());
+    case Instructions::return_.value():
+        lower_branch(m_control_stack.first());
+        m_is_unreachable = true;
+        return true;
+    case Instructions::call.value(): {
+        auto index = instruction.arguments().get<FunctionIndex>();
+        return lower_call(m_function.module().functions()[index.value()]);
+    }
+    case Instructions::call_indirect.value():
+        return lower_indirect_call(instruction.arguments().get<Instruction::IndirectCallArgs>());
+    case Instructions::drop.value():
+        pop();
+        return true;
+    case Instructions::select.value():
+    case Instructions::select_typed.value():
+        lower_select();
+        return true;
+    case Instructions::local_get.value():
+        emit({ .opcode = LoweredOpCode::move, .result = stack_slot(m_stack_height), .lhs = local(instruction.arguments().get<LocalIndex>().value()) });
+        push();
+        return true;
+    case Instructions::local_set.value():
+        lower_local_set(instruction.arguments().get<LocalIndex>());
+        return true;
+    case Instructions::local_tee.value():
+        emit({ .opcode = LoweredOpCode::move, .result = local(instruction.arguments().get<LocalIndex>().value()), .lhs = stack_slot(m_stack_height - 1) });
+        return true;
+    case Instructions::i32_const.value():
+        emit({ .opcode = LoweredOpCode::move, .result = stack_slot(m_stack_height), .lhs = *m_constant_slots.get(Value(instruction.arguments().get<i32>()).value().low()) });
+        push();
+        return true;
+    case Instructions::i64_const.value():
+        emit({ .opcode = LoweredOpCode::move, .result = stack_slot(m_stack_height), .lhs = *m_constant_slots.get(Value(instruction.arguments().get<i64>()).value().low()) });
+        push();
+        return true;
+    case Instructions::f32_const.value():
+        emit({ .opcode = LoweredOpCode::move, .result = stack_slot(m_stack_height), .lhs = *m_constant_slots.get(Value(instruction.arguments().get<float>()).value().low()) });
+        push();
+        return true;
+    case Instructions::f64_const.value():
+        emit({ .opcode = LoweredOpCode::move, .result = stack_slot(m_stack_height), .lhs = *m_constant_slots.get(Value(instruction.arguments().get<double>()).value().low()) });
+        push();
+        return true;
+    case Instructions::global_get.value():
+    case Instructions::memory_size.value():
+    case Instructions::table_size.value():
+    case Instructions::ref_null.value():
+    case Instructions::ref_func.value():
+        lower_interpreted(instruction, 0, 1);
+        return true;
+    case Instructions::global_set.value():
+        lower_interpreted(instruction, 1, 0);
+        return true;
+    case Instructions::memory_grow.value():
+    case Instructions::table_get.value():
+    case Instructions::ref_is_null.value():
+        lower_interpreted(instruction, 1, 1);
+        return true;
+    case Instructions::table_set.value():
+        lower_interpreted(instruction, 2, 0);
+        return true;
+    case Instructions::table_grow.value():
+        lower_interpreted(instruction, 2, 1);
+        return true;
+    case Instructions::memory_fill.value():
+    case Instructions::memory_copy.value():
+    case Instructions::memory_init.value():
+    case Instructions::table_init.value():
+    case Instructions::table_copy.value():
+    case Instructions::table_fill.value():
+        lower_interpreted(instruction, 3, 0);
+        return true;
+    case Instructions::data_drop.value():
+    case Instructions::elem_drop.value():
+        lower_interpreted(instruction, 0, 0);
+        return true;
+#define __ENUMERATE_LOWERED_OPERATION(name, ...) \
+    case Instructions::name.value():             \
+        lower_unary_operation(LoweredOpCode::name); \
+        return true;
+        ENUMERATE_LOWERED_UNARY_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+#undef __ENUMERATE_LOWERED_OPERATION
+#define __ENUMERATE_LOWERED_OPERATION(name, ...) \
+    case Instructions::name.value():             \
+        lower_binary_operation(LoweredOpCode::name); \
+        return true;
+        ENUMERATE_LOWERED_BINARY_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+#undef __ENUMERATE_LOWERED_OPERATION
+#define __ENUMERATE_LOWERED_OPERATION(name, ...) \
+    case Instructions::name.value():             \
+        return lower_load(LoweredOpCode::name, LoweredOpCode::guarded_##name, instruction.arguments().get<Instruction::MemoryArgument>());
+        ENUMERATE_LOWERED_LOAD_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+#undef __ENUMERATE_LOWERED_OPERATION
+#define __ENUMERATE_LOWERED_OPERATION(name, ...) \
+    case Instructions::name.value():             \
+        return lower_store(LoweredOpCode::name, LoweredOpCode::guarded_##name, instruction.arguments().get<Instruction::MemoryArgument>());
+        ENUMERATE_LOWERED_STORE_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+#undef __ENUMERATE_LOWERED_OPERATION
+    default:
+        // FIXME: Lower vector instructions as well.
+        return false;
+    }
+}
+
+bool FunctionLowerer::lower_block(Instruction const& instruction, ControlFrame::Kind kind)
+{
+    auto& args = instruction.arguments().get<Instruction::StructuredInstructionArgs>();
+    size_t parameter_count = 0;
+    size_t result_count = 0;
+    if (!load_block_type(args.block_type, parameter_count, result_count))
+        return false;
+
+    u32 condition = 0;
+    bool is_negated = false;
+    if (kind == ControlFrame::Kind::If) {
+        condition = fold_condition(stack_slot(m_stack_height - 1), is_negated);
+        pop();
+    }
+
+    ControlFrame frame {
+        .kind = kind,
+        .height = m_stack_height - parameter_count,
+        .parameter_count = parameter_count,
+        .result_count = result_count,
+    };
+
+    if (kind == ControlFrame::Kind::If)
+        frame.else_jump = emit({ .opcode = is_negated ? LoweredOpCode::jump_if_not_zero : LoweredOpCode::jump_if_zero, .lhs = condition });
+    if (kind == ControlFrame::Kind::Loop)
+        frame.loop_start = m_instructions.size();
+
+    m_fusion_barrier = m_instructions.size();
+    m_control_stack.append(move(frame));
+    return true;
+}
+
+void FunctionLowerer::lower_else()
+{
+    auto& frame = m_control_stack.last();
+    VERIFY(frame.kind == ControlFrame::Kind::If);
+    VERIFY(frame.else_jump.has_value());
+    if (!m_is_unreachable)
+        emit_jump(frame, LoweredOpCode::jump);
+    m_instructions[frame.else_jump.release_value()].argument = m_instructions.size();
+    m_fusion_barrier = m_instructions.size();
+    m_stack_height = frame.height + frame.parameter_count;
+    m_is_unreachable = false;
+}
+
+void FunctionLowerer::lower_end()
+{
+    VERIFY(m_control_stack.size() > 1);
+    auto frame = m_control_stack.take_last();
+    if (frame.else_jump.has_value())
+        m_instructions[*frame.else_jump].argument = m_instructions.size();
+    link_jumps_to_here(frame.pending_jumps);
+    m_fusion_barrier = m_instructions.size();
+    m_stack_height = frame.height + frame.result_count;
+    m_is_unreachable = false;
+}
+
+void FunctionLowerer::lower_branch(ControlFrame& frame)
+{
+    auto arity = frame.branch_arity();
+    auto source_height = m_stack_height - arity;
+    if (source_height != frame.height) {
+        // The values only ever move down the stack, so copying them in order can't overwrite any that are still needed.
+        for (size_t i = 0; i < arity; ++i)
+            emit({ .opcode = LoweredOpCode::move, .result = stack_slot(frame.height + i), .lhs = stack_slot(source_height + i) });
+    }
+    emit_jump(frame, LoweredOpCode::jump);
+}
+
+void FunctionLowerer::lower_conditional_branch(ControlFrame& frame)
+{
+    bool is_negated = false;
+    auto condition = fold_condition(stack_slot(m_stack_height - 1), is_negated);
+    pop();
+
+    if (m_stack_height - frame.branch_arity() == frame.height) {
+        emit_jump(frame, is_negated ? LoweredOpCode::jump_if_zero : LoweredOpCode::jump_if_not_zero, condition);
+        return;
+    }
+
+    // The branch values have to be moved into place first, which only happens if the branch is taken.
+    auto skip = emit({ .opcode = is_negated ? LoweredOpCode::jump_if_not_zero : LoweredOpCode::jump_if_zero, .lhs = condition });
+    lower_branch(frame);
+    m_instructions[skip].argument = m_instructions.size();
+    m_fusion_barrier = m_instructions.size();
+}
+
+bool FunctionLowerer::lower_table_branch(Instruction::TableBranchArgs const& args)
+{
+    if (args.labels.size() >= max_instruction_count)
+        return false;
+
+    auto index = fold_operand(stack_slot(m_stack_height - 1));
+    pop();
+
+    auto table_index = m_branch_tables.size();
+    m_branch_tables.append({});
+    emit({ .opcode = LoweredOpCode::branch_table, .lhs = index, .rhs = static_cast<u32>(args.labels.size()), .argument = table_index });
+
+    // Every distinct label gets a sequence of instructions which moves the branch values into place and jumps to it.
+    HashMap<u32, u32> label_entries;
+    auto entry_for_label = [&](LabelIndex label) -> u32 {
+        if (auto entry = label_entries.get(label.value()); entry.has_value())
+            return *entry;
+        u32 entry = m_instructions.size();
+        lower_branch(frame_for_label(label));
+        label_entries.set(label.value(), entry);
+        return entry;
+    };
+
+    Vector<u32> table;
+    table.ensure_capacity(args.labels.size() + 1);
+    for (auto label : args.labels)
+        table.unchecked_append(entry_for_label(label));
+    table.unchecked_append(entry_for_label(args.default_));
+    m_branch_tables[table_index] = move(table);
+
+    m_fusion_barrier = m_instructions.size();
+    m_is_unreachable = true;
+    return true;
+}
+
+bool FunctionLowerer::lower_call(FunctionAddress address)
+{
+    auto* instance = m_store.get(address);
+    if (!instance)
+        return false;
+
+    FunctionType const* type { nullptr };
+    instance->visit([&](auto const& function) { type = &function.type(); });
+    if (type->results().size() > max_slot_count)
+        return false;
+
+    auto arguments_height = m_stack_height - type->parameters().size();
+    emit({ .opcode = LoweredOpCode::call, .lhs = stack_slot(arguments_height), .argument = address.value() });
+    pop(type->parameters().size());
+    push(type->results().size());
+    return true;
+}
+
+bool FunctionLowerer::lower_indirect_call(Instruction::IndirectCallArgs const& args)
+{
+    auto& type = m_function.module().types()[args.type.value()];
+    auto table_address = m_function.module().tables()[args.table.value()];
+    if (type.results().size() > max_slot_count || table_address.value() > NumericLimits<u32>::max())
+        return false;
+
+    // The table index is passed along with the arguments, as the last one.
+    auto arguments_height = m_stack_height - type.parameters().size() - 1;
+    emit({ .opcode = LoweredOpCode::call_indirect, .result = static_cast<u32>(table_address.value()), .lhs = stack_slot(arguments_height), .argument = bit_cast<FlatPtr>(&type) });
+    pop(type.parameters().size() + 1);
+    push(type.results().size());
+    return true;
+}
+
+void FunctionLowerer::lower_interpreted(Instruction const& instruction, size_t pop_count, size_t push_count)
+{
+    auto operands_height = m_stack_height - pop_count;
+    emit({
+        .opcode = LoweredOpCode::interpret,
+        .result = static_cast<u32>(push_count),
+        .lhs = stack_slot(operands_height),
+        .rhs = static_cast<u32>(pop_count),
+        .argument = bit_cast<FlatPtr>(&instruction),
+    });
+    pop(pop_count);
+    push(push_count);
+}
+
+void FunctionLowerer::lower_select()
+{
+    // Folding takes the operands from the top of the stack down, as they were pushed in the opposite order.
+    auto condition = fold_operand(stack_slot(m_stack_height - 1));
+    auto rhs = fold_operand(stack_slot(m_stack_height - 2));
+    auto lhs = fold_operand(stack_slot(m_stack_height - 3));
+    emit({ .opcode = LoweredOpCode::select, .result = stack_slot(m_stack_height - 3), .lhs = lhs, .rhs = rhs, .argument = condition });
+    pop(2);
+}
+
+void FunctionLowerer::lower_local_set(LocalIndex index)
+{
+    auto source = stack_slot(m_stack_height - 1);
+    pop();
+
+    // A value which is computed just to be stored into a local can be written there directly.
+    if (m_instructions.size() > m_fusion_barrier) {
+        auto& last = m_instructions.last();
+        if (last.result == source && has_single_result(last.opcode)) {
+            last.result = local(index.value());
+            return;
+        }
+    }
+
+    emit({ .opcode = LoweredOpCode::move, .result = local(index.value()), .lhs = source });
+}
+
+void FunctionLowerer::lower_unary_operation(LoweredOpCode opcode)
+{
+    auto operand = fold_operand(stack_slot(m_stack_height - 1));
+    emit({ .opcode = opcode, .result = stack_slot(m_stack_height - 1), .lhs = operand });
+}
+
+void FunctionLowerer::lower_binary_operation(LoweredOpCode opcode)
+{
+    auto rhs = fold_operand(stack_slot(m_stack_height - 1));
+    auto lhs = fold_operand(stack_slot(m_stack_height - 2));
+    emit({ .opcode = opcode, .result = stack_slot(m_stack_height - 2), .lhs = lhs, .rhs = rhs });
+    pop();
+}
+
+bool FunctionLowerer::lower_load(LoweredOpCode opcode, LoweredOpCode guarded_opcode, Instruction::MemoryArgument const& memory_argument)
+{
+    auto address = memory_address(memory_argument.memory_index);
+    if (!address.has_value())
+        return false;
+    if (m_store.get(MemoryAddress { *address })->is_guarded()) {
+        opcode = guarded_opcode;
+        m_accesses_guarded_memory = true;
+    }
+
+    auto base = fold_operand(stack_slot(m_stack_height - 1));
+    emit({ .opcode = opcode, .result = stack_slot(m_stack_height - 1), .lhs = base, .rhs = *address, .argument = memory_argument.offset });
+    return true;
+}
+
+bool FunctionLowerer::lower_store(LoweredOpCode opcode, LoweredOpCode guarded_opcode, Instruction::MemoryArgument const& memory_argument)
+{
+    auto address = memory_address(memory_argument.memory_index);
+    if (!address.has_value())
+        return false;
+    if (m_store.get(MemoryAddress { *address })->is_guarded()) {
+        opcode = guarded_opcode;
+        m_accesses_guarded_memory = true;
+    }
+
+    auto value = fold_operand(stack_slot(m_stack_height - 1));
+    auto base = fold_operand(stack_slot(m_stack_height - 2));
+    emit({ .opcode = opcode, .result = *address, .lhs = base, .rhs = value, .argument = memory_argument.offset });
+    pop(2);
+    return true;
+}
+
+size_t FunctionLowerer::emit(LoweredInstruction instruction)
+{
+    m_instructions.append(instruction);
+    return m_instructions.size() - 1;
+}
+
+void FunctionLowerer::emit_jump(ControlFrame& frame, LoweredOpCode opcode, u32 condition)
+{
+    auto index = emit({ .opcode = opcode, .lhs = condition });
+    if (frame.kind == ControlFrame::Kind::Loop)
+        m_instructions[index].argument = frame.loop_start;
+    else
+        frame.pending_jumps.append(index);
+}
+
+void FunctionLowerer::link_jumps_to_here(Vector<size_t> const& jumps)
+{
+    for (auto index : jumps)
+        m_instructions[index].argument = m_instructions.size();
+}
+
+// If the value in the given stack slot was just copied there from a local or a constant, removes the copy and
+// returns the slot it was copied from instead, so the next instruction can read it directly.
+u32 FunctionLowerer::fold_operand(u32 slot)
+{
+    if (m_instructions.size() <= m_fusion_barrier)
+        return slot;
+    auto& last = m_instructions.last();
+    if (last.opcode != LoweredOpCode::move || last.result != slot)
+        return slot;
+    auto source = last.lhs;
+    m_instructions.take_last();
+    return source;
+}
+
+// Like fold_operand(), but also folds an i32.eqz that computed the condition into the branch using it.
+u32 FunctionLowerer::fold_condition(u32 slot, bool& is_negated)
+{
+    if (m_instructions.size() > m_fusion_barrier) {
+        auto& last = m_instructions.last();
+        if (last.opcode == LoweredOpCode::i32_eqz && last.result == slot) {
+            auto operand = last.lhs;
+            m_instructions.take_last();
+            is_negated = true;
+            return operand;
+        }
+    }
+    return fold_operand(slot);
+}
+
+void FunctionLowerer::push(size_t count)
+{
+    m_stack_height += count;
+    m_max_stack_height = max(m_max_stack_height, m_stack_height);
+}
+
+void FunctionLowerer::pop(size_t count)
+{
+    VERIFY(m_stack_height >= count);
+    m_stack_height -= count;
+}
+
+bool FunctionLowerer::load_block_type(BlockType const& block_type, size_t& parameter_count, size_t& result_count) const
+{
+    switch (block_type.kind()) {
+    case BlockType::Empty:
+        parameter_count = 0;
+        result_count = 0;
+        return true;
+    case BlockType::Type:
+        parameter_count = 0;
+        result_count = 1;
+        return true;
+    case BlockType::Index: {
+        auto& type = m_function.module().types()[block_type.type_index().value()];
+        if (type.results().size() > max_slot_count)
+            return false;
+        parameter_count = type.parameters().size();
+        result_count = type.results().size();
+        return true;
+    }
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Optional<u32> FunctionLowerer::memory_address(MemoryIndex index) const
+{
+    auto address = m_function.module().memories()[index.value()];
+    if (address.value() > NumericLimits<u32>::max())
+        return {};
+    return static_cast<u32>(address.value());
+}
+
+}
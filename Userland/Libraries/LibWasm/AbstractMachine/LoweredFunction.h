@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/OwnPtr.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+#include <LibWasm/AbstractMachine/AbstractMachine.h>
+
+namespace Wasm {
+
+// O(name, PopType, PushType, Operator)
+#define ENUMERATE_LOWERED_UNARY_OPERATIONS(O)                                      \
+    O(i32_eqz, i32, i32, Operators::EqualsZero)                                    \
+    O(i64_eqz, i64, i32, Operators::EqualsZero)                                    \
+    O(i32_clz, i32, i32, Operators::CountLeadingZeros)                             \
+    O(i32_ctz, i32, i32, Operators::CountTrailingZeros)                            \
+    O(i32_popcnt, i32, i32, Operators::PopCount)                                   \
+    O(i64_clz, i64, i64, Operators::CountLeadingZeros)                             \
+    O(i64_ctz, i64, i64, Operators::CountTrailingZeros)                            \
+    O(i64_popcnt, i64, i64, Operators::PopCount)                                   \
+    O(f32_abs, float, float, Operators::Absolute)                                  \
+    O(f32_neg, float, float, Operators::Negate)                                    \
+    O(f32_ceil, float, float, Operators::Ceil)                                     \
+    O(f32_floor, float, float, Operators::Floor)                                   \
+    O(f32_trunc, float, float, Operators::Truncate)                                \
+    O(f32_nearest, float, float, Operators::NearbyIntegral)                        \
+    O(f32_sqrt, float, float, Operators::SquareRoot)                               \
+    O(f64_abs, double, double, Operators::Absolute)                                \
+    O(f64_neg, double, double, Operators::Negate)                                  \
+    O(f64_ceil, double, double, Operators::Ceil)                                   \
+    O(f64_floor, double, double, Operators::Floor)                                 \
+    O(f64_trunc, double, double, Operators::Truncate)                              \
+    O(f64_nearest, double, double, Operators::NearbyIntegral)                      \
+    O(f64_sqrt, double, double, Operators::SquareRoot)                             \
+    O(i32_wrap_i64, i64, i32, Operators::Wrap<i32>)                                \
+    O(i32_trunc_sf32, float, i32, Operators::CheckedTruncate<i32>)                 \
+    O(i32_trunc_uf32, float, i32, Operators::CheckedTruncate<u32>)                 \
+    O(i32_trunc_sf64, double, i32, Operators::CheckedTruncate<i32>)                \
+    O(i32_trunc_uf64, double, i32, Operators::CheckedTruncate<u32>)                \
+    O(i64_trunc_sf32, float, i64, Operators::CheckedTruncate<i64>)                 \
+    O(i64_trunc_uf32, float, i64, Operators::CheckedTruncate<u64>)                 \
+    O(i64_trunc_sf64, double, i64, Operators::CheckedTruncate<i64>)                \
+    O(i64_trunc_uf64, double, i64, Operators::CheckedTruncate<u64>)                \
+    O(i64_extend_si32, i32, i64, Operators::Extend<i64>)                           \
+    O(i64_extend_ui32, u32, i64, Operators::Extend<i64>)                           \
+    O(f32_convert_si32, i32, float, Operators::Convert<float>)                     \
+    O(f32_convert_ui32, u32, float, Operators::Convert<float>)                     \
+    O(f32_convert_si64, i64, float, Operators::Convert<float>)                     \
+    O(f32_convert_ui64, u64, float, Operators::Convert<float>)                     \
+    O(f32_demote_f64, double, float, Operators::Demote)                            \
+    O(f64_convert_si32, i32, double, Operators::Convert<double>)                   \
+    O(f64_convert_ui32, u32, double, Operators::Convert<double>)                   \
+    O(f64_convert_si64, i64, double, Operators::Convert<double>)                   \
+    O(f64_convert_ui64, u64, double, Operators::Convert<double>)                   \
+    O(f64_promote_f32, float, double, Operators::Promote)                          \
+    O(i32_reinterpret_f32, float, i32, Operators::Reinterpret<i32>)                \
+    O(i64_reinterpret_f64, double, i64, Operators::Reinterpret<i64>)               \
+    O(f32_reinterpret_i32, i32, float, Operators::Reinterpret<float>)              \
+    O(f64_reinterpret_i64, i64, double, Operators::Reinterpret<double>)            \
+    O(i32_extend8_s, i32, i32, Operators::SignExtend<i8>)                          \
+    O(i32_extend16_s, i32, i32, Operators::SignExtend<i16>)                        \
+    O(i64_extend8_s, i64, i64, Operators::SignExtend<i8>)                          \
+    O(i64_extend16_s, i64, i64, Operators::SignExtend<i16>)                        \
+    O(i64_extend32_s, i64, i64, Operators::SignExtend<i32>)                        \
+    O(i32_trunc_sat_f32_s, float, i32, Operators::SaturatingTruncate<i32>)         \
+    O(i32_trunc_sat_f32_u, float, i32, Operators::SaturatingTruncate<u32>)         \
+    O(i32_trunc_sat_f64_s, double, i32, Operators::SaturatingTruncate<i32>)        \
+    O(i32_trunc_sat_f64_u, double, i32, Operators::SaturatingTruncate<u32>)        \
+    O(i64_trunc_sat_f32_s, float, i64, Operators::SaturatingTruncate<i64>)         \
+    O(i64_trunc_sat_f32_u, float, i64, Operators::SaturatingTruncate<u64>)         \
+    O(i64_trunc_sat_f64_s, double, i64, Operators::SaturatingTruncate<i64>)        \
+    O(i64_trunc_sat_f64_u, double, i64, Operators::SaturatingTruncate<u64>)
+
+// O(name, PopType, PushType, Operator)
+#define ENUMERATE_LOWERED_BINARY_OPERATIONS(O)                   \
+    O(i32_eq, i32, i32, Operators::Equals)                       \
+    O(i32_ne, i32, i32, Operators::NotEquals)                    \
+    O(i32_lts, i32, i32, Operators::LessThan)                    \
+    O(i32_ltu, u32, i32, Operators::LessThan)                    \
+    O(i32_gts, i32, i32, Operators::GreaterThan)                 \
+    O(i32_gtu, u32, i32, Operators::GreaterThan)                 \
+    O(i32_les, i32, i32, Operators::LessThanOrEquals)            \
+    O(i32_leu, u32, i32, Operators::LessThanOrEquals)            \
+    O(i32_ges, i32, i32, Operators::GreaterThanOrEquals)         \
+    O(i32_geu, u32, i32, Operators::GreaterThanOrEquals)         \
+    O(i64_eq, i64, i32, Operators::Equals)                       \
+    O(i64_ne, i64, i32, Operators::NotEquals)                    \
+    O(i64_lts, i64, i32, Operators::LessThan)                    \
+    O(i64_ltu, u64, i32, Operators::LessThan)                    \
+    O(i64_gts, i64, i32, Operators::GreaterThan)                 \
+    O(i64_gtu, u64, i32, Operators::GreaterThan)                 \
+    O(i64_les, i64, i32, Operators::LessThanOrEquals)            \
+    O(i64_leu, u64, i32, Operators::LessThanOrEquals)            \
+    O(i64_ges, i64, i32, Operators::GreaterThanOrEquals)         \
+    O(i64_geu, u64, i32, Operators::GreaterThanOrEquals)         \
+    O(f32_eq, float, i32, Operators::Equals)                     \
+    O(f32_ne, float, i32, Operators::NotEquals)                  \
+    O(f32_lt, float, i32, Operators::LessThan)                   \
+    O(f32_gt, float, i32, Operators::GreaterThan)                \
+    O(f32_le, float, i32, Operators::LessThanOrEquals)           \
+    O(f32_ge, float, i32, Operators::GreaterThanOrEquals)        \
+    O(f64_eq, double, i32, Operators::Equals)                    \
+    O(f64_ne, double, i32, Operators::NotEquals)                 \
+    O(f64_lt, double, i32, Operators::LessThan)                  \
+    O(f64_gt, double, i32, Operators::GreaterThan)               \
+    O(f64_le, double, i32, Operators::LessThanOrEquals)          \
+    O(f64_ge, double, i32, Operators::GreaterThanOrEquals)       \
+    O(i32_add, u32, i32, Operators::Add)                         \
+    O(i32_sub, u32, i32, Operators::Subtract)                    \
+    O(i32_mul, u32, i32, Operators::Multiply)                    \
+    O(i32_divs, i32, i32, Operators::Divide)                     \
+    O(i32_divu, u32, i32, Operators::Divide)                     \
+    O(i32_rems, i32, i32, Operators::Modulo)                     \
+    O(i32_remu, u32, i32, Operators::Modulo)                     \
+    O(i32_and, i32, i32, Operators::BitAnd)                      \
+    O(i32_or, i32, i32, Operators::BitOr)                        \
+    O(i32_xor, i32, i32, Operators::BitXor)                      \
+    O(i32_shl, u32, i32, Operators::BitShiftLeft)                \
+    O(i32_shrs, i32, i32, Operators::BitShiftRight)              \
+    O(i32_shru, u32, i32, Operators::BitShiftRight)              \
+    O(i32_rotl, u32, i32, Operators::BitRotateLeft)              \
+    O(i32_rotr, u32, i32, Operators::BitRotateRight)             \
+    O(i64_add, u64, i64, Operators::Add)                         \
+    O(i64_sub, u64, i64, Operators::Subtract)                    \
+    O(i64_mul, u64, i64, Operators::Multiply)                    \
+    O(i64_divs, i64, i64, Operators::Divide)                     \
+    O(i64_divu, u64, i64, Operators::Divide)                     \
+    O(i64_rems, i64, i64, Operators::Modulo)                     \
+    O(i64_remu, u64, i64, Operators::Modulo)                     \
+    O(i64_and, i64, i64, Operators::BitAnd)                      \
+    O(i64_or, i64, i64, Operators::BitOr)                        \
+    O(i64_xor, i64, i64, Operators::BitXor)                      \
+    O(i64_shl, u64, i64, Operators::BitShiftLeft)                \
+    O(i64_shrs, i64, i64, Operators::BitShiftRight)              \
+    O(i64_shru, u64, i64, Operators::BitShiftRight)              \
+    O(i64_rotl, u64, i64, Operators::BitRotateLeft)              \
+    O(i64_rotr, u64, i64, Operators::BitRotateRight)             \
+    O(f32_add, float, float, Operators::Add)                     \
+    O(f32_sub, float, float, Operators::Subtract)                \
+    O(f32_mul, float, float, Operators::Multiply)                \
+    O(f32_div, float, float, Operators::Divide)                  \
+    O(f32_min, float, float, Operators::Minimum)                 \
+    O(f32_max, float, float, Operators::Maximum)                 \
+    O(f32_copysign, float, float, Operators::CopySign)           \
+    O(f64_add, double, double, Operators::Add)                   \
+    O(f64_sub, double, double, Operators::Subtract)              \
+    O(f64_mul, double, double, Operators::Multiply)              \
+    O(f64_div, double, double, Operators::Divide)                \
+    O(f64_min, double, double, Operators::Minimum)               \
+    O(f64_max, double, double, Operators::Maximum)               \
+    O(f64_copysign, double, double, Operators::CopySign)
+
+// O(name, ReadType, PushType)
+#define ENUMERATE_LOWERED_LOAD_OPERATIONS(O) \
+    O(i32_load, i32, i32)                    \
+    O(i64_load, i64, i64)                    \
+    O(f32_load, float, float)                \
+    O(f64_load, double, double)              \
+    O(i32_load8_s, i8, i32)                  \
+    O(i32_load8_u, u8, i32)                  \
+    O(i32_load16_s, i16, i32)                \
+    O(i32_load16_u, u16, i32)                \
+    O(i64_load8_s, i8, i64)                  \
+    O(i64_load8_u, u8, i64)                  \
+    O(i64_load16_s, i16, i64)                \
+    O(i64_load16_u, u16, i64)                \
+    O(i64_load32_s, i32, i64)                \
+    O(i64_load32_u, u32, i64)
+
+// O(name, PopType, StoreType)
+#define ENUMERATE_LOWERED_STORE_OPERATIONS(O) \
+    O(i32_store, i32, i32)                    \
+    O(i64_store, i64, i64)                    \
+    O(f32_store, float, float)                \
+    O(f64_store, double, double)              \
+    O(i32_store8, i32, i8)                    \
+    O(i32_store16, i32, i16)                  \
+    O(i64_store8, i64, i8)                    \
+    O(i64_store16, i64, i16)                  \
+    O(i64_store32, i64, i32)
+
+/**
+ * The operations of a LoweredFunction. Unlike Wasm instructions, they don't
+ * have an implicit value stack; all of their operands are indices of slots
+ * (see LoweredFunction), and their meaning is as follows:
+ *
+ * - unreachable: Traps.
+ * - move: slots[result] = slots[lhs].
+ * - select: slots[result] = slots[argument] != 0 ? slots[lhs] : slots[rhs].
+ * - jump: Continues at the instruction with index `argument`.
+ * - jump_if_zero, jump_if_not_zero: Jumps to `argument` depending on slots[lhs].
+ * - branch_table: Jumps to entry min(slots[lhs], rhs) of the branch table with index `argument`.
+ * - call: Calls the function at address `argument` with its arguments starting at slots[lhs], and writes its
+ *   results back to the slots starting at slots[lhs].
+ * - call_indirect: Like call, but calls the function in the table at address `result` at index slots[lhs + N],
+ *   where N is the number of parameters of the FunctionType pointed to by `argument`.
+ * - interpret: Interprets the Instruction pointed to by `argument`, which pops `rhs` values starting at
+ *   slots[lhs], and pushes `result` values starting at slots[lhs].
+ * - Unary operations: slots[result] = operation(slots[lhs]).
+ * - Binary operations: slots[result] = operation(slots[lhs], slots[rhs]).
+ * - Loads: slots[result] = load(memory at address `rhs`, slots[lhs] + argument).
+ * - Stores: store(memory at address `result`, slots[lhs] + argument, slots[rhs]).
+ * - Guarded loads and stores: Like the above, but without bounds checks, as the memory is a GuardedMemory.
+ */
+enum class LoweredOpCode : u32 {
+    unreachable,
+    move,
+    select,
+    jump,
+    jump_if_zero,
+    jump_if_not_zero,
+    branch_table,
+    call,
+    call_indirect,
+    interpret,
+#define __ENUMERATE_LOWERED_OPERATION(name, ...) name,
+    ENUMERATE_LOWERED_UNARY_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+    ENUMERATE_LOWERED_BINARY_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+    ENUMERATE_LOWERED_LOAD_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+    ENUMERATE_LOWERED_STORE_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+#undef __ENUMERATE_LOWERED_OPERATION
+#define __ENUMERATE_LOWERED_OPERATION(name, ...) guarded_##name,
+    ENUMERATE_LOWERED_LOAD_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+    ENUMERATE_LOWERED_STORE_OPERATIONS(__ENUMERATE_LOWERED_OPERATION)
+#undef __ENUMERATE_LOWERED_OPERATION
+};
+
+StringView lowered_opcode_name(LoweredOpCode);
+
+struct LoweredInstruction {
+    LoweredOpCode opcode { LoweredOpCode::unreachable };
+    u32 result { 0 };
+    u32 lhs { 0 };
+    u32 rhs { 0 };
+    u64 argument { 0 };
+};
+
+/**
+ * A LoweredFunction is the body of a validated Wasm function, translated into
+ * a form which is cheaper to interpret than its Instructions.
+ *
+ * It operates on an array of Values ("slots"): the function's locals come
+ * first, followed by the constants it uses, followed by its value stack. The
+ * height of the value stack is known statically at every instruction, so all
+ * operands are resolved to slots ahead of time, and so are the targets of all
+ * branches. Values which are only read once, like locals and constants pushed
+ * right before an operation, are read by the operation directly, and results
+ * which are immediately stored into a local are written there directly.
+ *
+ * When the function returns, its results are stored in the first slots of
+ * the value stack.
+ */
+class LoweredFunction {
+    AK_MAKE_NONCOPYABLE(LoweredFunction);
+    AK_MAKE_NONMOVABLE(LoweredFunction);
+
+public:
+    // Returns nullptr if the function uses instructions which can't be lowered, and has to be interpreted directly.
+    static OwnPtr<LoweredFunction> lower(WasmFunction const&, Store&);
+
+    LoweredFunction(Vector<LoweredInstruction> instructions, Vector<Vector<u32>> branch_tables, Vector<Value> constants, size_t local_count, size_t max_stack_height, bool accesses_guarded_memory)
+        : m_instructions(move(instructions))
+        , m_branch_tables(move(branch_tables))
+        , m_constants(move(constants))
+        , m_local_count(local_count)
+        , m_max_stack_height(max_stack_height)
+        , m_accesses_guarded_memory(accesses_guarded_memory)
+    {
+    }
+
+    auto& instructions() const { return m_instructions; }
+    auto& branch_table(size_t index) const { return m_branch_tables[index]; }
+
+    size_t local_count() const { return m_local_count; }
+    size_t stack_base() const { return m_local_count + m_constants.size(); }
+    size_t slot_count() const { return stack_base() + m_max_stack_height; }
+
+    // Whether any of the instructions is a guarded load or store, which fault when they are out of bounds.
+    bool accesses_guarded_memory() const { return m_accesses_guarded_memory; }
+
+    // Copies the constants into their slots, which have to be set up before every call.
+    void initialize_constants(Span<Value> slots) const;
+
+private:
+    Vector<LoweredInstruction> m_instructions;
+    // The indices of the instructions branch_table jumps to; the last entry of each one is its default.
+    Vector<Vector<u32>> m_branch_tables;
+    Vector<Value> m_constants;
+    size_t m_local_count { 0 };
+    size_t m_max_stack_height { 0 };
+    bool m_accesses_guarded_memory { false };
+};
+
+}
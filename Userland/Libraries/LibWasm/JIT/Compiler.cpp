@@ -0,0 +1,1001 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibJIT/GDB.h>
+#include <LibWasm/AbstractMachine/BytecodeInterpreter.h>
+#include <LibWasm/AbstractMachine/Configuration.h>
+#include <LibWasm/JIT/Compiler.h>
+#include <LibWasm/Opcode.h>
+#include <LibWasm/Printer/Printer.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+namespace Wasm::JIT {
+
+bool Compiler::is_enabled_by_default()
+{
+#ifdef JIT_ARCH_SUPPORTED
+    static bool const s_enabled = getenv("LIBWASM_DISABLE_JIT") == nullptr;
+    return s_enabled;
+#else
+    return false;
+#endif
+}
+
+#ifndef JIT_ARCH_SUPPORTED
+
+OwnPtr<NativeExecutable> Compiler::compile(WasmFunction const&, Store&)
+{
+    return nullptr;
+}
+
+#else
+
+// The functions called by native code. They all return a TrapCode, and may move the default memory.
+// NOTE: Native code may run with faults being caught, which must not skip over anything these call, see GuardedMemory.
+struct Runtime {
+    static u64 call(NativeCallContext*, u64 address, Value* arguments);
+    static u64 call_indirect(NativeCallContext*, u64 table_address, FunctionType const* expected_type, Value* arguments);
+    static u64 interpret(NativeCallContext*, Instruction const*, Value* operands, u64 pop_count, u64 push_count);
+
+private:
+    static u64 finish(NativeCallContext&);
+};
+
+u64 Runtime::finish(NativeCallContext& context)
+{
+    context.update_memory();
+    return to_underlying(context.interpreter->did_trap() ? TrapCode::Interpreter : TrapCode::None);
+}
+
+u64 Runtime::call(NativeCallContext* context, u64 address, Value* arguments)
+{
+    GuardedMemory::run_without_catching_faults([&] {
+        context->interpreter->call_address(*context->configuration, FunctionAddress { address }, arguments);
+    });
+    return finish(*context);
+}
+
+u64 Runtime::call_indirect(NativeCallContext* context, u64 table_address, FunctionType const* expected_type, Value* arguments)
+{
+    GuardedMemory::run_without_catching_faults([&] {
+        context->interpreter->call_table_element(*context->configuration, TableAddress { table_address }, *expected_type, arguments);
+    });
+    return finish(*context);
+}
+
+u64 Runtime::interpret(NativeCallContext* context, Instruction const* instruction, Value* operands, u64 pop_count, u64 push_count)
+{
+    GuardedMemory::run_without_catching_faults([&] {
+        context->interpreter->interpret_instruction_on_slots(*context->configuration, *instruction, operands, pop_count, push_count);
+    });
+    return finish(*context);
+}
+
+using Assembler = ::JIT::Assembler;
+using Operand = Assembler::Operand;
+using Reg = Assembler::Reg;
+
+static constexpr auto RAX = Operand::Register(Reg::RAX);
+static constexpr auto RCX = Operand::Register(Reg::RCX);
+static constexpr auto RDX = Operand::Register(Reg::RDX);
+
+// Native code keeps these in callee-saved registers, so they survive calls to the runtime.
+static constexpr auto SLOTS = Operand::Register(Reg::RBX);
+static constexpr auto CONTEXT = Operand::Register(Reg::R14);
+static constexpr auto MEMORY_BASE = Operand::Register(Reg::R15);
+
+// The first argument registers of the System V calling convention.
+static constexpr auto ARG0 = Operand::Register(Reg::RDI);
+static constexpr auto ARG1 = Operand::Register(Reg::RSI);
+static constexpr auto ARG2 = Operand::Register(Reg::RDX);
+static constexpr auto ARG3 = Operand::Register(Reg::RCX);
+static constexpr auto ARG4 = Operand::Register(Reg::R8);
+
+static Operand context_member(size_t offset)
+{
+    return Operand::Mem64BaseAndOffset(Reg::R14, offset);
+}
+
+Compiler::Compiler(WasmFunction const& function, Store& store)
+    : m_function(function)
+    , m_store(store)
+    , m_assembler(m_output)
+{
+}
+
+OwnPtr<NativeExecutable> Compiler::compile(WasmFunction const& function, Store& store)
+{
+    Compiler compiler { function, store };
+    if (!compiler.compile_function())
+        return nullptr;
+
+    auto& code = compiler.m_output;
+    auto* executable_memory = mmap(nullptr, code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (executable_memory == MAP_FAILED) {
+        dbgln("Failed to allocate memory for Wasm JIT code: {}", strerror(errno));
+        return nullptr;
+    }
+
+    memcpy(executable_memory, code.data(), code.size());
+    if (mprotect(executable_memory, code.size(), PROT_READ | PROT_EXEC) < 0) {
+        dbgln_if(WASM_JIT_DEBUG, "Failed to make Wasm JIT code executable: {}", strerror(errno));
+        munmap(executable_memory, code.size());
+        return nullptr;
+    }
+
+    auto gdb_object = ::JIT::GDB::build_gdb_image({ executable_memory, code.size() }, "LibWasm JIT"sv, "Wasm function"sv);
+    dbgln_if(WASM_JIT_DEBUG, "JIT: Compiled a function into {} bytes of native code", code.size());
+    return make<NativeExecutable>(executable_memory, code.size(), compiler.m_local_count, compiler.m_max_stack_height, compiler.m_accesses_guarded_memory, move(gdb_object));
+}
+
+bool Compiler::compile_function()
+{
+    auto& type = m_function.type();
+    auto& locals = m_function.code().func().locals();
+    for (auto& parameter : type.parameters()) {
+        if (!parameter.is_numeric())
+            return false;
+    }
+    for (auto& result : type.results()) {
+        if (!result.is_numeric())
+            return false;
+    }
+    m_local_count = type.parameters().size();
+    for (auto& local : locals) {
+        if (!local.type().is_numeric())
+            return false;
+        m_local_count += local.n();
+    }
+    if (m_local_count > max_slot_count)
+        return false;
+
+    m_assembler.enter();
+    m_assembler.mov(SLOTS, ARG0);
+    m_assembler.mov(CONTEXT, ARG1);
+    m_assembler.mov(MEMORY_BASE, context_member(offsetof(NativeCallContext, memory_base)));
+
+    m_control_stack.append(ControlFrame {
+        .kind = ControlFrame::Kind::Function,
+        .height = 0,
+        .parameter_count = 0,
+        .result_count = type.results().size(),
+    });
+
+    for (auto& instruction : m_function.code().func().body().instructions()) {
+        if (!compile_instruction(instruction)) {
+            dbgln_if(WASM_JIT_DEBUG, "JIT: Unable to compile {}, leaving the function to the interpreter", instruction_name(instruction.opcode()));
+            return false;
+        }
+    }
+
+    // The final end of the function body is implicit.
+    VERIFY(m_control_stack.size() == 1);
+    m_control_stack.first().label.link(m_assembler);
+    m_assembler.mov(RAX, Operand::Imm(to_underlying(TrapCode::None)));
+    m_exit.link(m_assembler);
+    m_assembler.exit();
+
+    auto compile_trap = [&](Assembler::Label& label, TrapCode code) {
+        label.link(m_assembler);
+        m_assembler.mov(RAX, Operand::Imm(to_underlying(code)));
+        m_assembler.jump(m_exit);
+    };
+    compile_trap(m_unreachable_trap, TrapCode::Unreachable);
+    compile_trap(m_out_of_bounds_trap, TrapCode::MemoryAccessOutOfBounds);
+    compile_trap(m_instruction_limit_trap, TrapCode::ExceededInstructionLimit);
+    return true;
+}
+
+static bool is_unary_numeric_operation(u64 opcode)
+{
+    auto is_between = [&](OpCode first, OpCode last) { return opcode >= first.value() && opcode <= last.value(); };
+    return opcode == Instructions::i32_eqz.value()
+        || opcode == Instructions::i64_eqz.value()
+        || is_between(Instructions::i32_clz, Instructions::i32_popcnt)
+        || is_between(Instructions::i64_clz, Instructions::i64_popcnt)
+        || is_between(Instructions::f32_abs, Instructions::f32_sqrt)
+        || is_between(Instructions::f64_abs, Instructions::f64_sqrt)
+        || is_between(Instructions::i32_wrap_i64, Instructions::i64_extend32_s)
+        || is_between(Instructions::i32_trunc_sat_f32_s, Instructions::i64_trunc_sat_f64_u);
+}
+
+static bool is_binary_numeric_operation(u64 opcode)
+{
+    return opcode >= Instructions::i32_eqz.value()
+        && opcode <= Instructions::f64_copysign.value()
+        && !is_unary_numeric_operation(opcode);
+}
+
+bool Compiler::compile_instruction(Instruction const& instruction)
+{
+    auto opcode = instruction.opcode();
+
+    if (m_is_unreachable) {
+        switch (opcode.value()) {
+        case Instructions::block.value():
+        case Instructions::loop.value():
+        case Instructions::if_.value():
+            ++m_unreachable_depth;
+            return true;
+        case Instructions::structured_else.value():
+            if (m_unreachable_depth == 0)
+                compile_else();
+            return true;
+        case Instructions::structured_end.value():
+            if (m_unreachable_depth == 0)
+                compile_end();
+            else
+                --m_unreachable_depth;
+            return true;
+        default:
+            return true;
+        }
+    }
+
+    if (m_local_count + m_stack_height > max_slot_count)
+        return false;
+
+    auto frame_for_label = [&](LabelIndex index) -> ControlFrame& {
+        return m_control_stack[m_control_stack.size() - index.value() - 1];
+    };
+
+    switch (opcode.value()) {
+    case Instructions::unreachable.value():
+        m_assembler.jump(m_unreachable_trap);
+        m_is_unreachable = true;
+        return true;
+    case Instructions::nop.value():
+        return true;
+    case Instructions::block.value():
+        return compile_block(instruction, ControlFrame::Kind::Block);
+    case Instructions::loop.value():
+        return compile_block(instruction, ControlFrame::Kind::Loop);
+    case Instructions::if_.value():
+        return compile_block(instruction, ControlFrame::Kind::If);
+    case Instructions::structured_else.value():
+        compile_else();
+        return true;
+    case Instructions::structured_end.value():
+        compile_end();
+        return true;
+    case Instructions::br.value():
+        compile_branch(frame_for_label(instruction.arguments().get<LabelIndex>()));
+        m_is_unreachable = true;
+        return true;
+    case Instructions::br_if.value(): {
+        pop();
+        m_assembler.mov32(RAX, stack_slot(m_stack_height));
+        m_assembler.test32(RAX, RAX);
+        auto& frame = frame_for_label(instruction.arguments().get<LabelIndex>());
+        if (m_stack_height - frame.branch_arity() == frame.height) {
+            m_assembler.jump_if(Assembler::Condition::NotEqualTo, frame.label);
+        } else {
+            Assembler::Label not_taken;
+            m_assembler.jump_if(Assembler::Condition::EqualTo, not_taken);
+            compile_branch(frame);
+            not_taken.link(m_assembler);
+        }
+        return true;
+    }
+    case Instructions::br_table.value(): {
+        auto& args = instruction.arguments().get<Instruction::TableBranchArgs>();
+        if (args.labels.size() > NumericLimits<i32>::max())
+            return false;
+        pop();
+        m_assembler.mov32(RAX, stack_slot(m_stack_height));
+        Assembler::Label default_label;
+        m_assembler.cmp32(RAX, Operand::Imm(args.labels.size()));
+        m_assembler.jump_if(Assembler::Condition::UnsignedGreaterThanOrEqualTo, default_label);
+        if (!args.labels.is_empty())
+            compile_table_branch(args, 0, args.labels.size());
+        default_label.link(m_assembler);
+        compile_branch(frame_for_label(args.default_));
+        m_is_unreachable = true;
+        return true;
+    }
+    case Instructions::return_.value():
+        compile_branch(m_control_stack.first());
+        m_is_unreachable = true;
+        return true;
+    case Instructions::call.value(): {
+        auto index = instruction.arguments().get<FunctionIndex>();
+        return compile_call(m_function.module().functions()[index.value()]);
+    }
+    case Instructions::call_indirect.value():
+        return compile_indirect_call(instruction.arguments().get<Instruction::IndirectCallArgs>());
+    case Instructions::drop.value():
+        pop();
+        return true;
+    case Instructions::select_typed.value():
+        for (auto& type : instruction.arguments().get<Vector<ValueType>>()) {
+            if (!type.is_numeric())
+                return false;
+        }
+        [[fallthrough]];
+    case Instructions::select.value():
+        // Vectors are never on the stack in compiled functions, so the lower half of the slots is all there is to select.
+        m_assembler.mov32(RAX, stack_slot(m_stack_height - 1));
+        m_assembler.mov(RCX, stack_slot(m_stack_height - 3));
+        m_assembler.mov(RDX, stack_slot(m_stack_height - 2));
+        m_assembler.test32(RAX, RAX);
+        m_assembler.mov_if(Assembler::Condition::EqualTo, RCX, RDX);
+        m_assembler.mov(stack_slot(m_stack_height - 3), RCX);
+        pop(2);
+        return true;
+    case Instructions::local_get.value():
+        m_assembler.mov(RAX, local(instruction.arguments().get<LocalIndex>().value()));
+        m_assembler.mov(stack_slot(m_stack_height), RAX);
+        push();
+        return true;
+    case Instructions::local_set.value():
+        pop();
+        m_assembler.mov(RAX, stack_slot(m_stack_height));
+        m_assembler.mov(local(instruction.arguments().get<LocalIndex>().value()), RAX);
+        return true;
+    case Instructions::local_tee.value():
+        m_assembler.mov(RAX, stack_slot(m_stack_height - 1));
+        m_assembler.mov(local(instruction.arguments().get<LocalIndex>().value()), RAX);
+        return true;
+    case Instructions::global_get.value():
+    case Instructions::global_set.value(): {
+        auto address = m_function.module().globals()[instruction.arguments().get<GlobalIndex>().value()];
+        auto* global = m_store.get(address);
+        if (!global || !global->type().type().is_numeric())
+            return false;
+        if (opcode == Instructions::global_get)
+            return compile_interpreter_call(instruction, 0, 1);
+        return compile_interpreter_call(instruction, 1, 0);
+    }
+    case Instructions::memory_size.value():
+        return compile_interpreter_call(instruction, 0, 1);
+    case Instructions::memory_grow.value():
+        return compile_interpreter_call(instruction, 1, 1);
+    case Instructions::memory_fill.value():
+    case Instructions::memory_copy.value():
+    case Instructions::memory_init.value():
+        return compile_interpreter_call(instruction, 3, 0);
+    case Instructions::data_drop.value():
+        return compile_interpreter_call(instruction, 0, 0);
+    case Instructions::i32_const.value():
+        m_assembler.mov(RAX, Operand::Imm(static_cast<i64>(instruction.arguments().get<i32>())));
+        m_assembler.mov(stack_slot(m_stack_height), RAX);
+        push();
+        return true;
+    case Instructions::i64_const.value():
+        m_assembler.mov(RAX, Operand::Imm(instruction.arguments().get<i64>()));
+        m_assembler.mov(stack_slot(m_stack_height), RAX);
+        push();
+        return true;
+    case Instructions::f32_const.value():
+        m_assembler.mov(RAX, Operand::Imm(static_cast<i64>(bit_cast<i32>(instruction.arguments().get<float>()))));
+        m_assembler.mov(stack_slot(m_stack_height), RAX);
+        push();
+        return true;
+    case Instructions::f64_const.value():
+        m_assembler.mov(RAX, Operand::Imm(bit_cast<u64>(instruction.arguments().get<double>())));
+        m_assembler.mov(stack_slot(m_stack_height), RAX);
+        push();
+        return true;
+    case Instructions::i32_load.value():
+    case Instructions::i64_load.value():
+    case Instructions::f32_load.value():
+    case Instructions::f64_load.value():
+    case Instructions::i32_load8_s.value():
+    case Instructions::i32_load8_u.value():
+    case Instructions::i32_load16_s.value():
+    case Instructions::i32_load16_u.value():
+    case Instructions::i64_load8_s.value():
+    case Instructions::i64_load8_u.value():
+    case Instructions::i64_load16_s.value():
+    case Instructions::i64_load16_u.value():
+    case Instructions::i64_load32_s.value():
+    case Instructions::i64_load32_u.value(): {
+        auto& memory_argument = instruction.arguments().get<Instruction::MemoryArgument>();
+        if (memory_argument.memory_index.value() != 0)
+            return false;
+        switch (opcode.value()) {
+        case Instructions::i32_load.value():
+        case Instructions::f32_load.value():
+        case Instructions::i64_load32_s.value():
+            compile_load(memory_argument, 4, true);
+            break;
+        case Instructions::i64_load32_u.value():
+            compile_load(memory_argument, 4, false);
+            break;
+        case Instructions::i64_load.value():
+        case Instructions::f64_load.value():
+            compile_load(memory_argument, 8, false);
+            break;
+        case Instructions::i32_load8_s.value():
+        case Instructions::i64_load8_s.value():
+            compile_load(memory_argument, 1, true);
+            break;
+        case Instructions::i32_load8_u.value():
+        case Instructions::i64_load8_u.value():
+            compile_load(memory_argument, 1, false);
+            break;
+        case Instructions::i32_load16_s.value():
+        case Instructions::i64_load16_s.value():
+            compile_load(memory_argument, 2, true);
+            break;
+        case Instructions::i32_load16_u.value():
+        case Instructions::i64_load16_u.value():
+            compile_load(memory_argument, 2, false);
+            break;
+        default:
+            VERIFY_NOT_REACHED();
+        }
+        return true;
+    }
+    case Instructions::i32_store.value():
+    case Instructions::i64_store.value():
+    case Instructions::f32_store.value():
+    case Instructions::f64_store.value():
+    case Instructions::i32_store8.value():
+    case Instructions::i32_store16.value():
+    case Instructions::i64_store8.value():
+    case Instructions::i64_store16.value():
+    case Instructions::i64_store32.value(): {
+        auto& memory_argument = instruction.arguments().get<Instruction::MemoryArgument>();
+        if (memory_argument.memory_index.value() != 0)
+            return false;
+        switch (opcode.value()) {
+        case Instructions::i32_store.value():
+        case Instructions::f32_store.value():
+        case Instructions::i64_store32.value():
+            compile_store(memory_argument, 4);
+            break;
+        case Instructions::i64_store.value():
+        case Instructions::f64_store.value():
+            compile_store(memory_argument, 8);
+            break;
+        case Instructions::i32_store8.value():
+        case Instructions::i64_store8.value():
+            compile_store(memory_argument, 1);
+            break;
+        case Instructions::i32_store16.value():
+        case Instructions::i64_store16.value():
+            compile_store(memory_argument, 2);
+            break;
+        default:
+            VERIFY_NOT_REACHED();
+        }
+        return true;
+    }
+    case Instructions::i32_eqz.value():
+    case Instructions::i64_eqz.value():
+        m_assembler.mov(RDX, Operand::Imm(0));
+        m_assembler.mov(RAX, stack_slot(m_stack_height - 1));
+        if (opcode == Instructions::i32_eqz)
+            m_assembler.test32(RAX, RAX);
+        else
+            m_assembler.test(RAX, RAX);
+        m_assembler.set_if(Assembler::Condition::EqualTo, RDX);
+        m_assembler.mov(stack_slot(m_stack_height - 1), RDX);
+        return true;
+    case Instructions::i32_eq.value():
+    case Instructions::i32_ne.value():
+    case Instructions::i32_lts.value():
+    case Instructions::i32_ltu.value():
+    case Instructions::i32_gts.value():
+    case Instructions::i32_gtu.value():
+    case Instructions::i32_les.value():
+    case Instructions::i32_leu.value():
+    case Instructions::i32_ges.value():
+    case Instructions::i32_geu.value():
+        compile_comparison(opcode, false);
+        return true;
+    case Instructions::i64_eq.value():
+    case Instructions::i64_ne.value():
+    case Instructions::i64_lts.value():
+    case Instructions::i64_ltu.value():
+    case Instructions::i64_gts.value():
+    case Instructions::i64_gtu.value():
+    case Instructions::i64_les.value():
+    case Instructions::i64_leu.value():
+    case Instructions::i64_ges.value():
+    case Instructions::i64_geu.value():
+        compile_comparison(opcode, true);
+        return true;
+    case Instructions::i32_add.value():
+    case Instructions::i32_sub.value():
+    case Instructions::i32_mul.value():
+    case Instructions::i32_and.value():
+    case Instructions::i32_or.value():
+    case Instructions::i32_xor.value():
+    case Instructions::i32_shl.value():
+    case Instructions::i32_shrs.value():
+    case Instructions::i32_shru.value():
+        compile_i32_binary_operation(opcode);
+        return true;
+    case Instructions::i64_add.value():
+    case Instructions::i64_sub.value():
+    case Instructions::i64_mul.value():
+    case Instructions::i64_and.value():
+    case Instructions::i64_or.value():
+    case Instructions::i64_xor.value():
+    case Instructions::i64_shl.value():
+    case Instructions::i64_shrs.value():
+    case Instructions::i64_shru.value():
+        compile_i64_binary_operation(opcode);
+        return true;
+    case Instructions::i32_wrap_i64.value():
+    case Instructions::i64_extend_si32.value():
+        m_assembler.mov(RAX, stack_slot(m_stack_height - 1));
+        m_assembler.sign_extend_32_to_64_bits(Reg::RAX);
+        m_assembler.mov(stack_slot(m_stack_height - 1), RAX);
+        return true;
+    case Instructions::i64_extend_ui32.value():
+        m_assembler.mov32(RAX, stack_slot(m_stack_height - 1));
+        m_assembler.mov(stack_slot(m_stack_height - 1), RAX);
+        return true;
+    default:
+        break;
+    }
+
+    if (is_unary_numeric_operation(opcode.value()))
+        return compile_interpreter_call(instruction, 1, 1);
+    if (is_binary_numeric_operation(opcode.value()))
+        return compile_interpreter_call(instruction, 2, 1);
+    return false;
+}
+
+bool Compiler::compile_interpreter_call(Instruction const& instruction, size_t pop_count, size_t push_count)
+{
+    auto operands_height = m_stack_height - pop_count;
+    m_assembler.mov(ARG0, CONTEXT);
+    m_assembler.mov(ARG1, Operand::Imm(bit_cast<FlatPtr>(&instruction)));
+    m_assembler.mov(ARG2, SLOTS);
+    m_assembler.add(ARG2, Operand::Imm((m_local_count + operands_height) * sizeof(Value)));
+    m_assembler.mov(ARG3, Operand::Imm(pop_count));
+    m_assembler.mov(ARG4, Operand::Imm(push_count));
+    call_runtime(bit_cast<void*>(&Runtime::interpret));
+    check_runtime_call_result();
+    pop(pop_count);
+    push(push_count);
+    return true;
+}
+
+bool Compiler::compile_block(Instruction const& instruction, ControlFrame::Kind kind)
+{
+    auto& args = instruction.arguments().get<Instruction::StructuredInstructionArgs>();
+    size_t parameter_count = 0;
+    size_t result_count = 0;
+    if (!load_block_type(args.block_type, parameter_count, result_count))
+        return false;
+
+    if (kind == ControlFrame::Kind::If) {
+        pop();
+        m_assembler.mov32(RAX, stack_slot(m_stack_height));
+        m_assembler.test32(RAX, RAX);
+    }
+
+    ControlFrame frame {
+        .kind = kind,
+        .height = m_stack_height - parameter_count,
+        .parameter_count = parameter_count,
+        .result_count = result_count,
+    };
+
+    if (kind == ControlFrame::Kind::If)
+        m_assembler.jump_if(Assembler::Condition::EqualTo, frame.else_label);
+
+    if (kind == ControlFrame::Kind::Loop) {
+        frame.label.link(m_assembler);
+
+        // Every loop iteration counts against the instruction limit, which is enough to stop any infinite loop.
+        m_assembler.sub(context_member(offsetof(NativeCallContext, remaining_loop_iterations)), Operand::Imm(1));
+        m_assembler.jump_if(Assembler::Condition::EqualTo, m_instruction_limit_trap);
+    }
+
+    m_control_stack.append(move(frame));
+    return true;
+}
+
+void Compiler::compile_else()
+{
+    auto& frame = m_control_stack.last();
+    VERIFY(frame.kind == ControlFrame::Kind::If);
+    if (!m_is_unreachable)
+        m_assembler.jump(frame.label);
+    frame.else_label.link(m_assembler);
+    frame.has_else = true;
+    m_stack_height = frame.height + frame.parameter_count;
+    m_is_unreachable = false;
+}
+
+void Compiler::compile_end()
+{
+    VERIFY(m_control_stack.size() > 1);
+    auto frame = m_control_stack.take_last();
+    if (frame.kind == ControlFrame::Kind::If && !frame.has_else)
+        frame.else_label.link(m_assembler);
+    if (frame.kind != ControlFrame::Kind::Loop)
+        frame.label.link(m_assembler);
+    m_stack_height = frame.height + frame.result_count;
+    m_is_unreachable = false;
+}
+
+void Compiler::compile_branch(ControlFrame& frame)
+{
+    auto arity = frame.branch_arity();
+    auto source_height = m_stack_height - arity;
+    if (source_height != frame.height) {
+        for (size_t i = 0; i < arity; ++i) {
+            m_assembler.mov(RCX, stack_slot(source_height + i));
+            m_assembler.mov(stack_slot(frame.height + i), RCX);
+        }
+    }
+    m_assembler.jump(frame.label);
+}
+
+// Dispatches on the label index in RAX by binary search, which is known to be less than end_index.
+void Compiler::compile_table_branch(Instruction::TableBranchArgs const& args, size_t first_index, size_t end_index)
+{
+    if (end_index - first_index == 1) {
+        compile_branch(m_control_stack[m_control_stack.size() - args.labels[first_index].value() - 1]);
+        return;
+    }
+
+    auto middle_index = first_index + (end_index - first_index) / 2;
+    Assembler::Label upper_half;
+    m_assembler.cmp32(RAX, Operand::Imm(middle_index));
+    m_assembler.jump_if(Assembler::Condition::UnsignedGreaterThanOrEqualTo, upper_half);
+    compile_table_branch(args, first_index, middle_index);
+    upper_half.link(m_assembler);
+    compile_table_branch(args, middle_index, end_index);
+}
+
+bool Compiler::compile_call(FunctionAddress address)
+{
+    auto* instance = m_store.get(address);
+    if (!instance)
+        return false;
+
+    FunctionType const* type { nullptr };
+    instance->visit([&](auto const& function) { type = &function.type(); });
+    if (type->results().size() > max_slot_count)
+        return false;
+    for (auto& parameter : type->parameters()) {
+        if (!parameter.is_numeric())
+            return false;
+    }
+    for (auto& result : type->results()) {
+        if (!result.is_numeric())
+            return false;
+    }
+
+    auto arguments_height = m_stack_height - type->parameters().size();
+    m_assembler.mov(ARG0, CONTEXT);
+    m_assembler.mov(ARG1, Operand::Imm(address.value()));
+    m_assembler.mov(ARG2, SLOTS);
+    m_assembler.add(ARG2, Operand::Imm((m_local_count + arguments_height) * sizeof(Value)));
+    call_runtime(bit_cast<void*>(&Runtime::call));
+    check_runtime_call_result();
+    pop(type->parameters().size());
+    push(type->results().size());
+    return true;
+}
+
+bool Compiler::compile_indirect_call(Instruction::IndirectCallArgs const& args)
+{
+    auto& type = m_function.module().types()[args.type.value()];
+    if (type.results().size() > max_slot_count)
+        return false;
+    for (auto& parameter : type.parameters()) {
+        if (!parameter.is_numeric())
+            return false;
+    }
+    for (auto& result : type.results()) {
+        if (!result.is_numeric())
+            return false;
+    }
+
+    // The table index is passed along with the arguments, as the last one.
+    auto arguments_height = m_stack_height - type.parameters().size() - 1;
+    m_assembler.mov(ARG0, CONTEXT);
+    m_assembler.mov(ARG1, Operand::Imm(m_function.module().tables()[args.table.value()].value()));
+    m_assembler.mov(ARG2, Operand::Imm(bit_cast<FlatPtr>(&type)));
+    m_assembler.mov(ARG3, SLOTS);
+    m_assembler.add(ARG3, Operand::Imm((m_local_count + arguments_height) * sizeof(Value)));
+    call_runtime(bit_cast<void*>(&Runtime::call_indirect));
+    check_runtime_call_result();
+    pop(type.parameters().size() + 1);
+    push(type.results().size());
+    return true;
+}
+
+void Compiler::compile_i32_binary_operation(OpCode opcode)
+{
+    m_assembler.mov(RAX, stack_slot(m_stack_height - 2));
+    m_assembler.mov(RCX, stack_slot(m_stack_height - 1));
+    switch (opcode.value()) {
+    case Instructions::i32_add.value():
+        m_assembler.add32(RAX, RCX, {});
+        break;
+    case Instructions::i32_sub.value():
+        m_assembler.sub32(RAX, RCX, {});
+        break;
+    case Instructions::i32_mul.value():
+        m_assembler.mul32(RAX, RCX, {});
+        break;
+    case Instructions::i32_and.value():
+        m_assembler.bitwise_and(RAX, RCX);
+        break;
+    case Instructions::i32_or.value():
+        m_assembler.bitwise_or(RAX, RCX);
+        break;
+    case Instructions::i32_xor.value():
+        m_assembler.bitwise_xor32(RAX, RCX);
+        break;
+    // The shifts take their count from CL, and mask it like Wasm does.
+    case Instructions::i32_shl.value():
+        m_assembler.shift_left32(RAX, {});
+        break;
+    case Instructions::i32_shrs.value():
+        m_assembler.arithmetic_right_shift32(RAX, {});
+        break;
+    case Instructions::i32_shru.value():
+        m_assembler.shift_right32(RAX, {});
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+    m_assembler.sign_extend_32_to_64_bits(Reg::RAX);
+    m_assembler.mov(stack_slot(m_stack_height - 2), RAX);
+    pop();
+}
+
+void Compiler::compile_i64_binary_operation(OpCode opcode)
+{
+    m_assembler.mov(RAX, stack_slot(m_stack_height - 2));
+    m_assembler.mov(RCX, stack_slot(m_stack_height - 1));
+    switch (opcode.value()) {
+    case Instructions::i64_add.value():
+        m_assembler.add(RAX, RCX);
+        break;
+    case Instructions::i64_sub.value():
+        m_assembler.sub(RAX, RCX);
+        break;
+    case Instructions::i64_mul.value():
+        m_assembler.mul(RAX, RCX);
+        break;
+    case Instructions::i64_and.value():
+        m_assembler.bitwise_and(RAX, RCX);
+        break;
+    case Instructions::i64_or.value():
+        m_assembler.bitwise_or(RAX, RCX);
+        break;
+    case Instructions::i64_xor.value():
+        m_assembler.bitwise_xor(RAX, RCX);
+        break;
+    case Instructions::i64_shl.value():
+        m_assembler.shift_left(RAX, {});
+        break;
+    case Instructions::i64_shrs.value():
+        m_assembler.arithmetic_right_shift(RAX, {});
+        break;
+    case Instructions::i64_shru.value():
+        m_assembler.shift_right(RAX, {});
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+    m_assembler.mov(stack_slot(m_stack_height - 2), RAX);
+    pop();
+}
+
+void Compiler::compile_comparison(OpCode opcode, bool is_64_bit)
+{
+    auto condition = [&] {
+        switch (opcode.value()) {
+        case Instructions::i32_eq.value():
+        case Instructions::i64_eq.value():
+            return Assembler::Condition::EqualTo;
+        case Instructions::i32_ne.value():
+        case Instructions::i64_ne.value():
+            return Assembler::Condition::NotEqualTo;
+        case Instructions::i32_lts.value():
+        case Instructions::i64_lts.value():
+            return Assembler::Condition::SignedLessThan;
+        case Instructions::i32_ltu.value():
+        case Instructions::i64_ltu.value():
+            return Assembler::Condition::UnsignedLessThan;
+        case Instructions::i32_gts.value():
+        case Instructions::i64_gts.value():
+            return Assembler::Condition::SignedGreaterThan;
+        case Instructions::i32_gtu.value():
+        case Instructions::i64_gtu.value():
+            return Assembler::Condition::UnsignedGreaterThan;
+        case Instructions::i32_les.value():
+        case Instructions::i64_les.value():
+            return Assembler::Condition::SignedLessThanOrEqualTo;
+        case Instructions::i32_leu.value():
+        case Instructions::i64_leu.value():
+            return Assembler::Condition::UnsignedLessThanOrEqualTo;
+        case Instructions::i32_ges.value():
+        case Instructions::i64_ges.value():
+            return Assembler::Condition::SignedGreaterThanOrEqualTo;
+        case Instructions::i32_geu.value():
+        case Instructions::i64_geu.value():
+            return Assembler::Condition::UnsignedGreaterThanOrEqualTo;
+        default:
+            VERIFY_NOT_REACHED();
+        }
+    }();
+
+    // Zeroing RDX clobbers the flags, so it has to happen before the comparison.
+    m_assembler.mov(RDX, Operand::Imm(0));
+    m_assembler.mov(RAX, stack_slot(m_stack_height - 2));
+    m_assembler.mov(RCX, stack_slot(m_stack_height - 1));
+    if (is_64_bit)
+        m_assembler.cmp(RAX, RCX);
+    else
+        m_assembler.cmp32(RAX, RCX);
+    m_assembler.set_if(condition, RDX);
+    m_assembler.mov(stack_slot(m_stack_height - 2), RDX);
+    pop();
+}
+
+void Compiler::compile_load(Instruction::MemoryArgument const& memory_argument, size_t size, bool is_signed)
+{
+    m_assembler.mov32(RAX, stack_slot(m_stack_height - 1));
+    compute_effective_address(memory_argument, size);
+
+    auto extension = is_signed ? Assembler::Extension::SignExtend : Assembler::Extension::ZeroExtend;
+    auto address = Operand::Mem64BaseAndOffset(Reg::RAX, 0);
+    switch (size) {
+    case 1:
+        m_assembler.mov8(RAX, address, extension);
+        break;
+    case 2:
+        m_assembler.mov16(RAX, address, extension);
+        break;
+    case 4:
+        // This also matches how Value stores i32s and f32s, which are sign-extended.
+        m_assembler.mov32(RAX, address, extension);
+        break;
+    case 8:
+        m_assembler.mov(RAX, address);
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+    // Narrower loads only sign-extend to 32 bits.
+    if (is_signed && size < 4)
+        m_assembler.sign_extend_32_to_64_bits(Reg::RAX);
+    m_assembler.mov(stack_slot(m_stack_height - 1), RAX);
+}
+
+void Compiler::compile_store(Instruction::MemoryArgument const& memory_argument, size_t size)
+{
+    m_assembler.mov32(RAX, stack_slot(m_stack_height - 2));
+    compute_effective_address(memory_argument, size);
+    m_assembler.mov(RCX, stack_slot(m_stack_height - 1));
+
+    auto address = Operand::Mem64BaseAndOffset(Reg::RAX, 0);
+    switch (size) {
+    case 1:
+        m_assembler.mov8(address, RCX);
+        break;
+    case 2:
+        m_assembler.mov16(address, RCX);
+        break;
+    case 4:
+        m_assembler.mov32(address, RCX);
+        break;
+    case 8:
+        m_assembler.mov(address, RCX);
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+    pop(2);
+}
+
+// Turns the (zero-extended) base address in RAX into a pointer to the accessed bytes, or traps if any of them are out of bounds.
+void Compiler::compute_effective_address(Instruction::MemoryArgument const& memory_argument, size_t size)
+{
+    if (memory_argument.offset != 0) {
+        auto offset = Operand::Imm(memory_argument.offset);
+        if (offset.fits_in_i32()) {
+            m_assembler.add(RAX, offset);
+        } else {
+            m_assembler.mov(RCX, offset);
+            m_assembler.add(RAX, RCX);
+        }
+    }
+
+    // Out of bounds accesses to guarded memories fault instead, and NativeExecutable::run() turns that into a trap.
+    if (is_default_memory_guarded()) {
+        m_accesses_guarded_memory = true;
+    } else {
+        m_assembler.mov(RDX, RAX);
+        m_assembler.add(RDX, Operand::Imm(size));
+        m_assembler.cmp(context_member(offsetof(NativeCallContext, memory_size)), RDX);
+        m_assembler.jump_if(Assembler::Condition::UnsignedLessThan, m_out_of_bounds_trap);
+    }
+    m_assembler.add(RAX, MEMORY_BASE);
+}
+
+bool Compiler::is_default_memory_guarded() const
+{
+    auto& memories = m_function.module().memories();
+    return !memories.is_empty() && m_store.get(memories.first())->is_guarded();
+}
+
+void Compiler::call_runtime(void* function)
+{
+    m_assembler.native_call(bit_cast<u64>(function));
+}
+
+void Compiler::check_runtime_call_result()
+{
+    m_assembler.test(RAX, RAX);
+    m_assembler.jump_if(Assembler::Condition::NotEqualTo, m_exit);
+    m_assembler.mov(MEMORY_BASE, context_member(offsetof(NativeCallContext, memory_base)));
+}
+
+Compiler::Operand Compiler::local(size_t index) const
+{
+    return Operand::Mem64BaseAndOffset(Reg::RBX, index * sizeof(Value));
+}
+
+Compiler::Operand Compiler::stack_slot(size_t height) const
+{
+    return local(m_local_count + height);
+}
+
+void Compiler::push(size_t count)
+{
+    m_stack_height += count;
+    m_max_stack_height = max(m_max_stack_height, m_stack_height);
+}
+
+void Compiler::pop(size_t count)
+{
+    VERIFY(m_stack_height >= count);
+    m_stack_height -= count;
+}
+
+bool Compiler::load_block_type(BlockType const& block_type, size_t& parameter_count, size_t& result_count) const
+{
+    switch (block_type.kind()) {
+    case BlockType::Empty:
+        parameter_count = 0;
+        result_count = 0;
+        return true;
+    case BlockType::Type:
+        parameter_count = 0;
+        result_count = 1;
+        return block_type.value_type().is_numeric();
+    case BlockType::Index: {
+        auto& type = m_function.module().types()[block_type.type_index().value()];
+        if (type.results().size() > max_slot_count)
+            return false;
+        for (auto& parameter : type.parameters()) {
+            if (!parameter.is_numeric())
+                return false;
+        }
+        for (auto& result : type.results()) {
+            if (!result.is_numeric())
+                return false;
+        }
+        parameter_count = type.parameters().size();
+        result_count = type.results().size();
+        return true;
+    }
+    }
+    VERIFY_NOT_REACHED();
+}
+
+#endif
+
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/OwnPtr.h>
+#include <AK/Vector.h>
+#include <LibJIT/Assembler.h>
+#include <LibWasm/AbstractMachine/AbstractMachine.h>
+#include <LibWasm/JIT/NativeExecutable.h>
+
+namespace Wasm::JIT {
+
+struct Runtime;
+
+/**
+ * The Compiler is a baseline JIT, which translates a validated Wasm function
+ * into machine code in a single pass over its instructions. It does not do any
+ * register allocation; every value lives in its slot (see NativeExecutable),
+ * and every instruction loads its operands from and stores its result to those
+ * slots directly.
+ *
+ * Control flow, locals, memory accesses and the common integer instructions are
+ * compiled to native code. Calls, and other simple instructions which only use
+ * the value stack, call back into the interpreter. Functions which use anything
+ * else (vectors, references, tables, ...) are not compiled at all, and are left
+ * to the interpreter.
+ */
+class Compiler {
+public:
+    // Whether functions should be compiled by default, which can be overridden by setting LIBWASM_DISABLE_JIT
+    // in the environment.
+    static bool is_enabled_by_default();
+
+    static OwnPtr<NativeExecutable> compile(WasmFunction const&, Store&);
+
+#ifdef JIT_ARCH_SUPPORTED
+private:
+    using Assembler = ::JIT::Assembler;
+    using Operand = Assembler::Operand;
+    using Reg = Assembler::Reg;
+
+    // Keeps the offsets of all slots small enough to be encoded as 32-bit displacements.
+    static constexpr size_t max_slot_count = 1 << 20;
+
+    struct ControlFrame {
+        enum class Kind {
+            Function,
+            Block,
+            Loop,
+            If,
+        };
+
+        Kind kind { Kind::Block };
+
+        // The stack height at which the frame's parameters start.
+        size_t height { 0 };
+        size_t parameter_count { 0 };
+        size_t result_count { 0 };
+
+        // Where branches to this frame go; its start for loops, its end for everything else.
+        Assembler::Label label;
+        Assembler::Label else_label;
+        bool has_else { false };
+
+        size_t branch_arity() const { return kind == Kind::Loop ? parameter_count : result_count; }
+    };
+
+    Compiler(WasmFunction const&, Store&);
+
+    bool compile_function();
+    bool compile_instruction(Instruction const&);
+    bool compile_interpreter_call(Instruction const&, size_t pop_count, size_t push_count);
+
+    bool compile_block(Instruction const&, ControlFrame::Kind);
+    void compile_else();
+    void compile_end();
+    void compile_branch(ControlFrame&);
+    void compile_table_branch(Instruction::TableBranchArgs const&, size_t first_index, size_t end_index);
+    bool compile_call(FunctionAddress);
+    bool compile_indirect_call(Instruction::IndirectCallArgs const&);
+
+    void compile_i32_binary_operation(OpCode);
+    void compile_i64_binary_operation(OpCode);
+    void compile_comparison(OpCode, bool is_64_bit);
+    void compile_load(Instruction::MemoryArgument const&, size_t size, bool is_signed);
+    void compile_store(Instruction::MemoryArgument const&, size_t size);
+    void compute_effective_address(Instruction::MemoryArgument const&, size_t size);
+    bool is_default_memory_guarded() const;
+
+    void call_runtime(void* function);
+    void check_runtime_call_result();
+
+    Operand local(size_t index) const;
+    Operand stack_slot(size_t height) const;
+    void push(size_t count = 1);
+    void pop(size_t count = 1);
+    bool load_block_type(BlockType const&, size_t& parameter_count, size_t& result_count) const;
+
+    WasmFunction const& m_function;
+    Store& m_store;
+
+    Vector<u8> m_output;
+    Assembler m_assembler;
+
+    size_t m_local_count { 0 };
+    size_t m_stack_height { 0 };
+    size_t m_max_stack_height { 0 };
+    Vector<ControlFrame> m_control_stack;
+
+    // Instructions after an unconditional branch are never executed, and are skipped up to the end of their frame.
+    bool m_is_unreachable { false };
+    size_t m_unreachable_depth { 0 };
+
+    bool m_accesses_guarded_memory { false };
+
+    Assembler::Label m_exit;
+    Assembler::Label m_unreachable_trap;
+    Assembler::Label m_out_of_bounds_trap;
+    Assembler::Label m_instruction_limit_trap;
+#endif
+};
+
+}
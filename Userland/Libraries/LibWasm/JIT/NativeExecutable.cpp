@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJIT/GDB.h>
+#include <LibWasm/AbstractMachine/Configuration.h>
+#include <LibWasm/JIT/NativeExecutable.h>
+#include <sys/mman.h>
+
+namespace Wasm::JIT {
+
+StringView trap_code_reason(TrapCode code)
+{
+    switch (code) {
+    case TrapCode::Unreachable:
+        return "Unreachable"sv;
+    case TrapCode::MemoryAccessOutOfBounds:
+        return "Memory access out of bounds"sv;
+    case TrapCode::ExceededInstructionLimit:
+        return "Exceeded maximum allowed number of instructions"sv;
+    case TrapCode::None:
+    case TrapCode::Interpreter:
+        break;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+void NativeCallContext::update_memory()
+{
+    if (!memory_address.has_value())
+        return;
+
+    auto* memory = configuration->store().get(*memory_address);
+    memory_base = memory->bytes().data();
+    memory_size = memory->size();
+}
+
+NativeExecutable::NativeExecutable(void* code, size_t size, size_t local_count, size_t max_stack_height, bool accesses_guarded_memory, Optional<FixedArray<u8>> gdb_object)
+    : m_code(code)
+    , m_size(size)
+    , m_local_count(local_count)
+    , m_max_stack_height(max_stack_height)
+    , m_accesses_guarded_memory(accesses_guarded_memory)
+    , m_gdb_object(move(gdb_object))
+{
+    if (m_gdb_object.has_value())
+        ::JIT::GDB::register_into_gdb(m_gdb_object.value().span());
+}
+
+NativeExecutable::~NativeExecutable()
+{
+    if (m_gdb_object.has_value())
+        ::JIT::GDB::unregister_from_gdb(m_gdb_object.value().span());
+    munmap(m_code, m_size);
+}
+
+TrapCode NativeExecutable::run(Value* slots, NativeCallContext& context) const
+{
+    using EntryPoint = u64 (*)(Value* slots, NativeCallContext* context);
+    auto entry_point = bit_cast<EntryPoint>(m_code);
+    if (!m_accesses_guarded_memory)
+        return static_cast<TrapCode>(entry_point(slots, &context));
+
+    TrapCode trap_code = TrapCode::None;
+    if (!GuardedMemory::run_catching_faults([&] { trap_code = static_cast<TrapCode>(entry_point(slots, &context)); }))
+        return TrapCode::MemoryAccessOutOfBounds;
+    return trap_code;
+}
+
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2024, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/FixedArray.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/Types.h>
+#include <AK/Variant.h>
+#include <LibWasm/AbstractMachine/AbstractMachine.h>
+
+namespace Wasm {
+
+struct BytecodeInterpreter;
+
+}
+
+namespace Wasm::JIT {
+
+// The reasons for which native code can stop executing a function early.
+enum class TrapCode : u64 {
+    None = 0,
+    Unreachable,
+    MemoryAccessOutOfBounds,
+    ExceededInstructionLimit,
+
+    // The trap was raised while calling back into the interpreter, which has already recorded it.
+    Interpreter,
+};
+
+StringView trap_code_reason(TrapCode);
+
+// The state shared between native code and the runtime functions it calls. Native code reads the first
+// few members directly, so their layout must stay in sync with the offsets used by the Compiler.
+struct NativeCallContext {
+    u8* memory_base { nullptr };
+    u64 memory_size { 0 };
+    u64 remaining_loop_iterations { NumericLimits<u64>::max() };
+
+    BytecodeInterpreter* interpreter { nullptr };
+    Configuration* configuration { nullptr };
+    Optional<MemoryAddress> memory_address;
+
+    // Native code caches the base of the default memory, so this has to be called whenever it may have moved.
+    void update_memory();
+};
+
+/**
+ * A NativeExecutable holds the machine code generated by the JIT Compiler for
+ * a single Wasm function.
+ *
+ * The code operates on an array of Values ("slots"), the first of which are
+ * the function's locals, directly followed by its value stack. The height of
+ * the value stack is known statically at every instruction, so the code can
+ * address every value directly; when it returns, the function's results are
+ * stored in the first slots of the value stack.
+ */
+class NativeExecutable {
+    AK_MAKE_NONCOPYABLE(NativeExecutable);
+    AK_MAKE_NONMOVABLE(NativeExecutable);
+
+public:
+    NativeExecutable(void* code, size_t size, size_t local_count, size_t max_stack_height, bool accesses_guarded_memory, Optional<FixedArray<u8>> gdb_object);
+    ~NativeExecutable();
+
+    size_t local_count() const { return m_local_count; }
+    size_t max_stack_height() const { return m_max_stack_height; }
+    ReadonlyBytes code_bytes() const { return { m_code, m_size }; }
+
+    TrapCode run(Value* slots, NativeCallContext&) const;
+
+private:
+    void* m_code { nullptr };
+    size_t m_size { 0 };
+    size_t m_local_count { 0 };
+    size_t m_max_stack_height { 0 };
+    // The code doesn't bounds check accesses to the default memory, as it's a GuardedMemory.
+    bool m_accesses_guarded_memory { false };
+    Optional<FixedArray<u8>> m_gdb_object;
+};
+
+}
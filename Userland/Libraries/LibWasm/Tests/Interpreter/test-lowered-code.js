@@ -0,0 +1,90 @@
+// These exercise what only the lowered form of functions does, so the JIT is disabled for them. The lowered
+// instructions are checked as well, as most of this is about instructions that are fused or left out.
+
+// prettier-ignore
+const binary = new Uint8Array([
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x02, 0x60, 0x01, 0x7f, 0x01, 0x7f,
+    0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x08, 0x07, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+    0x07, 0x46, 0x07, 0x06, 0x73, 0x77, 0x69, 0x74, 0x63, 0x68, 0x00, 0x00, 0x09, 0x63, 0x6f, 0x75,
+    0x6e, 0x74, 0x64, 0x6f, 0x77, 0x6e, 0x00, 0x01, 0x05, 0x66, 0x75, 0x73, 0x65, 0x64, 0x00, 0x02,
+    0x07, 0x62, 0x72, 0x49, 0x66, 0x45, 0x71, 0x7a, 0x00, 0x03, 0x05, 0x69, 0x66, 0x45, 0x71, 0x7a,
+    0x00, 0x04, 0x06, 0x65, 0x71, 0x7a, 0x54, 0x65, 0x65, 0x00, 0x05, 0x0a, 0x62, 0x72, 0x49, 0x66,
+    0x56, 0x61, 0x6c, 0x75, 0x65, 0x73, 0x00, 0x06, 0x0a, 0x9d, 0x01, 0x07, 0x22, 0x00, 0x02, 0x7f,
+    0x02, 0x7f, 0x02, 0x7f, 0x41, 0xe3, 0x00, 0x41, 0x07, 0x20, 0x00, 0x0e, 0x03, 0x00, 0x01, 0x02,
+    0x01, 0x0b, 0x41, 0xe4, 0x00, 0x6a, 0x0c, 0x01, 0x0b, 0x41, 0xc8, 0x01, 0x6a, 0x0b, 0x0b, 0x1e,
+    0x01, 0x01, 0x7f, 0x02, 0x40, 0x03, 0x40, 0x20, 0x01, 0x41, 0x03, 0x6a, 0x21, 0x01, 0x20, 0x00,
+    0x41, 0x01, 0x6b, 0x22, 0x00, 0x0e, 0x01, 0x01, 0x00, 0x0b, 0x0b, 0x20, 0x01, 0x0b, 0x16, 0x01,
+    0x01, 0x7f, 0x20, 0x00, 0x41, 0x05, 0x6b, 0x20, 0x01, 0x6c, 0x21, 0x02, 0x20, 0x01, 0x41, 0x02,
+    0x74, 0x20, 0x02, 0x6a, 0x0b, 0x0f, 0x00, 0x02, 0x7f, 0x41, 0x01, 0x20, 0x00, 0x45, 0x0d, 0x00,
+    0x1a, 0x41, 0x02, 0x0b, 0x0b, 0x0d, 0x00, 0x20, 0x00, 0x45, 0x04, 0x7f, 0x41, 0x0a, 0x05, 0x41,
+    0x14, 0x0b, 0x0b, 0x10, 0x01, 0x01, 0x7f, 0x02, 0x40, 0x20, 0x00, 0x45, 0x22, 0x01, 0x0d, 0x00,
+    0x0b, 0x20, 0x01, 0x0b, 0x13, 0x00, 0x02, 0x7f, 0x41, 0xe3, 0x00, 0x41, 0x01, 0x20, 0x00, 0x45,
+    0x0d, 0x00, 0x1a, 0x1a, 0x41, 0x02, 0x0b, 0x0b,
+]);
+
+const module = parseWebAssemblyModule(binary, undefined, { jit: false });
+
+const invoke = (name, ...args) => {
+    const address = module.getExport(name);
+    expect(address).not.toBeUndefined();
+    return module.invoke(address, ...args);
+};
+
+test("branch tables jump through stubs that move the branch values into place", () => {
+    expect(invoke("switch", 0)).toBe(107);
+    expect(invoke("switch", 1)).toBe(207);
+    expect(invoke("switch", 2)).toBe(7);
+    expect(invoke("switch", 3)).toBe(207);
+    expect(invoke("switch", -1)).toBe(207);
+
+    // Labels used by several entries share a stub, so there's one for each of the three distinct labels.
+    // prettier-ignore
+    expect(module.getLoweredOpcodes("switch")).toEqual([
+        "move", "move", "branch_table",
+        "move", "jump", "move", "jump", "move", "jump",
+        "i32_add", "jump", "i32_add",
+    ]);
+});
+
+test("branch tables can jump back to loops", () => {
+    expect(invoke("countdown", 1)).toBe(3);
+    expect(invoke("countdown", 5)).toBe(15);
+    expect(invoke("countdown", 1000)).toBe(3000);
+    expect(module.getLoweredOpcodes("countdown")).toContain("branch_table");
+});
+
+test("locals and constants are read directly by the instructions that use them", () => {
+    expect(invoke("fused", 7, 3)).toBe(18);
+    expect(invoke("fused", -2, 100)).toBe(-300);
+    expect(invoke("fused", 0x7fffffff, 2)).toBe(-4);
+
+    // The result of i32.mul is also written straight into the local it's stored to.
+    expect(module.getLoweredOpcodes("fused")).toEqual(["i32_sub", "i32_mul", "i32_shl", "i32_add"]);
+});
+
+test("i32.eqz is folded into br_if", () => {
+    expect(invoke("brIfEqz", 0)).toBe(1);
+    expect(invoke("brIfEqz", 1)).toBe(2);
+    expect(invoke("brIfEqz", -1)).toBe(2);
+    expect(module.getLoweredOpcodes("brIfEqz")).toEqual(["move", "jump_if_zero", "move"]);
+
+    expect(invoke("brIfValues", 0)).toBe(1);
+    expect(invoke("brIfValues", 3)).toBe(2);
+    // prettier-ignore
+    expect(module.getLoweredOpcodes("brIfValues")).toEqual([
+        "move", "move", "jump_if_not_zero", "move", "jump", "move",
+    ]);
+});
+
+test("i32.eqz is folded into if", () => {
+    expect(invoke("ifEqz", 0)).toBe(10);
+    expect(invoke("ifEqz", 1)).toBe(20);
+    expect(invoke("ifEqz", -1)).toBe(20);
+    expect(module.getLoweredOpcodes("ifEqz")).toEqual(["jump_if_not_zero", "move", "jump", "move"]);
+});
+
+test("i32.eqz is not folded if its result is used for anything else", () => {
+    expect(invoke("eqzTee", 0)).toBe(1);
+    expect(invoke("eqzTee", 5)).toBe(0);
+    expect(module.getLoweredOpcodes("eqzTee")).toEqual(["i32_eqz", "move", "jump_if_not_zero", "move"]);
+});
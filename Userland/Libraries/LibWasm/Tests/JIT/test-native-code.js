@@ -0,0 +1,89 @@
+// These exercise the functions which are compiled to native code by the JIT, and the same functions lowered for the
+// interpreter, which is what runs them when the JIT is disabled or unsupported.
+
+// prettier-ignore
+const binary = new Uint8Array([
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x17, 0x04, 0x60, 0x01, 0x7f, 0x01, 0x7e,
+    0x60, 0x01, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7f, 0x01,
+    0x7e, 0x03, 0x0b, 0x0a, 0x00, 0x01, 0x03, 0x01, 0x02, 0x02, 0x01, 0x01, 0x01, 0x01, 0x05, 0x03,
+    0x01, 0x00, 0x01, 0x07, 0x45, 0x0a, 0x03, 0x73, 0x75, 0x6d, 0x00, 0x00, 0x06, 0x73, 0x77, 0x69,
+    0x74, 0x63, 0x68, 0x00, 0x01, 0x03, 0x6d, 0x65, 0x6d, 0x00, 0x02, 0x03, 0x66, 0x69, 0x62, 0x00,
+    0x03, 0x03, 0x64, 0x69, 0x76, 0x00, 0x04, 0x04, 0x6d, 0x61, 0x78, 0x75, 0x00, 0x05, 0x04, 0x74,
+    0x72, 0x61, 0x70, 0x00, 0x06, 0x04, 0x67, 0x72, 0x6f, 0x77, 0x00, 0x07, 0x04, 0x73, 0x70, 0x69,
+    0x6e, 0x00, 0x08, 0x04, 0x62, 0x72, 0x69, 0x66, 0x00, 0x09, 0x0a, 0xed, 0x01, 0x0a, 0x2b, 0x02,
+    0x01, 0x7f, 0x01, 0x7e, 0x02, 0x40, 0x20, 0x00, 0x45, 0x0d, 0x00, 0x03, 0x40, 0x20, 0x02, 0x20,
+    0x01, 0xad, 0x20, 0x01, 0xad, 0x7e, 0x7c, 0x21, 0x02, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x22, 0x01,
+    0x20, 0x00, 0x49, 0x0d, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0x0b, 0x24, 0x00, 0x02, 0x40, 0x02, 0x40,
+    0x02, 0x40, 0x02, 0x40, 0x20, 0x00, 0x0e, 0x03, 0x00, 0x01, 0x02, 0x03, 0x0b, 0x41, 0xe4, 0x00,
+    0x0f, 0x0b, 0x41, 0xc8, 0x01, 0x0f, 0x0b, 0x41, 0xac, 0x02, 0x0f, 0x0b, 0x41, 0x7f, 0x0b, 0x14,
+    0x00, 0x20, 0x00, 0x20, 0x01, 0x36, 0x02, 0x00, 0x20, 0x00, 0x32, 0x01, 0x01, 0x20, 0x00, 0x31,
+    0x00, 0x00, 0x7c, 0x0b, 0x1c, 0x00, 0x20, 0x00, 0x41, 0x02, 0x48, 0x04, 0x7f, 0x20, 0x00, 0x05,
+    0x20, 0x00, 0x41, 0x01, 0x6b, 0x10, 0x03, 0x20, 0x00, 0x41, 0x02, 0x6b, 0x10, 0x03, 0x6a, 0x0b,
+    0x0b, 0x0d, 0x00, 0x20, 0x00, 0x20, 0x01, 0x6d, 0x20, 0x00, 0x20, 0x01, 0x6f, 0x6a, 0x0b, 0x0c,
+    0x00, 0x20, 0x00, 0x20, 0x01, 0x20, 0x00, 0x20, 0x01, 0x4b, 0x1b, 0x0b, 0x10, 0x00, 0x20, 0x00,
+    0x04, 0x40, 0x00, 0x0b, 0x20, 0x00, 0x41, 0x03, 0x6c, 0x20, 0x00, 0x74, 0x0b, 0x1f, 0x01, 0x01,
+    0x7f, 0x20, 0x00, 0x40, 0x00, 0x1a, 0x3f, 0x00, 0x41, 0x10, 0x74, 0x41, 0x04, 0x6b, 0x22, 0x01,
+    0x41, 0xb9, 0xe0, 0x00, 0x36, 0x02, 0x00, 0x20, 0x01, 0x28, 0x02, 0x00, 0x0b, 0x0a, 0x00, 0x03,
+    0x40, 0x01, 0x0c, 0x00, 0x0b, 0x41, 0x00, 0x0b, 0x11, 0x00, 0x02, 0x7f, 0x41, 0x05, 0x41, 0x07,
+    0x20, 0x00, 0x0d, 0x00, 0x1a, 0x1a, 0x41, 0x09, 0x0b, 0x0b,
+]);
+
+for (const jit of [true, false]) {
+    describe(jit ? "native code" : "lowered code", () => {
+        const module = parseWebAssemblyModule(binary, undefined, { jit });
+
+        const invoke = (name, ...args) => {
+            const address = module.getExport(name);
+            expect(address).not.toBeUndefined();
+            return module.invoke(address, ...args);
+        };
+
+        test("loops", () => {
+            expect(invoke("sum", 0)).toBe(0n);
+            expect(invoke("sum", 1000)).toBe(332833500n);
+            expect(invoke("sum", 100000)).toBe(333328333350000n);
+        });
+
+        test("branch tables", () => {
+            expect(invoke("switch", 0)).toBe(100);
+            expect(invoke("switch", 1)).toBe(200);
+            expect(invoke("switch", 2)).toBe(300);
+            expect(invoke("switch", 3)).toBe(-1);
+            expect(invoke("switch", 4)).toBe(-1);
+            expect(invoke("switch", -1)).toBe(-1);
+        });
+
+        test("conditional branches with values", () => {
+            expect(invoke("brif", 0)).toBe(9);
+            expect(invoke("brif", 1)).toBe(7);
+        });
+
+        test("calls", () => {
+            expect(invoke("fib", 20)).toBe(6765);
+        });
+
+        test("interpreted instructions", () => {
+            expect(invoke("div", 17, 5)).toBe(5);
+            expect(invoke("div", -17, 5)).toBe(-5);
+            expect(() => invoke("div", 1, 0)).toThrowWithMessage(TypeError, "Execution trapped");
+            expect(invoke("maxu", 3, 7)).toBe(7);
+            expect(invoke("maxu", -1, 7)).toBe(-1);
+        });
+
+        test("memory accesses", () => {
+            expect(invoke("mem", 8, 0x12345678)).toBe(13518n);
+            expect(invoke("mem", 100, -2)).toBe(253n);
+            expect(invoke("mem", 65532, 1)).toBe(1n);
+            expect(() => invoke("mem", 65533, 1)).toThrowWithMessage(TypeError, "Memory access out of bounds");
+            expect(() => invoke("mem", -1, 1)).toThrowWithMessage(TypeError, "Memory access out of bounds");
+            expect(invoke("grow", 1)).toBe(12345);
+            expect(invoke("grow", 2)).toBe(12345);
+        });
+
+        test("traps", () => {
+            expect(invoke("trap", 0)).toBe(0);
+            expect(() => invoke("trap", 5)).toThrowWithMessage(TypeError, "Unreachable");
+            expect(() => invoke("spin")).toThrowWithMessage(TypeError, "Exceeded maximum allowed number of instructions");
+        });
+    });
+}
@@ -0,0 +1,105 @@
+// These check that memories trap on out of bounds accesses and grow the same way whether they're bounds checked or
+// backed by guard pages. Guarded memories don't check bounds at all, they rely on accesses faulting in the guard region.
+
+// prettier-ignore
+const binary = new Uint8Array([
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x14, 0x04, 0x60, 0x01, 0x7f, 0x01, 0x7f,
+    0x60, 0x01, 0x7f, 0x01, 0x7e, 0x60, 0x02, 0x7f, 0x7f, 0x00, 0x60, 0x00, 0x01, 0x7f, 0x03, 0x0a,
+    0x09, 0x00, 0x00, 0x01, 0x00, 0x02, 0x02, 0x02, 0x00, 0x03, 0x05, 0x04, 0x01, 0x01, 0x01, 0x04,
+    0x07, 0x5f, 0x0a, 0x06, 0x6c, 0x6f, 0x61, 0x64, 0x33, 0x32, 0x00, 0x00, 0x09, 0x6c, 0x6f, 0x61,
+    0x64, 0x33, 0x32, 0x46, 0x61, 0x72, 0x00, 0x01, 0x06, 0x6c, 0x6f, 0x61, 0x64, 0x36, 0x34, 0x00,
+    0x02, 0x06, 0x6c, 0x6f, 0x61, 0x64, 0x38, 0x75, 0x00, 0x03, 0x07, 0x73, 0x74, 0x6f, 0x72, 0x65,
+    0x33, 0x32, 0x00, 0x04, 0x06, 0x73, 0x74, 0x6f, 0x72, 0x65, 0x38, 0x00, 0x05, 0x0a, 0x73, 0x74,
+    0x6f, 0x72, 0x65, 0x33, 0x32, 0x46, 0x61, 0x72, 0x00, 0x06, 0x04, 0x67, 0x72, 0x6f, 0x77, 0x00,
+    0x07, 0x04, 0x73, 0x69, 0x7a, 0x65, 0x00, 0x08, 0x06, 0x6d, 0x65, 0x6d, 0x6f, 0x72, 0x79, 0x02,
+    0x00, 0x0a, 0x51, 0x09, 0x07, 0x00, 0x20, 0x00, 0x28, 0x02, 0x00, 0x0b, 0x09, 0x00, 0x20, 0x00,
+    0x28, 0x02, 0x80, 0x80, 0x04, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x29, 0x03, 0x00, 0x0b, 0x07, 0x00,
+    0x20, 0x00, 0x2d, 0x00, 0x00, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x20, 0x01, 0x36, 0x02, 0x00, 0x0b,
+    0x09, 0x00, 0x20, 0x00, 0x20, 0x01, 0x3a, 0x00, 0x00, 0x0b, 0x0d, 0x00, 0x20, 0x00, 0x20, 0x01,
+    0x36, 0x02, 0xff, 0xff, 0xff, 0xff, 0x0f, 0x0b, 0x06, 0x00, 0x20, 0x00, 0x40, 0x00, 0x0b, 0x04,
+    0x00, 0x3f, 0x00, 0x0b,
+]);
+
+const instantiate = (guardedMemories, jit = true) => {
+    const module = parseWebAssemblyModule(binary, undefined, { guardedMemories, jit });
+    const invoke = (name, ...args) => {
+        const address = module.getExport(name);
+        expect(address).not.toBeUndefined();
+        return module.invoke(address, ...args);
+    };
+    return { module, invoke };
+};
+
+test("memories only use guard pages when asked to and supported", () => {
+    expect(instantiate(false).module.getMemory("memory").guarded).toBeFalse();
+    expect(instantiate(true).module.getMemory("memory").guarded).toBe(guardedMemoriesSupported());
+});
+
+test("lowered accesses to guarded memories are not bounds checked", () => {
+    const { module } = instantiate(true, false);
+    const prefix = module.getMemory("memory").guarded ? "guarded_" : "";
+    expect(module.getLoweredOpcodes("load32")).toEqual([`${prefix}i32_load`]);
+    expect(module.getLoweredOpcodes("store32")).toEqual([`${prefix}i32_store`]);
+    expect(instantiate(false, false).module.getLoweredOpcodes("load32")).toEqual(["i32_load"]);
+});
+
+for (const guardedMemories of [false, true]) {
+    const memoryKind = guardedMemories ? "guarded memories" : "bounds checked memories";
+    for (const jit of [true, false]) {
+        describe(`${memoryKind}, ${jit ? "native code" : "lowered code"}`, () => {
+            test("out of bounds loads trap", () => {
+                const { invoke } = instantiate(guardedMemories, jit);
+                expect(invoke("load32", 65532)).toBe(0);
+                expect(() => invoke("load32", 65533)).toThrowWithMessage(TypeError, "Memory access out of bounds");
+                expect(() => invoke("load32", 65536)).toThrowWithMessage(TypeError, "Memory access out of bounds");
+                expect(() => invoke("load32", -1)).toThrowWithMessage(TypeError, "Memory access out of bounds");
+                expect(() => invoke("load32Far", 0)).toThrowWithMessage(TypeError, "Memory access out of bounds");
+                expect(() => invoke("load32Far", -65536)).toThrowWithMessage(TypeError, "Memory access out of bounds");
+                expect(invoke("load64", 65528)).toBe(0n);
+                expect(() => invoke("load64", 65529)).toThrowWithMessage(TypeError, "Memory access out of bounds");
+                expect(invoke("load8u", 65535)).toBe(0);
+                expect(() => invoke("load8u", 65536)).toThrowWithMessage(TypeError, "Memory access out of bounds");
+            });
+
+            test("out of bounds stores trap", () => {
+                const { invoke } = instantiate(guardedMemories, jit);
+                expect(() => invoke("store32", 65533, 1)).toThrowWithMessage(TypeError, "Memory access out of bounds");
+                expect(() => invoke("store8", 65536, 1)).toThrowWithMessage(TypeError, "Memory access out of bounds");
+                expect(() => invoke("store32", -4, 1)).toThrowWithMessage(TypeError, "Memory access out of bounds");
+                expect(() => invoke("store32Far", 0, 1)).toThrowWithMessage(TypeError, "Memory access out of bounds");
+                expect(() => invoke("store32Far", -1, 1)).toThrowWithMessage(TypeError, "Memory access out of bounds");
+
+                // The module keeps working after a trap.
+                invoke("store32", 0, 42);
+                expect(invoke("load32", 0)).toBe(42);
+                invoke("store8", 65535, 0xff);
+                expect(invoke("load8u", 65535)).toBe(0xff);
+            });
+
+            test("memory.grow makes more of the memory accessible", () => {
+                const { module, invoke } = instantiate(guardedMemories, jit);
+                const before = module.getMemory("memory");
+                invoke("store32", 65532, 0x12345678);
+
+                expect(invoke("grow", 1)).toBe(1);
+                expect(invoke("size")).toBe(2);
+                const after = module.getMemory("memory");
+                expect(after.size).toBe(2 * 65536);
+                // Guarded memories grow in place instead of being copied.
+                if (after.guarded) expect(after.base).toBe(before.base);
+
+                expect(invoke("load32", 65532)).toBe(0x12345678);
+                expect(invoke("load32", 65536)).toBe(0);
+                expect(invoke("load32Far", 0)).toBe(0);
+                expect(invoke("load32", 131068)).toBe(0);
+                expect(() => invoke("load32", 131069)).toThrowWithMessage(TypeError, "Memory access out of bounds");
+
+                // Growing past the maximum fails and leaves the memory alone.
+                expect(invoke("grow", 3)).toBe(-1);
+                expect(invoke("size")).toBe(2);
+                expect(module.getMemory("memory").base).toBe(after.base);
+                expect(() => invoke("store32", 131069, 1)).toThrowWithMessage(TypeError, "Memory access out of bounds");
+            });
+        });
+    }
+}
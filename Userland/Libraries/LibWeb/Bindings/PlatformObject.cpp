@@ -399,6 +399,22 @@ JS::ThrowCompletionOr<bool> PlatformObject::internal_prevent_extensions()
     return false;
 }
 
+bool PlatformObject::has_ordinary_set_and_define_own_property() const
+{
+    // Only legacy platform objects that aren't global objects have their own [[Set]] and [[DefineOwnProperty]].
+    if (m_legacy_platform_object_flags.has_value() && !m_legacy_platform_object_flags->has_global_interface_extended_attribute)
+        return false;
+    return Base::has_ordinary_set_and_define_own_property();
+}
+
+bool PlatformObject::eligible_for_own_property_enumeration_fast_path() const
+{
+    // Legacy platform objects have supported property names and indices on top of their own properties.
+    if (m_legacy_platform_object_flags.has_value() && !m_legacy_platform_object_flags->has_global_interface_extended_attribute)
+        return false;
+    return Base::eligible_for_own_property_enumeration_fast_path();
+}
+
 // https://webidl.spec.whatwg.org/#legacy-platform-object-ownpropertykeys
 JS::ThrowCompletionOr<JS::MarkedVector<JS::Value>> PlatformObject::internal_own_property_keys() const
 {
@@ -6,6 +6,7 @@
 
 #include <AK/Debug.h>
 #include <LibCore/ElapsedTimer.h>
+#include <LibJS/BackgroundParser.h>
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibWeb/Bindings/ExceptionOrUtils.h>
 #include <LibWeb/HTML/Scripting/ClassicScript.h>
@@ -18,8 +19,52 @@ namespace Web::HTML {
 
 JS_DEFINE_ALLOCATOR(ClassicScript);
 
+// Scripts smaller than this are parsed on the spot, as that's quicker than handing them to another thread and back.
+static constexpr size_t min_source_length_for_background_parsing = 32 * KiB;
+
 // https://html.spec.whatwg.org/multipage/webappapis.html#creating-a-classic-script
 JS::NonnullGCPtr<ClassicScript> ClassicScript::create(ByteString filename, StringView source, EnvironmentSettingsObject& environment_settings_object, URL::URL base_url, size_t source_line_number, MutedErrors muted_errors)
+{
+    // 3. If scripting is disabled for settings, then set source to the empty string.
+    if (environment_settings_object.is_scripting_disabled())
+        source = ""sv;
+
+    auto script = create_without_record(move(filename), environment_settings_object, move(base_url), muted_errors);
+
+    // 10. Let result be ParseScript(source, settings's Realm, script).
+    auto parse_timer = Core::ElapsedTimer::start_new();
+    auto result = JS::Script::parse(source, environment_settings_object.realm(), script->filename(), script, source_line_number);
+    dbgln_if(HTML_SCRIPT_DEBUG, "ClassicScript: Parsed {} in {}ms", script->filename(), parse_timer.elapsed());
+
+    script->set_parse_result(move(result));
+
+    // 13. Return script.
+    return script;
+}
+
+void ClassicScript::create_with_background_parsing(ByteString filename, StringView source, EnvironmentSettingsObject& environment_settings_object, URL::URL base_url, size_t source_line_number, MutedErrors muted_errors, Function<void(JS::NonnullGCPtr<ClassicScript>)> on_complete)
+{
+    if (source.length() < min_source_length_for_background_parsing || environment_settings_object.is_scripting_disabled()) {
+        on_complete(create(move(filename), source, environment_settings_object, move(base_url), source_line_number, muted_errors));
+        return;
+    }
+
+    auto& vm = environment_settings_object.realm().vm();
+    vm.background_parser().parse(source, filename, source_line_number, JS::Program::Type::Script,
+        [filename, settings_object = JS::make_handle(environment_settings_object), base_url = move(base_url), muted_errors, on_complete = move(on_complete)](auto program_or_errors) mutable {
+            dbgln_if(HTML_SCRIPT_DEBUG, "ClassicScript: Parsed {} in the background", filename);
+
+            auto script = create_without_record(move(filename), *settings_object, move(base_url), muted_errors);
+            if (program_or_errors.is_error())
+                script->set_parse_result(program_or_errors.release_error());
+            else
+                script->set_parse_result(JS::Script::create(settings_object->realm(), script->filename(), program_or_errors.release_value(), script));
+            on_complete(script);
+        });
+}
+
+// Steps 1 to 9 of https://html.spec.whatwg.org/multipage/webappapis.html#creating-a-classic-script
+JS::NonnullGCPtr<ClassicScript> ClassicScript::create_without_record(ByteString filename, EnvironmentSettingsObject& environment_settings_object, URL::URL base_url, MutedErrors muted_errors)
 {
     auto& vm = environment_settings_object.realm().vm();
 
@@ -29,9 +74,7 @@ JS::NonnullGCPtr<ClassicScript> ClassicScript::create(ByteString filename, Strin
     if (muted_errors == MutedErrors::Yes)
         base_url = "about:blank"sv;
 
-    // 3. If scripting is disabled for settings, then set source to the empty string.
-    if (environment_settings_object.is_scripting_disabled())
-        source = ""sv;
+    // 3. If scripting is disabled for settings, then set source to the empty string. (NOTE: This is done by the callers.)
 
     // 4. Let script be a new classic script that this algorithm will subsequently initialize.
     auto script = vm.heap().allocate_without_realm<ClassicScript>(move(base_url), move(filename), environment_settings_object);
@@ -49,29 +92,27 @@ JS::NonnullGCPtr<ClassicScript> ClassicScript::create(ByteString filename, Strin
     script->set_parse_error(JS::js_null());
     script->set_error_to_rethrow(JS::js_null());
 
-    // 10. Let result be ParseScript(source, settings's Realm, script).
-    auto parse_timer = Core::ElapsedTimer::start_new();
-    auto result = JS::Script::parse(source, environment_settings_object.realm(), script->filename(), script, source_line_number);
-    dbgln_if(HTML_SCRIPT_DEBUG, "ClassicScript: Parsed {} in {}ms", script->filename(), parse_timer.elapsed());
+    return script;
+}
 
+// Steps 11 and 12 of https://html.spec.whatwg.org/multipage/webappapis.html#creating-a-classic-script
+void ClassicScript::set_parse_result(Result<JS::NonnullGCPtr<JS::Script>, Vector<JS::ParserError>> result)
+{
     // 11. If result is a list of errors, then:
     if (result.is_error()) {
         auto& parse_error = result.error().first();
         dbgln_if(HTML_SCRIPT_DEBUG, "ClassicScript: Failed to parse: {}", parse_error.to_string());
 
         // 1. Set script's parse error and its error to rethrow to result[0].
-        script->set_parse_error(JS::SyntaxError::create(environment_settings_object.realm(), parse_error.to_string()));
-        script->set_error_to_rethrow(script->parse_error());
+        set_parse_error(JS::SyntaxError::create(settings_object().realm(), parse_error.to_string()));
+        set_error_to_rethrow(this->parse_error());
 
         // 2. Return script.
-        return script;
+        return;
     }
 
     // 12. Set script's record to result.
-    script->m_script_record = *result.release_value();
-
-    // 13. Return script.
-    return script;
+    m_script_record = *result.release_value();
 }
 
 // https://html.spec.whatwg.org/multipage/webappapis.html#run-a-classic-script
@@ -371,11 +371,12 @@ WebIDL::ExceptionOr<void> fetch_classic_script(JS::NonnullGCPtr<HTMLScriptElemen
         // 7. Let script be the result of creating a classic script given source text, settings object, response's URL,
         //    options, and muted errors.
         // FIXME: Pass options.
+        // NOTE: Large scripts are parsed on a background thread, so they don't hold up everything else in the meantime.
         auto response_url = response->url().value_or({});
-        auto script = ClassicScript::create(response_url.to_byte_string(), source_text, settings_object, response_url, 1, muted_errors);
-
-        // 8. Run onComplete given script.
-        on_complete->function()(script);
+        ClassicScript::create_with_background_parsing(response_url.to_byte_string(), source_text, settings_object, response_url, 1, muted_errors, [on_complete = JS::make_handle(on_complete)](auto script) {
+            // 8. Run onComplete given script.
+            on_complete->function()(script);
+        });
     };
 
     TRY(Fetch::Fetching::fetch(element->realm(), request, Fetch::Infrastructure::FetchAlgorithms::create(vm, move(fetch_algorithms_input))));
@@ -827,8 +828,15 @@ void fetch_single_module_script(JS::Realm& realm,
 
         // 7. If mimeType is a JavaScript MIME type and moduleType is "javascript", then set moduleScript to the result of creating a JavaScript module script given sourceText, settingsObject, response's URL, and options.
         // FIXME: Pass options.
-        if (mime_type->is_javascript() && module_type == "javascript")
-            module_script = JavaScriptModuleScript::create(url.basename(), source_text, settings_object, response->url().value_or({})).release_value_but_fixme_should_propagate_errors();
+        // NOTE: Large modules are parsed on a background thread, so they don't hold up everything else in the meantime.
+        if (mime_type->is_javascript() && module_type == "javascript") {
+            JavaScriptModuleScript::create_with_background_parsing(url.basename(), source_text, settings_object, response->url().value_or({}), [module_map = JS::make_handle(module_map), url, module_type, on_complete = JS::make_handle(on_complete)](auto module_script) {
+                // 10. Set moduleMap[(url, moduleType)] to moduleScript, and run onComplete given moduleScript.
+                module_map->set(url, module_type, { ModuleMap::EntryType::ModuleScript, module_script });
+                on_complete->function()(module_script);
+            });
+            return;
+        }
 
         // FIXME: 8. If the MIME type essence of mimeType is "text/css" and moduleType is "css", then set moduleScript to the result of creating a CSS module script given sourceText and settingsObject.
         // FIXME: 9. If mimeType is a JSON MIME type and moduleType is "json", then set moduleScript to the result of creating a JSON module script given sourceText and settingsObject.
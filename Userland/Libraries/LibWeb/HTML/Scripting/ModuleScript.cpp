@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibJS/BackgroundParser.h>
 #include <LibJS/Runtime/ModuleRequest.h>
 #include <LibWeb/HTML/Scripting/Environments.h>
 #include <LibWeb/HTML/Scripting/Fetching.h>
@@ -29,6 +30,9 @@ JavaScriptModuleScript::JavaScriptModuleScript(URL::URL base_url, ByteString fil
 {
 }
 
+// Modules smaller than this are parsed on the spot, as that's quicker than handing them to another thread and back.
+static constexpr size_t min_source_length_for_background_parsing = 32 * KiB;
+
 // https://html.spec.whatwg.org/multipage/webappapis.html#creating-a-javascript-module-script
 WebIDL::ExceptionOr<JS::GCPtr<JavaScriptModuleScript>> JavaScriptModuleScript::create(ByteString const& filename, StringView source, EnvironmentSettingsObject& settings_object, URL::URL base_url)
 {
@@ -36,6 +40,40 @@ WebIDL::ExceptionOr<JS::GCPtr<JavaScriptModuleScript>> JavaScriptModuleScript::c
     if (settings_object.is_scripting_disabled())
         source = ""sv;
 
+    auto script = create_without_record(filename, settings_object, move(base_url));
+
+    // 7. Let result be ParseModule(source, settings's Realm, script).
+    auto result = JS::SourceTextModule::parse(source, settings_object.realm(), filename.view(), script);
+
+    script->set_parse_result(move(result));
+
+    // 11. Return script.
+    return script;
+}
+
+void JavaScriptModuleScript::create_with_background_parsing(ByteString const& filename, StringView source, EnvironmentSettingsObject& settings_object, URL::URL base_url, Function<void(JS::NonnullGCPtr<JavaScriptModuleScript>)> on_complete)
+{
+    if (source.length() < min_source_length_for_background_parsing || settings_object.is_scripting_disabled()) {
+        auto script = create(filename, source, settings_object, move(base_url)).release_value_but_fixme_should_propagate_errors();
+        on_complete(*script);
+        return;
+    }
+
+    auto& vm = settings_object.realm().vm();
+    vm.background_parser().parse(source, filename, 0, JS::Program::Type::Module,
+        [filename, settings_object = JS::make_handle(settings_object), base_url = move(base_url), on_complete = move(on_complete)](auto program_or_errors) mutable {
+            auto script = create_without_record(filename, *settings_object, move(base_url));
+            if (program_or_errors.is_error())
+                script->set_parse_result(program_or_errors.release_error());
+            else
+                script->set_parse_result(JS::SourceTextModule::create(settings_object->realm(), filename, program_or_errors.release_value(), script));
+            on_complete(script);
+        });
+}
+
+// Steps 2 to 6 of https://html.spec.whatwg.org/multipage/webappapis.html#creating-a-javascript-module-script
+JS::NonnullGCPtr<JavaScriptModuleScript> JavaScriptModuleScript::create_without_record(ByteString const& filename, EnvironmentSettingsObject& settings_object, URL::URL base_url)
+{
     auto& realm = settings_object.realm();
 
     // 2. Let script be a new module script that this algorithm will subsequently initialize.
@@ -53,8 +91,13 @@ WebIDL::ExceptionOr<JS::GCPtr<JavaScriptModuleScript>> JavaScriptModuleScript::c
     script->set_parse_error(JS::js_null());
     script->set_error_to_rethrow(JS::js_null());
 
-    // 7. Let result be ParseModule(source, settings's Realm, script).
-    auto result = JS::SourceTextModule::parse(source, settings_object.realm(), filename.view(), script);
+    return script;
+}
+
+// Steps 8 to 10 of https://html.spec.whatwg.org/multipage/webappapis.html#creating-a-javascript-module-script
+void JavaScriptModuleScript::set_parse_result(Result<JS::NonnullGCPtr<JS::SourceTextModule>, Vector<JS::ParserError>> result)
+{
+    auto& settings = settings_object();
 
     // 8. If result is a list of errors, then:
     if (result.is_error()) {
@@ -62,10 +105,10 @@ WebIDL::ExceptionOr<JS::GCPtr<JavaScriptModuleScript>> JavaScriptModuleScript::c
         dbgln("JavaScriptModuleScript: Failed to parse: {}", parse_error.to_string());
 
         // 1. Set script's parse error to result[0].
-        script->set_parse_error(JS::SyntaxError::create(settings_object.realm(), parse_error.to_string()));
+        set_parse_error(JS::SyntaxError::create(settings.realm(), parse_error.to_string()));
 
         // 2. Return script.
-        return script;
+        return;
     }
 
     // 9. For each ModuleRequest record requested of result.[[RequestedModules]]:
@@ -75,46 +118,43 @@ WebIDL::ExceptionOr<JS::GCPtr<JavaScriptModuleScript>> JavaScriptModuleScript::c
         for (auto const& attribute : requested.attributes) {
             if (attribute.key != "type"sv) {
                 // 1. Let error be a new SyntaxError exception.
-                auto error = JS::SyntaxError::create(settings_object.realm(), "Module request attributes must only contain a type attribute"_string);
+                auto error = JS::SyntaxError::create(settings.realm(), "Module request attributes must only contain a type attribute"_string);
 
                 // 2. Set script's parse error to error.
-                script->set_parse_error(error);
+                set_parse_error(error);
 
                 // 3. Return script.
-                return script;
+                return;
             }
         }
 
         // 2. Let url be the result of resolving a module specifier given script and requested.[[Specifier]], catching any exceptions.
-        auto url = resolve_module_specifier(*script, requested.module_specifier);
+        auto url = resolve_module_specifier(*this, requested.module_specifier);
 
         // 3. If the previous step threw an exception, then:
         if (url.is_exception()) {
             // FIXME: 1. Set script's parse error to that exception.
 
             // 2. Return script.
-            return script;
+            return;
         }
 
         // 4. Let moduleType be the result of running the module type from module request steps given requested.
         auto module_type = module_type_from_module_request(requested);
 
         // 5. If the result of running the module type allowed steps given moduleType and settings is false, then:
-        if (!settings_object.module_type_allowed(module_type)) {
+        if (!settings.module_type_allowed(module_type)) {
             // FIXME: 1. Let error be a new TypeError exception.
 
             // FIXME: 2. Set script's parse error to error.
 
             // 3. Return script.
-            return script;
+            return;
         }
     }
 
     // 10. Set script's record to result.
-    script->m_record = result.value();
-
-    // 11. Return script.
-    return script;
+    m_record = result.value();
 }
 
 // https://html.spec.whatwg.org/multipage/webappapis.html#run-a-module-script
@@ -31,6 +31,10 @@ public:
 
     static WebIDL::ExceptionOr<JS::GCPtr<JavaScriptModuleScript>> create(ByteString const& filename, StringView source, EnvironmentSettingsObject&, URL::URL base_url);
 
+    // Like create(), but large modules are parsed on a background thread. on_complete is invoked with the script once it
+    // has been created, which may happen before this returns.
+    static void create_with_background_parsing(ByteString const& filename, StringView source, EnvironmentSettingsObject&, URL::URL base_url, Function<void(JS::NonnullGCPtr<JavaScriptModuleScript>)> on_complete);
+
     enum class PreventErrorReporting {
         Yes,
         No
@@ -47,6 +51,9 @@ protected:
 private:
     virtual void visit_edges(JS::Cell::Visitor&) override;
 
+    static JS::NonnullGCPtr<JavaScriptModuleScript> create_without_record(ByteString const& filename, EnvironmentSettingsObject&, URL::URL base_url);
+    void set_parse_result(Result<JS::NonnullGCPtr<JS::SourceTextModule>, Vector<JS::ParserError>>);
+
     JS::GCPtr<JS::SourceTextModule> m_record;
 
     size_t m_fetch_internal_request_count { 0 };
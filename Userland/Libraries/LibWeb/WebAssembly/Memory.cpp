@@ -111,7 +111,12 @@ WebIDL::ExceptionOr<JS::NonnullGCPtr<JS::ArrayBuffer>> Memory::create_a_memory_b
     if (!memory)
         return vm.throw_completion<JS::RangeError>("Could not find the memory instance"sv);
 
-    auto array_buffer = JS::ArrayBuffer::create(realm, &memory->data());
+    // NOTE: LibWeb never enables guarded memories, which can't be exposed as an ArrayBuffer.
+    auto* byte_buffer = memory->byte_buffer();
+    if (!byte_buffer)
+        return vm.throw_completion<JS::InternalError>("Guarded memories can't be exposed as an ArrayBuffer"sv);
+
+    auto array_buffer = JS::ArrayBuffer::create(realm, byte_buffer);
     array_buffer->set_detach_key(JS::PrimitiveString::create(vm, "WebAssembly.Memory"_string));
 
     return JS::NonnullGCPtr(*array_buffer);
@@ -58,6 +58,7 @@ JS::ThrowCompletionOr<void> ObservableArray::append(JS::Value value)
     if (m_on_set_an_indexed_value)
         TRY(Bindings::throw_dom_exception_if_needed(vm(), [&] { return m_on_set_an_indexed_value->function()(value); }));
     indexed_properties().append(value);
+    did_store_edge(value);
     return {};
 }
 
@@ -111,4 +111,17 @@ void ConnectionFromClient::ready_for_next_result(SQL::StatementID statement_id,
     async_execution_error(statement_id, execution_id, SQL::SQLErrorCode::StatementUnavailable, ByteString::formatted("{}", statement_id));
 }
 
+Messages::SQLServer::BlockCacheStatisticsResponse ConnectionFromClient::block_cache_statistics(SQL::ConnectionID connection_id)
+{
+    dbgln_if(SQLSERVER_DEBUG, "ConnectionFromClient::block_cache_statistics(connection_id: {})", connection_id);
+
+    auto database_connection = DatabaseConnection::connection_for(connection_id);
+    if (!database_connection) {
+        dbgln("Database connection has disappeared");
+        return Optional<SQL::BlockCacheStatistics> {};
+    }
+
+    return { database_connection->database()->block_cache_statistics() };
+}
+
 }
@@ -5,6 +5,7 @@
  */
 
 #include <AK/LexicalPath.h>
+#include <LibCore/EventLoop.h>
 #include <SQLServer/DatabaseConnection.h>
 #include <SQLServer/SQLStatement.h>
 
@@ -13,6 +14,10 @@ namespace SQLServer {
 static HashMap<SQL::ConnectionID, NonnullRefPtr<DatabaseConnection>> s_connections;
 static SQL::ConnectionID s_next_connection_id = 0;
 
+// Callbacks waiting for the next sync of each database. Every statement committed before that sync runs shares
+// its single fsync, regardless of the connection it was executed on.
+static HashMap<SQL::Database*, Vector<Function<void(ErrorOr<void> const&)>>> s_pending_syncs;
+
 static ErrorOr<NonnullRefPtr<SQL::Database>> find_or_create_database(StringView database_path, StringView database_name)
 {
     for (auto const& connection : s_connections) {
@@ -43,6 +48,8 @@ ErrorOr<NonnullRefPtr<DatabaseConnection>> DatabaseConnection::create(StringView
             warnln("Could not open database: {}", result.error().error_string());
             return Error::from_string_view("Could not open database"sv);
         }
+
+        database->set_defers_sync(true);
     }
 
     return adopt_nonnull_ref_or_enomem(new (nothrow) DatabaseConnection(move(database), move(database_name), client_id));
@@ -72,4 +79,21 @@ SQL::ResultOr<SQL::StatementID> DatabaseConnection::prepare_statement(StringView
     return statement->statement_id();
 }
 
+void DatabaseConnection::after_sync(Function<void(ErrorOr<void> const&)> callback)
+{
+    auto& callbacks = s_pending_syncs.ensure(m_database.ptr(), [&]() {
+        Core::deferred_invoke([database = m_database]() {
+            auto callbacks = s_pending_syncs.take(database.ptr()).release_value();
+            auto result = database->sync();
+
+            for (auto& callback : callbacks)
+                callback(result);
+        });
+
+        return Vector<Function<void(ErrorOr<void> const&)>> {};
+    });
+
+    callbacks.append(move(callback));
+}
+
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Function.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/RefCounted.h>
 #include <LibSQL/Database.h>
@@ -27,6 +28,9 @@ public:
     void disconnect();
     SQL::ResultOr<SQL::StatementID> prepare_statement(StringView sql);
 
+    // Invokes the callback once everything committed to this connection's database so far is durable.
+    void after_sync(Function<void(ErrorOr<void> const&)>);
+
 private:
     DatabaseConnection(NonnullRefPtr<SQL::Database> database, ByteString database_name, int client_id);
 
@@ -4,8 +4,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/TypeCasts.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/EventReceiver.h>
+#include <LibSQL/AST/Operators.h>
 #include <LibSQL/AST/Parser.h>
 #include <SQLServer/ConnectionFromClient.h>
 #include <SQLServer/DatabaseConnection.h>
@@ -70,7 +72,13 @@ Optional<SQL::ExecutionID> SQLStatement::execute(Vector<SQL::Value> placeholder_
 
     auto execution_id = m_next_execution_id++;
 
-    Core::deferred_invoke([this, strong_this = NonnullRefPtr(*this), placeholder_values = move(placeholder_values), execution_id] {
+    Core::deferred_invoke([this, strong_this = NonnullRefPtr(*this), placeholder_values = move(placeholder_values), execution_id]() mutable {
+        if (is<SQL::AST::Select>(*m_statement)) {
+            if (auto result = execute_select(static_cast<SQL::AST::Select const&>(*m_statement), move(placeholder_values), execution_id); result.is_error())
+                report_error(result.release_error(), execution_id);
+            return;
+        }
+
         auto execution_result = m_statement->execute(connection().database(), placeholder_values);
 
         if (execution_result.is_error()) {
@@ -78,35 +86,104 @@ Optional<SQL::ExecutionID> SQLStatement::execute(Vector<SQL::Value> placeholder_
             return;
         }
 
-        auto client_connection = ConnectionFromClient::client_connection_for(connection().client_id());
-        if (!client_connection) {
-            warnln("Cannot return statement execution results. Client disconnected");
-            return;
-        }
+        // Only report success once the statement's changes are durable. Statements executed while waiting for
+        // the sync are committed along with this one.
+        connection().after_sync([this, strong_this = NonnullRefPtr(*this), result = execution_result.release_value(), execution_id](ErrorOr<void> const& sync_result) mutable {
+            if (sync_result.is_error()) {
+                report_error(Error::copy(sync_result.error()), execution_id);
+                return;
+            }
 
-        auto result = execution_result.release_value();
-        auto result_size = result.size();
-
-        if (should_send_result_rows(result)) {
-            client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), true, 0, 0, 0);
-
-            m_ongoing_executions.set(execution_id, { move(result), result_size });
-            ready_for_next_result(execution_id);
-        } else {
-            if (result.command() == SQL::SQLCommand::Insert)
-                client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, result_size, 0, 0);
-            else if (result.command() == SQL::SQLCommand::Update)
-                client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, result_size, 0);
-            else if (result.command() == SQL::SQLCommand::Delete)
-                client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, 0, result_size);
-            else
-                client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, 0, 0);
-        }
+            send_execution_result(move(result), execution_id);
+        });
     });
 
     return execution_id;
 }
 
+void SQLStatement::send_execution_result(SQL::ResultSet result, SQL::ExecutionID execution_id)
+{
+    auto client_connection = ConnectionFromClient::client_connection_for(connection().client_id());
+    if (!client_connection) {
+        warnln("Cannot return statement execution results. Client disconnected");
+        return;
+    }
+
+    auto result_size = result.size();
+
+    if (should_send_result_rows(result)) {
+        client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), true, 0, 0, 0);
+
+        m_ongoing_executions.set(execution_id, { move(result), nullptr, result_size });
+        ready_for_next_result(execution_id);
+    } else {
+        if (result.command() == SQL::SQLCommand::Insert)
+            client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, result_size, 0, 0);
+        else if (result.command() == SQL::SQLCommand::Update)
+            client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, result_size, 0);
+        else if (result.command() == SQL::SQLCommand::Delete)
+            client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, 0, result_size);
+        else
+            client_connection->async_execution_success(statement_id(), execution_id, result.column_names(), false, 0, 0, 0);
+    }
+}
+
+SQL::ResultOr<void> SQLStatement::execute_select(SQL::AST::Select const& select, Vector<SQL::Value> placeholder_values, SQL::ExecutionID execution_id)
+{
+    auto cursor = TRY(SQL::AST::Cursor::create(connection().database(), select, move(placeholder_values)));
+    Execution execution { {}, move(cursor), 0 };
+
+    // Produce the first batch of rows before reporting success, so that errors raised while reading them are
+    // reported in place of the success message, and so that the client is told whether there are any rows.
+    auto rows = TRY(take_next_rows(execution));
+
+    auto client_connection = ConnectionFromClient::client_connection_for(connection().client_id());
+    if (!client_connection) {
+        warnln("Cannot return statement execution results. Client disconnected");
+        return {};
+    }
+
+    auto has_results = !rows.is_empty();
+    client_connection->async_execution_success(statement_id(), execution_id, execution.cursor->column_names(), has_results, 0, 0, 0);
+
+    if (has_results) {
+        m_ongoing_executions.set(execution_id, move(execution));
+        client_connection->async_next_results(statement_id(), execution_id, move(rows));
+    }
+
+    return {};
+}
+
+SQL::ResultOr<Vector<Vector<SQL::Value>>> SQLStatement::take_next_rows(Execution& execution)
+{
+    Vector<Vector<SQL::Value>> rows;
+
+    if (execution.result.has_value()) {
+        auto& result = *execution.result;
+        auto count = min(result.size(), max_rows_per_batch);
+
+        TRY(rows.try_ensure_capacity(count));
+        for (size_t i = 0; i < count; ++i)
+            rows.unchecked_append(result[i].row.take_data());
+
+        result.remove(0, count);
+        return rows;
+    }
+
+    VERIFY(execution.cursor);
+
+    while (rows.size() < max_rows_per_batch) {
+        auto row = TRY(execution.cursor->next());
+        if (!row.has_value())
+            break;
+
+        TRY(rows.try_append(row->take_data()));
+        ++execution.result_size;
+    }
+
+    return rows;
+}
+
 void SQLStatement::ready_for_next_result(SQL::ExecutionID execution_id)
 {
     auto client_connection = ConnectionFromClient::client_connection_for(connection().client_id());
@@ -120,14 +197,20 @@ void SQLStatement::ready_for_next_result(SQL::ExecutionID execution_id)
         return;
     }
 
-    if (execution->result.is_empty()) {
+    auto rows = take_next_rows(*execution);
+    if (rows.is_error()) {
+        m_ongoing_executions.remove(execution_id);
+        report_error(rows.release_error(), execution_id);
+        return;
+    }
+
+    if (rows.value().is_empty()) {
         client_connection->async_results_exhausted(statement_id(), execution_id, execution->result_size);
         m_ongoing_executions.remove(execution_id);
         return;
     }
 
-    auto result_row = execution->result.take_first();
-    client_connection->async_next_result(statement_id(), execution_id, result_row.row.take_data());
+    client_connection->async_next_results(statement_id(), execution_id, rows.release_value());
 }
 
 bool SQLStatement::should_send_result_rows(SQL::ResultSet const& result) const
@@ -137,6 +220,7 @@ bool SQLStatement::should_send_result_rows(SQL::ResultSet const& result) const
 
     switch (result.command()) {
     case SQL::SQLCommand::Describe:
+    case SQL::SQLCommand::Explain:
     case SQL::SQLCommand::Select:
         return true;
     default:
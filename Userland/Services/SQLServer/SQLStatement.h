@@ -7,9 +7,11 @@
 #pragma once
 
 #include <AK/NonnullRefPtr.h>
+#include <AK/OwnPtr.h>
 #include <AK/RefCounted.h>
 #include <AK/Vector.h>
 #include <LibSQL/AST/AST.h>
+#include <LibSQL/AST/Operators.h>
 #include <LibSQL/Result.h>
 #include <LibSQL/ResultSet.h>
 #include <LibSQL/Type.h>
@@ -31,14 +33,27 @@ public:
 private:
     SQLStatement(DatabaseConnection&, NonnullRefPtr<SQL::AST::Statement> statement);
 
+    struct Execution;
+
+    SQL::ResultOr<void> execute_select(SQL::AST::Select const&, Vector<SQL::Value> placeholder_values, SQL::ExecutionID);
+    SQL::ResultOr<Vector<Vector<SQL::Value>>> take_next_rows(Execution&);
+
+    void send_execution_result(SQL::ResultSet, SQL::ExecutionID);
     bool should_send_result_rows(SQL::ResultSet const& result) const;
     void report_error(SQL::Result, SQL::ExecutionID execution_id);
 
     DatabaseConnection& m_connection;
     SQL::StatementID m_statement_id { 0 };
 
+    // Rows are sent to the client in batches of at most this many rows, each of which the client acknowledges
+    // before the next one is produced.
+    static constexpr size_t max_rows_per_batch = 64;
+
     struct Execution {
-        SQL::ResultSet result;
+        // SELECT statements produce their rows through a cursor as the client asks for them. All other
+        // statements are executed up front, and their rows are sent from the complete result set.
+        Optional<SQL::ResultSet> result;
+        OwnPtr<SQL::AST::Cursor> cursor;
         size_t result_size { 0 };
     };
     HashMap<SQL::ExecutionID, Execution> m_ongoing_executions;
@@ -24,6 +24,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     Optional<size_t> unified_format_context;
     Optional<size_t> context_format_context;
+    StringView algorithm_name = "myers"sv;
 
     StringView filename1;
     StringView filename2;
@@ -34,8 +35,15 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     parser.add_option(context, "Write diff in context format", nullptr, 'c');
     parser.add_option(unified_format_context, "Write diff in unified format with the given number of context lines", "unified", 'U', "lines");
     parser.add_option(context_format_context, "Write diff in context format with the given number of context lines", "context", 'C', "lines");
+    parser.add_option(algorithm_name, "Diff algorithm to use: myers (default) or patience", "diff-algorithm", 0, "algorithm");
     parser.parse(arguments);
 
+    auto algorithm = Diff::algorithm_from_name(algorithm_name);
+    if (!algorithm.has_value()) {
+        warnln("diff: Unknown diff algorithm '{}'", algorithm_name);
+        return 2;
+    }
+
     auto file1 = TRY(Core::File::open(filename1, Core::File::OpenMode::Read));
     auto file2 = TRY(Core::File::open(filename2, Core::File::OpenMode::Read));
     auto out = TRY(Core::File::standard_output());
@@ -55,7 +63,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         number_context_lines = 3;
     }
 
-    auto hunks = TRY(Diff::from_text(TRY(file1->read_until_eof()), TRY(file2->read_until_eof()), number_context_lines));
+    auto hunks = TRY(Diff::from_text(TRY(file1->read_until_eof()), TRY(file2->read_until_eof()), number_context_lines, *algorithm));
 
     if (hunks.is_empty())
         return 0;
@@ -11,19 +11,23 @@
 #include <AK/StringBuilder.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/ConfigFile.h>
+#include <LibCore/File.h>
 #include <LibCore/StandardPaths.h>
 #include <LibCore/System.h>
 #include <LibJS/Bytecode/BasicBlock.h>
+#include <LibJS/Bytecode/Executable.h>
 #include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Console.h>
 #include <LibJS/Contrib/Test262/GlobalObject.h>
 #include <LibJS/Parser.h>
 #include <LibJS/Print.h>
+#include <LibJS/ProgramCache.h>
 #include <LibJS/Runtime/ConsoleObject.h>
 #include <LibJS/Runtime/DeclarativeEnvironment.h>
 #include <LibJS/Runtime/GlobalEnvironment.h>
 #include <LibJS/Runtime/JSONObject.h>
+#include <LibJS/Runtime/PrimitiveString.h>
 #include <LibJS/Runtime/StringPrototype.h>
 #include <LibJS/Runtime/ValueInlines.h>
 #include <LibJS/SourceTextModule.h>
@@ -56,6 +60,7 @@ private:
     JS_DECLARE_NATIVE_FUNCTION(save_to_file);
     JS_DECLARE_NATIVE_FUNCTION(load_ini);
     JS_DECLARE_NATIVE_FUNCTION(load_json);
+    JS_DECLARE_NATIVE_FUNCTION(load_script);
     JS_DECLARE_NATIVE_FUNCTION(last_value_getter);
     JS_DECLARE_NATIVE_FUNCTION(print);
 };
@@ -320,6 +325,27 @@ static JS::ThrowCompletionOr<JS::Value> load_json_impl(JS::VM& vm)
     return JS::JSONObject::parse_json_value(vm, json.value());
 }
 
+// Parses the file through the VM's program cache, so loading the same file again skips parsing it.
+static JS::ThrowCompletionOr<JS::Value> load_script_impl(JS::VM& vm)
+{
+    auto& realm = *vm.current_realm();
+
+    auto filename = TRY(vm.argument(0).to_byte_string(vm));
+    auto file_or_error = Core::File::open(filename, Core::File::OpenMode::Read);
+    if (file_or_error.is_error())
+        return vm.throw_completion<JS::Error>(TRY_OR_THROW_OOM(vm, String::formatted("Failed to open '{}': {}", filename, file_or_error.error())));
+
+    auto file_contents_or_error = file_or_error.value()->read_until_eof();
+    if (file_contents_or_error.is_error())
+        return vm.throw_completion<JS::Error>(TRY_OR_THROW_OOM(vm, String::formatted("Failed to read '{}': {}", filename, file_contents_or_error.error())));
+
+    auto script_or_error = JS::Script::parse(file_contents_or_error.value(), realm, filename);
+    if (script_or_error.is_error())
+        return vm.throw_completion<JS::SyntaxError>(script_or_error.error()[0].to_string());
+
+    return vm.bytecode_interpreter().run(script_or_error.value());
+}
+
 void ReplObject::initialize(JS::Realm& realm)
 {
     Base::initialize(realm);
@@ -331,6 +357,7 @@ void ReplObject::initialize(JS::Realm& realm)
     define_native_function(realm, "save", save_to_file, 1, attr);
     define_native_function(realm, "loadINI", load_ini, 1, attr);
     define_native_function(realm, "loadJSON", load_json, 1, attr);
+    define_native_function(realm, "load", load_script, 1, attr);
     define_native_function(realm, "print", print, 1, attr);
 
     define_native_accessor(
@@ -381,6 +408,7 @@ JS_DEFINE_NATIVE_FUNCTION(ReplObject::repl_help)
     warnln("    help(): display this menu");
     warnln("    loadINI(file): load the given file as INI.");
     warnln("    loadJSON(file): load the given file as JSON.");
+    warnln("    load(file): run the given file as a script. Loading it again reuses the parsed script.");
     warnln("    print(value): pretty-print the given JS value.");
     warnln("    save(file): write REPL input history to the given file. For example: save(\"foo.txt\")");
     return JS::js_undefined();
@@ -396,6 +424,11 @@ JS_DEFINE_NATIVE_FUNCTION(ReplObject::load_json)
     return load_json_impl(vm);
 }
 
+JS_DEFINE_NATIVE_FUNCTION(ReplObject::load_script)
+{
+    return load_script_impl(vm);
+}
+
 JS_DEFINE_NATIVE_FUNCTION(ReplObject::print)
 {
     auto result = ::print(vm.argument(0));
@@ -439,6 +472,12 @@ JS_DEFINE_NATIVE_FUNCTION(ScriptObject::print)
     return JS::js_undefined();
 }
 
+static void print_program_cache_statistics(JS::ProgramCache const& program_cache)
+{
+    warnln("Program cache: {} hits, {} misses, {} programs from {} bytes of source text kept",
+        program_cache.hit_count(), program_cache.miss_count(), program_cache.size(), program_cache.total_source_length());
+}
+
 static ErrorOr<void> repl(JS::Realm& realm)
 {
     while (s_keep_running_repl) {
@@ -535,9 +574,19 @@ private:
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
-    TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction map_fixed"));
+    TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction map_fixed thread"));
 
     bool gc_on_every_allocation = false;
+    bool generational_gc = false;
+    size_t gc_marking_thread_count = 1;
+    bool lazy_function_parsing = false;
+    bool dump_property_lookup_caches = false;
+    bool dump_string_statistics = false;
+    size_t program_cache_size_in_kib = JS::ProgramCache::default_capacity / KiB;
+    bool dump_program_cache_statistics = false;
+    StringView profile_path;
+    size_t profile_interval_in_microseconds = 1000;
+    bool count_instructions = false;
     bool disable_syntax_highlight = false;
     bool disable_debug_printing = false;
     bool use_test262_global = false;
@@ -548,11 +597,21 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.set_general_help("This is a JavaScript interpreter.");
     args_parser.add_option(s_dump_ast, "Dump the AST", "dump-ast", 'A');
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
+    args_parser.add_option(dump_property_lookup_caches, "Dump the hits and misses of property lookup caches on exit", "dump-property-lookup-caches", {});
+    args_parser.add_option(dump_string_statistics, "Dump how much memory the strings on the heap take up on exit", "dump-string-statistics", {});
+    args_parser.add_option(profile_path, "Sample the JS call stack while running and write the stacks to this file in the folded format", "profile", {}, "path");
+    args_parser.add_option(profile_interval_in_microseconds, "Interval between samples of the JS call stack", "profile-interval", {}, "microseconds");
+    args_parser.add_option(count_instructions, "Count how often each kind of bytecode instruction is executed and print the counts on exit", "count-instructions", {});
     args_parser.add_option(s_as_module, "Treat as module", "as-module", 'm');
     args_parser.add_option(s_print_last_result, "Print last result", "print-last-result", 'l');
     args_parser.add_option(s_strip_ansi, "Disable ANSI colors", "disable-ansi-colors", 'i');
     args_parser.add_option(s_disable_source_location_hints, "Disable source location hints", "disable-source-location-hints", 'h');
     args_parser.add_option(gc_on_every_allocation, "GC on every allocation", "gc-on-every-allocation", 'g');
+    args_parser.add_option(generational_gc, "Collect the young generation separately", "generational-gc", {});
+    args_parser.add_option(gc_marking_thread_count, "Number of threads to mark live cells with", "gc-marking-threads", {}, "count");
+    args_parser.add_option(program_cache_size_in_kib, "Amount of source text whose parsed programs are kept around to be reused, 0 to disable", "program-cache-size", {}, "KiB");
+    args_parser.add_option(dump_program_cache_statistics, "Dump the hits and misses of the program cache on exit", "dump-program-cache-statistics", {});
+    args_parser.add_option(lazy_function_parsing, "Parse function bodies when they are first called", "lazy-function-parsing", {});
     args_parser.add_option(disable_syntax_highlight, "Disable live syntax highlighting", "no-syntax-highlight", 's');
     args_parser.add_option(disable_debug_printing, "Disable debug output", "disable-debug-output", {});
     args_parser.add_option(evaluate_script, "Evaluate argument as a script", "evaluate", 'c', "script");
@@ -568,6 +627,18 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     g_vm_storage.get() = TRY(JS::VM::create());
     g_vm = g_vm_storage->ptr();
     g_vm->set_dynamic_imports_allowed(true);
+    g_vm->set_lazy_function_parsing_enabled(lazy_function_parsing);
+    g_vm->program_cache().set_capacity(program_cache_size_in_kib * KiB);
+
+    if (!profile_path.is_empty() || count_instructions) {
+        if (profile_interval_in_microseconds == 0)
+            return Error::from_string_literal("The profile interval must not be zero");
+        JS::Bytecode::Profiler::Options profiler_options {
+            .sampling_interval = Duration::from_microseconds(profile_interval_in_microseconds),
+            .count_instructions = count_instructions,
+        };
+        g_vm->bytecode_interpreter().set_profiler(make<JS::Bytecode::Profiler>(*g_vm, profiler_options));
+    }
 
     if (!disable_debug_printing) {
         // NOTE: These will print out both warnings when using something like Promise.reject().catch(...) -
@@ -600,6 +671,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         ReplConsoleClient console_client(console_object.console());
         console_object.console().set_client(console_client);
         g_vm->heap().set_should_collect_on_every_allocation(gc_on_every_allocation);
+        g_vm->heap().set_generational_collection_enabled(generational_gc);
+        g_vm->heap().set_marking_thread_count(gc_marking_thread_count);
 
         auto& global_environment = realm.global_environment();
 
@@ -817,6 +890,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         s_editor->on_tab_complete = move(complete);
         TRY(repl(realm));
         s_editor->save_history(s_history_path.to_byte_string());
+
+        if (dump_program_cache_statistics)
+            print_program_cache_statistics(g_vm->program_cache());
     } else {
         OwnPtr<JS::ExecutionContext> root_execution_context;
         if (use_test262_global)
@@ -829,6 +905,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         ReplConsoleClient console_client(console_object.console());
         console_object.console().set_client(console_client);
         g_vm->heap().set_should_collect_on_every_allocation(gc_on_every_allocation);
+        g_vm->heap().set_generational_collection_enabled(generational_gc);
+        g_vm->heap().set_marking_thread_count(gc_marking_thread_count);
 
         StringBuilder builder;
         StringView source_name;
@@ -861,7 +939,39 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
         // We resolve modules as if it is the first file
 
-        if (!TRY(parse_and_run(realm, builder.string_view(), source_name)))
+        auto succeeded = TRY(parse_and_run(realm, builder.string_view(), source_name));
+
+        if (dump_property_lookup_caches) {
+            g_vm->heap().for_each_live_cell([](JS::Cell* cell) {
+                if (is<JS::Bytecode::Executable>(cell))
+                    static_cast<JS::Bytecode::Executable*>(cell)->dump_property_lookup_cache_statistics();
+            });
+        }
+
+        if (dump_string_statistics) {
+            JS::StringStorageStatistics statistics;
+            g_vm->heap().for_each_live_cell([&](JS::Cell* cell) {
+                if (is<JS::PrimitiveString>(cell))
+                    statistics.add(static_cast<JS::PrimitiveString const&>(*cell));
+            });
+            statistics.dump();
+        }
+
+        if (dump_program_cache_statistics)
+            print_program_cache_statistics(g_vm->program_cache());
+
+        if (auto* profiler = g_vm->bytecode_interpreter().profiler()) {
+            if (!profile_path.is_empty()) {
+                auto file = TRY(Core::File::open(profile_path, Core::File::OpenMode::Write));
+                TRY(profiler->write_folded_stacks(*file));
+            }
+            if (count_instructions) {
+                auto standard_error = TRY(Core::File::standard_error());
+                TRY(profiler->write_instruction_counts(*standard_error));
+            }
+        }
+
+        if (!succeeded)
             return 1;
     }
 
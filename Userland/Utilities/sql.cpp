@@ -330,6 +330,13 @@ private:
             } else {
                 outln("\033[33;1mCannot recursively read sql files\033[0m");
             }
+        } else if (command == ".stats") {
+            if (auto statistics = m_sql_client->block_cache_statistics(m_connection_id); statistics.has_value()) {
+                outln("Block cache: {} of {} blocks in use", statistics->cached_blocks, statistics->capacity);
+                outln("  {} hits, {} misses, {} blocks read ahead, {} evictions", statistics->hits, statistics->misses, statistics->read_ahead_blocks, statistics->evictions);
+            } else {
+                outln("\033[33;1mNot connected to a database\033[0m");
+            }
         } else {
             outln("\033[33;1mUnrecognized command:\033[0m {}", command);
         }
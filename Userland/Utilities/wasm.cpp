@@ -352,7 +352,7 @@ static bool pre_interpret_hook(Wasm::Configuration& config, Wasm::InstructionPoi
                     warnln("invalid memory index {} (not found)", args[2]);
                     continue;
                 }
-                warnln("{:>32hex-dump}", mem->data().bytes());
+                warnln("{:>32hex-dump}", mem->bytes());
                 continue;
             }
             if (what.is_one_of("i", "instr", "instruction")) {
@@ -523,6 +523,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool export_all_imports = false;
     bool shell_mode = false;
     bool wasi = false;
+    bool disable_jit = false;
+    bool use_guard_pages = false;
     ByteString exported_function_to_execute;
     Vector<ParsedValue> values_to_push;
     Vector<ByteString> modules_to_link_in;
@@ -538,6 +540,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     parser.add_option(export_all_imports, "Export noop functions corresponding to imports", "export-noop");
     parser.add_option(shell_mode, "Launch a REPL in the module's context (implies -i)", "shell", 's');
     parser.add_option(wasi, "Enable WASI", "wasi", 'w');
+    parser.add_option(disable_jit, "Only interpret the module, without compiling it to native code", "no-jit");
+    parser.add_option(use_guard_pages, "Catch out of bounds memory accesses with guard pages instead of checking every access", "guard-pages");
     parser.add_option(Core::ArgsParser::Option {
         .argument_mode = Core::ArgsParser::OptionArgumentMode::Required,
         .help_string = "Directory mappings to expose via WASI",
@@ -616,6 +620,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     if (attempt_instantiate) {
         Wasm::AbstractMachine machine;
+        // Faults skip the debugger's frames, so it has to keep checking every access.
+        if (use_guard_pages && !debug)
+            machine.enable_guarded_memories();
         Optional<Wasm::Wasi::Implementation> wasi_impl;
 
         if (wasi) {
@@ -645,6 +652,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         }
 
         Core::EventLoop main_loop;
+        // Neither native code nor lowered functions can be stepped through, so the debugger has to interpret everything.
+        g_interpreter.set_jit_enabled(!disable_jit && !debug && Wasm::JIT::Compiler::is_enabled_by_default());
+        g_interpreter.set_lowering_enabled(!debug);
         if (debug) {
             g_line_editor = Line::Editor::construct();
             g_interpreter.pre_interpret_hook = pre_interpret_hook;